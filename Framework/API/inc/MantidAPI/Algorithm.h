@@ -8,6 +8,8 @@
 #define MANTID_API_ALGORITHM_H_
 
 #include <atomic>
+#include <map>
+#include <mutex>
 
 #include "MantidAPI/DllConfig.h"
 #include "MantidAPI/IAlgorithm.h"
@@ -288,6 +290,10 @@ public:
                              const double startProgress = -1.,
                              const double endProgress = -1.,
                              const bool enableLogging = true);
+  boost::shared_ptr<Algorithm>
+  reuseChildAlgorithm(const std::string &name, const double startProgress = -1.,
+                      const double endProgress = -1.,
+                      const bool enableLogging = true, const int &version = -1);
 
   /// set whether we wish to track the child algorithm's history and pass it the
   /// parent object to fill.
@@ -441,6 +447,8 @@ private:
 
   bool isCompoundProperty(const std::string &name) const;
 
+  void resetForReuse(const std::vector<std::string> &initialProperties);
+
   // --------------------- Private Members -----------------------------------
   /// Poco::ActiveMethod used to implement asynchronous execution.
   std::unique_ptr<Poco::ActiveMethod<bool, Poco::Void, Algorithm,
@@ -477,6 +485,17 @@ private:
                                                               /// to any child
                                                               /// algorithms
                                                               /// created
+  /// A child algorithm handed out by reuseChildAlgorithm
+  struct ReusableChild {
+    boost::shared_ptr<Algorithm> algorithm;
+    /// The names of the properties declared by init()
+    std::vector<std::string> initialProperties;
+  };
+  /// Child algorithms handed out by reuseChildAlgorithm, by name and version
+  std::map<std::pair<std::string, int>, ReusableChild>
+      m_reusableChildAlgorithms;
+  /// Guards m_reusableChildAlgorithms
+  std::mutex m_reusableChildLock;
 
   /// Vector of all the workspaces that have been read-locked
   WorkspaceVector m_readLockedWorkspaces;
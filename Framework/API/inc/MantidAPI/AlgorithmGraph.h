@@ -0,0 +1,100 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_API_ALGORITHMGRAPH_H_
+#define MANTID_API_ALGORITHMGRAPH_H_
+
+#include "MantidAPI/DllConfig.h"
+#include "MantidAPI/IAlgorithm_fwd.h"
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Mantid {
+namespace API {
+
+/** AlgorithmGraph : runs a set of configured algorithms concurrently while
+  respecting the dependencies between them.
+
+  Nodes are executed in the order they were added unless they are
+  independent, in which case they may run at the same time on a shared pool
+  of threads. A dependency is inferred whenever two nodes name the same
+  workspace and at least one of them writes to it (an Output or InOut
+  workspace property), so a reader always sees the output of the writer added
+  before it and a later writer never overwrites a workspace still being read.
+  Further dependencies can be added explicitly with addDependency().
+
+  Properties naming workspaces that do not exist yet (e.g. the output of an
+  upstream node) cannot be set on an algorithm in advance, so they may be
+  passed to addAlgorithm() instead and are applied just before the algorithm
+  runs.
+
+  Every node exposes a future that becomes ready when it completes. A node
+  whose algorithm throws stores the exception in its future; the nodes that
+  depend on it are skipped while independent nodes carry on.
+*/
+class MANTID_API_DLL AlgorithmGraph {
+public:
+  /// Identifies a node in the graph
+  using NodeId = size_t;
+  /// Execution state of a node
+  enum class NodeState { Queued, Running, Succeeded, Failed, Skipped };
+
+  NodeId addAlgorithm(IAlgorithm_sptr algorithm,
+                      const std::map<std::string, std::string> &properties =
+                          std::map<std::string, std::string>());
+  void addDependency(NodeId node, NodeId dependsOn);
+  void setThreadLimit(NodeId node, int maxThreads);
+
+  /// Number of nodes in the graph
+  size_t size() const { return m_nodes.size(); }
+  IAlgorithm_sptr algorithm(NodeId node) const;
+  std::set<NodeId> dependencies(NodeId node) const;
+  NodeState state(NodeId node) const;
+  std::shared_future<bool> future(NodeId node) const;
+  double progress() const;
+
+  bool execute(size_t numThreads = 0);
+  std::future<bool> executeAsync(size_t numThreads = 0);
+
+private:
+  struct Node {
+    IAlgorithm_sptr algorithm;
+    std::map<std::string, std::string> properties;
+    std::set<NodeId> explicitDependencies;
+    int maxThreads{0};
+    NodeState state{NodeState::Queued};
+    std::promise<bool> promise;
+    std::shared_future<bool> future;
+  };
+  class NodeTask;
+
+  void checkNode(NodeId node) const;
+  std::vector<std::set<NodeId>> buildDependencies() const;
+  void runNode(NodeId node);
+  void setState(NodeId node, NodeState state);
+
+  /// The nodes, in the order they were added
+  std::vector<Node> m_nodes;
+  /// All dependencies of each node, fixed when execution starts
+  std::vector<std::set<NodeId>> m_dependencies;
+  /// Guards the node states while the graph is executing
+  mutable std::mutex m_stateLock;
+  /// Number of nodes that have reached a final state
+  std::atomic<size_t> m_completed{0};
+  /// Has execute() been called?
+  bool m_started{false};
+};
+
+} // namespace API
+} // namespace Mantid
+
+#endif /* MANTID_API_ALGORITHMGRAPH_H_ */
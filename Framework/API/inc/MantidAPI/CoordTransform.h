@@ -40,6 +40,10 @@ public:
   virtual CoordTransform *clone() const = 0;
   virtual std::string id() const = 0;
 
+  /// Transform a contiguous batch of input vectors
+  virtual void applyBatch(const coord_t *inputVectors, coord_t *outVectors,
+                          const size_t numVectors) const;
+
   /// Wrapper for VMD
   Mantid::Kernel::VMD applyVMD(const Mantid::Kernel::VMD &inputVector) const;
 
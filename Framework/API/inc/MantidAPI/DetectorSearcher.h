@@ -48,10 +48,17 @@ public:
                    const Geometry::DetectorInfo &detInfo);
   /// Find a detector that intsects with the given Qlab vector
   DetectorSearchResult findDetectorIndex(const Kernel::V3D &q);
+  /// Find the detectors that intersect with each of the given Qlab vectors
+  std::vector<DetectorSearchResult>
+  findDetectorIndices(const std::vector<Kernel::V3D> &qs);
 
 private:
   /// Attempt to find a detector using a full instrument ray tracing strategy
   DetectorSearchResult searchUsingInstrumentRayTracing(const Kernel::V3D &q);
+  /// Attempt to find a detector with the given ray tracer
+  DetectorSearchResult
+  searchUsingInstrumentRayTracing(const Kernel::V3D &q,
+                                  const Geometry::InstrumentRayTracer &tracer);
   /// Attempt to find a detector using a nearest neighbours search strategy
   DetectorSearchResult searchUsingNearestNeighbours(const Kernel::V3D &q);
   /// Check whether the given direction in detector space intercepts with a
@@ -67,7 +74,13 @@ private:
   /// Helper function to handle the tube gap parameter in tube instruments
   DetectorSearchResult handleTubeGap(
       const Kernel::V3D &detectorDir,
-      const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours);
+      const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours,
+      const std::vector<double> &gaps) const;
+  /// Check the nearest neighbours found for a Qlab vector for a detector hit
+  DetectorSearchResult checkNeighbours(
+      const Kernel::V3D &q,
+      const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours,
+      const std::vector<double> &gaps) const;
 
   // Instance variables
 
@@ -12,8 +12,12 @@
 //----------------------------------------------------------------------
 #include "MantidAPI/IFunctionWithLocation.h"
 
+#include <utility>
+
 namespace Mantid {
 namespace API {
+class FunctionDomain1D;
+
 /** An interface to a peak function, which extend the interface of
     IFunctionWithLocation by adding methods to set and get peak width.
 
@@ -52,6 +56,14 @@ public:
   virtual std::pair<double, double>
   getDomainInterval(double level = DEFAULT_SEARCH_LEVEL) const;
 
+  /// Get the range of points of a sorted domain within the peak radius
+  std::pair<size_t, size_t>
+  getPeakRadiusWindow(const FunctionDomain1D &domain) const;
+  /// Whether the peak is evaluated by functionLocal() through function1D()
+  /// and so is zero outside getPeakRadiusWindow(). Only such peaks may be
+  /// evaluated on the window alone, e.g. by CompositeFunction.
+  virtual bool usesPeakRadiusWindow() const { return false; }
+
   /// Function evaluation method to be implemented in the inherited classes
   virtual void functionLocal(double *out, const double *xValues,
                              const size_t nData) const = 0;
@@ -38,6 +38,8 @@
 
 #include <json/json.h>
 
+#include <algorithm>
+#include <cassert>
 #include <map>
 
 // Index property handling template definitions
@@ -66,6 +68,19 @@ public:
 private:
   const std::string &m_value;
 };
+
+/// Give nameless, mandatory output workspaces a temporary name to satisfy
+/// the validator of a child algorithm
+void createTemporaryOutputNames(const IAlgorithm &alg) {
+  for (auto prop : alg.getProperties()) {
+    auto wsProp = dynamic_cast<IWorkspaceProperty *>(prop);
+    if (prop->direction() == Mantid::Kernel::Direction::Output && wsProp) {
+      if (prop->value().empty() && !wsProp->isOptional()) {
+        prop->createTemporaryValue();
+      }
+    }
+  }
+}
 } // namespace
 
 // Doxygen can't handle member specialization at the moment:
@@ -848,15 +863,7 @@ void Algorithm::setupAsChildAlgorithm(Algorithm_sptr alg,
 
   // If output workspaces are nameless, give them a temporary name to satisfy
   // validator
-  const std::vector<Property *> &props = alg->getProperties();
-  for (auto prop : props) {
-    auto wsProp = dynamic_cast<IWorkspaceProperty *>(prop);
-    if (prop->direction() == Mantid::Kernel::Direction::Output && wsProp) {
-      if (prop->value().empty() && !wsProp->isOptional()) {
-        prop->createTemporaryValue();
-      }
-    }
-  }
+  createTemporaryOutputNames(*alg);
 
   if (startProgress >= 0.0 && endProgress > startProgress &&
       endProgress <= 1.0) {
@@ -872,10 +879,94 @@ void Algorithm::setupAsChildAlgorithm(Algorithm_sptr alg,
   // in parallel safely.
   boost::weak_ptr<IAlgorithm> weakPtr(alg);
   PARALLEL_CRITICAL(Algorithm_StoreWeakPtr) {
+    // Forget children that have been destroyed before the vector grows, so
+    // that algorithms creating many children in a loop do not accumulate them
+    if (m_ChildAlgorithms.size() == m_ChildAlgorithms.capacity()) {
+      m_ChildAlgorithms.erase(
+          std::remove_if(m_ChildAlgorithms.begin(), m_ChildAlgorithms.end(),
+                         [](const boost::weak_ptr<IAlgorithm> &child) {
+                           return child.expired();
+                         }),
+          m_ChildAlgorithms.end());
+    }
     m_ChildAlgorithms.push_back(weakPtr);
   }
 }
 
+/** Get a child algorithm that is kept by this algorithm and handed out again
+ * by later calls with the same name and version, once the caller has
+ * released it. A reused instance has the properties declared after init()
+ * removed and all others reset to their defaults, so creating it through the
+ * factory and declaring its properties is only paid once. This is intended
+ * for loops that run the same child algorithm many times.
+ *
+ * Only use this for child algorithms that do not keep state in member
+ * variables between executions. If the cached instance is still held
+ * elsewhere (e.g. by another thread) a new one is created, as
+ * createChildAlgorithm would. Arguments are as for createChildAlgorithm.
+ *
+ * @return shared pointer to the child algorithm
+ */
+Algorithm_sptr Algorithm::reuseChildAlgorithm(const std::string &name,
+                                              const double startProgress,
+                                              const double endProgress,
+                                              const bool enableLogging,
+                                              const int &version) {
+  std::lock_guard<std::mutex> lock(m_reusableChildLock);
+  auto &entry = m_reusableChildAlgorithms[std::make_pair(name, version)];
+  auto &cached = entry.algorithm;
+  if (!cached || cached.use_count() > 1 || cached->isRunning()) {
+    cached = createChildAlgorithm(name, startProgress, endProgress,
+                                  enableLogging, version);
+    entry.initialProperties.clear();
+    for (const auto prop : cached->getProperties())
+      entry.initialProperties.push_back(prop->name());
+    return cached;
+  }
+
+  cached->resetForReuse(entry.initialProperties);
+  cached->setLogging(enableLogging);
+  createTemporaryOutputNames(*cached);
+  cached->removeObserver(this->progressObserver());
+  if (startProgress >= 0.0 && endProgress > startProgress &&
+      endProgress <= 1.0) {
+    cached->addObserver(this->progressObserver());
+    m_startChildProgress = startProgress;
+    m_endChildProgress = endProgress;
+  }
+  return cached;
+}
+
+/** Return the algorithm to the state it had after initialization so that
+ * it can be executed again: properties declared after init(), e.g. in
+ * afterPropertySet, are removed, every other property is set back to its
+ * default and the executed and cancelled flags are cleared. State kept in
+ * member variables is not reset.
+ * @param initialProperties :: the names of the properties declared by init()
+ */
+void Algorithm::resetForReuse(
+    const std::vector<std::string> &initialProperties) {
+  std::vector<std::string> dynamicProperties;
+  for (const auto prop : getProperties()) {
+    if (std::find(initialProperties.cbegin(), initialProperties.cend(),
+                  prop->name()) == initialProperties.cend())
+      dynamicProperties.push_back(prop->name());
+  }
+  for (const auto &propName : dynamicProperties)
+    removeProperty(propName);
+  assert(propertyCount() == initialProperties.size());
+
+  for (auto prop : getProperties()) {
+    // The default of a mandatory property is invalid until it is set again,
+    // so the validation message is expected here. Parsing errors are not,
+    // as the default was accepted when the property was declared.
+    prop->setValue(prop->getDefault());
+  }
+  setExecuted(false);
+  m_cancel = false;
+  m_history.reset();
+}
+
 //=============================================================================================
 //================================== Algorithm History
 //========================================
@@ -1299,9 +1390,10 @@ bool Algorithm::doCallProcessGroups(
     // Get how long this algorithm took to run
     const float duration = timer.elapsed();
 
-    m_history = boost::make_shared<AlgorithmHistory>(this, startTime, duration,
-                                                     ++g_execCount);
-    if (trackingHistory() && m_history) {
+    // Capturing the properties is only needed when the history is recorded
+    if (trackingHistory()) {
+      m_history = boost::make_shared<AlgorithmHistory>(this, startTime,
+                                                       duration, ++g_execCount);
       // find any further outputs created by the execution
       WorkspaceVector outputWorkspaces;
       const bool checkADS{true};
@@ -0,0 +1,337 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidAPI/AlgorithmGraph.h"
+#include "MantidAPI/IAlgorithm.h"
+#include "MantidAPI/IWorkspaceProperty.h"
+#include "MantidKernel/Logger.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidKernel/Property.h"
+#include "MantidKernel/Task.h"
+#include "MantidKernel/ThreadPool.h"
+#include "MantidKernel/ThreadSchedulerDependencies.h"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <deque>
+#include <stdexcept>
+
+namespace Mantid {
+namespace API {
+namespace {
+/// static logger
+Kernel::Logger g_log("AlgorithmGraph");
+
+/// The workspaces a node reads and writes, keyed by workspace name
+struct WorkspaceAccess {
+  std::set<std::string> reads;
+  std::set<std::string> writes;
+};
+
+/** Collect the names of the workspaces an algorithm will read and write.
+ * @param algorithm :: the configured algorithm
+ * @param deferred :: property values that will be set before execution
+ */
+WorkspaceAccess
+workspaceAccess(const IAlgorithm &algorithm,
+                const std::map<std::string, std::string> &deferred) {
+  std::map<std::string, std::string> deferredLower;
+  for (const auto &property : deferred)
+    deferredLower.emplace(boost::algorithm::to_lower_copy(property.first),
+                          property.second);
+
+  WorkspaceAccess access;
+  for (const auto property : algorithm.getProperties()) {
+    if (!dynamic_cast<IWorkspaceProperty *>(property))
+      continue;
+    const auto found =
+        deferredLower.find(boost::algorithm::to_lower_copy(property->name()));
+    const std::string wsName =
+        found != deferredLower.end() ? found->second : property->value();
+    if (wsName.empty())
+      continue;
+    if (property->direction() != Kernel::Direction::Output)
+      access.reads.insert(wsName);
+    if (property->direction() != Kernel::Direction::Input)
+      access.writes.insert(wsName);
+  }
+  return access;
+}
+
+/// Does any name in first also appear in second?
+bool intersects(const std::set<std::string> &first,
+                const std::set<std::string> &second) {
+  for (const auto &name : first) {
+    if (second.count(name) > 0)
+      return true;
+  }
+  return false;
+}
+} // namespace
+
+/// Task running a single node of the graph
+class AlgorithmGraph::NodeTask : public Kernel::Task {
+public:
+  NodeTask(AlgorithmGraph &graph, NodeId node) : m_graph(graph), m_node(node) {}
+  void run() override { m_graph.runNode(m_node); }
+
+private:
+  AlgorithmGraph &m_graph;
+  NodeId m_node;
+};
+
+/** Add a configured algorithm to the graph.
+ *
+ * @param algorithm :: an initialized algorithm. Its properties may be set
+ *        already; they are read when execution starts to infer dependencies.
+ * @param properties :: property values to set immediately before the
+ *        algorithm runs, e.g. input workspaces produced by other nodes.
+ * @return the id of the new node
+ */
+AlgorithmGraph::NodeId AlgorithmGraph::addAlgorithm(
+    IAlgorithm_sptr algorithm,
+    const std::map<std::string, std::string> &properties) {
+  if (m_started)
+    throw std::runtime_error("AlgorithmGraph: cannot add an algorithm after "
+                             "execution has started.");
+  if (!algorithm)
+    throw std::invalid_argument("AlgorithmGraph: null algorithm.");
+  if (!algorithm->isInitialized())
+    algorithm->initialize();
+  Node node;
+  node.algorithm = std::move(algorithm);
+  node.properties = properties;
+  node.future = node.promise.get_future().share();
+  m_nodes.push_back(std::move(node));
+  return m_nodes.size() - 1;
+}
+
+/** Make a node wait for another one, in addition to the dependencies
+ * inferred from workspace names.
+ *
+ * @param node :: the node that has to wait
+ * @param dependsOn :: the node that must finish first
+ */
+void AlgorithmGraph::addDependency(NodeId node, NodeId dependsOn) {
+  checkNode(node);
+  checkNode(dependsOn);
+  if (node == dependsOn)
+    throw std::invalid_argument(
+        "AlgorithmGraph: a node cannot depend on itself.");
+  m_nodes[node].explicitDependencies.insert(dependsOn);
+}
+
+/** Limit the number of OpenMP threads a node's algorithm may use. The pool
+ * running the graph decides how many nodes run at once, so the total thread
+ * count is roughly the sum of the limits of the running nodes.
+ *
+ * @param node :: the node to limit
+ * @param maxThreads :: maximum number of threads, 0 for no limit
+ */
+void AlgorithmGraph::setThreadLimit(NodeId node, int maxThreads) {
+  checkNode(node);
+  if (maxThreads < 0)
+    throw std::invalid_argument(
+        "AlgorithmGraph: the thread limit cannot be negative.");
+  m_nodes[node].maxThreads = maxThreads;
+}
+
+/// @return the algorithm held by a node
+IAlgorithm_sptr AlgorithmGraph::algorithm(NodeId node) const {
+  checkNode(node);
+  return m_nodes[node].algorithm;
+}
+
+/// @return all nodes that must complete before the given node, both inferred
+/// and explicit
+std::set<AlgorithmGraph::NodeId>
+AlgorithmGraph::dependencies(NodeId node) const {
+  checkNode(node);
+  if (m_started)
+    return m_dependencies[node];
+  return buildDependencies()[node];
+}
+
+/// @return the execution state of a node
+AlgorithmGraph::NodeState AlgorithmGraph::state(NodeId node) const {
+  checkNode(node);
+  std::lock_guard<std::mutex> lock(m_stateLock);
+  return m_nodes[node].state;
+}
+
+/** The future becomes ready when the node has completed. get() returns the
+ * result of IAlgorithm::execute(), or rethrows the exception that stopped the
+ * node (including that a dependency failed).
+ */
+std::shared_future<bool> AlgorithmGraph::future(NodeId node) const {
+  checkNode(node);
+  return m_nodes[node].future;
+}
+
+/// @return the fraction of nodes that have completed, between 0 and 1
+double AlgorithmGraph::progress() const {
+  if (m_nodes.empty())
+    return 1.0;
+  return static_cast<double>(m_completed) / static_cast<double>(m_nodes.size());
+}
+
+/** Run all nodes, blocking until they have completed.
+ *
+ * @param numThreads :: number of nodes that may run at the same time,
+ *        0 to use all physical cores.
+ * @return true if every algorithm executed successfully
+ * @throw std::runtime_error if the dependencies contain a cycle or the graph
+ *        has already been executed
+ */
+bool AlgorithmGraph::execute(size_t numThreads) {
+  if (m_started)
+    throw std::runtime_error("AlgorithmGraph: the graph has already been "
+                             "executed.");
+  m_dependencies = buildDependencies();
+
+  // Kahn's algorithm: every node must be reachable once its dependencies
+  // are satisfied, otherwise they form a cycle
+  std::vector<size_t> unmet(m_nodes.size());
+  std::vector<std::vector<NodeId>> dependents(m_nodes.size());
+  std::deque<NodeId> ready;
+  for (NodeId i = 0; i < m_nodes.size(); ++i) {
+    unmet[i] = m_dependencies[i].size();
+    for (const auto dependency : m_dependencies[i])
+      dependents[dependency].push_back(i);
+    if (unmet[i] == 0)
+      ready.push_back(i);
+  }
+  std::vector<NodeId> order;
+  order.reserve(m_nodes.size());
+  while (!ready.empty()) {
+    const NodeId current = ready.front();
+    ready.pop_front();
+    order.push_back(current);
+    for (const auto dependent : dependents[current]) {
+      if (--unmet[dependent] == 0)
+        ready.push_back(dependent);
+    }
+  }
+  if (order.size() != m_nodes.size())
+    throw std::runtime_error(
+        "AlgorithmGraph: the dependencies between algorithms form a cycle.");
+
+  m_started = true;
+  auto scheduler = new Kernel::ThreadSchedulerDependencies();
+  Kernel::ThreadPool pool(scheduler, numThreads);
+  // Push in topological order so every dependency is already queued
+  std::vector<Kernel::Task *> tasks(m_nodes.size(), nullptr);
+  for (const auto node : order) {
+    std::vector<Kernel::Task *> waitFor;
+    for (const auto dependency : m_dependencies[node])
+      waitFor.push_back(tasks[dependency]);
+    tasks[node] = new NodeTask(*this, node);
+    scheduler->push(tasks[node], waitFor);
+  }
+  pool.joinAll();
+
+  bool allSucceeded = true;
+  for (const auto &node : m_nodes)
+    allSucceeded = allSucceeded && node.state == NodeState::Succeeded;
+  return allSucceeded;
+}
+
+/** Run all nodes in a background thread.
+ *
+ * @param numThreads :: number of nodes that may run at the same time,
+ *        0 to use all physical cores.
+ * @return a future holding the result of execute()
+ */
+std::future<bool> AlgorithmGraph::executeAsync(size_t numThreads) {
+  return std::async(std::launch::async,
+                    [this, numThreads]() { return execute(numThreads); });
+}
+
+/// @throw std::out_of_range if the node id is not in the graph
+void AlgorithmGraph::checkNode(NodeId node) const {
+  if (node >= m_nodes.size())
+    throw std::out_of_range("AlgorithmGraph: invalid node id " +
+                            std::to_string(node));
+}
+
+/** Combine the explicit dependencies with the ones implied by workspace
+ * names. Only earlier nodes can be inferred as dependencies so the inferred
+ * part never contains a cycle.
+ */
+std::vector<std::set<AlgorithmGraph::NodeId>>
+AlgorithmGraph::buildDependencies() const {
+  std::vector<WorkspaceAccess> access;
+  access.reserve(m_nodes.size());
+  for (const auto &node : m_nodes)
+    access.push_back(workspaceAccess(*node.algorithm, node.properties));
+
+  std::vector<std::set<NodeId>> dependencies(m_nodes.size());
+  for (NodeId later = 0; later < m_nodes.size(); ++later) {
+    dependencies[later] = m_nodes[later].explicitDependencies;
+    for (NodeId earlier = 0; earlier < later; ++earlier) {
+      const auto &first = access[earlier];
+      const auto &second = access[later];
+      if (intersects(first.writes, second.reads) ||
+          intersects(first.writes, second.writes) ||
+          intersects(first.reads, second.writes))
+        dependencies[later].insert(earlier);
+    }
+  }
+  return dependencies;
+}
+
+/** Execute a single node. Called from the thread pool once all of the
+ * node's dependencies have completed. The state is updated before the
+ * promise is fulfilled so that it is final once the future is ready.
+ */
+void AlgorithmGraph::runNode(NodeId id) {
+  auto &node = m_nodes[id];
+  for (const auto dependency : m_dependencies[id]) {
+    if (state(dependency) != NodeState::Succeeded) {
+      const auto &failed = m_nodes[dependency].algorithm;
+      g_log.warning() << "Skipping " << node.algorithm->name()
+                      << " because " << failed->name() << " did not succeed.\n";
+      setState(id, NodeState::Skipped);
+      node.promise.set_exception(std::make_exception_ptr(std::runtime_error(
+          "AlgorithmGraph: skipped " + node.algorithm->name() + " because " +
+          failed->name() + " did not succeed.")));
+      return;
+    }
+  }
+
+  setState(id, NodeState::Running);
+  const int previousThreads = PARALLEL_GET_MAX_THREADS;
+  if (node.maxThreads > 0) {
+    PARALLEL_SET_NUM_THREADS(node.maxThreads);
+  }
+  try {
+    for (const auto &property : node.properties)
+      node.algorithm->setPropertyValue(property.first, property.second);
+    const bool result = node.algorithm->execute();
+    setState(id, result ? NodeState::Succeeded : NodeState::Failed);
+    node.promise.set_value(result);
+  } catch (...) {
+    g_log.error() << node.algorithm->name() << " failed in AlgorithmGraph.\n";
+    setState(id, NodeState::Failed);
+    node.promise.set_exception(std::current_exception());
+  }
+  if (node.maxThreads > 0) {
+    PARALLEL_SET_NUM_THREADS(previousThreads);
+  }
+}
+
+/// Record the new state of a node and count it if it has completed
+void AlgorithmGraph::setState(NodeId node, NodeState state) {
+  {
+    std::lock_guard<std::mutex> lock(m_stateLock);
+    m_nodes[node].state = state;
+  }
+  if (state != NodeState::Queued && state != NodeState::Running)
+    ++m_completed;
+}
+
+} // namespace API
+} // namespace Mantid
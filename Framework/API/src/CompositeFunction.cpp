@@ -8,8 +8,10 @@
 // Includes
 //----------------------------------------------------------------------
 #include "MantidAPI/CompositeFunction.h"
+#include "MantidAPI/FunctionDomain1D.h"
 #include "MantidAPI/FunctionFactory.h"
 #include "MantidAPI/IConstraint.h"
+#include "MantidAPI/IPeakFunction.h"
 #include "MantidAPI/ParameterTie.h"
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/Logger.h"
@@ -26,6 +28,27 @@ namespace API {
 namespace {
 /// static logger
 Kernel::Logger g_log("CompositeFunction");
+
+/**
+ * Check if the peak functions of a composite can be evaluated only within their
+ * peak radius on a domain: it must be a 1D point domain with a peak radius
+ * set and sorted arguments.
+ * @param domain :: Function domain to check.
+ * @return :: The 1D domain, or nullptr if the peaks must be evaluated on all
+ * of its points.
+ */
+const FunctionDomain1D *getPeakRadiusDomain(const FunctionDomain &domain) {
+  const auto *domain1D = dynamic_cast<const FunctionDomain1D *>(&domain);
+  if (!domain1D || domain1D->getPeakRadius() <= 0 || domain1D->size() == 0 ||
+      dynamic_cast<const FunctionDomain1DHistogram *>(&domain)) {
+    return nullptr;
+  }
+  const double *x = domain1D->getPointerAt(0);
+  if (!std::is_sorted(x, x + domain1D->size())) {
+    return nullptr;
+  }
+  return domain1D;
+}
 } // namespace
 
 using std::size_t;
@@ -154,7 +177,23 @@ void CompositeFunction::function(const FunctionDomain &domain,
                                  FunctionValues &values) const {
   FunctionValues tmp(domain);
   values.zeroCalculated();
+  const auto *peakDomain = getPeakRadiusDomain(domain);
   for (size_t iFun = 0; iFun < nFunctions(); ++iFun) {
+    const auto *peak =
+        dynamic_cast<const IPeakFunction *>(m_functions[iFun].get());
+    if (peakDomain && peak && peak->usesPeakRadiusWindow()) {
+      // a peak is zero outside its radius: only evaluate it inside
+      const auto window = peak->getPeakRadiusWindow(*peakDomain);
+      if (window.first < window.second) {
+        FunctionDomain1DView view(peakDomain->getPointerAt(window.first),
+                                  window.second - window.first);
+        view.setPeakRadius(peakDomain->getPeakRadius());
+        FunctionValues peakValues(view);
+        peak->function(view, peakValues);
+        values.addToCalculated(window.first, peakValues);
+      }
+      continue;
+    }
     m_functions[iFun]->function(domain, tmp);
     values += tmp;
   }
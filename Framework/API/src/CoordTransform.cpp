@@ -58,5 +58,23 @@ CoordTransform::applyVMD(const Mantid::Kernel::VMD &inputVector) const {
   return out;
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the transformation to many vectors at once. The default calls
+ * apply() on each one; subclasses override it with loops the compiler can
+ * vectorise across the batch.
+ *
+ * @param inputVectors :: numVectors input vectors of inD coordinates each,
+ *stored one after the other
+ * @param outVectors :: numVectors output vectors of outD coordinates each,
+ *stored one after the other
+ * @param numVectors :: number of vectors in the batch
+ */
+void CoordTransform::applyBatch(const coord_t *inputVectors,
+                                coord_t *outVectors,
+                                const size_t numVectors) const {
+  for (size_t i = 0; i < numVectors; ++i)
+    this->apply(inputVectors + i * inD, outVectors + i * outD);
+}
+
 } // namespace API
 } // namespace Mantid
@@ -7,6 +7,7 @@
 #include "MantidAPI/DetectorSearcher.h"
 #include "MantidGeometry/Instrument/ReferenceFrame.h"
 #include "MantidKernel/ConfigService.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/NearestNeighbours.h"
 
 #include <tuple>
@@ -118,6 +119,58 @@ DetectorSearcher::findDetectorIndex(const V3D &q) {
   }
 }
 
+/** Find the indices of the detectors for many vectors in Qlab space at once
+ *
+ * The searches are run in parallel. Ray tracing uses a tracer per thread,
+ * while the nearest neighbours are found serially, as the KD-tree search is
+ * not thread safe, before the neighbours are checked in parallel.
+ *
+ * @param qs :: the Qlab vectors to find detectors for
+ * @return tuples with data <detector found, detector index>, in the order of
+ * the Qlab vectors
+ */
+std::vector<DetectorSearcher::DetectorSearchResult>
+DetectorSearcher::findDetectorIndices(const std::vector<V3D> &qs) {
+  std::vector<DetectorSearchResult> results(qs.size(),
+                                            std::make_tuple(false, 0));
+  const auto numQs = static_cast<int64_t>(qs.size());
+
+  if (m_usingFullRayTrace) {
+    std::vector<std::unique_ptr<InstrumentRayTracer>> tracers(
+        PARALLEL_GET_MAX_THREADS);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = 0; i < numQs; ++i) {
+      if (qs[i].nullVector())
+        continue;
+      auto &tracer = tracers[PARALLEL_THREAD_NUMBER];
+      if (!tracer)
+        tracer = Kernel::make_unique<InstrumentRayTracer>(m_instrument);
+      results[i] = searchUsingInstrumentRayTracing(qs[i], *tracer);
+    }
+    return results;
+  }
+
+  std::vector<Kernel::NearestNeighbours<3>::NearestNeighbourResults>
+      neighbours(qs.size());
+  for (size_t i = 0; i < qs.size(); ++i) {
+    const auto &q = qs[i];
+    if (!q.nullVector())
+      neighbours[i] = m_detectorCacheSearch->findNearest(
+          Eigen::Vector3d(q[0], q[1], q[2]), 5);
+  }
+
+  std::vector<double> gaps;
+  if (m_instrument->hasParameter("tube-gap"))
+    gaps = m_instrument->getNumberParameter("tube-gap", true);
+
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < numQs; ++i) {
+    if (!neighbours[i].empty())
+      results[i] = checkNeighbours(qs[i], neighbours[i], gaps);
+  }
+  return results;
+}
+
 /** Find the index of a detector given a vector in Qlab space using a ray
  * tracing search strategy
  *
@@ -128,9 +181,22 @@ DetectorSearcher::findDetectorIndex(const V3D &q) {
  */
 DetectorSearcher::DetectorSearchResult
 DetectorSearcher::searchUsingInstrumentRayTracing(const V3D &q) {
+  return searchUsingInstrumentRayTracing(q, *m_rayTracer);
+}
+
+/** Find the index of a detector given a vector in Qlab space using the given
+ * ray tracer. Each thread needs its own tracer as it keeps its results.
+ *
+ * @param q :: the Qlab vector to find a detector for
+ * @param tracer :: the ray tracer to use
+ * @return tuple with data <detector found, detector index>
+ */
+DetectorSearcher::DetectorSearchResult
+DetectorSearcher::searchUsingInstrumentRayTracing(
+    const V3D &q, const InstrumentRayTracer &tracer) {
   const auto direction = convertQtoDirection(q);
-  m_rayTracer->traceFromSample(direction);
-  const auto det = m_rayTracer->getDetectorResult();
+  tracer.traceFromSample(direction);
+  const auto det = tracer.getDetectorResult();
 
   if (!det)
     return std::make_tuple(false, 0);
@@ -153,13 +219,32 @@ DetectorSearcher::searchUsingInstrumentRayTracing(const V3D &q) {
  */
 DetectorSearcher::DetectorSearchResult
 DetectorSearcher::searchUsingNearestNeighbours(const V3D &q) {
-  const auto detectorDir = convertQtoDirection(q);
   // find where this Q vector should intersect with "extended" space
   const auto neighbours =
       m_detectorCacheSearch->findNearest(Eigen::Vector3d(q[0], q[1], q[2]), 5);
   if (neighbours.empty())
     return std::make_tuple(false, 0);
 
+  std::vector<double> gaps;
+  if (m_instrument->hasParameter("tube-gap"))
+    gaps = m_instrument->getNumberParameter("tube-gap", true);
+
+  return checkNeighbours(q, neighbours, gaps);
+}
+
+/** Check whether the direction in detector space of a Qlab vector intercepts
+ * with any of its nearest neighbours, allowing for the gaps between tubes.
+ *
+ * @param q :: the Qlab vector to find a detector for
+ * @param neighbours :: the NearestNeighbour results to check interception with
+ * @param gaps :: the values of the tube-gap parameter, empty if there is none
+ * @return tuple with data <detector found, detector index>
+ */
+DetectorSearcher::DetectorSearchResult DetectorSearcher::checkNeighbours(
+    const V3D &q,
+    const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours,
+    const std::vector<double> &gaps) const {
+  const auto detectorDir = convertQtoDirection(q);
   const auto result = checkInteceptWithNeighbours(detectorDir, neighbours);
   const auto hitDetector = std::get<0>(result);
   const auto index = std::get<1>(result);
@@ -168,8 +253,8 @@ DetectorSearcher::searchUsingNearestNeighbours(const V3D &q) {
     return std::make_tuple(true, m_indexMap[index]);
 
   // Tube Gap Parameter specifically applies to tube instruments
-  if (!hitDetector && m_instrument->hasParameter("tube-gap")) {
-    return handleTubeGap(detectorDir, neighbours);
+  if (!hitDetector && !gaps.empty()) {
+    return handleTubeGap(detectorDir, neighbours, gaps);
   }
 
   return std::make_tuple(false, 0);
@@ -182,12 +267,13 @@ DetectorSearcher::searchUsingNearestNeighbours(const V3D &q) {
  *
  * @param detectorDir :: the predicted direction towards a detector
  * @param neighbours :: the NearestNeighbour results to check interception with
+ * @param gaps :: the values of the tube-gap parameter
  * @return a detector search result with whether a detector was hit
  */
 DetectorSearcher::DetectorSearchResult DetectorSearcher::handleTubeGap(
     const V3D &detectorDir,
-    const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours) {
-  std::vector<double> gaps = m_instrument->getNumberParameter("tube-gap", true);
+    const Kernel::NearestNeighbours<3>::NearestNeighbourResults &neighbours,
+    const std::vector<double> &gaps) const {
   if (!gaps.empty()) {
     const auto gap = static_cast<double>(gaps.front());
     // try adding and subtracting tube-gap in 3 q dimensions to see if you can
@@ -8,6 +8,7 @@
 // Includes
 //----------------------------------------------------------------------
 #include "MantidAPI/IPeakFunction.h"
+#include "MantidAPI/FunctionDomain1D.h"
 #include "MantidAPI/FunctionFactory.h"
 #include "MantidAPI/FunctionParameterDecorator.h"
 #include "MantidAPI/IFunction1D.tcc"
@@ -15,6 +16,7 @@
 #include "MantidAPI/PeakFunctionIntegrator.h"
 #include "MantidKernel/Exception.h"
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 #include <cmath>
@@ -171,6 +173,27 @@ void IPeakFunction::functionDeriv1D(Jacobian *out, const double *xValues,
   this->functionDerivLocal(&J, xValues + i0, n);
 }
 
+/**
+ * Find the points of a domain at which the peak is evaluated when the peak
+ * radius of the domain is applied. The points of the domain must be sorted
+ * in ascending order.
+ * @param domain :: A sorted 1D domain.
+ * @return :: The index of the first point within the peak radius and one past
+ * the index of the last one.
+ */
+std::pair<size_t, size_t>
+IPeakFunction::getPeakRadiusWindow(const FunctionDomain1D &domain) const {
+  setPeakRadius(domain.getPeakRadius());
+  const double c = this->centre();
+  const double dx = fabs(m_peakRadius * this->fwhm());
+  const double *begin = domain.getPointerAt(0);
+  const double *end = begin + domain.size();
+  const double *first = std::upper_bound(begin, end, c - dx);
+  const double *last = std::lower_bound(first, end, c + dx);
+  return std::make_pair(static_cast<size_t>(first - begin),
+                        static_cast<size_t>(last - begin));
+}
+
 void IPeakFunction::setPeakRadius(int r) const {
   if (r > 0) {
     m_peakRadius = r;
@@ -0,0 +1,152 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_API_ALGORITHMGRAPHTEST_H_
+#define MANTID_API_ALGORITHMGRAPHTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidAPI/Algorithm.h"
+#include "MantidAPI/AlgorithmGraph.h"
+#include "MantidAPI/AnalysisDataService.h"
+#include "MantidAPI/WorkspaceProperty.h"
+#include "MantidTestHelpers/FakeObjects.h"
+
+#include <boost/make_shared.hpp>
+
+using namespace Mantid::API;
+using namespace Mantid::Kernel;
+
+namespace {
+/// Appends a letter to the title of its input workspace
+class GraphToyAlgorithm : public Algorithm {
+public:
+  const std::string name() const override { return "GraphToyAlgorithm"; }
+  int version() const override { return 1; }
+  const std::string category() const override { return "Cat"; }
+  const std::string summary() const override { return "Test summary"; }
+
+  void init() override {
+    declareProperty(make_unique<WorkspaceProperty<>>(
+        "InputWorkspace", "", Direction::Input, PropertyMode::Optional));
+    declareProperty(make_unique<WorkspaceProperty<>>("OutputWorkspace", "",
+                                                     Direction::Output));
+    declareProperty("Letter", "a");
+    declareProperty("Fail", false);
+  }
+
+  void exec() override {
+    if (getProperty("Fail"))
+      throw std::runtime_error("GraphToyAlgorithm was asked to fail");
+    Workspace_sptr input = getProperty("InputWorkspace");
+    auto output = boost::make_shared<WorkspaceTester>();
+    output->initialize(1, 1, 1);
+    const std::string letter = getProperty("Letter");
+    output->setTitle((input ? input->getTitle() : "") + letter);
+    setProperty("OutputWorkspace", output);
+  }
+};
+
+IAlgorithm_sptr makeToy(const std::string &output, const std::string &letter,
+                        bool fail = false) {
+  auto alg = boost::make_shared<GraphToyAlgorithm>();
+  alg->initialize();
+  alg->setRethrows(true);
+  alg->setPropertyValue("OutputWorkspace", output);
+  alg->setPropertyValue("Letter", letter);
+  alg->setProperty("Fail", fail);
+  return alg;
+}
+
+std::map<std::string, std::string> readFrom(const std::string &input) {
+  return {{"InputWorkspace", input}};
+}
+} // namespace
+
+class AlgorithmGraphTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static AlgorithmGraphTest *createSuite() { return new AlgorithmGraphTest(); }
+  static void destroySuite(AlgorithmGraphTest *suite) { delete suite; }
+
+  void tearDown() override { AnalysisDataService::Instance().clear(); }
+
+  void test_dependencies_are_inferred_from_workspace_names() {
+    AlgorithmGraph graph;
+    const auto a = graph.addAlgorithm(makeToy("graph_a", "a"));
+    const auto b = graph.addAlgorithm(makeToy("graph_b", "b"));
+    const auto ab = graph.addAlgorithm(makeToy("graph_ab", "b"),
+                                       readFrom("graph_a"));
+    // Overwrites graph_a, so it must wait for its reader as well as its writer
+    const auto again = graph.addAlgorithm(makeToy("graph_a", "c"));
+
+    TS_ASSERT(graph.dependencies(a).empty());
+    TS_ASSERT(graph.dependencies(b).empty());
+    TS_ASSERT_EQUALS(graph.dependencies(ab), std::set<size_t>({a}));
+    TS_ASSERT_EQUALS(graph.dependencies(again), std::set<size_t>({a, ab}));
+  }
+
+  void test_execute_runs_chain_in_order() {
+    AlgorithmGraph graph;
+    graph.addAlgorithm(makeToy("graph_a", "a"));
+    graph.addAlgorithm(makeToy("graph_ab", "b"), readFrom("graph_a"));
+    const auto abc =
+        graph.addAlgorithm(makeToy("graph_abc", "c"), readFrom("graph_ab"));
+    graph.addAlgorithm(makeToy("graph_x", "x"));
+    graph.setThreadLimit(abc, 1);
+
+    TS_ASSERT(graph.execute(4));
+    TS_ASSERT_EQUALS(graph.progress(), 1.0);
+    TS_ASSERT(graph.future(abc).get());
+    TS_ASSERT_EQUALS(graph.state(abc), AlgorithmGraph::NodeState::Succeeded);
+    auto result = AnalysisDataService::Instance().retrieve("graph_abc");
+    TS_ASSERT_EQUALS(result->getTitle(), "abc");
+    TS_ASSERT(AnalysisDataService::Instance().doesExist("graph_x"));
+  }
+
+  void test_failure_skips_dependents_only() {
+    AlgorithmGraph graph;
+    const auto bad = graph.addAlgorithm(makeToy("graph_a", "a", true));
+    const auto dependent =
+        graph.addAlgorithm(makeToy("graph_ab", "b"), readFrom("graph_a"));
+    const auto independent = graph.addAlgorithm(makeToy("graph_x", "x"));
+
+    TS_ASSERT(!graph.execute(2));
+    TS_ASSERT_EQUALS(graph.state(bad), AlgorithmGraph::NodeState::Failed);
+    TS_ASSERT_EQUALS(graph.state(dependent),
+                     AlgorithmGraph::NodeState::Skipped);
+    TS_ASSERT_EQUALS(graph.state(independent),
+                     AlgorithmGraph::NodeState::Succeeded);
+    TS_ASSERT_THROWS(graph.future(bad).get(), const std::runtime_error &);
+    TS_ASSERT_THROWS(graph.future(dependent).get(), const std::runtime_error &);
+    TS_ASSERT_EQUALS(graph.progress(), 1.0);
+  }
+
+  void test_explicit_cycle_throws() {
+    AlgorithmGraph graph;
+    const auto a = graph.addAlgorithm(makeToy("graph_a", "a"));
+    const auto b = graph.addAlgorithm(makeToy("graph_b", "b"));
+    graph.addDependency(a, b);
+    graph.addDependency(b, a);
+    TS_ASSERT_THROWS(graph.execute(), const std::runtime_error &);
+    TS_ASSERT_THROWS(graph.addDependency(a, a), const std::invalid_argument &);
+    TS_ASSERT_THROWS(graph.addDependency(a, 5), const std::out_of_range &);
+  }
+
+  void test_executeAsync() {
+    AlgorithmGraph graph;
+    graph.addAlgorithm(makeToy("graph_a", "a"));
+    const auto ab =
+        graph.addAlgorithm(makeToy("graph_ab", "b"), readFrom("graph_a"));
+    auto result = graph.executeAsync(2);
+    TS_ASSERT(graph.future(ab).get());
+    TS_ASSERT(result.get());
+    TS_ASSERT_THROWS(graph.execute(), const std::runtime_error &);
+  }
+};
+
+#endif /* MANTID_API_ALGORITHMGRAPHTEST_H_ */
@@ -196,6 +196,29 @@ public:
 
 DECLARE_ALGORITHM(IndexingAlgorithm)
 
+/**
+ * Algorithm which declares a property once another one has been set
+ */
+class DynamicPropertyAlgorithm : public Algorithm {
+public:
+  const std::string name() const override {
+    return "DynamicPropertyAlgorithm";
+  }
+  int version() const override { return 1; }
+  const std::string summary() const override { return "Test summary"; }
+
+  void init() override { declareProperty("AddExtra", false); }
+
+  void afterPropertySet(const std::string &name) override {
+    if (name == "AddExtra" && !existsProperty("Extra"))
+      declareProperty("Extra", 0);
+  }
+
+  void exec() override {}
+};
+
+DECLARE_ALGORITHM(DynamicPropertyAlgorithm)
+
 class AlgorithmTest : public CxxTest::TestSuite {
 public:
   // This pair of boilerplate methods prevent the suite being created statically
@@ -646,6 +669,58 @@ public:
     return group;
   }
 
+  void test_reuseChildAlgorithm_resets_released_instance() {
+    StubbedWorkspaceAlgorithm parent;
+    parent.initialize();
+    auto input = boost::make_shared<WorkspaceTester>();
+    input->initialize(10, 10, 10);
+
+    auto child = parent.reuseChildAlgorithm("StubbedWorkspaceAlgorithm");
+    TS_ASSERT(child->isChild());
+    child->setProperty("InputWorkspace1", input);
+    child->setProperty("Number", 3.0);
+    TS_ASSERT(child->execute());
+    const Algorithm *first = child.get();
+    child.reset();
+
+    child = parent.reuseChildAlgorithm("StubbedWorkspaceAlgorithm");
+    TS_ASSERT_EQUALS(child.get(), first);
+    TS_ASSERT(!child->isExecuted());
+    TS_ASSERT_EQUALS(static_cast<double>(child->getProperty("Number")), 0.0);
+    Workspace_sptr resetInput = child->getProperty("InputWorkspace1");
+    TS_ASSERT(!resetInput);
+    child->setProperty("InputWorkspace1", input);
+    TS_ASSERT(child->execute());
+    MatrixWorkspace_sptr output = child->getProperty("OutputWorkspace1");
+    TS_ASSERT_EQUALS(output->y(0)[0], 0.0);
+
+    // Still held, so another request has to create a new instance
+    auto other = parent.reuseChildAlgorithm("StubbedWorkspaceAlgorithm");
+    TS_ASSERT_DIFFERS(other.get(), child.get());
+  }
+
+  void test_reuseChildAlgorithm_removes_properties_declared_after_init() {
+    StubbedWorkspaceAlgorithm parent;
+    parent.initialize();
+
+    auto child = parent.reuseChildAlgorithm("DynamicPropertyAlgorithm");
+    child->setProperty("AddExtra", true);
+    child->setProperty("Extra", 5);
+    TS_ASSERT(child->execute());
+    TS_ASSERT_EQUALS(child->propertyCount(), 2);
+    const Algorithm *first = child.get();
+    child.reset();
+
+    child = parent.reuseChildAlgorithm("DynamicPropertyAlgorithm");
+    TS_ASSERT_EQUALS(child.get(), first);
+    TS_ASSERT_EQUALS(child->propertyCount(), 1);
+    TS_ASSERT(!child->existsProperty("Extra"));
+    TS_ASSERT(!static_cast<bool>(child->getProperty("AddExtra")));
+    // Declared again, with its default
+    child->setProperty("AddExtra", true);
+    TS_ASSERT_EQUALS(static_cast<int>(child->getProperty("Extra")), 0);
+  }
+
   void test_processGroups_failures() {
     // Fails due to unequal sizes.
     do_test_groups("A", "A_1,A_2,A_3", "B", "B_1,B_2,B_3,B_4", "", "",
@@ -1023,4 +1098,44 @@ private:
   MatrixWorkspace_sptr ws3;
 };
 
+class AlgorithmTestPerformance : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static AlgorithmTestPerformance *createSuite() {
+    return new AlgorithmTestPerformance();
+  }
+  static void destroySuite(AlgorithmTestPerformance *suite) { delete suite; }
+
+  AlgorithmTestPerformance() : m_input(boost::make_shared<WorkspaceTester>()) {
+    m_input->initialize(1, 1, 1);
+    m_parent.initialize();
+  }
+
+  void test_createChildAlgorithm_many_times() {
+    for (size_t i = 0; i < NUM_CHILDREN; ++i) {
+      auto child = m_parent.createChildAlgorithm("StubbedWorkspaceAlgorithm");
+      runChild(*child);
+    }
+  }
+
+  void test_reuseChildAlgorithm_many_times() {
+    for (size_t i = 0; i < NUM_CHILDREN; ++i) {
+      auto child = m_parent.reuseChildAlgorithm("StubbedWorkspaceAlgorithm");
+      runChild(*child);
+    }
+  }
+
+private:
+  void runChild(IAlgorithm &child) {
+    child.setProperty("InputWorkspace1", m_input);
+    child.setProperty("Number", 1.0);
+    child.execute();
+  }
+
+  static constexpr size_t NUM_CHILDREN = 10000;
+  StubbedWorkspaceAlgorithm m_parent;
+  boost::shared_ptr<WorkspaceTester> m_input;
+};
+
 #endif /*ALGORITHMTEST_H_*/
@@ -11,13 +11,17 @@
 
 #include "MantidAPI/CompositeFunction.h"
 #include "MantidAPI/FrameworkManager.h"
+#include "MantidAPI/FunctionDomain1D.h"
 #include "MantidAPI/FunctionFactory.h"
+#include "MantidAPI/FunctionValues.h"
 #include "MantidAPI/IFunction1D.h"
 #include "MantidAPI/IPeakFunction.h"
 #include "MantidAPI/MatrixWorkspace.h"
 #include "MantidAPI/ParamFunction.h"
 #include "MantidTestHelpers/FakeObjects.h"
 
+#include <boost/make_shared.hpp>
+
 using namespace Mantid;
 using namespace Mantid::API;
 
@@ -133,6 +137,7 @@ public:
   double height() const override { return getParameter(1); }
 
   double fwhm() const override { return getParameter(2); }
+  bool usesPeakRadiusWindow() const override { return true; }
 
   void setCentre(const double c) override { setParameter(0, c); }
   void setHeight(const double h) override { setParameter(1, h); }
@@ -1239,6 +1244,56 @@ public:
     TS_ASSERT_EQUALS(fun->parameterLocalName(4, true), "a");
     TS_ASSERT_EQUALS(fun->parameterLocalName(6, true), "a");
   }
+
+  void test_peaks_are_only_evaluated_within_peak_radius() {
+    auto composite = boost::make_shared<CompositeFunction>();
+    auto peak1 = boost::make_shared<Gauss>();
+    peak1->setParameter("c", 2.0);
+    peak1->setParameter("h", 3.0);
+    peak1->setParameter("s", 0.5);
+    auto peak2 = boost::make_shared<Gauss>();
+    peak2->setParameter("c", 7.0);
+    peak2->setParameter("h", 1.0);
+    peak2->setParameter("s", 0.25);
+    auto background = boost::make_shared<Linear>();
+    background->setParameter("a", 0.1);
+    background->setParameter("b", 0.01);
+    composite->addFunction(peak1);
+    composite->addFunction(background);
+    composite->addFunction(peak2);
+
+    FunctionDomain1DVector domain(0.0, 10.0, 101);
+    domain.setPeakRadius(2);
+    FunctionValues values(domain);
+    composite->function(domain, values);
+
+    // each member evaluated on the whole domain with the same peak radius
+    FunctionValues expected(domain);
+    expected.zeroCalculated();
+    for (size_t i = 0; i < composite->nFunctions(); ++i) {
+      FunctionValues member(domain);
+      composite->getFunction(i)->function(domain, member);
+      expected += member;
+    }
+    for (size_t i = 0; i < domain.size(); ++i) {
+      TS_ASSERT_DELTA(values.getCalculated(i), expected.getCalculated(i),
+                      1e-12);
+    }
+    // outside both peak radii only the background is left
+    TS_ASSERT_DELTA(values.getCalculated(100), 0.2, 1e-12);
+  }
+
+  void test_peak_radius_window() {
+    Gauss peak;
+    peak.setParameter("c", 5.0);
+    peak.setParameter("s", 1.0);
+    FunctionDomain1DVector domain(0.0, 10.0, 11);
+    domain.setPeakRadius(2);
+    auto window = peak.getPeakRadiusWindow(domain);
+    // points strictly within 2 * fwhm of the centre: 4, 5 and 6
+    TS_ASSERT_EQUALS(window.first, 4);
+    TS_ASSERT_EQUALS(window.second, 7);
+  }
 };
 
 #endif /*COMPOSITEFUNCTIONTEST_H_*/
@@ -235,6 +235,45 @@ public:
 
     TS_ASSERT_EQUALS(hitCount, 16235)
   }
+
+  void test_findDetectorIndices_rectangular() {
+    doTestFindDetectorIndices(
+        ComponentCreationHelper::createTestInstrumentRectangular2(1, 100));
+  }
+
+  void test_findDetectorIndices_cylindrical() {
+    doTestFindDetectorIndices(
+        ComponentCreationHelper::createTestInstrumentCylindrical(
+            3, V3D(0, 0, -1), V3D(0, 0, 0), 1.6, 1.0));
+  }
+
+private:
+  void doTestFindDetectorIndices(const Instrument_sptr &inst) {
+    ExperimentInfo expInfo;
+    expInfo.setInstrument(inst);
+    const auto &info = expInfo.detectorInfo();
+    DetectorSearcher searcher(inst, info);
+
+    std::vector<V3D> qs{V3D(0, 0, 0)};
+    for (int x = -10; x <= 10; ++x)
+      for (int y = -10; y <= 10; ++y)
+        for (int z = 1; z <= 10; ++z)
+          qs.emplace_back(x * 0.1, y * 0.1, z * 0.1);
+
+    const auto results = searcher.findDetectorIndices(qs);
+
+    TS_ASSERT_EQUALS(results.size(), qs.size());
+    size_t hitCount = 0;
+    for (size_t i = 0; i < qs.size() && i < results.size(); ++i) {
+      const auto expected = searcher.findDetectorIndex(qs[i]);
+      TS_ASSERT_EQUALS(std::get<0>(results[i]), std::get<0>(expected));
+      if (std::get<0>(expected)) {
+        TS_ASSERT_EQUALS(std::get<1>(results[i]), std::get<1>(expected));
+        ++hitCount;
+      }
+    }
+    TS_ASSERT(hitCount > 0);
+  }
 };
 
 #endif
@@ -8,11 +8,14 @@
 #define MANTID_ALGORITHMS_DIFFRACTIONFOCUSSING2_H_
 
 #include "MantidAPI/Algorithm.h"
+#include "MantidAPI/Progress.h"
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidDataObjects/GroupingWorkspace.h"
 #include "MantidIndexing/SpectrumNumber.h"
 #include "MantidKernel/System.h"
 
+#include <set>
+
 namespace Mantid {
 namespace Algorithms {
 /**
@@ -83,12 +86,26 @@ public:
     return "Diffraction\\Focussing";
   }
 
+protected:
+  Parallel::ExecutionMode getParallelExecutionMode(
+      const std::map<std::string, Parallel::StorageMode> &storageModes)
+      const override;
+
 private:
   // Overridden Algorithm methods
   void init() override;
   void exec() override;
   void cleanup();
 
+  void sumGroup(const std::vector<size_t> &indices,
+                const HistogramData::BinEdges &Xout, MantidVec &Yout,
+                MantidVec &Eout, MantidVec &groupWgt,
+                std::set<detid_t> &detectorIDs, const double eventXMin,
+                const double eventXMax, API::Progress &prog) const;
+  API::MatrixWorkspace_sptr focusDistributed(const double eventXMin,
+                                             const double eventXMax,
+                                             API::Progress &prog);
+
   std::size_t setupGroupToWSIndices();
 
   // For events
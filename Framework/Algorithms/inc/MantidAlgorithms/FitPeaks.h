@@ -60,6 +60,36 @@ private:
   /// fitted peak and background parameters' fitting error
   std::vector<std::vector<double>> m_function_errors_vector;
 };
+
+/// Fitting resources owned by one thread and reused for every spectrum that
+/// the thread fits, together with the converged peak parameters of the last
+/// spectrum it fitted, which can seed the fit of the neighbouring spectrum
+struct FitWorker {
+  /// child Fit algorithm for single domain peak + background fitting
+  API::IAlgorithm_sptr fitter;
+  API::IPeakFunction_sptr peakfunction;
+  API::IBackgroundFunction_sptr bkgdfunction;
+  /// whether this worker has started fitting any spectrum yet
+  bool hasLastWorkspaceIndex{false};
+  /// workspace index of the last spectrum fitted by this worker
+  size_t lastWorkspaceIndex{0};
+  /// converged peak parameters of the last spectrum; empty for a bad fit
+  std::vector<std::vector<double>> lastPeakParameters;
+
+  /// Start fitting a spectrum. Returns the converged parameters of each peak
+  /// of the previous spectrum if this worker fitted the spectrum immediately
+  /// before wi, otherwise an empty vector for every peak.
+  std::vector<std::vector<double>> startSpectrum(size_t wi, size_t numPeaks) {
+    std::vector<std::vector<double>> neighbourPeakParameters;
+    if (hasLastWorkspaceIndex && lastWorkspaceIndex + 1 == wi)
+      neighbourPeakParameters.swap(lastPeakParameters);
+    neighbourPeakParameters.resize(numPeaks);
+    lastPeakParameters.assign(numPeaks, std::vector<double>());
+    lastWorkspaceIndex = wi;
+    hasLastWorkspaceIndex = true;
+    return neighbourPeakParameters;
+  }
+};
 } // namespace FitPeaksAlgorithm
 
 class DLLExport FitPeaks : public API::Algorithm {
@@ -123,7 +153,11 @@ private:
   /// fit peaks in a same spectrum
   void fitSpectrumPeaks(
       size_t wi, const std::vector<double> &expected_peak_centers,
-      boost::shared_ptr<FitPeaksAlgorithm::PeakFitResult> fit_result);
+      boost::shared_ptr<FitPeaksAlgorithm::PeakFitResult> fit_result,
+      FitPeaksAlgorithm::FitWorker &worker);
+
+  /// set up the reusable fitting resources of a worker thread
+  void initializeFitWorker(FitPeaksAlgorithm::FitWorker &worker);
 
   /// fit background
   bool fitBackground(const size_t &ws_index,
@@ -280,6 +314,8 @@ private:
   bool m_fitPeaksFromRight;
   /// Fit iterations
   int m_fitIterations;
+  /// Flag to seed peak parameters from the neighbouring spectrum's fit
+  bool m_seedFromNeighbours;
 
   //-------- Input param init values --------------------------------
   /// input starting parameters' indexes in peak function
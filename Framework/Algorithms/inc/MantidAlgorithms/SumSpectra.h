@@ -9,6 +9,8 @@
 
 #include "MantidAPI/ParallelAlgorithm.h"
 #include "MantidGeometry/IDTypes.h"
+#include "MantidHistogramData/HistogramE.h"
+#include "MantidHistogramData/HistogramY.h"
 #include <set>
 
 namespace Mantid {
@@ -58,6 +60,11 @@ public:
   /// Cross-input validation
   std::map<std::string, std::string> validateInputs() override;
 
+protected:
+  Parallel::ExecutionMode getParallelExecutionMode(
+      const std::map<std::string, Parallel::StorageMode> &storageModes)
+      const override;
+
 private:
   /// Handle logic for RebinnedOutput workspaces
   void doFractionalSum(API::MatrixWorkspace_sptr outputWorkspace,
@@ -67,10 +74,18 @@ private:
   void doSimpleSum(API::MatrixWorkspace_sptr outputWorkspace,
                    API::Progress &progress, size_t &numSpectra,
                    size_t &numMasked, size_t &numZeros);
+  /// Accumulate the selected spectra of a histogram workspace
+  void sumHistograms(const API::MatrixWorkspace &workspace,
+                     HistogramData::HistogramY &YSum,
+                     HistogramData::HistogramE &YErrorSum,
+                     std::vector<double> &weight, std::vector<size_t> &nZeros,
+                     std::set<detid_t> &detectorIDs, API::Progress &progress,
+                     size_t &numSpectra, size_t &numMasked);
 
   // Overridden Algorithm methods
   void init() override;
   void exec() override;
+  void execDistributed() override;
   void execEvent(API::MatrixWorkspace_sptr outputWorkspace,
                  API::Progress &progress, size_t &numSpectra, size_t &numMasked,
                  size_t &numZeros);
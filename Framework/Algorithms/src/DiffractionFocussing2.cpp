@@ -7,6 +7,7 @@
 #include "MantidAlgorithms/DiffractionFocussing2.h"
 #include "MantidAPI/Axis.h"
 #include "MantidAPI/FileProperty.h"
+#include "MantidAPI/HistoWorkspace.h"
 #include "MantidAPI/ISpectrum.h"
 #include "MantidAPI/MatrixWorkspace.h"
 #include "MantidAPI/RawCountValidator.h"
@@ -20,9 +21,15 @@
 #include "MantidIndexing/Group.h"
 #include "MantidIndexing/IndexInfo.h"
 #include "MantidKernel/VectorHelper.h"
+#include "MantidParallel/Collectives.h"
+#include "MantidParallel/Communicator.h"
+
+#include <boost/serialization/vector.hpp>
 
 #include <cfloat>
+#include <cmath>
 #include <iterator>
+#include <limits>
 #include <numeric>
 
 using namespace Mantid::Kernel;
@@ -38,6 +45,122 @@ namespace Algorithms {
 // Register the class into the algorithm factory
 DECLARE_ALGORITHM(DiffractionFocussing2)
 
+namespace {
+/// Map from group number to the range <Xmin,Xmax> of its spectra
+using group2minmaxmap = std::map<int, std::pair<double, double>>;
+
+/// Widen the X range of each group to cover its spectra on all ranks
+void combineGroupRanges(const Parallel::Communicator &comm,
+                        group2minmaxmap &group2minmax) {
+  std::vector<int> groups;
+  std::vector<double> mins;
+  std::vector<double> maxs;
+  for (const auto &item : group2minmax) {
+    groups.push_back(item.first);
+    mins.push_back(item.second.first);
+    maxs.push_back(item.second.second);
+  }
+  std::vector<std::vector<int>> allGroups;
+  std::vector<std::vector<double>> allMins;
+  std::vector<std::vector<double>> allMaxs;
+  Parallel::all_gather(comm, groups, allGroups);
+  Parallel::all_gather(comm, mins, allMins);
+  Parallel::all_gather(comm, maxs, allMaxs);
+  for (size_t rank = 0; rank < allGroups.size(); ++rank) {
+    for (size_t i = 0; i < allGroups[rank].size(); ++i) {
+      auto &range = group2minmax
+                        .emplace(allGroups[rank][i],
+                                 std::make_pair(allMins[rank][i],
+                                                allMaxs[rank][i]))
+                        .first->second;
+      range.first = std::min(range.first, allMins[rank][i]);
+      range.second = std::max(range.second, allMaxs[rank][i]);
+    }
+  }
+}
+
+/** Agree the number of points of the input across ranks. Ranks without
+ * spectra pass 0 and take the value of the other ranks, ranks with histograms
+ * of unequal size pass -1. Every rank throws if the ranks do not agree, so no
+ * rank is left waiting in a later collective.
+ */
+int agreeNumberOfPoints(const Parallel::Communicator &comm,
+                        const int localPoints) {
+  std::vector<int> allPoints;
+  Parallel::all_gather(comm, localPoints, allPoints);
+  int points = 0;
+  for (const auto rankPoints : allPoints) {
+    if (rankPoints == 0)
+      continue;
+    if (rankPoints < 0 || (points > 0 && rankPoints != points))
+      throw std::length_error(
+          "blocksize undefined because size of histograms is not equal");
+    points = rankPoints;
+  }
+  return points;
+}
+
+/** The X range of all spectra on all ranks. Like MatrixWorkspace::getXMinMax,
+ * but the extrema are always gathered, also on a rank that holds every
+ * spectrum or none of them.
+ */
+void globalXMinMax(const Parallel::Communicator &comm,
+                   const MatrixWorkspace &ws, double &xmin, double &xmax) {
+  xmin = std::numeric_limits<double>::max();
+  xmax = -1.0 * xmin;
+  for (size_t i = 0; i < ws.getNumberHistograms(); ++i) {
+    const auto &dataX = ws.x(i);
+    const double xfront = dataX.front();
+    const double xback = dataX.back();
+    if (std::isfinite(xfront) && std::isfinite(xback)) {
+      xmin = std::min(xmin, xfront);
+      xmax = std::max(xmax, xback);
+    }
+  }
+  std::vector<double> extrema;
+  Parallel::all_gather(comm, xmin, extrema);
+  xmin = *std::min_element(extrema.begin(), extrema.end());
+  Parallel::all_gather(comm, xmax, extrema);
+  xmax = *std::max_element(extrema.begin(), extrema.end());
+}
+
+/** Turn the sum of the spectra of a group into counts. The rebinning adds up
+ * the spectra as distributions with squared errors, and groupWgt holds how
+ * much of each output bin the spectra cover.
+ */
+void normaliseGroup(const BinEdges &Xout, MantidVec &Yout, MantidVec &Eout,
+                    const MantidVec &groupWgt, const size_t groupSize) {
+  // Calculate the bin widths
+  std::vector<double> widths(Xout.size());
+  std::adjacent_difference(Xout.begin(), Xout.end(), widths.begin());
+
+  // Take the square root of the errors
+  std::transform(Eout.begin(), Eout.end(), Eout.begin(),
+                 static_cast<double (*)(double)>(sqrt));
+
+  // Multiply the data and errors by the bin widths because the rebin
+  // function, when used
+  // in the fashion above for the weights, doesn't put it back in
+  std::transform(Yout.begin(), Yout.end(), widths.begin() + 1, Yout.begin(),
+                 std::multiplies<double>());
+  std::transform(Eout.begin(), Eout.end(), widths.begin() + 1, Eout.begin(),
+                 std::multiplies<double>());
+
+  // Now need to normalise the data (and errors) by the weights
+  std::transform(Yout.begin(), Yout.end(), groupWgt.begin(), Yout.begin(),
+                 std::divides<double>());
+  std::transform(Eout.begin(), Eout.end(), groupWgt.begin(), Eout.begin(),
+                 std::divides<double>());
+  // Now multiply by the number of spectra in the group
+  std::for_each(Yout.begin(), Yout.end(), [groupSize](double &val) {
+    val *= static_cast<double>(groupSize);
+  });
+  std::for_each(Eout.begin(), Eout.end(), [groupSize](double &val) {
+    val *= static_cast<double>(groupSize);
+  });
+}
+} // namespace
+
 /** Initialisation method. Declares properties to be used in algorithm.
  *
  */
@@ -67,6 +190,20 @@ void DiffractionFocussing2::init() {
                   "Workspace2D histogram.");
 }
 
+/** The input workspace may be distributed, cloned or master-only. A grouping
+ * workspace covers the whole instrument and must be cloned or have the same
+ * storage mode as the input. */
+Parallel::ExecutionMode DiffractionFocussing2::getParallelExecutionMode(
+    const std::map<std::string, Parallel::StorageMode> &storageModes) const {
+  const auto inputMode = storageModes.at("InputWorkspace");
+  const auto grouping = storageModes.find("GroupingWorkspace");
+  if (grouping != storageModes.end() &&
+      grouping->second != Parallel::StorageMode::Cloned &&
+      grouping->second != inputMode)
+    return Parallel::ExecutionMode::Invalid;
+  return Parallel::getCorrespondingExecutionMode(inputMode);
+}
+
 //=============================================================================
 /** Perform clean-up of memory after execution but before destructor.
  * Private method
@@ -104,8 +241,34 @@ void DiffractionFocussing2::exec() {
 
   // Get the input workspace
   m_matrixInputW = getProperty("InputWorkspace");
-  nPoints = static_cast<int>(m_matrixInputW->blocksize());
+  if (m_matrixInputW->storageMode() == Parallel::StorageMode::Distributed) {
+    if (!groupWS)
+      throw std::invalid_argument("A GroupingWorkspace is required to focus a "
+                                  "distributed workspace.");
+    const bool preserveEvents = getProperty("PreserveEvents");
+    if (preserveEvents &&
+        boost::dynamic_pointer_cast<const EventWorkspace>(m_matrixInputW))
+      throw std::invalid_argument("PreserveEvents is not supported when "
+                                  "focussing a distributed workspace.");
+  }
   nHist = static_cast<int>(m_matrixInputW->getNumberHistograms());
+  if (m_matrixInputW->storageMode() == Parallel::StorageMode::Distributed) {
+    // A rank may own no spectra. The number of points and the check below
+    // must agree on all ranks before the collectives in the focussing.
+    int localPoints = 0;
+    if (nHist > 0) {
+      try {
+        localPoints = static_cast<int>(m_matrixInputW->blocksize());
+      } catch (std::length_error &) {
+        localPoints = -1;
+      }
+    }
+    nPoints = agreeNumberOfPoints(communicator(), localPoints);
+    if (nPoints <= 0)
+      throw std::runtime_error("No points found in the data range.");
+  } else {
+    nPoints = static_cast<int>(m_matrixInputW->blocksize());
+  }
 
   // Validate UnitID (spacing)
   Axis *axis = m_matrixInputW->getAxis(0);
@@ -155,7 +318,10 @@ void DiffractionFocussing2::exec() {
     } else {
       // get the full d-spacing range
       m_eventW->sortAll(DataObjects::TOF_SORT, nullptr);
-      m_matrixInputW->getXMinMax(eventXMin, eventXMax);
+      if (m_matrixInputW->storageMode() == Parallel::StorageMode::Distributed)
+        globalXMinMax(communicator(), *m_matrixInputW, eventXMin, eventXMax);
+      else
+        m_matrixInputW->getXMinMax(eventXMin, eventXMax);
     }
   }
 
@@ -169,15 +335,17 @@ void DiffractionFocussing2::exec() {
   if (nPoints <= 0) {
     throw std::runtime_error("No points found in the data range.");
   }
+  Progress prog(this, 0.2, 1.0, static_cast<int>(totalHistProcess) + nGroups);
+
+  if (m_matrixInputW->storageMode() == Parallel::StorageMode::Distributed) {
+    setProperty("OutputWorkspace",
+                focusDistributed(eventXMin, eventXMax, prog));
+    this->cleanup();
+    return;
+  }
+
   API::MatrixWorkspace_sptr out = API::WorkspaceFactory::Instance().create(
       m_matrixInputW, m_validGroups.size(), nPoints + 1, nPoints);
-  // Caching containers that are either only read from or unused. Initialize
-  // them once.
-  // Helgrind will show a race-condition but the data is completely unused so it
-  // is irrelevant
-  MantidVec weights_default(1, 1.0), emptyVec(1, 0.0), EOutDummy(nPoints);
-
-  Progress prog(this, 0.2, 1.0, static_cast<int>(totalHistProcess) + nGroups);
 
   PARALLEL_FOR_IF(Kernel::threadSafe(*m_matrixInputW, *out))
   for (int outWorkspaceIndex = 0;
@@ -202,130 +370,228 @@ void DiffractionFocussing2::exec() {
     auto &Yout = outSpec.dataY();
     auto &Eout = outSpec.dataE();
 
-    // Initialize the group's weight vector here and the dummy vector used for
-    // accumulating errors.
+    // Initialize the group's weight vector here
     MantidVec groupWgt(nPoints, 0.0);
 
     // loop through the contributing histograms
     const std::vector<size_t> &indices = m_wsIndices[outWorkspaceIndex];
-    const size_t groupSize = indices.size();
-    for (size_t i = 0; i < groupSize; i++) {
-      size_t inWorkspaceIndex = indices[i];
-      // This is the input spectrum
-      const auto &inSpec = m_matrixInputW->getSpectrum(inWorkspaceIndex);
-      // Get reference to its old X,Y,and E.
-      auto &Xin = inSpec.x();
-      auto &Yin = inSpec.y();
-      auto &Ein = inSpec.e();
-      outSpec.addDetectorIDs(inSpec.getDetectorIDs());
+    std::set<detid_t> detectorIDs;
+    sumGroup(indices, Xout, Yout, Eout, groupWgt, detectorIDs, eventXMin,
+             eventXMax, prog);
+    outSpec.addDetectorIDs(detectorIDs);
+    normaliseGroup(Xout, Yout, Eout, groupWgt, indices.size());
 
-      try {
-        // TODO This should be implemented in Histogram as rebin
-        Mantid::Kernel::VectorHelper::rebinHistogram(
-            Xin.rawData(), Yin.rawData(), Ein.rawData(), Xout.rawData(), Yout,
-            Eout, true);
-      } catch (...) {
-        // Should never happen because Xout is constructed to envelop all of the
-        // Xin vectors
-        std::ostringstream mess;
-        mess << "Error in rebinning process for spectrum:" << inWorkspaceIndex;
-        throw std::runtime_error(mess.str());
-      }
+    prog.report();
+    PARALLEL_END_INTERUPT_REGION
+  } // end of loop for groups
+  PARALLEL_CHECK_INTERUPT_REGION
 
-      // Check for masked bins in this spectrum
-      if (m_matrixInputW->hasMaskedBins(i)) {
-        MantidVec weight_bins, weights;
-        weight_bins.push_back(Xin.front());
-        // If there are masked bins, get a reference to the list of them
-        const API::MatrixWorkspace::MaskList &mask =
-            m_matrixInputW->maskedBins(i);
-        // Now iterate over the list, adjusting the weights for the affected
-        // bins
-        for (const auto &bin : mask) {
-          const double currentX = Xin[bin.first];
-          // Add an intermediate bin with full weight if masked bins aren't
-          // consecutive
-          if (weight_bins.back() != currentX) {
-            weights.push_back(1.0);
-            weight_bins.push_back(currentX);
-          }
-          // The weight for this masked bin is 1 - the degree to which this bin
-          // is masked
-          weights.push_back(1.0 - bin.second);
-          weight_bins.push_back(Xin[bin.first + 1]);
-        }
-        // Add on a final bin with full weight if masking doesn't go up to the
-        // end
-        if (weight_bins.back() != Xin.back()) {
-          weights.push_back(1.0);
-          weight_bins.push_back(Xin.back());
-        }
+  setProperty("OutputWorkspace", out);
+
+  this->cleanup();
+}
 
-        // Create a zero vector for the errors because we don't care about them
-        // here
-        const MantidVec zeroes(weights.size(), 0.0);
-        // Rebin the weights - note that this is a distribution
-        VectorHelper::rebin(weight_bins, weights, zeroes, Xout.rawData(),
-                            groupWgt, EOutDummy, true, true);
-      } else // If no masked bins we want to add 1 to the weight of the output
-             // bins that this input covers
-      {
-        // Initialized within the loop to avoid having to wrap writing to it
-        // with a PARALLEL_CRITICAL sections
-        MantidVec limits(2);
-
-        if (eventXMin > 0. && eventXMax > 0.) {
-          limits[0] = eventXMin;
-          limits[1] = eventXMax;
-        } else {
-          limits[0] = Xin.front();
-          limits[1] = Xin.back();
+/** Rebin the spectra of a group onto the bin edges of the group and add them
+ * up. Yout and Eout accumulate a distribution and squared errors, groupWgt how
+ * much of each output bin the spectra cover; see normaliseGroup().
+ *
+ * @param indices :: the input workspace indices of the spectra in the group
+ * @param Xout :: the bin edges of the group
+ * @param Yout :: the summed data
+ * @param Eout :: the summed squared errors
+ * @param groupWgt :: the summed weights
+ * @param detectorIDs :: collects the detector IDs of the spectra
+ * @param eventXMin :: minimum X of all events, if the input has events
+ * @param eventXMax :: maximum X of all events, if the input has events
+ * @param prog :: reports one step per spectrum
+ */
+void DiffractionFocussing2::sumGroup(const std::vector<size_t> &indices,
+                                     const BinEdges &Xout, MantidVec &Yout,
+                                     MantidVec &Eout, MantidVec &groupWgt,
+                                     std::set<detid_t> &detectorIDs,
+                                     const double eventXMin,
+                                     const double eventXMax,
+                                     Progress &prog) const {
+  const MantidVec weights_default(1, 1.0), emptyVec(1, 0.0);
+  MantidVec EOutDummy(nPoints);
+  const size_t groupSize = indices.size();
+  for (size_t i = 0; i < groupSize; i++) {
+    size_t inWorkspaceIndex = indices[i];
+    // This is the input spectrum
+    const auto &inSpec = m_matrixInputW->getSpectrum(inWorkspaceIndex);
+    // Get reference to its old X,Y,and E.
+    auto &Xin = inSpec.x();
+    auto &Yin = inSpec.y();
+    auto &Ein = inSpec.e();
+    const auto &ids = inSpec.getDetectorIDs();
+    detectorIDs.insert(ids.begin(), ids.end());
+
+    try {
+      // TODO This should be implemented in Histogram as rebin
+      Mantid::Kernel::VectorHelper::rebinHistogram(
+          Xin.rawData(), Yin.rawData(), Ein.rawData(), Xout.rawData(), Yout,
+          Eout, true);
+    } catch (...) {
+      // Should never happen because Xout is constructed to envelop all of the
+      // Xin vectors
+      std::ostringstream mess;
+      mess << "Error in rebinning process for spectrum:" << inWorkspaceIndex;
+      throw std::runtime_error(mess.str());
+    }
+
+    // Check for masked bins in this spectrum
+    if (m_matrixInputW->hasMaskedBins(i)) {
+      MantidVec weight_bins, weights;
+      weight_bins.push_back(Xin.front());
+      // If there are masked bins, get a reference to the list of them
+      const API::MatrixWorkspace::MaskList &mask =
+          m_matrixInputW->maskedBins(i);
+      // Now iterate over the list, adjusting the weights for the affected
+      // bins
+      for (const auto &bin : mask) {
+        const double currentX = Xin[bin.first];
+        // Add an intermediate bin with full weight if masked bins aren't
+        // consecutive
+        if (weight_bins.back() != currentX) {
+          weights.push_back(1.0);
+          weight_bins.push_back(currentX);
         }
+        // The weight for this masked bin is 1 - the degree to which this bin
+        // is masked
+        weights.push_back(1.0 - bin.second);
+        weight_bins.push_back(Xin[bin.first + 1]);
+      }
+      // Add on a final bin with full weight if masking doesn't go up to the
+      // end
+      if (weight_bins.back() != Xin.back()) {
+        weights.push_back(1.0);
+        weight_bins.push_back(Xin.back());
+      }
 
-        // Rebin the weights - note that this is a distribution
-        VectorHelper::rebin(limits, weights_default, emptyVec, Xout.rawData(),
-                            groupWgt, EOutDummy, true, true);
+      // Create a zero vector for the errors because we don't care about them
+      // here
+      const MantidVec zeroes(weights.size(), 0.0);
+      // Rebin the weights - note that this is a distribution
+      VectorHelper::rebin(weight_bins, weights, zeroes, Xout.rawData(),
+                          groupWgt, EOutDummy, true, true);
+    } else // If no masked bins we want to add 1 to the weight of the output
+           // bins that this input covers
+    {
+      MantidVec limits(2);
+
+      if (eventXMin > 0. && eventXMax > 0.) {
+        limits[0] = eventXMin;
+        limits[1] = eventXMax;
+      } else {
+        limits[0] = Xin.front();
+        limits[1] = Xin.back();
       }
-      prog.report();
-    } // end of loop for input spectra
-
-    // Calculate the bin widths
-    std::vector<double> widths(Xout.size());
-    std::adjacent_difference(Xout.begin(), Xout.end(), widths.begin());
-
-    // Take the square root of the errors
-    std::transform(Eout.begin(), Eout.end(), Eout.begin(),
-                   static_cast<double (*)(double)>(sqrt));
-
-    // Multiply the data and errors by the bin widths because the rebin
-    // function, when used
-    // in the fashion above for the weights, doesn't put it back in
-    std::transform(Yout.begin(), Yout.end(), widths.begin() + 1, Yout.begin(),
-                   std::multiplies<double>());
-    std::transform(Eout.begin(), Eout.end(), widths.begin() + 1, Eout.begin(),
-                   std::multiplies<double>());
-
-    // Now need to normalise the data (and errors) by the weights
-    std::transform(Yout.begin(), Yout.end(), groupWgt.begin(), Yout.begin(),
-                   std::divides<double>());
-    std::transform(Eout.begin(), Eout.end(), groupWgt.begin(), Eout.begin(),
-                   std::divides<double>());
-    // Now multiply by the number of spectra in the group
-    std::for_each(Yout.begin(), Yout.end(), [groupSize](double &val) {
-      val *= static_cast<double>(groupSize);
-    });
-    std::for_each(Eout.begin(), Eout.end(), [groupSize](double &val) {
-      val *= static_cast<double>(groupSize);
-    });
 
+      // Rebin the weights - note that this is a distribution
+      VectorHelper::rebin(limits, weights_default, emptyVec, Xout.rawData(),
+                          groupWgt, EOutDummy, true, true);
+    }
     prog.report();
+  } // end of loop for input spectra
+}
+
+/** Focus a distributed workspace. Every rank sums the spectra it holds for
+ * each group. The partial sums of a group are then sent to the rank that holds
+ * the group in the distributed output workspace, which adds them up and
+ * normalises them. The output is partitioned round-robin by group.
+ *
+ * @param eventXMin :: minimum X of all events, if the input has events
+ * @param eventXMax :: maximum X of all events, if the input has events
+ * @param prog :: progress reporting
+ * @return the focussed workspace
+ */
+MatrixWorkspace_sptr
+DiffractionFocussing2::focusDistributed(const double eventXMin,
+                                        const double eventXMax,
+                                        Progress &prog) {
+  const auto &comm = communicator();
+  const auto nRanks = static_cast<size_t>(comm.size());
+  const auto nValid = m_validGroups.size();
+
+  // Sum this rank's spectra of every group, with threads over the groups
+  std::vector<MantidVec> partialY(nValid, MantidVec(nPoints, 0.0));
+  std::vector<MantidVec> partialE(nValid, MantidVec(nPoints, 0.0));
+  std::vector<MantidVec> partialWgt(nValid, MantidVec(nPoints, 0.0));
+  std::vector<std::set<detid_t>> partialIDs(nValid);
+  PARALLEL_FOR_IF(Kernel::threadSafe(*m_matrixInputW))
+  for (int iGroup = 0; iGroup < static_cast<int>(nValid); ++iGroup) {
+    PARALLEL_START_INTERUPT_REGION
+    const auto &Xout =
+        group2xvector.at(static_cast<int>(m_validGroups[iGroup]));
+    sumGroup(m_wsIndices[iGroup], Xout, partialY[iGroup], partialE[iGroup],
+             partialWgt[iGroup], partialIDs[iGroup], eventXMin, eventXMax,
+             prog);
     PARALLEL_END_INTERUPT_REGION
-  } // end of loop for groups
+  }
   PARALLEL_CHECK_INTERUPT_REGION
 
-  setProperty("OutputWorkspace", out);
+  // Pack the partial sums for the rank owning each group: Y, squared E and
+  // weights of the groups in order, the number of spectra and detector IDs of
+  // each group, and the detector IDs themselves
+  std::vector<std::vector<double>> sendData(nRanks);
+  std::vector<std::vector<size_t>> sendSizes(nRanks);
+  std::vector<std::vector<detid_t>> sendIDs(nRanks);
+  for (size_t iGroup = 0; iGroup < nValid; ++iGroup) {
+    const auto rank = iGroup % nRanks;
+    auto &data = sendData[rank];
+    data.insert(data.end(), partialY[iGroup].begin(), partialY[iGroup].end());
+    data.insert(data.end(), partialE[iGroup].begin(), partialE[iGroup].end());
+    data.insert(data.end(), partialWgt[iGroup].begin(),
+                partialWgt[iGroup].end());
+    sendSizes[rank].push_back(m_wsIndices[iGroup].size());
+    sendSizes[rank].push_back(partialIDs[iGroup].size());
+    sendIDs[rank].insert(sendIDs[rank].end(), partialIDs[iGroup].begin(),
+                         partialIDs[iGroup].end());
+  }
+  std::vector<std::vector<double>> recvData;
+  std::vector<std::vector<size_t>> recvSizes;
+  std::vector<std::vector<detid_t>> recvIDs;
+  Parallel::all_to_all(comm, sendData, recvData);
+  Parallel::all_to_all(comm, sendSizes, recvSizes);
+  Parallel::all_to_all(comm, sendIDs, recvIDs);
+
+  Indexing::IndexInfo indexInfo(m_validGroups,
+                                Parallel::StorageMode::Distributed, comm);
+  auto out = create<HistoWorkspace>(*m_matrixInputW, indexInfo,
+                                    BinEdges(nPoints + 1));
+  const auto n = static_cast<size_t>(nPoints);
+  std::vector<size_t> idOffsets(nRanks, 0);
+  for (size_t i = 0; i < out->getNumberHistograms(); ++i) {
+    const auto iGroup = static_cast<size_t>(comm.rank()) + i * nRanks;
+    const auto &Xout =
+        group2xvector.at(static_cast<int>(m_validGroups[iGroup]));
+    MantidVec Yout(n, 0.0), Eout(n, 0.0), groupWgt(n, 0.0);
+    size_t groupSize = 0;
+    std::set<detid_t> detectorIDs;
+    for (size_t rank = 0; rank < nRanks; ++rank) {
+      const auto data = recvData[rank].begin() + 3 * n * i;
+      std::transform(Yout.begin(), Yout.end(), data, Yout.begin(),
+                     std::plus<double>());
+      std::transform(Eout.begin(), Eout.end(), data + n, Eout.begin(),
+                     std::plus<double>());
+      std::transform(groupWgt.begin(), groupWgt.end(), data + 2 * n,
+                     groupWgt.begin(), std::plus<double>());
+      groupSize += recvSizes[rank][2 * i];
+      const auto nIDs = recvSizes[rank][2 * i + 1];
+      const auto ids = recvIDs[rank].begin() + idOffsets[rank];
+      detectorIDs.insert(ids, ids + nIDs);
+      idOffsets[rank] += nIDs;
+    }
+    normaliseGroup(Xout, Yout, Eout, groupWgt, groupSize);
 
-  this->cleanup();
+    out->setBinEdges(i, Xout);
+    auto &outSpec = out->getSpectrum(i);
+    outSpec.dataY() = std::move(Yout);
+    outSpec.dataE() = std::move(Eout);
+    outSpec.addDetectorIDs(detectorIDs);
+    prog.report();
+  }
+  return std::move(out);
 }
 
 //=============================================================================
@@ -537,8 +803,6 @@ int DiffractionFocussing2::validateSpectrumInGroup(size_t wi) {
 void DiffractionFocussing2::determineRebinParameters() {
   std::ostringstream mess;
 
-  // typedef for the storage of the group ranges
-  using group2minmaxmap = std::map<int, std::pair<double, double>>;
   // Map from group number to its associated range parameters <Xmin,Xmax,step>
   group2minmaxmap group2minmax;
   group2minmaxmap::iterator gpit;
@@ -587,6 +851,10 @@ void DiffractionFocussing2::determineRebinParameters() {
       (gpit->second).second = temp;
   }
 
+  // A group may have spectra on several ranks
+  if (m_matrixInputW->storageMode() == Parallel::StorageMode::Distributed)
+    combineGroupRanges(communicator(), group2minmax);
+
   nGroups = group2minmax.size(); // Number of unique groups
 
   double Xmin, Xmax, step;
@@ -655,6 +923,12 @@ size_t DiffractionFocussing2::setupGroupToWSIndices() {
     wsIndices[group].push_back(wi);
   }
 
+  // Groups may have no spectra on this rank if the input is distributed
+  if (!group2xvector.empty())
+    wsIndices.resize(std::max(
+        wsIndices.size(),
+        static_cast<size_t>(group2xvector.rbegin()->first) + 1));
+
   // initialize a vector of the valid group numbers
   size_t totalHistProcess = 0;
   for (const auto &item : group2xvector) {
@@ -199,7 +199,8 @@ enum PeakFitResult { NOSIGNAL, LOWPEAK, OUTOFBOUND, GOOD };
 
 //----------------------------------------------------------------------------------------------
 FitPeaks::FitPeaks()
-    : m_fitPeaksFromRight(true), m_fitIterations(50), m_numPeaksToFit(0),
+    : m_fitPeaksFromRight(true), m_fitIterations(50),
+      m_seedFromNeighbours(false), m_numPeaksToFit(0),
       m_minPeakHeight(20.), m_bkgdSimga(1.), m_peakPosTolCase234(false) {}
 
 //----------------------------------------------------------------------------------------------
@@ -327,9 +328,17 @@ void FitPeaks::init() {
   declareProperty("MaxFitIterations", 50, min_max_iter,
                   "Maximum number of function fitting iterations.");
 
+  declareProperty("SeedFromNeighbours", false,
+                  "If true, the starting parameters of each peak are taken "
+                  "from the converged fit of the same peak in the previous "
+                  "spectrum, which is usually a neighbouring pixel.  This "
+                  "reduces the number of iterations needed to fit "
+                  "instruments with many similar spectra.");
+
   std::string optimizergrp("Optimization Setup");
   setPropertyGroup("Minimizer", optimizergrp);
   setPropertyGroup("CostFunction", optimizergrp);
+  setPropertyGroup("SeedFromNeighbours", optimizergrp);
 
   // other helping information
   declareProperty(
@@ -532,6 +541,7 @@ void FitPeaks::processInputs() {
   m_fitPeaksFromRight = getProperty("FitFromRight");
   m_constrainPeaksPosition = getProperty("ConstrainPeakPositions");
   m_fitIterations = getProperty("MaxFitIterations");
+  m_seedFromNeighbours = getProperty("SeedFromNeighbours");
 
   // Peak centers, tolerance and fitting range
   processInputPeakCenters();
@@ -911,8 +921,16 @@ FitPeaks::fitPeaks() {
   std::vector<boost::shared_ptr<FitPeaksAlgorithm::PeakFitResult>>
       fit_result_vector(num_fit_result);
 
+  // fitting resources are created once per thread and reused for all of the
+  // spectra fitted by that thread
+  std::vector<FitPeaksAlgorithm::FitWorker> workers(PARALLEL_GET_MAX_THREADS);
+
+  // neighbouring spectra can only seed each other if they are fitted in
+  // sequence by the same thread, so hand out blocks of spectra in that case
+  const int chunk_size = m_seedFromNeighbours ? 16 : 1;
+
   // cppcheck-suppress syntaxError
-  PRAGMA_OMP(parallel for schedule(dynamic, 1) )
+  PRAGMA_OMP(parallel for schedule(dynamic, chunk_size) )
   for (int wi = static_cast<int>(m_startWorkspaceIndex);
        wi <= static_cast<int>(m_stopWorkspaceIndex); ++wi) {
 
@@ -929,8 +947,11 @@ FitPeaks::fitPeaks() {
         boost::make_shared<FitPeaksAlgorithm::PeakFitResult>(m_numPeaksToFit,
                                                              numfuncparams);
 
+    auto &worker = workers[PARALLEL_THREAD_NUMBER];
+    if (!worker.fitter)
+      initializeFitWorker(worker);
     fitSpectrumPeaks(static_cast<size_t>(wi), expected_peak_centers,
-                     fit_result);
+                     fit_result, worker);
 
     PARALLEL_CRITICAL(FindPeaks_WriteOutput) {
       writeFitResult(static_cast<size_t>(wi), expected_peak_centers,
@@ -994,21 +1015,14 @@ double numberCounts(const Histogram &histogram, const double xmin,
 } // namespace
 
 //----------------------------------------------------------------------------------------------
-/** Fit peaks across one single spectrum
+/** Create the child Fit algorithm and the peak and background functions that a
+ * worker thread reuses for all of the spectra it fits
+ * @param worker :: (output) FitWorker to initialize
  */
-void FitPeaks::fitSpectrumPeaks(
-    size_t wi, const std::vector<double> &expected_peak_centers,
-    boost::shared_ptr<FitPeaksAlgorithm::PeakFitResult> fit_result) {
-  if (numberCounts(m_inputMatrixWS->histogram(wi)) <= m_minPeakHeight) {
-    for (size_t i = 0; i < fit_result->getNumberPeaks(); ++i)
-      fit_result->setBadRecord(i, -1.);
-    return; // don't do anything
-  }
-
+void FitPeaks::initializeFitWorker(FitPeaksAlgorithm::FitWorker &worker) {
   // Set up sub algorithm Fit for peak and background
-  IAlgorithm_sptr peak_fitter; // both peak and background (combo)
   try {
-    peak_fitter = createChildAlgorithm("Fit", -1, -1, false);
+    worker.fitter = createChildAlgorithm("Fit", -1, -1, false);
   } catch (Exception::NotFoundError &) {
     std::stringstream errss;
     errss << "The FitPeak algorithm requires the CurveFitting library";
@@ -1016,17 +1030,47 @@ void FitPeaks::fitSpectrumPeaks(
     throw std::runtime_error(errss.str());
   }
 
+  // set up properties of algorithm (reference) 'Fit'
+  worker.fitter->setProperty("Minimizer", m_minimizer);
+  worker.fitter->setProperty("CostFunction", m_costFunction);
+  worker.fitter->setProperty("CalcErrors", true);
+
   // Clone the function
-  IPeakFunction_sptr peakfunction =
+  worker.peakfunction =
       boost::dynamic_pointer_cast<API::IPeakFunction>(m_peakFunction->clone());
-  IBackgroundFunction_sptr bkgdfunction =
-      boost::dynamic_pointer_cast<API::IBackgroundFunction>(
-          m_bkgdFunction->clone());
+  worker.bkgdfunction = boost::dynamic_pointer_cast<API::IBackgroundFunction>(
+      m_bkgdFunction->clone());
 
-  // set up properties of algorithm (reference) 'Fit'
-  peak_fitter->setProperty("Minimizer", m_minimizer);
-  peak_fitter->setProperty("CostFunction", m_costFunction);
-  peak_fitter->setProperty("CalcErrors", true);
+  worker.hasLastWorkspaceIndex = false;
+  worker.lastPeakParameters.assign(m_numPeaksToFit, std::vector<double>());
+}
+
+//----------------------------------------------------------------------------------------------
+/** Fit peaks across one single spectrum
+ * @param wi :: workspace index of the spectrum to fit
+ * @param expected_peak_centers :: expected positions of the peaks to fit
+ * @param fit_result :: (output) fitting result of all the peaks
+ * @param worker :: fitting resources of the calling thread
+ */
+void FitPeaks::fitSpectrumPeaks(
+    size_t wi, const std::vector<double> &expected_peak_centers,
+    boost::shared_ptr<FitPeaksAlgorithm::PeakFitResult> fit_result,
+    FitPeaksAlgorithm::FitWorker &worker) {
+  // the converged parameters of the previous spectrum are only used as
+  // starting values if it was fitted immediately before this one; they are
+  // only recorded if SeedFromNeighbours is set
+  const auto neighbourPeakParameters =
+      worker.startSpectrum(wi, m_numPeaksToFit);
+
+  if (numberCounts(m_inputMatrixWS->histogram(wi)) <= m_minPeakHeight) {
+    for (size_t i = 0; i < fit_result->getNumberPeaks(); ++i)
+      fit_result->setBadRecord(i, -1.);
+    return; // don't do anything
+  }
+
+  IAlgorithm_sptr peak_fitter = worker.fitter; // both peak and background
+  IPeakFunction_sptr peakfunction = worker.peakfunction;
+  IBackgroundFunction_sptr bkgdfunction = worker.bkgdfunction;
 
   // store the peak fit parameters once one works
   bool foundAnyPeak = false;
@@ -1041,12 +1085,20 @@ void FitPeaks::fitSpectrumPeaks(
       peak_index = m_numPeaksToFit - fit_index - 1;
 
     // reset the background function
-    for (size_t i = 0; i < bkgdfunction->nParams(); ++i)
-      bkgdfunction->setParameter(0, 0.);
+    for (size_t i = 0; i < bkgdfunction->nParams(); ++i) {
+      bkgdfunction->setParameter(i, 0.);
+      bkgdfunction->setError(i, 0.);
+    }
 
-    // set the peak parameters from last good fit - override peak center
-    for (size_t i = 0; i < lastGoodPeakParameters.size(); ++i)
-      peakfunction->setParameter(i, lastGoodPeakParameters[i]);
+    // set the peak parameters from the same peak in the neighbouring spectrum
+    // or from the last good fit - override peak center
+    const auto &neighbourParameters = neighbourPeakParameters[peak_index];
+    const bool use_neighbour = !neighbourParameters.empty();
+    for (size_t i = 0; i < lastGoodPeakParameters.size(); ++i) {
+      peakfunction->setParameter(i, use_neighbour ? neighbourParameters[i]
+                                                  : lastGoodPeakParameters[i]);
+      peakfunction->setError(i, 0.);
+    }
     double expected_peak_pos = expected_peak_centers[peak_index];
     peakfunction->setCentre(expected_peak_pos);
 
@@ -1059,7 +1111,9 @@ void FitPeaks::fitSpectrumPeaks(
       std::pair<double, double> peak_window_i =
           getPeakFitWindow(wi, peak_index);
 
+      // the width of a peak seeded from its neighbour is already good
       bool observe_peak_width_flag =
+          !use_neighbour &&
           decideToEstimatePeakWidth(!foundAnyPeak, peakfunction);
 
       if (observe_peak_width_flag &&
@@ -1088,6 +1142,14 @@ void FitPeaks::fitSpectrumPeaks(
 
     processSinglePeakFitResult(wi, peak_index, cost, expected_peak_centers,
                                fit_function, fit_result); // sets the record
+
+    // keep the accepted fit to seed the next spectrum
+    if (m_seedFromNeighbours && fit_result->getCost(peak_index) < DBL_MAX) {
+      auto &converged = worker.lastPeakParameters[peak_index];
+      converged.resize(peakfunction->nParams());
+      for (size_t i = 0; i < converged.size(); ++i)
+        converged[i] = peakfunction->getParameter(i);
+    }
   }
 
   return;
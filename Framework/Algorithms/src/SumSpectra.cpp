@@ -6,6 +6,7 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidAlgorithms/SumSpectra.h"
 #include "MantidAPI/CommonBinsValidator.h"
+#include "MantidAPI/HistoWorkspace.h"
 #include "MantidAPI/Run.h"
 #include "MantidAPI/SpectrumInfo.h"
 #include "MantidAPI/WorkspaceFactory.h"
@@ -14,9 +15,16 @@
 #include "MantidDataObjects/RebinnedOutput.h"
 #include "MantidDataObjects/WorkspaceCreation.h"
 #include "MantidGeometry/IDetector.h"
+#include "MantidIndexing/GlobalSpectrumIndex.h"
+#include "MantidIndexing/IndexInfo.h"
+#include "MantidIndexing/SpectrumIndexSet.h"
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/EnabledWhenProperty.h"
+#include "MantidParallel/Collectives.h"
+#include "MantidParallel/Communicator.h"
+
+#include <boost/serialization/vector.hpp>
 
 #include <functional>
 
@@ -43,7 +51,8 @@ bool validateSingleMatrixWorkspace(
     const MatrixWorkspace &ws, const int minIndex, const int maxIndex,
     const std::vector<int> &indices) {
   bool success(true);
-  const int numSpectra = static_cast<int>(ws.getNumberHistograms());
+  // The indices are global if the workspace is distributed
+  const int numSpectra = static_cast<int>(ws.indexInfo().globalSize());
   // check StartWorkSpaceIndex,  >=0 done by validator
   if (minIndex >= numSpectra) {
     validationOutput["StartWorkspaceIndex"] =
@@ -107,6 +116,28 @@ void validateWorkspaceName(std::map<std::string, std::string> &validationOutput,
     ++index;
   }
 }
+
+/** The number of bins of a distributed workspace. A rank that holds no
+ * spectra passes 0 and is ignored, so every rank packs and unpacks the same
+ * number of bins. Every rank throws if the ranks do not agree.
+ */
+size_t agreeNumberOfBins(const Parallel::Communicator &comm,
+                         const size_t localBins) {
+  std::vector<size_t> allBins;
+  Parallel::all_gather(comm, localBins, allBins);
+  size_t bins = 0;
+  for (const auto rankBins : allBins) {
+    if (rankBins == 0)
+      continue;
+    if (bins > 0 && rankBins != bins)
+      throw std::length_error(
+          "blocksize undefined because size of histograms is not equal");
+    bins = rankBins;
+  }
+  if (bins == 0)
+    throw std::runtime_error("SumSpectra: no bins found on any rank.");
+  return bins;
+}
 } // namespace
 
 /** Initialisation method.
@@ -200,6 +231,14 @@ std::map<std::string, std::string> SumSpectra::validateInputs() {
   return validationOutput;
 }
 
+/// Distributed inputs are summed on each rank and combined on the master.
+Parallel::ExecutionMode SumSpectra::getParallelExecutionMode(
+    const std::map<std::string, Parallel::StorageMode> &storageModes) const {
+  if (storageModes.at("InputWorkspace") == Parallel::StorageMode::Distributed)
+    return Parallel::ExecutionMode::Distributed;
+  return ParallelAlgorithm::getParallelExecutionMode(storageModes);
+}
+
 /** Executes the algorithm
  *
  */
@@ -449,15 +488,52 @@ void SumSpectra::doSimpleSum(MatrixWorkspace_sptr outputWorkspace,
     nZeros.assign(YSum.size(), 0);
   }
 
-  const auto &spectrumInfo = localworkspace->spectrumInfo();
+  std::set<detid_t> detectorIDs;
+  sumHistograms(*localworkspace, YSum, YErrorSum, Weight, nZeros, detectorIDs,
+                progress, numSpectra, numMasked);
+  // Map all the detectors onto the spectrum of the output
+  outSpec.addDetectorIDs(detectorIDs);
+
+  if (m_calculateWeightedSum) {
+    numZeros =
+        applyWeight(numSpectra, YSum, Weight, nZeros, m_multiplyByNumSpec);
+  } else {
+    numZeros = 0;
+  }
+}
+
+/**
+ * Add up the selected spectra of a histogram workspace. The errors are
+ * summed in quadrature, i.e. YErrorSum holds the sum of squared errors.
+ * @param workspace The workspace to sum
+ * @param YSum The sum of the data, divided by the squared errors if
+ * calculating a weighted sum
+ * @param YErrorSum The sum of the squared errors
+ * @param weight The sum of the inverse squared errors (weighted sum only)
+ * @param nZeros The number of zero errors in each bin (weighted sum only)
+ * @param detectorIDs Collects the detector IDs of the summed spectra
+ * @param progress the progress indicator
+ * @param numSpectra The number of spectra contributed to the sum.
+ * @param numMasked The spectra dropped from the summations because they are
+ * masked.
+ */
+void SumSpectra::sumHistograms(const MatrixWorkspace &workspace,
+                               HistogramData::HistogramY &YSum,
+                               HistogramData::HistogramE &YErrorSum,
+                               std::vector<double> &weight,
+                               std::vector<size_t> &nZeros,
+                               std::set<detid_t> &detectorIDs,
+                               Progress &progress, size_t &numSpectra,
+                               size_t &numMasked) {
+  const auto &spectrumInfo = workspace.spectrumInfo();
   // Loop over spectra
   for (const auto wsIndex : m_indices) {
     if (!useSpectrum(spectrumInfo, wsIndex, m_keepMonitors, numMasked))
       continue;
     numSpectra++;
 
-    const auto &YValues = localworkspace->y(wsIndex);
-    const auto &YErrors = localworkspace->e(wsIndex);
+    const auto &YValues = workspace.y(wsIndex);
+    const auto &YErrors = workspace.e(wsIndex);
 
     if (m_calculateWeightedSum) {
       // Retrieve the spectrum into a vector
@@ -466,7 +542,7 @@ void SumSpectra::doSimpleSum(MatrixWorkspace_sptr outputWorkspace,
         if (std::isnormal(yErrorsVal)) { // is non-zero, nan, or infinity
           const double errsq = yErrorsVal * yErrorsVal;
           YErrorSum[yIndex] += errsq;
-          Weight[yIndex] += 1. / errsq;
+          weight[yIndex] += 1. / errsq;
           YSum[yIndex] += YValues[yIndex] / errsq;
         } else {
           nZeros[yIndex]++;
@@ -481,19 +557,11 @@ void SumSpectra::doSimpleSum(MatrixWorkspace_sptr outputWorkspace,
                      });
     }
 
-    // Map all the detectors onto the spectrum of the output
-    outSpec.addDetectorIDs(
-        localworkspace->getSpectrum(wsIndex).getDetectorIDs());
+    const auto &ids = workspace.getSpectrum(wsIndex).getDetectorIDs();
+    detectorIDs.insert(ids.begin(), ids.end());
 
     progress.report();
   }
-
-  if (m_calculateWeightedSum) {
-    numZeros =
-        applyWeight(numSpectra, YSum, Weight, nZeros, m_multiplyByNumSpec);
-  } else {
-    numZeros = 0;
-  }
 }
 
 /**
@@ -636,5 +704,137 @@ void SumSpectra::execEvent(MatrixWorkspace_sptr outputWorkspace,
   }
 }
 
+/** Sum a distributed Workspace2D. Each rank adds up the selected spectra
+ * it holds and the partial sums are combined on the master rank, which holds
+ * the (MasterOnly) output.
+ */
+void SumSpectra::execDistributed() {
+  m_keepMonitors = getProperty("IncludeMonitors");
+  m_replaceSpecialValues = getProperty("RemoveSpecialValues");
+  m_calculateWeightedSum = getProperty("WeightedSum");
+  m_multiplyByNumSpec = getProperty("MultiplyBySpectra");
+
+  MatrixWorkspace_const_sptr inputWorkspace = getProperty("InputWorkspace");
+  if (boost::dynamic_pointer_cast<const EventWorkspace>(inputWorkspace) ||
+      inputWorkspace->id() == "RebinnedOutput")
+    throw std::runtime_error("SumSpectra: only Workspace2D inputs can be "
+                             "summed when the workspace is distributed.");
+  const auto &indexInfo = inputWorkspace->indexInfo();
+  const auto &comm = indexInfo.communicator();
+
+  // The selected indices are global, keep the ones held by this rank
+  determineIndices(indexInfo.globalSize());
+  std::vector<Indexing::GlobalSpectrumIndex> globalIndices;
+  for (const auto index : m_indices)
+    globalIndices.emplace_back(index);
+  const auto localIndices = indexInfo.makeIndexSet(globalIndices);
+  m_indices.clear();
+  for (const auto index : localIndices)
+    m_indices.insert(index);
+  m_yLength = agreeNumberOfBins(comm, inputWorkspace->blocksize());
+
+  auto localWorkspace = replaceSpecialValues();
+  HistogramData::HistogramY ySum(m_yLength, 0.0);
+  HistogramData::HistogramE eSquaredSum(m_yLength, 0.0);
+  std::vector<double> weight(m_calculateWeightedSum ? m_yLength : 0, 0.0);
+  std::vector<size_t> nZeros(m_calculateWeightedSum ? m_yLength : 0, 0);
+  std::set<detid_t> detectorIDs;
+  size_t numSpectra(0);
+  size_t numMasked(0);
+  Progress progress(this, 0.0, 1.0, m_indices.size());
+  sumHistograms(*localWorkspace, ySum, eSquaredSum, weight, nZeros,
+                detectorIDs, progress, numSpectra, numMasked);
+
+  // Pack the partial sums into a single message: the counts, the lowest
+  // spectrum number (if any spectra were selected here), the sums, the bin
+  // edges (if this rank holds any spectra, the bins are common) and the
+  // detector IDs
+  const bool haveSpectra = inputWorkspace->getNumberHistograms() > 0;
+  std::vector<double> partial{static_cast<double>(numSpectra),
+                              static_cast<double>(numMasked),
+                              static_cast<double>(m_indices.size())};
+  partial.push_back(m_indices.empty()
+                        ? 0.0
+                        : static_cast<double>(getOutputSpecNo(localWorkspace)));
+  partial.push_back(haveSpectra ? 1.0 : 0.0);
+  partial.insert(partial.end(), ySum.begin(), ySum.end());
+  partial.insert(partial.end(), eSquaredSum.begin(), eSquaredSum.end());
+  partial.insert(partial.end(), weight.begin(), weight.end());
+  partial.insert(partial.end(), nZeros.begin(), nZeros.end());
+  if (haveSpectra) {
+    const auto &binEdges = inputWorkspace->binEdges(0);
+    partial.insert(partial.end(), binEdges.cbegin(), binEdges.cend());
+  }
+  partial.insert(partial.end(), detectorIDs.begin(), detectorIDs.end());
+
+  std::vector<std::vector<double>> partials;
+  Parallel::gather(comm, partial, partials, 0);
+  if (comm.rank() != 0)
+    return;
+
+  ySum.assign(m_yLength, 0.0);
+  eSquaredSum.assign(m_yLength, 0.0);
+  std::fill(weight.begin(), weight.end(), 0.0);
+  std::fill(nZeros.begin(), nZeros.end(), 0);
+  numSpectra = 0;
+  numMasked = 0;
+  bool haveSpectrumNumber(false);
+  std::vector<double> binEdges;
+  for (const auto &rankPartial : partials) {
+    auto it = rankPartial.begin();
+    numSpectra += static_cast<size_t>(*it++);
+    numMasked += static_cast<size_t>(*it++);
+    const bool selected = *it++ > 0.0;
+    const auto specNum = static_cast<specnum_t>(*it++);
+    if (selected && (!haveSpectrumNumber || specNum < m_outSpecNum)) {
+      m_outSpecNum = specNum;
+      haveSpectrumNumber = true;
+    }
+    const bool rankHasSpectra = *it++ > 0.0;
+    for (auto &y : ySum)
+      y += *it++;
+    for (auto &e : eSquaredSum)
+      e += *it++;
+    for (auto &w : weight)
+      w += *it++;
+    for (auto &n : nZeros)
+      n += static_cast<size_t>(*it++);
+    if (rankHasSpectra) {
+      if (binEdges.empty())
+        binEdges.assign(it, it + m_yLength + 1);
+      it += m_yLength + 1;
+    }
+    for (; it != rankPartial.end(); ++it)
+      detectorIDs.insert(static_cast<detid_t>(*it));
+  }
+
+  size_t numZeros(0);
+  if (m_calculateWeightedSum)
+    numZeros =
+        applyWeight(numSpectra, ySum, weight, nZeros, m_multiplyByNumSpec);
+  // take the square root of all the accumulated squared errors - Assumes
+  // Gaussian errors
+  std::transform(eSquaredSum.begin(), eSquaredSum.end(), eSquaredSum.begin(),
+                 (double (*)(double))std::sqrt);
+
+  MatrixWorkspace_sptr outputWorkspace = create<HistoWorkspace>(
+      *inputWorkspace,
+      Indexing::IndexInfo(1, Parallel::StorageMode::MasterOnly, comm),
+      HistogramData::BinEdges(std::move(binEdges)));
+  auto &outSpec = outputWorkspace->getSpectrum(0);
+  outSpec.setSpectrumNo(m_outSpecNum);
+  outSpec.setDetectorIDs(detectorIDs);
+  outSpec.mutableY() = std::move(ySum);
+  outSpec.mutableE() = std::move(eSquaredSum);
+
+  outputWorkspace->mutableRun().addProperty("NumAllSpectra", int(numSpectra),
+                                            "", true);
+  outputWorkspace->mutableRun().addProperty("NumMaskSpectra", int(numMasked),
+                                            "", true);
+  outputWorkspace->mutableRun().addProperty("NumZeroSpectra", int(numZeros), "",
+                                            true);
+  setProperty("OutputWorkspace", outputWorkspace);
+}
+
 } // namespace Algorithms
 } // namespace Mantid
@@ -16,11 +16,20 @@
 #include "MantidDataHandling/LoadNexus.h"
 #include "MantidDataHandling/LoadRaw3.h"
 #include "MantidDataObjects/EventWorkspace.h"
+#include "MantidDataObjects/GroupingWorkspace.h"
+#include "MantidDataObjects/WorkspaceCreation.h"
 #include "MantidHistogramData/LinearGenerator.h"
+#include "MantidIndexing/IndexInfo.h"
+#include "MantidIndexing/LoadBalancedPartitioner.h"
 #include "MantidKernel/UnitFactory.h"
 #include "MantidKernel/cow_ptr.h"
+#include "MantidTestHelpers/ComponentCreationHelper.h"
+#include "MantidTestHelpers/ParallelAlgorithmCreation.h"
+#include "MantidTestHelpers/ParallelRunner.h"
 #include "MantidTestHelpers/WorkspaceCreationHelper.h"
 #include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <numeric>
 
 using namespace Mantid;
 using namespace Mantid::DataHandling;
@@ -31,6 +40,123 @@ using namespace Mantid::DataObjects;
 using Mantid::HistogramData::BinEdges;
 using Mantid::Types::Event::TofEvent;
 
+namespace {
+/// Two banks of 9 detectors, focussed into one group per bank
+constexpr size_t nFocusSpectra = 18;
+
+/** Create the input for the focussing. The spectra have different X ranges,
+ * and the counts or events depend on the spectrum number, so the result does
+ * not depend on which rank holds a spectrum.
+ */
+MatrixWorkspace_sptr
+createFocusInput(const Geometry::Instrument_const_sptr &instrument,
+                 const Indexing::IndexInfo &indexInfo, const bool events) {
+  MatrixWorkspace_sptr ws;
+  if (events)
+    ws = create<EventWorkspace>(instrument, indexInfo, BinEdges(2));
+  else
+    ws = create<Workspace2D>(instrument, indexInfo, BinEdges(11));
+  ws->getAxis(0)->unit() = UnitFactory::Instance().create("TOF");
+  for (size_t i = 0; i < ws->getNumberHistograms(); ++i) {
+    const auto specNum =
+        static_cast<double>(ws->getSpectrum(i).getSpectrumNo());
+    const double xmin = 1000. + 10. * specNum;
+    if (events) {
+      auto &eventList = boost::dynamic_pointer_cast<EventWorkspace>(ws)
+                            ->getSpectrum(i);
+      for (int event = 0; event < 10; ++event)
+        eventList += TofEvent(xmin + 50. * event + specNum);
+      ws->setBinEdges(i, BinEdges{xmin, xmin + 500.});
+    } else {
+      ws->setBinEdges(
+          i, BinEdges(11, HistogramData::LinearGenerator(xmin, 50.)));
+      auto &y = ws->mutableY(i);
+      std::iota(y.begin(), y.end(), specNum);
+      auto &e = ws->mutableE(i);
+      std::transform(y.begin(), y.end(), e.begin(),
+                     static_cast<double (*)(double)>(std::sqrt));
+    }
+  }
+  return ws;
+}
+
+GroupingWorkspace_sptr
+createFocusGrouping(const Geometry::Instrument_const_sptr &instrument) {
+  auto grouping = boost::make_shared<GroupingWorkspace>(instrument);
+  auto detIDs = instrument->getDetectorIDs(true);
+  std::sort(detIDs.begin(), detIDs.end());
+  for (size_t i = 0; i < detIDs.size(); ++i)
+    grouping->setValue(detIDs[i], i < detIDs.size() / 2 ? 1. : 2.);
+  return grouping;
+}
+
+/** Focus a distributed input and compare every local output spectrum to the
+ * focussing of the same data on a single rank. Most of the weight is on the
+ * first spectrum, so with three or more ranks the first rank holds no input
+ * spectra.
+ */
+void run_focus_distributed(const Parallel::Communicator &comm,
+                           const bool events) {
+  using namespace Parallel;
+  const auto instrument =
+      ComponentCreationHelper::createTestInstrumentCylindrical(2);
+  auto grouping = createFocusGrouping(instrument);
+
+  DiffractionFocussing2 reference;
+  reference.setChild(true);
+  reference.initialize();
+  reference.setProperty(
+      "InputWorkspace",
+      createFocusInput(instrument, Indexing::IndexInfo(nFocusSpectra),
+                       events));
+  reference.setProperty("GroupingWorkspace", grouping);
+  reference.setProperty("PreserveEvents", false);
+  reference.setPropertyValue("OutputWorkspace", "unused");
+  TS_ASSERT_THROWS_NOTHING(reference.execute());
+  MatrixWorkspace_const_sptr expected =
+      reference.getProperty("OutputWorkspace");
+
+  std::vector<double> weights(nFocusSpectra, 1.0);
+  weights[0] = 1000.0;
+  auto partitioner = std::make_shared<Indexing::LoadBalancedPartitioner>(
+      comm.size(), Indexing::PartitionIndex(comm.rank()),
+      Indexing::Partitioner::MonitorStrategy::TreatAsNormalSpectrum,
+      std::vector<Indexing::GlobalSpectrumIndex>{}, weights);
+  std::vector<Indexing::SpectrumNumber> specNums(nFocusSpectra);
+  std::iota(specNums.begin(), specNums.end(), 1);
+  const Indexing::IndexInfo indexInfo(specNums, StorageMode::Distributed,
+                                      comm, partitioner);
+  if (comm.size() > 2 && comm.rank() == 0)
+    TS_ASSERT_EQUALS(indexInfo.size(), 0);
+
+  auto focus = ParallelTestHelpers::create<DiffractionFocussing2>(comm);
+  focus->setProperty("InputWorkspace",
+                     createFocusInput(instrument, indexInfo, events));
+  focus->setProperty("GroupingWorkspace", grouping);
+  focus->setProperty("PreserveEvents", false);
+  TS_ASSERT_THROWS_NOTHING(focus->execute());
+  MatrixWorkspace_const_sptr out = focus->getProperty("OutputWorkspace");
+  TS_ASSERT_EQUALS(out->storageMode(), StorageMode::Distributed);
+  TS_ASSERT_EQUALS(out->indexInfo().globalSize(), 2);
+  for (size_t i = 0; i < out->getNumberHistograms(); ++i) {
+    const auto group = out->getSpectrum(i).getSpectrumNo();
+    const auto &expectedSpectrum = expected->getSpectrum(
+        expected->getIndexFromSpectrumNumber(group));
+    TS_ASSERT_EQUALS(out->getSpectrum(i).getDetectorIDs(),
+                     expectedSpectrum.getDetectorIDs());
+    const auto &x = out->x(i);
+    const auto &y = out->y(i);
+    const auto &e = out->e(i);
+    TS_ASSERT_EQUALS(y.size(), expectedSpectrum.y().size());
+    for (size_t bin = 0; bin < y.size(); ++bin) {
+      TS_ASSERT_DELTA(x[bin], expectedSpectrum.x()[bin], 1e-9);
+      TS_ASSERT_DELTA(y[bin], expectedSpectrum.y()[bin], 1e-9);
+      TS_ASSERT_DELTA(e[bin], expectedSpectrum.e()[bin], 1e-9);
+    }
+  }
+}
+} // namespace
+
 class DiffractionFocussing2Test : public CxxTest::TestSuite {
 public:
   void testName() { TS_ASSERT_EQUALS(focus.name(), "DiffractionFocussing"); }
@@ -380,6 +506,14 @@ public:
     TS_ASSERT_EQUALS(outWS->getNumberHistograms(), 6);
     AnalysisDataService::Instance().remove("SNAP_focus");
   }
+
+  void test_parallel_distributed() {
+    ParallelTestHelpers::runParallel(run_focus_distributed, false);
+  }
+
+  void test_parallel_distributed_events() {
+    ParallelTestHelpers::runParallel(run_focus_distributed, true);
+  }
 };
 
 #endif /*DIFFRACTIONFOCUSSING2TEST_H_*/
@@ -242,6 +242,109 @@ public:
     AnalysisDataService::Instance().remove("PeakParametersWS");
   }
 
+  //----------------------------------------------------------------------------------------------
+  /** Test fitting multiple peaks on multiple spectra with the starting
+   * parameters of each spectrum seeded from the previous one
+   */
+  void test_multiPeaksMultiSpectraSeedFromNeighbours() {
+    // set up parameters with starting value
+    std::vector<string> peakparnames;
+    std::vector<double> peakparvalues;
+    createGuassParameters(peakparnames, peakparvalues);
+
+    // Generate input workspace
+    createTestData(m_inputWorkspaceName);
+
+    // initialize algorithm to test
+    FitPeaks fitpeaks;
+
+    fitpeaks.initialize();
+    TS_ASSERT(fitpeaks.isInitialized());
+
+    TS_ASSERT_THROWS_NOTHING(
+        fitpeaks.setProperty("InputWorkspace", m_inputWorkspaceName));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("StartWorkspaceIndex", 0));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("StopWorkspaceIndex", 2));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("PeakCenters", "5.0, 10.0"));
+    TS_ASSERT_THROWS_NOTHING(
+        fitpeaks.setProperty("FitWindowBoundaryList", "2.5, 6.5, 8.0, 12.0"));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("FitFromRight", true));
+    TS_ASSERT_THROWS_NOTHING(
+        fitpeaks.setProperty("PeakParameterNames", peakparnames));
+    TS_ASSERT_THROWS_NOTHING(
+        fitpeaks.setProperty("PeakParameterValues", peakparvalues));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("HighBackground", false));
+    TS_ASSERT_THROWS_NOTHING(fitpeaks.setProperty("SeedFromNeighbours", true));
+
+    fitpeaks.setProperty("OutputWorkspace", "PeakPositionsWS");
+    fitpeaks.setProperty("OutputPeakParametersWorkspace", "PeakParametersWS");
+    fitpeaks.setProperty("ConstrainPeakPositions", false);
+
+    fitpeaks.execute();
+
+    // check result
+    TS_ASSERT(fitpeaks.isExecuted());
+    if (!fitpeaks.isExecuted())
+      return;
+
+    // the seeded fits must converge to the same peaks as the unseeded ones
+    API::MatrixWorkspace_sptr main_out_ws =
+        boost::dynamic_pointer_cast<API::MatrixWorkspace>(
+            AnalysisDataService::Instance().retrieve("PeakPositionsWS"));
+    TS_ASSERT(main_out_ws);
+    TS_ASSERT_EQUALS(main_out_ws->getNumberHistograms(), 3);
+
+    const auto &fitted_positions_0 = main_out_ws->histogram(0).y();
+    TS_ASSERT_DELTA(fitted_positions_0[0], 5.0, 1.E-6);
+    TS_ASSERT_DELTA(fitted_positions_0[1], 10.0, 1.E-6);
+    const auto &fitted_positions_2 = main_out_ws->histogram(2).y();
+    TS_ASSERT_DELTA(fitted_positions_2[0], 5.03, 1.E-6);
+    TS_ASSERT_DELTA(fitted_positions_2[1], 10.02, 1.E-6);
+
+    API::ITableWorkspace_sptr param_ws =
+        boost::dynamic_pointer_cast<API::ITableWorkspace>(
+            AnalysisDataService::Instance().retrieve("PeakParametersWS"));
+    TS_ASSERT(param_ws);
+    TS_ASSERT_EQUALS(param_ws->rowCount(), 6);
+    TS_ASSERT_DELTA(param_ws->cell<double>(2, 2), 4., 1E-6);
+    TS_ASSERT_DELTA(param_ws->cell<double>(2, 4), 0.17, 1E-6);
+    TS_ASSERT_DELTA(param_ws->cell<double>(3, 2), 2., 1E-6);
+    TS_ASSERT_DELTA(param_ws->cell<double>(3, 4), 0.12, 1E-6);
+
+    // clean up
+    AnalysisDataService::Instance().remove(m_inputWorkspaceName);
+    AnalysisDataService::Instance().remove("PeakPositionsWS");
+    AnalysisDataService::Instance().remove("PeakParametersWS");
+  }
+
+  //----------------------------------------------------------------------------------------------
+  /** Test that a spectrum is only seeded with the converged peak parameters
+   * of the spectrum fitted immediately before it by the same worker
+   */
+  void test_fitWorkerSeedsOnlyFromPreviousSpectrum() {
+    Mantid::Algorithms::FitPeaksAlgorithm::FitWorker worker;
+
+    // the first spectrum has no neighbour, even at workspace index 0
+    auto seed = worker.startSpectrum(0, 2);
+    TS_ASSERT_EQUALS(seed.size(), 2);
+    TS_ASSERT(seed[0].empty());
+    TS_ASSERT(seed[1].empty());
+    worker.lastPeakParameters[0] = {1., 2., 3.};
+
+    // the next spectrum starts from the accepted fits of the previous one
+    seed = worker.startSpectrum(1, 2);
+    TS_ASSERT_EQUALS(seed.size(), 2);
+    TS_ASSERT_EQUALS(seed[0], std::vector<double>({1., 2., 3.}));
+    TS_ASSERT(seed[1].empty());
+    TS_ASSERT(worker.lastPeakParameters[0].empty());
+    worker.lastPeakParameters[1] = {4., 5., 6.};
+
+    // a gap in the workspace indices means there is no neighbour
+    seed = worker.startSpectrum(3, 2);
+    TS_ASSERT(seed[0].empty());
+    TS_ASSERT(seed[1].empty());
+  }
+
   //----------------------------------------------------------------------------------------------
   /** Test output of effective peak parameters
    * @brief test_effectivePeakParameters
@@ -9,19 +9,103 @@
 
 #include "MantidAPI/AnalysisDataService.h"
 #include "MantidAPI/SpectrumInfo.h"
+#include "MantidAlgorithms/CreateWorkspace.h"
 #include "MantidAlgorithms/SumSpectra.h"
 #include "MantidDataObjects/Workspace2D.h"
+#include "MantidDataObjects/WorkspaceCreation.h"
 #include "MantidGeometry/Instrument/ParameterMap.h"
+#include "MantidIndexing/IndexInfo.h"
+#include "MantidIndexing/LoadBalancedPartitioner.h"
+#include "MantidTestHelpers/ParallelAlgorithmCreation.h"
+#include "MantidTestHelpers/ParallelRunner.h"
 #include "MantidTestHelpers/WorkspaceCreationHelper.h"
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include <cxxtest/TestSuite.h>
 #include <limits>
+#include <numeric>
 
 using namespace Mantid;
 using namespace Mantid::API;
 using namespace Mantid::DataObjects;
 
+namespace {
+void run_sum_distributed(const Parallel::Communicator &comm,
+                         const bool weighted) {
+  using namespace Parallel;
+  auto create = ParallelTestHelpers::create<Algorithms::CreateWorkspace>(comm);
+  const int nspec = 100;
+  create->setProperty<int>("NSpec", nspec);
+  create->setProperty<std::vector<double>>("DataX", {0.0, 1.0, 2.0});
+  create->setProperty<std::vector<double>>("DataY",
+                                           std::vector<double>(2 * nspec, 1.0));
+  create->setProperty<std::vector<double>>("DataE",
+                                           std::vector<double>(2 * nspec, 1.0));
+  create->setProperty("ParallelStorageMode",
+                      toString(StorageMode::Distributed));
+  create->execute();
+  MatrixWorkspace_sptr ws = create->getProperty("OutputWorkspace");
+
+  auto sum = ParallelTestHelpers::create<Algorithms::SumSpectra>(comm);
+  sum->setProperty("InputWorkspace", ws);
+  sum->setProperty("StartWorkspaceIndex", 10);
+  sum->setProperty("EndWorkspaceIndex", 59);
+  sum->setProperty("WeightedSum", weighted);
+  TS_ASSERT_THROWS_NOTHING(sum->execute());
+  MatrixWorkspace_const_sptr out = sum->getProperty("OutputWorkspace");
+  if (comm.rank() != 0) {
+    TS_ASSERT_EQUALS(out, nullptr);
+    return;
+  }
+  TS_ASSERT_EQUALS(out->storageMode(), StorageMode::MasterOnly);
+  TS_ASSERT_EQUALS(out->getNumberHistograms(), 1);
+  TS_ASSERT_EQUALS(out->getSpectrum(0).getSpectrumNo(), 11);
+  TS_ASSERT_EQUALS(out->y(0)[0], 50.0);
+  TS_ASSERT_EQUALS(out->y(0)[1], 50.0);
+  TS_ASSERT_DELTA(out->e(0)[0], std::sqrt(50.0), 1e-12);
+  TS_ASSERT_EQUALS(out->run().getPropertyValueAsType<int>("NumAllSpectra"),
+                   50);
+}
+
+/// Spectrum 0 is heavy, so with more than 2 ranks rank 0 holds no spectra
+void run_sum_distributed_empty_ranks(const Parallel::Communicator &comm) {
+  using namespace Parallel;
+  const size_t nspec = 10;
+  std::vector<double> weights(nspec, 1.0);
+  weights[0] = 1000.0;
+  auto partitioner = std::make_shared<Indexing::LoadBalancedPartitioner>(
+      comm.size(), Indexing::PartitionIndex(comm.rank()),
+      Indexing::Partitioner::MonitorStrategy::TreatAsNormalSpectrum,
+      std::vector<Indexing::GlobalSpectrumIndex>{}, weights);
+  std::vector<Indexing::SpectrumNumber> specNums(nspec);
+  std::iota(specNums.begin(), specNums.end(), 1);
+  const Indexing::IndexInfo indexInfo(specNums, StorageMode::Distributed,
+                                      comm, partitioner);
+  if (comm.size() > 2 && comm.rank() == 0)
+    TS_ASSERT_EQUALS(indexInfo.size(), 0);
+  MatrixWorkspace_sptr ws = create<Workspace2D>(
+      indexInfo,
+      HistogramData::Histogram(HistogramData::BinEdges{0.5, 1.5, 3.0},
+                               HistogramData::Counts(2, 1.0)));
+
+  auto sum = ParallelTestHelpers::create<Algorithms::SumSpectra>(comm);
+  sum->setProperty("InputWorkspace", ws);
+  sum->setProperty("StartWorkspaceIndex", 1);
+  TS_ASSERT_THROWS_NOTHING(sum->execute());
+  MatrixWorkspace_const_sptr out = sum->getProperty("OutputWorkspace");
+  if (comm.rank() != 0) {
+    TS_ASSERT_EQUALS(out, nullptr);
+    return;
+  }
+  TS_ASSERT_EQUALS(out->getNumberHistograms(), 1);
+  TS_ASSERT_EQUALS(out->getSpectrum(0).getSpectrumNo(), 2);
+  TS_ASSERT_EQUALS(out->x(0).rawData(), std::vector<double>({0.5, 1.5, 3.0}));
+  TS_ASSERT_EQUALS(out->y(0).rawData(), std::vector<double>({9.0, 9.0}));
+  TS_ASSERT_EQUALS(out->run().getPropertyValueAsType<int>("NumAllSpectra"),
+                   9);
+}
+} // namespace
+
 class SumSpectraTest : public CxxTest::TestSuite {
 public:
   static SumSpectraTest *createSuite() { return new SumSpectraTest(); }
@@ -669,6 +753,18 @@ public:
     AnalysisDataService::Instance().remove(outWsName);
   }
 
+  void test_parallel_distributed() {
+    ParallelTestHelpers::runParallel(run_sum_distributed, false);
+  }
+
+  void test_parallel_distributed_weighted() {
+    ParallelTestHelpers::runParallel(run_sum_distributed, true);
+  }
+
+  void test_parallel_distributed_with_empty_ranks() {
+    ParallelTestHelpers::runParallel(run_sum_distributed_empty_ranks);
+  }
+
 private:
   int nTestHist;
   Mantid::Algorithms::SumSpectra alg; // Test with range limits
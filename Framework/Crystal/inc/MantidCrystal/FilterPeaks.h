@@ -9,6 +9,7 @@
 
 #include "MantidAPI/Algorithm.h"
 #include "MantidAPI/IPeaksWorkspace.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/System.h"
 
 namespace Mantid {
@@ -64,12 +65,19 @@ private:
                    const FilterFunction &filterFunction,
                    const double filterValue) {
     Comparator operatorFunc;
-    for (int i = 0; i < inputWS.getNumberPeaks(); ++i) {
-      const Geometry::IPeak &currentPeak = inputWS.getPeak(i);
-      const auto currentValue = filterFunction(currentPeak);
+    const int nPeaks = inputWS.getNumberPeaks();
+    // Evaluate the filter for all the peaks in parallel, then copy those that
+    // pass in their original order
+    std::vector<char> passes(nPeaks);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int i = 0; i < nPeaks; ++i) {
+      const auto currentValue = filterFunction(inputWS.getPeak(i));
+      passes[i] = operatorFunc(currentValue, filterValue);
+    }
 
-      if (operatorFunc(currentValue, filterValue))
-        filteredWS.addPeak(currentPeak);
+    for (int i = 0; i < nPeaks; ++i) {
+      if (passes[i])
+        filteredWS.addPeak(inputWS.getPeak(i));
     }
   }
 };
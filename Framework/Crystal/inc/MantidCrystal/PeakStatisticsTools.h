@@ -15,6 +15,8 @@
 
 #include "MantidKernel/V3D.h"
 
+#include <array>
+
 namespace Mantid {
 namespace Crystal {
 namespace PeakStatisticsTools {
@@ -67,6 +69,11 @@ private:
  * counts can be obtained, for example to calculate redundancy or
  * completeness of the observations.
  *
+ * Reflection families are determined with integer copies of the point
+ * group's HKL transformations, and observations are grouped through a
+ * hash table keyed by the family, so that large data sets can be merged
+ * without ordered lookups.
+ *
  */
 class DLLExport UniqueReflectionCollection {
 public:
@@ -93,11 +100,19 @@ protected:
   UniqueReflectionCollection(
       const std::map<Kernel::V3D, UniqueReflection> &reflections,
       const Geometry::PointGroup_sptr &pointGroup)
-      : m_reflections(reflections), m_pointgroup(pointGroup) {}
+      : m_reflections(reflections), m_pointgroup(pointGroup),
+        m_hklOperations(getHKLOperations(pointGroup)) {}
 
 private:
+  /// Row-major integer matrix acting on HKL.
+  using HKLOperation = std::array<int, 9>;
+
+  static std::vector<HKLOperation>
+  getHKLOperations(const Geometry::PointGroup_sptr &pointGroup);
+
   std::map<Kernel::V3D, UniqueReflection> m_reflections;
   Geometry::PointGroup_sptr m_pointgroup;
+  std::vector<HKLOperation> m_hklOperations;
 };
 
 /**
@@ -10,6 +10,7 @@
 #include "MantidAPI/Algorithm.h"
 #include "MantidAPI/DetectorSearcher.h"
 #include "MantidDataObjects/PeaksWorkspace.h"
+#include "MantidGeometry/Crystal/HKLFilterWavelength.h"
 #include "MantidGeometry/Crystal/ReflectionCondition.h"
 #include "MantidKernel/Matrix.h"
 #include "MantidKernel/NearestNeighbours.h"
@@ -74,6 +75,15 @@ private:
   void calculateQAndAddToOutput(const Kernel::V3D &hkl,
                                 const Kernel::DblMatrix &orientedUB,
                                 const Kernel::DblMatrix &goniometerMatrix);
+  void calculateQForAllowedHKLs(const std::vector<Kernel::V3D> &possibleHKLs,
+                                const Kernel::DblMatrix &orientedUB,
+                                const Geometry::HKLFilterWavelength &filter,
+                                std::vector<Kernel::V3D> &allowedHKLs,
+                                std::vector<Kernel::V3D> &qs) const;
+  void
+  addPeakToOutput(const Kernel::V3D &hkl, const Kernel::V3D &q,
+                  const API::DetectorSearcher::DetectorSearchResult &result,
+                  const Kernel::DblMatrix &goniometerMatrix);
 
 private:
   /// Get the predicted detector direction from Q
@@ -103,6 +113,8 @@ private:
   Geometry::StructureFactorCalculator_sptr m_sfCalculator;
 
   double m_qConventionFactor;
+  /// Whether peaks missing the detectors are placed in extended space
+  bool m_useExtendedDetectorSpace = false;
 };
 
 } // namespace Crystal
@@ -19,9 +19,7 @@ namespace Crystal {
  * @param label : Label (taken as original) for Cluster
  */
 Cluster::Cluster(const size_t &label)
-    : m_originalLabel(label), m_rootCluster(this) {
-  m_indexes.reserve(1000);
-}
+    : m_originalLabel(label), m_rootCluster(this) {}
 
 /**
  * Get the label
@@ -9,6 +9,39 @@
 #include "MantidDataObjects/PeaksWorkspace.h"
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/EnabledWhenProperty.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <boost/functional/hash.hpp>
+
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+/// Cell of a cubic grid in Q
+struct GridCell {
+  int64_t x, y, z;
+  bool operator==(const GridCell &other) const {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
+struct GridCellHash {
+  size_t operator()(const GridCell &cell) const {
+    size_t seed = 0;
+    boost::hash_combine(seed, cell.x);
+    boost::hash_combine(seed, cell.y);
+    boost::hash_combine(seed, cell.z);
+    return seed;
+  }
+};
+
+/// Get the cell of the grid containing a Q vector
+GridCell cellOf(const Mantid::Kernel::V3D &q, const double cellSize) {
+  return {static_cast<int64_t>(std::floor(q.X() / cellSize)),
+          static_cast<int64_t>(std::floor(q.Y() / cellSize)),
+          static_cast<int64_t>(std::floor(q.Z() / cellSize))};
+}
+} // namespace
 
 namespace Mantid {
 namespace Crystal {
@@ -97,30 +130,51 @@ void CombinePeaksWorkspaces::exec() {
   {
     const double Tolerance = getProperty("Tolerance");
 
-    // Get hold of the peaks in the first workspace as we'll need to examine
-    // them
-    auto &lhsPeaks = LHSWorkspace->getPeaks();
-
-    // Loop over the peaks in the second workspace, appending ones that don't
-    // match any in first workspace
-    for (const auto &currentPeak : rhsPeaks) {
-      // Now have to go through the first workspace checking for matches
-      // Not doing anything clever as peaks workspace are typically not large -
-      // just a linear search
-      bool match = false;
-      for (const auto &lhsPeak : lhsPeaks) {
-        const V3D deltaQ =
-            currentPeak.getQSampleFrame() - lhsPeak.getQSampleFrame();
-        if (deltaQ.nullVector(
-                Tolerance)) // Using a V3D method that does the job
-        {
-          match = true;
-          break;
+    // Put the peaks of the first workspace on a grid with cells no smaller
+    // than the tolerance, so a matching peak can only be in the same cell or
+    // one of its neighbours
+    const double cellSize = std::max(Tolerance, 1e-9);
+    const auto lhsQs = LHSWorkspace->getQSampleFrames();
+    std::unordered_map<GridCell, std::vector<size_t>, GridCellHash> grid;
+    for (size_t i = 0; i < lhsQs.size(); ++i) {
+      grid[cellOf(lhsQs[i], cellSize)].push_back(i);
+    }
+
+    const auto rhsQs = RHSWorkspace->getQSampleFrames();
+    auto hasMatch = [&](const V3D &q) {
+      const auto cell = cellOf(q, cellSize);
+      for (int64_t dx = -1; dx <= 1; ++dx) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+          for (int64_t dz = -1; dz <= 1; ++dz) {
+            const auto found =
+                grid.find({cell.x + dx, cell.y + dy, cell.z + dz});
+            if (found == grid.end())
+              continue;
+            for (const auto lhsIndex : found->second) {
+              const V3D deltaQ = q - lhsQs[lhsIndex];
+              if (deltaQ.nullVector(
+                      Tolerance)) // Using a V3D method that does the job
+                return true;
+            }
+          }
         }
       }
+      return false;
+    };
+
+    const auto nRHSPeaks = static_cast<int64_t>(rhsPeaks.size());
+    std::vector<char> matched(rhsPeaks.size());
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = 0; i < nRHSPeaks; ++i) {
+      matched[i] = hasMatch(rhsQs[i]);
+    }
+
+    // Append the peaks in the second workspace that don't match any in the
+    // first workspace
+    for (size_t i = 0; i < rhsPeaks.size(); ++i) {
       // Only add the peak if there was no match
-      if (!match)
-        output->addPeak(currentPeak);
+      if (!matched[i])
+        output->addPeak(rhsPeaks[i]);
       progress.report();
     }
   }
@@ -11,9 +11,18 @@
 #include "MantidAPI/IMDIterator.h"
 #include "MantidCrystal/BackgroundStrategy.h"
 #include "MantidCrystal/Cluster.h"
-#include "MantidCrystal/ClusterRegister.h"
+#include "MantidCrystal/CompositeCluster.h"
 #include "MantidCrystal/ICluster.h"
 #include "MantidKernel/Memory.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
 
 using namespace Mantid::API;
 using namespace Mantid::Kernel;
@@ -22,42 +31,37 @@ using namespace Mantid::Crystal::ConnectedComponentMappingTypes;
 namespace Mantid {
 namespace Crystal {
 namespace {
+Logger g_log("ConnectedComponentLabeling");
+
 /**
- * Perform integer power to determine the maximum number of face and edge
- * connected
- * neighbours for a given dimensionality
- * @param ws : Workspace with dimensionality
- * @return : Maximum number of possible neighbours
+ * Check there is enough memory to label the workspace and write the output
+ * @param nPoints : Number of elements in the workspace
+ * @param sizeOfLabel : Size of the disjoint-set entry of each element
  */
-size_t calculateMaxNeighbours(IMDHistoWorkspace const *const ws) {
-  const size_t ndims = ws->getNumDims();
-  size_t maxNeighbours = 3;
-  for (size_t i = 1; i < ndims; ++i) {
-    maxNeighbours *= 3;
+void memoryCheck(size_t nPoints, size_t sizeOfLabel) {
+  size_t sizeOfElement = (3 * sizeof(signal_t)) + sizeof(bool) + sizeOfLabel;
+
+  MemoryStats memoryStats;
+  const size_t freeMemory = memoryStats.availMem();         // in kB
+  const size_t memoryCost = sizeOfElement * nPoints / 1000; // in kB
+  if (memoryCost > freeMemory) {
+    std::string basicMessage =
+        "CCL requires more free memory than you have available.";
+    std::stringstream sstream;
+    sstream << basicMessage << " Requires " << memoryCost
+            << " KB of contiguous memory.";
+    g_log.notice(sstream.str());
+    throw std::runtime_error(basicMessage);
   }
-  maxNeighbours -= 1;
-  return maxNeighbours;
 }
 
 /**
- * Get the maximum number of clusters possible in an MD space. For use as an
- * offset.
- * @param ws : Workspace to interogate
- * @param nIterators : number of equally sized iterators working on the
- * workspace
- * @return Maximum number of clusters.
+ * Can the disjoint-set forest of a workspace use 32 bit indexes
+ * @param nPoints : Number of elements in the workspace
+ * @return True if all indexes and the empty marker fit in 32 bits
  */
-size_t calculateMaxClusters(IMDHistoWorkspace const *const ws,
-                            size_t nIterators) {
-  size_t maxClusters = 1;
-  for (size_t i = 0; i < ws->getNumDims(); ++i) {
-    maxClusters *= ws->getDimension(i)->getNBins() / 2;
-  }
-  maxClusters /= nIterators;
-  if (maxClusters == 0) {
-    maxClusters = ws->getNPoints();
-  }
-  return maxClusters;
+bool useCompactLabels(size_t nPoints) {
+  return nPoints < std::numeric_limits<uint32_t>::max();
 }
 
 /**
@@ -80,143 +84,213 @@ cloneInputWorkspace(IMDHistoWorkspace_sptr &inWS) {
 }
 
 /**
- * Helper function to calculate report frequecny
- * @param maxReports : Maximum number of reports wanted
- * @param maxIterations : Maximum number of possible iterations
- * @return
+ * Disjoint-set forest over the linear indexes of an image, which many threads
+ * can join at once without locking. Every element points to a parent with a
+ * lower index, so the root of each set is its lowest index and linking roots
+ * with a compare-and-swap can never make a cycle. Elements which are not part
+ * of any set are marked as empty.
  */
-template <typename T>
-T reportEvery(const T &maxReports, const T &maxIterations) {
-  T frequency = maxReports;
-  if (maxIterations >= maxReports) {
-    frequency = maxIterations / maxReports;
+template <typename IndexType> class ParallelDisjointSet {
+public:
+  /// Marks elements which are not part of any set
+  static constexpr IndexType Empty = std::numeric_limits<IndexType>::max();
+
+  explicit ParallelDisjointSet(size_t size) : m_parents(size) {
+    const auto nElements = static_cast<int64_t>(size);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = 0; i < nElements; ++i) {
+      m_parents[i].store(Empty, std::memory_order_relaxed);
+    }
   }
-  return frequency;
-}
 
-// Helper function for determining if a set contains a specific value.
-template <typename Container>
-bool does_contain_key(const Container &container,
-                      const typename Container::key_type &value) {
-  return container.find(value) != container.end();
-}
+  /// Make the element a set of its own
+  void makeSet(size_t index) {
+    m_parents[index].store(static_cast<IndexType>(index),
+                           std::memory_order_relaxed);
+  }
+
+  /// Is the element outside of all sets
+  bool isEmpty(size_t index) const {
+    return m_parents[index].load(std::memory_order_relaxed) == Empty;
+  }
+
+  /// Find the root of an element, halving the path to it on the way
+  IndexType find(IndexType index) {
+    while (true) {
+      IndexType parent = m_parents[index].load(std::memory_order_relaxed);
+      if (parent == index)
+        return index;
+      const IndexType grandParent =
+          m_parents[parent].load(std::memory_order_relaxed);
+      // Failing is harmless as a parent is only ever replaced by an ancestor
+      if (grandParent != parent)
+        m_parents[index].compare_exchange_weak(parent, grandParent);
+      index = grandParent;
+    }
+  }
 
-using EdgeIndexPair = boost::tuple<size_t, size_t>;
-using VecEdgeIndexPair = std::vector<EdgeIndexPair>;
+  /// Join the sets of two elements under the lower of their roots
+  void unite(IndexType a, IndexType b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return;
+      if (a < b)
+        std::swap(a, b);
+      // Only succeeds if a is still a root, otherwise try again
+      IndexType expected = a;
+      if (m_parents[a].compare_exchange_strong(expected, b))
+        return;
+    }
+  }
+
+private:
+  std::vector<std::atomic<IndexType>> m_parents;
+};
 
 /**
- * Free function performing the CCL implementation over a range defined by the
- *iterator.
+ * Label the connected clusters of non-background elements in the workspace.
+ *
+ * The image is split into a block for each thread. Each element is joined to
+ * its non-background neighbours with lower indexes, including those in other
+ * blocks, so there is no serial merge across the block boundaries. Labels
+ * are given to the clusters in the order of their lowest index, so they do
+ * not depend on the number of threads. A cluster spanning several blocks is
+ * made of a Cluster for each block.
  *
- * @param iterator : Iterator giving access the the image
- * @param strategy : Strategy for identifying background
- * @param neighbourElements : Grid of DisjointElements the same size as the
- *image
+ * @param ws : Workspace to label
+ * @param baseStrategy : Strategy for identifying background
  * @param progress : Progress object to update
- * @param maxNeighbours : Maximum number of neighbours each element may have.
- *Determined by dimensionality.
- * @param startLabelId : Start label index to increment
- * @param edgeIndexVec : Vector of edge index pairs. To identify elements across
- *iterator boundaries to resolve later.
- * @return
+ * @param nThreads : Number of blocks to process in parallel
+ * @param startId : Label of the first cluster
+ * @return Map of label ids to clusters
  */
-size_t doConnectedComponentLabeling(IMDIterator *iterator,
-                                    BackgroundStrategy *const strategy,
-                                    VecElements &neighbourElements,
-                                    Progress &progress, size_t maxNeighbours,
-                                    size_t startLabelId,
-                                    VecEdgeIndexPair &edgeIndexVec) {
-  size_t currentLabelCount = startLabelId;
-  strategy->configureIterator(
-      iterator); // Set up such things as desired Normalization.
-  do {
-    if (!strategy->isBackground(iterator)) {
-
-      size_t currentIndex = iterator->getLinearIndex();
-      progress.report();
-      // Linear indexes of neighbours
-      VecIndexes neighbourIndexes = iterator->findNeighbourIndexes();
-      VecIndexes nonEmptyNeighbourIndexes;
-      nonEmptyNeighbourIndexes.reserve(maxNeighbours);
-      SetIds neighbourIds;
-      // Discover non-empty neighbours
-      for (auto neighIndex : neighbourIndexes) {
-        if (!iterator->isWithinBounds(neighIndex)) {
-          /* Record labels which appear to belong to the same cluster, but
-           cannot be combined in this
-           pass and will later need to be conjoined and resolved. As Labels
-           cannot be guarnteed to be
-           correcly provided for all neighbours until the end. We must store
-           indexes instead.
-           */
-          edgeIndexVec.emplace_back(currentIndex, neighIndex);
-          continue;
-        }
-
-        const DisjointElement &neighbourElement = neighbourElements[neighIndex];
-
-        if (!neighbourElement.isEmpty()) {
-          nonEmptyNeighbourIndexes.push_back(neighIndex);
-          neighbourIds.insert(neighbourElement.getId());
-        }
+template <typename IndexType>
+ClusterMap labelClusters(IMDHistoWorkspace &ws,
+                         BackgroundStrategy *const baseStrategy,
+                         Progress &progress, int nThreads, size_t startId) {
+  const size_t nPoints = ws.getNPoints();
+  ParallelDisjointSet<IndexType> disjointSet(nPoints);
+  auto iterators = ws.createIterators(nThreads);
+  const auto nBlocks = static_cast<int>(iterators.size());
+  progress.resetNumSteps(4 * nBlocks, 0.0, 0.8);
+
+  // ------------- Stage one. Find the elements which are not background.
+  g_log.debug("Find non-background elements");
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nBlocks; ++i) {
+    API::IMDIterator *iterator = iterators[i].get();
+    // Share the strategy if there's only one block
+    boost::scoped_ptr<BackgroundStrategy> localStrategy(
+        nBlocks > 1 ? baseStrategy->clone() : nullptr);
+    BackgroundStrategy *strategy =
+        localStrategy ? localStrategy.get() : baseStrategy;
+    strategy->configureIterator(iterator);
+    do {
+      if (!strategy->isBackground(iterator)) {
+        disjointSet.makeSet(iterator->getLinearIndex());
       }
+    } while (iterator->next());
+    progress.report();
+  }
 
-      if (nonEmptyNeighbourIndexes.empty()) {
-        DisjointElement &element = neighbourElements[currentIndex];
-        element.setId(static_cast<int>(currentLabelCount));
-        ++currentLabelCount;
-      } else if (neighbourIds.size() ==
-                 1) // Do we have a single unique id amongst all neighbours.
-      {
-        neighbourElements[currentIndex] =
-            neighbourElements[nonEmptyNeighbourIndexes.front()]; // Copy
-                                                                 // non-empty
-                                                                 // neighbour
-      } else {
-        // Choose the lowest neighbour index as the parent.
-        size_t candidateSourceParentIndex = nonEmptyNeighbourIndexes[0];
-        for (size_t i = 1; i < nonEmptyNeighbourIndexes.size(); ++i) {
-          size_t neighIndex = nonEmptyNeighbourIndexes[i];
-          if (neighbourElements[neighIndex].getRoot() <
-              neighbourElements[candidateSourceParentIndex].getRoot()) {
-            candidateSourceParentIndex = neighIndex;
-          }
-        }
-        // Get the chosen parent
-        DisjointElement &parentElement =
-            neighbourElements[candidateSourceParentIndex];
-        // Union remainder parents with the chosen parent
-        for (auto neighIndex : nonEmptyNeighbourIndexes) {
-          if (neighIndex != candidateSourceParentIndex) {
-            neighbourElements[neighIndex].unionWith(&parentElement);
-          }
+  // ------------- Stage two. Join neighbouring elements.
+  g_log.debug("Join neighbouring elements");
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nBlocks; ++i) {
+    API::IMDIterator *iterator = iterators[i].get();
+    iterator->jumpTo(0); // Reset
+    do {
+      const size_t currentIndex = iterator->getLinearIndex();
+      if (disjointSet.isEmpty(currentIndex))
+        continue;
+      for (auto neighIndex : iterator->findNeighbourIndexes()) {
+        if (neighIndex < currentIndex && !disjointSet.isEmpty(neighIndex)) {
+          disjointSet.unite(static_cast<IndexType>(currentIndex),
+                            static_cast<IndexType>(neighIndex));
         }
+      }
+    } while (iterator->next());
+    progress.report();
+  }
+  iterators.clear();
 
-        neighbourElements[currentIndex].unionWith(&parentElement);
+  // ------------- Stage three. Find the roots in each block, in order.
+  g_log.debug("Find cluster roots");
+  std::vector<std::vector<IndexType>> blockRoots(nBlocks);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nBlocks; ++i) {
+    const size_t begin = (i * nPoints) / nBlocks;
+    const size_t end = ((i + 1) * nPoints) / nBlocks;
+    for (size_t index = begin; index < end; ++index) {
+      if (!disjointSet.isEmpty(index) &&
+          disjointSet.find(static_cast<IndexType>(index)) == index) {
+        blockRoots[i].push_back(static_cast<IndexType>(index));
       }
     }
-  } while (iterator->next());
-
-  return currentLabelCount;
-}
-
-Logger g_log("ConnectedComponentLabeling");
+    progress.report();
+  }
+  std::vector<IndexType> roots;
+  for (auto &block : blockRoots) {
+    roots.insert(roots.end(), block.begin(), block.end());
+    std::vector<IndexType>().swap(block);
+  }
 
-void memoryCheck(size_t nPoints) {
-  size_t sizeOfElement = (3 * sizeof(signal_t)) + sizeof(bool);
+  // ------------- Stage four. Add the elements of each block to clusters.
+  g_log.debug("Create clusters");
+  using BlockClusterMap =
+      std::unordered_map<IndexType, boost::shared_ptr<Cluster>>;
+  std::vector<BlockClusterMap> blockClusters(nBlocks);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nBlocks; ++i) {
+    const size_t begin = (i * nPoints) / nBlocks;
+    const size_t end = ((i + 1) * nPoints) / nBlocks;
+    BlockClusterMap &localClusters = blockClusters[i];
+    Cluster *currentCluster = nullptr;
+    IndexType currentRoot = ParallelDisjointSet<IndexType>::Empty;
+    for (size_t index = begin; index < end; ++index) {
+      if (disjointSet.isEmpty(index))
+        continue;
+      const IndexType root = disjointSet.find(static_cast<IndexType>(index));
+      // Neighbouring elements are usually in the same cluster
+      if (root != currentRoot) {
+        auto &cluster = localClusters[root];
+        if (!cluster) {
+          const auto ordinal = static_cast<size_t>(std::distance(
+              roots.cbegin(),
+              std::lower_bound(roots.cbegin(), roots.cend(), root)));
+          cluster = boost::make_shared<Cluster>(startId + ordinal);
+        }
+        currentCluster = cluster.get();
+        currentRoot = root;
+      }
+      currentCluster->addIndex(index);
+    }
+    progress.report();
+  }
 
-  MemoryStats memoryStats;
-  const size_t freeMemory = memoryStats.availMem();         // in kB
-  const size_t memoryCost = sizeOfElement * nPoints / 1000; // in kB
-  if (memoryCost > freeMemory) {
-    std::string basicMessage =
-        "CCL requires more free memory than you have available.";
-    std::stringstream sstream;
-    sstream << basicMessage << " Requires " << memoryCost
-            << " KB of contiguous memory.";
-    g_log.notice(sstream.str());
-    throw std::runtime_error(basicMessage);
+  // Combine the parts of clusters found in several blocks.
+  ClusterMap clusterMap;
+  for (auto &localClusters : blockClusters) {
+    for (auto &rootCluster : localClusters) {
+      boost::shared_ptr<ICluster> cluster = rootCluster.second;
+      auto &entry = clusterMap[cluster->getLabel()];
+      if (!entry) {
+        entry = cluster;
+        continue;
+      }
+      auto composite = boost::dynamic_pointer_cast<CompositeCluster>(entry);
+      if (!composite) {
+        composite = boost::make_shared<CompositeCluster>();
+        composite->add(entry);
+        entry = composite;
+      }
+      composite->add(cluster);
+    }
+    BlockClusterMap().swap(localClusters);
   }
+  return clusterMap;
 }
 } // namespace
 
@@ -270,7 +344,7 @@ int ConnectedComponentLabeling::getNThreads() const {
 /**
  * Perform the work of the CCL algorithm
  * - Pre filtering of background
- * - Labeling using DisjointElements
+ * - Labeling using a disjoint-set forest over the image
  *
  * @param ws : MDHistoWorkspace to run CCL algorithm on
  * @param baseStrategy : Background strategy
@@ -280,120 +354,15 @@ int ConnectedComponentLabeling::getNThreads() const {
 ClusterMap ConnectedComponentLabeling::calculateDisjointTree(
     IMDHistoWorkspace_sptr ws, BackgroundStrategy *const baseStrategy,
     Progress &progress) const {
-  std::map<size_t, boost::shared_ptr<ICluster>> clusterMap;
-  VecElements neighbourElements(ws->getNPoints());
-
-  const size_t maxNeighbours = calculateMaxNeighbours(ws.get());
-
   progress.doReport("Identifying clusters");
-  size_t frequency = reportEvery<size_t>(10000, ws->getNPoints());
-  progress.resetNumSteps(frequency, 0.0, 0.8);
-
-  // For each process maintains pair of index from within process bounds to
-  // index outside process bounds
   const int nThreadsToUse = getNThreads();
-
-  if (nThreadsToUse > 1) {
-    auto iterators = ws->createIterators(nThreadsToUse);
-    const size_t maxClustersPossible =
-        calculateMaxClusters(ws.get(), nThreadsToUse);
-
-    std::vector<VecEdgeIndexPair> parallelEdgeVec(nThreadsToUse);
-
-    std::vector<std::map<size_t, boost::shared_ptr<Cluster>>>
-        parallelClusterMapVec(nThreadsToUse);
-
-    // ------------- Stage One. Local CCL in parallel.
-    g_log.debug("Parallel solve local CCL");
-    // PARALLEL_FOR_NO_WSP_CHECK()
-    for (int i = 0; i < nThreadsToUse; ++i) {
-      API::IMDIterator *iterator = iterators[i].get();
-      boost::scoped_ptr<BackgroundStrategy> strategy(
-          baseStrategy->clone());                     // local strategy
-      VecEdgeIndexPair &edgeVec = parallelEdgeVec[i]; // local edge indexes
-
-      const size_t startLabel =
-          m_startId + (i * maxClustersPossible); // Ensure that label ids are
-                                                 // totally unique within each
-                                                 // parallel unit.
-      const size_t endLabel = doConnectedComponentLabeling(
-          iterator, strategy.get(), neighbourElements, progress, maxNeighbours,
-          startLabel, edgeVec);
-
-      // Create clusters from labels.
-      std::map<size_t, boost::shared_ptr<Cluster>> &localClusterMap =
-          parallelClusterMapVec[i]; // local cluster map.
-      for (size_t labelId = startLabel; labelId != endLabel; ++labelId) {
-        auto cluster = boost::make_shared<Cluster>(
-            labelId); // Create a cluster for the label and key it by the label.
-        localClusterMap[labelId] = cluster;
-      }
-
-      // Associate the member DisjointElements with a cluster. Involves looping
-      // back over iterator.
-      iterator->jumpTo(0); // Reset
-      do {
-        if (!baseStrategy->isBackground(iterator)) {
-          // Second pass smoothing step
-          const size_t currentIndex = iterator->getLinearIndex();
-
-          const size_t &labelAtIndex =
-              neighbourElements[currentIndex].getRoot();
-          localClusterMap[labelAtIndex]->addIndex(currentIndex);
-        }
-      } while (iterator->next());
-    }
-
-    // -------------------- Stage 2 --- Preparation stage for combining
-    // equivalent clusters. Must be done in sequence.
-    // Combine cluster maps processed by each thread.
-    ClusterRegister clusterRegister;
-    for (const auto &parallelClusterMap : parallelClusterMapVec) {
-      for (const auto &cluster : parallelClusterMap) {
-        clusterRegister.add(cluster.first, cluster.second);
-      }
-    }
-
-    // Percolate minimum label across boundaries for indexes where there is
-    // ambiguity.
-    g_log.debug("Percolate minimum label across boundaries");
-
-    for (auto &indexPairVec : parallelEdgeVec) {
-      for (auto &iit : indexPairVec) {
-        DisjointElement &a = neighbourElements[iit.get<0>()];
-        DisjointElement &b = neighbourElements[iit.get<1>()];
-        clusterRegister.merge(a, b);
-      }
-    }
-    clusterMap = clusterRegister.clusters(neighbourElements);
-
-  } else {
-    auto iterator = ws->createIterator(nullptr);
-    VecEdgeIndexPair edgeIndexPair; // This should never get filled in a single
-                                    // threaded situation.
-    size_t endLabelId = doConnectedComponentLabeling(
-        iterator.get(), baseStrategy, neighbourElements, progress,
-        maxNeighbours, m_startId, edgeIndexPair);
-
-    // Create clusters from labels.
-    for (size_t labelId = m_startId; labelId != endLabelId; ++labelId) {
-      auto cluster = boost::make_shared<Cluster>(
-          labelId); // Create a cluster for the label and key it by the label.
-      clusterMap[labelId] = cluster;
-    }
-
-    // Associate the member DisjointElements with a cluster. Involves looping
-    // back over iterator.
-    iterator->jumpTo(0); // Reset
-    do {
-      const size_t currentIndex = iterator->getLinearIndex();
-      if (!baseStrategy->isBackground(iterator.get())) {
-        const int labelAtIndex = neighbourElements[currentIndex].getRoot();
-        clusterMap[labelAtIndex]->addIndex(currentIndex);
-      }
-    } while (iterator->next());
+  // Use the smallest disjoint-set entries that can index the whole image
+  if (useCompactLabels(ws->getNPoints())) {
+    return labelClusters<uint32_t>(*ws, baseStrategy, progress, nThreadsToUse,
+                                   m_startId);
   }
-  return clusterMap;
+  return labelClusters<uint64_t>(*ws, baseStrategy, progress, nThreadsToUse,
+                                 m_startId);
 }
 
 /**
@@ -425,7 +394,9 @@ ClusterTuple ConnectedComponentLabeling::executeAndFetchClusters(
     IMDHistoWorkspace_sptr ws, BackgroundStrategy *const strategy,
     Progress &progress) const {
   // Can we run the analysis
-  memoryCheck(ws->getNPoints());
+  const size_t nPoints = ws->getNPoints();
+  memoryCheck(nPoints, useCompactLabels(nPoints) ? sizeof(uint32_t)
+                                                 : sizeof(uint64_t));
 
   // Perform the bulk of the connected component analysis, but don't collapse
   // the elements yet.
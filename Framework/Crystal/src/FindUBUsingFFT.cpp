@@ -11,6 +11,9 @@
 #include "MantidGeometry/Crystal/OrientedLattice.h"
 #include "MantidKernel/BoundedValidator.h"
 
+#include <map>
+#include <mutex>
+
 namespace Mantid {
 namespace Crystal {
 // Register the algorithm into the AlgorithmFactory
@@ -21,6 +24,17 @@ using namespace Mantid::API;
 using namespace Mantid::DataObjects;
 using namespace Mantid::Geometry;
 
+namespace {
+/// Real space unit cell edges of the last UB found for each instrument and
+/// sample, so later runs of a rotation series can start from them
+std::map<std::string, std::vector<V3D>> g_previousDirections;
+std::mutex g_previousDirectionsMutex;
+
+std::string previousDirectionsKey(const PeaksWorkspace &ws) {
+  return ws.getInstrument()->getName() + ":" + ws.sample().getName();
+}
+} // namespace
+
 const std::string FindUBUsingFFT::name() const { return "FindUBUsingFFT"; }
 
 int FindUBUsingFFT::version() const { return 1; }
@@ -51,6 +65,11 @@ void FindUBUsingFFT::init() {
                         "The resolution of the search through possible "
                         "orientations is specified by this parameter.  One to "
                         "two degrees per step is usually adequate.");
+  this->declareProperty(
+      "ReuseDirections", false,
+      "Try the unit cell edges of the last UB found by this algorithm for the "
+      "same instrument and sample before scanning all directions. This saves "
+      "time when indexing the runs of a rotation series of one crystal.");
 }
 
 /** Execute the algorithm.
@@ -62,8 +81,10 @@ void FindUBUsingFFT::exec() {
   int iterations = this->getProperty("Iterations");
 
   double degrees_per_step = this->getProperty("DegreesPerStep");
+  const bool reuse_directions = this->getProperty("ReuseDirections");
 
   PeaksWorkspace_sptr ws = this->getProperty("PeaksWorkspace");
+  const std::string directions_key = previousDirectionsKey(*ws);
 
   const std::vector<Peak> &peaks = ws->getPeaks();
   size_t n_peaks = ws->getNumberPeaks();
@@ -73,9 +94,18 @@ void FindUBUsingFFT::exec() {
     q_vectors.push_back(peaks[i].getQSampleFrame());
   }
 
+  std::vector<V3D> prior_directions;
+  if (reuse_directions) {
+    std::lock_guard<std::mutex> lock(g_previousDirectionsMutex);
+    const auto previous = g_previousDirections.find(directions_key);
+    if (previous != g_previousDirections.end())
+      prior_directions = previous->second;
+  }
+
   Matrix<double> UB(3, 3, false);
-  double error = IndexingUtils::Find_UB(UB, q_vectors, min_d, max_d, tolerance,
-                                        degrees_per_step, iterations);
+  double error =
+      IndexingUtils::Find_UB(UB, q_vectors, min_d, max_d, tolerance,
+                             degrees_per_step, iterations, prior_directions);
 
   g_log.notice() << "Error = " << error << '\n';
   g_log.notice() << "UB = " << UB << '\n';
@@ -111,6 +141,15 @@ void FindUBUsingFFT::exec() {
     g_log.notice() << o_lattice << "\n";
 
     ws->mutableSample().setOrientedLattice(&o_lattice);
+
+    DblMatrix UB_inv(UB);
+    UB_inv.Invert();
+    std::vector<V3D> abc_directions;
+    for (size_t row = 0; row < 3; row++)
+      abc_directions.emplace_back(UB_inv[row][0], UB_inv[row][1],
+                                  UB_inv[row][2]);
+    std::lock_guard<std::mutex> lock(g_previousDirectionsMutex);
+    g_previousDirections[directions_key] = std::move(abc_directions);
   }
 }
 
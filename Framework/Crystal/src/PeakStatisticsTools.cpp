@@ -9,10 +9,13 @@
 #include "MantidGeometry/Crystal/BasicHKLFilters.h"
 #include "MantidGeometry/Crystal/HKLGenerator.h"
 
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/Statistics.h"
 
 #include <boost/make_shared.hpp>
+#include <cmath>
 #include <numeric>
+#include <unordered_map>
 
 namespace Mantid {
 namespace Crystal {
@@ -22,6 +25,61 @@ using namespace Mantid::DataObjects;
 using namespace Mantid::Geometry;
 using namespace Mantid::Kernel;
 
+namespace {
+using IntHKL = std::array<int, 3>;
+
+/// Indices beyond this are not packed into hash keys, no cell is that large.
+constexpr int MAX_HKL_INDEX = 1 << 20;
+
+/// Converts a rounded HKL to integers, returns false for unusable indices.
+bool toIntHKL(const V3D &hkl, IntHKL &intHKL) {
+  for (size_t i = 0; i < 3; ++i) {
+    if (!(std::abs(hkl[i]) < MAX_HKL_INDEX))
+      return false;
+    intHKL[i] = static_cast<int>(std::lround(hkl[i]));
+  }
+  return true;
+}
+
+/// Packs the three indices into one key for the hash table.
+int64_t packHKL(const IntHKL &hkl) {
+  return ((static_cast<int64_t>(hkl[0]) + MAX_HKL_INDEX) << 42) |
+         ((static_cast<int64_t>(hkl[1]) + MAX_HKL_INDEX) << 21) |
+         (static_cast<int64_t>(hkl[2]) + MAX_HKL_INDEX);
+}
+
+/**
+ * Integer version of PointGroup::getReflectionFamily. std::array compares
+ * lexicographically like V3D, so the same representative is chosen.
+ */
+template <typename Operations>
+IntHKL getReflectionFamily(const Operations &operations, const IntHKL &hkl) {
+  IntHKL family{{0, 0, 0}};
+  bool first = true;
+  for (const auto &m : operations) {
+    const IntHKL equivalent{{m[0] * hkl[0] + m[1] * hkl[1] + m[2] * hkl[2],
+                             m[3] * hkl[0] + m[4] * hkl[1] + m[5] * hkl[2],
+                             m[6] * hkl[0] + m[7] * hkl[1] + m[8] * hkl[2]}};
+    if (first || family < equivalent) {
+      family = equivalent;
+      first = false;
+    }
+  }
+  return family;
+}
+
+V3D toV3D(const IntHKL &hkl) { return V3D(hkl[0], hkl[1], hkl[2]); }
+
+/// Merging statistics of one unique reflection, summed up in map order.
+struct ReflectionStatistics {
+  double iOverSigmaSum = 0.0;
+  double chiSquared = 0.0;
+  double rMergeNumerator = 0.0;
+  double rPimNumerator = 0.0;
+  double intensitySum = 0.0;
+};
+} // namespace
+
 /// Returns a vector with the wavelengths of the Peaks stored in this
 /// reflection.
 std::vector<double> UniqueReflection::getWavelengths() const {
@@ -121,7 +179,8 @@ UniqueReflectionCollection::UniqueReflectionCollection(
     const UnitCell &cell, const std::pair<double, double> &dLimits,
     const PointGroup_sptr &pointGroup,
     const ReflectionCondition_sptr &centering)
-    : m_reflections(), m_pointgroup(pointGroup) {
+    : m_reflections(), m_pointgroup(pointGroup),
+      m_hklOperations(getHKLOperations(pointGroup)) {
   HKLGenerator generator(cell, dLimits.first);
   auto dFilter = boost::make_shared<const HKLFilterDRange>(cell, dLimits.first,
                                                            dLimits.second);
@@ -129,30 +188,73 @@ UniqueReflectionCollection::UniqueReflectionCollection(
       boost::make_shared<const HKLFilterCentering>(centering);
   auto filter = dFilter & centeringFilter;
 
-  // Generate map of UniqueReflection-objects with reflection family as key.
-  for (const auto &hkl : generator) {
-    if (filter->isAllowed(hkl)) {
-      V3D hklFamily = m_pointgroup->getReflectionFamily(hkl);
-      m_reflections.emplace(hklFamily, UniqueReflection(hklFamily));
+  std::vector<V3D> hkls(generator.begin(), generator.end());
+  std::vector<IntHKL> families(hkls.size());
+  std::vector<char> allowed(hkls.size(), 0);
+
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(hkls.size()); ++i) {
+    IntHKL hkl;
+    if (filter->isAllowed(hkls[i]) && toIntHKL(hkls[i], hkl)) {
+      families[i] = getReflectionFamily(m_hklOperations, hkl);
+      allowed[i] = 1;
     }
   }
+
+  std::vector<IntHKL> uniqueFamilies;
+  uniqueFamilies.reserve(families.size());
+  for (size_t i = 0; i < families.size(); ++i) {
+    if (allowed[i])
+      uniqueFamilies.push_back(families[i]);
+  }
+  std::sort(uniqueFamilies.begin(), uniqueFamilies.end());
+  uniqueFamilies.erase(
+      std::unique(uniqueFamilies.begin(), uniqueFamilies.end()),
+      uniqueFamilies.end());
+
+  // Generate map of UniqueReflection-objects with reflection family as key.
+  // The families are sorted in the map's order, so every insert is at the
+  // end.
+  for (const auto &family : uniqueFamilies) {
+    const V3D hklFamily = toV3D(family);
+    m_reflections.emplace_hint(m_reflections.end(), hklFamily,
+                               UniqueReflection(hklFamily));
+  }
 }
 
 /// Assigns the supplied peaks to the proper UniqueReflection. Peaks for which
 /// the reflection family can not be found are ignored.
 void UniqueReflectionCollection::addObservations(
     const std::vector<Peak> &peaks) {
-  for (auto const &peak : peaks) {
-    V3D hkl = peak.getHKL();
-    hkl.round();
+  std::unordered_map<int64_t, UniqueReflection *> reflectionsByFamily;
+  reflectionsByFamily.reserve(m_reflections.size());
+  for (auto &reflection : m_reflections) {
+    IntHKL family;
+    if (toIntHKL(reflection.first, family))
+      reflectionsByFamily.emplace(packHKL(family), &reflection.second);
+  }
 
-    auto reflection =
-        m_reflections.find(m_pointgroup->getReflectionFamily(hkl));
+  std::vector<UniqueReflection *> targets(peaks.size(), nullptr);
+
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(peaks.size()); ++i) {
+    V3D hkl = peaks[i].getHKL();
+    hkl.round();
 
-    if (reflection != m_reflections.end()) {
-      (*reflection).second.addPeak(peak);
+    IntHKL intHKL;
+    if (toIntHKL(hkl, intHKL)) {
+      auto reflection = reflectionsByFamily.find(
+          packHKL(getReflectionFamily(m_hklOperations, intHKL)));
+      if (reflection != reflectionsByFamily.end())
+        targets[i] = reflection->second;
     }
   }
+
+  // Peaks are appended in input order, as before.
+  for (size_t i = 0; i < peaks.size(); ++i) {
+    if (targets[i])
+      targets[i]->addPeak(peaks[i]);
+  }
 }
 
 /// Returns a copy of the UniqueReflection with the supplied HKL. Raises an
@@ -203,6 +305,28 @@ size_t UniqueReflectionCollection::getObservedReflectionCount() const {
       });
 }
 
+/// Integer matrices of the point group's operations acting on HKL. They are
+/// obtained from the images of the unit vectors, which are exact integers.
+std::vector<UniqueReflectionCollection::HKLOperation>
+UniqueReflectionCollection::getHKLOperations(
+    const PointGroup_sptr &pointGroup) {
+  const auto operations = pointGroup->getSymmetryOperations();
+  std::vector<HKLOperation> hklOperations;
+  hklOperations.reserve(operations.size());
+  for (const auto &operation : operations) {
+    HKLOperation matrix;
+    for (size_t column = 0; column < 3; ++column) {
+      V3D unit;
+      unit[column] = 1.0;
+      const V3D image = operation.transformHKL(unit);
+      for (size_t row = 0; row < 3; ++row)
+        matrix[3 * row + column] = static_cast<int>(std::lround(image[row]));
+    }
+    hklOperations.push_back(matrix);
+  }
+  return hklOperations;
+}
+
 /// Returns the internally stored reflection map. May disappear or change if
 /// implementation changes.
 const std::map<V3D, UniqueReflection> &
@@ -231,70 +355,99 @@ void PeaksStatistics::calculatePeaksStatistics(
     const std::map<V3D, UniqueReflection> &uniqueReflections,
     std::string &equivalentIntensities, double &sigmaCritical,
     bool &weightedZ) {
+  /* Since all possible unique reflections are explored
+   * there may be 0 observations for some of them.
+   * In that case, nothing can be done.*/
+  std::vector<const UniqueReflection *> observed;
+  for (const auto &unique : uniqueReflections) {
+    if (unique.second.count() > 0)
+      observed.push_back(&unique.second);
+  }
+
+  std::vector<UniqueReflection> merged;
+  merged.reserve(observed.size());
+  for (const auto unique : observed)
+    merged.emplace_back(unique->getHKL());
+  std::vector<ReflectionStatistics> statistics(observed.size());
+  const bool useMedian = equivalentIntensities == "Median";
+
+  // Checked here, exceptions can not leave the parallel loop.
+  if (!observed.empty() && sigmaCritical <= 0.0) {
+    throw std::invalid_argument(
+        "Critical sigma value has to be greater than 0.");
+  }
+
+  // Reflections are independent of each other, the sums are formed afterwards
+  // in map order so that the result does not depend on the thread count.
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(observed.size()); ++i) {
+    // Possibly remove outliers.
+    merged[i] = observed[i]->removeOutliers(sigmaCritical, weightedZ);
+    const auto &outliersRemoved = merged[i];
+    auto &current = statistics[i];
+
+    // I/sigma is calculated for all reflections, even if there is only one
+    // observation.
+    auto intensities = outliersRemoved.getIntensities();
+    auto sigmas = outliersRemoved.getSigmas();
+
+    current.iOverSigmaSum = getIOverSigmaSum(sigmas, intensities);
+
+    if (outliersRemoved.count() > 1) {
+      // Get mean, standard deviation for intensities
+      auto intensityStatistics = Kernel::getStatistics(
+          intensities, StatOptions::Mean | StatOptions::UncorrectedStdDev |
+                           StatOptions::Median);
+
+      double meanIntensity = intensityStatistics.mean;
+      if (useMedian)
+        meanIntensity = intensityStatistics.median;
+
+      /* This was in the original algorithm, not entirely sure where it is
+       * used. It's basically the sum of all relative standard deviations.
+       * In a perfect data set with all equivalent reflections exactly
+       * equivalent that would be 0. */
+      current.chiSquared =
+          intensityStatistics.standard_deviation / meanIntensity;
+
+      // For both RMerge and RPim sum(|I - <I>|) is required
+      double sumOfDeviationsFromMean =
+          std::accumulate(intensities.begin(), intensities.end(), 0.0,
+                          [meanIntensity](double sum, double intensity) {
+                            return sum + fabs(intensity - meanIntensity);
+                          });
+
+      current.rMergeNumerator = sumOfDeviationsFromMean;
+
+      // For Rpim, the sum is weighted by a factor depending on N
+      double rPimFactor =
+          sqrt(1.0 / (static_cast<double>(outliersRemoved.count()) - 1.0));
+      current.rPimNumerator = rPimFactor * sumOfDeviationsFromMean;
+
+      // Collect sum of intensities for R-value calculation
+      current.intensitySum =
+          std::accumulate(intensities.begin(), intensities.end(), 0.0);
+    }
+  }
+
   double rMergeNumerator = 0.0;
   double rPimNumerator = 0.0;
   double intensitySumRValues = 0.0;
   double iOverSigmaSum = 0.0;
 
-  for (const auto &unique : uniqueReflections) {
-    /* Since all possible unique reflections are explored
-     * there may be 0 observations for some of them.
-     * In that case, nothing can be done.*/
-    if (unique.second.count() > 0) {
-      ++m_uniqueReflections;
-
-      // Possibly remove outliers.
-      auto outliersRemoved =
-          unique.second.removeOutliers(sigmaCritical, weightedZ);
-
-      // I/sigma is calculated for all reflections, even if there is only one
-      // observation.
-      auto intensities = outliersRemoved.getIntensities();
-      auto sigmas = outliersRemoved.getSigmas();
-
-      // Accumulate the I/sigma's for current reflection into sum
-      iOverSigmaSum += getIOverSigmaSum(sigmas, intensities);
-
-      if (outliersRemoved.count() > 1) {
-        // Get mean, standard deviation for intensities
-        auto intensityStatistics = Kernel::getStatistics(
-            intensities, StatOptions::Mean | StatOptions::UncorrectedStdDev |
-                             StatOptions::Median);
-
-        double meanIntensity = intensityStatistics.mean;
-        if (equivalentIntensities == "Median")
-          meanIntensity = intensityStatistics.median;
-
-        /* This was in the original algorithm, not entirely sure where it is
-         * used. It's basically the sum of all relative standard deviations.
-         * In a perfect data set with all equivalent reflections exactly
-         * equivalent that would be 0. */
-        m_chiSquared += intensityStatistics.standard_deviation / meanIntensity;
-
-        // For both RMerge and RPim sum(|I - <I>|) is required
-        double sumOfDeviationsFromMean =
-            std::accumulate(intensities.begin(), intensities.end(), 0.0,
-                            [meanIntensity](double sum, double intensity) {
-                              return sum + fabs(intensity - meanIntensity);
-                            });
-
-        // Accumulate into total sum for numerator of RMerge
-        rMergeNumerator += sumOfDeviationsFromMean;
-
-        // For Rpim, the sum is weighted by a factor depending on N
-        double rPimFactor =
-            sqrt(1.0 / (static_cast<double>(outliersRemoved.count()) - 1.0));
-        rPimNumerator += (rPimFactor * sumOfDeviationsFromMean);
-
-        // Collect sum of intensities for R-value calculation
-        intensitySumRValues +=
-            std::accumulate(intensities.begin(), intensities.end(), 0.0);
-      }
+  for (size_t i = 0; i < merged.size(); ++i) {
+    ++m_uniqueReflections;
 
-      const std::vector<Peak> &reflectionPeaks = outliersRemoved.getPeaks();
-      m_peaks.insert(m_peaks.end(), reflectionPeaks.begin(),
-                     reflectionPeaks.end());
-    }
+    const auto &current = statistics[i];
+    iOverSigmaSum += current.iOverSigmaSum;
+    m_chiSquared += current.chiSquared;
+    rMergeNumerator += current.rMergeNumerator;
+    rPimNumerator += current.rPimNumerator;
+    intensitySumRValues += current.intensitySum;
+
+    const std::vector<Peak> &reflectionPeaks = merged[i].getPeaks();
+    m_peaks.insert(m_peaks.end(), reflectionPeaks.begin(),
+                   reflectionPeaks.end());
   }
 
   m_measuredReflections = static_cast<int>(m_peaks.size());
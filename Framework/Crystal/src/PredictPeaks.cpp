@@ -23,6 +23,7 @@
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/EnabledWhenProperty.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/make_unique.h"
 
 #include <fstream>
@@ -299,6 +300,7 @@ void PredictPeaks::exec() {
 
   m_detectorCacheSearch =
       Kernel::make_unique<DetectorSearcher>(m_inst, m_pw->detectorInfo());
+  m_useExtendedDetectorSpace = getProperty("PredictPeaksOutsideDetectors");
 
   if (getProperty("CalculateGoniometerForCW")) {
     size_t allowedPeakCount = 0;
@@ -338,33 +340,32 @@ void PredictPeaks::exec() {
     logNumberOfPeaksFound(allowedPeakCount);
 
   } else {
+    if (m_useExtendedDetectorSpace &&
+        !m_inst->getComponentByName("extended-detector-space")) {
+      g_log.warning() << "Attempting to find peaks outside of detectors but "
+                         "no extended detector space has been defined\n";
+    }
+
+    std::vector<V3D> allowedHKLs;
+    std::vector<V3D> qs;
     for (auto &goniometerMatrix : gonioVec) {
       // Final transformation matrix (HKL to Q in lab frame)
       DblMatrix orientedUB = goniometerMatrix * ub;
 
       /* Because of the additional filtering step it's better to keep track of
-       * the allowed peaks with a counter. */
+       * the allowed peaks with a counter. The detectors hit by all the
+       * allowed peaks are searched for at once. */
       HKLFilterWavelength lambdaFilter(orientedUB, lambdaMin, lambdaMax);
-
-      size_t allowedPeakCount = 0;
-
-      bool useExtendedDetectorSpace =
-          getProperty("PredictPeaksOutsideDetectors");
-      if (useExtendedDetectorSpace &&
-          !m_inst->getComponentByName("extended-detector-space")) {
-        g_log.warning() << "Attempting to find peaks outside of detectors but "
-                           "no extended detector space has been defined\n";
+      calculateQForAllowedHKLs(possibleHKLs, orientedUB, lambdaFilter,
+                               allowedHKLs, qs);
+      const auto searchResults = m_detectorCacheSearch->findDetectorIndices(qs);
+      for (size_t i = 0; i < allowedHKLs.size(); ++i) {
+        addPeakToOutput(allowedHKLs[i], qs[i], searchResults[i],
+                        goniometerMatrix);
       }
+      prog.reportIncrement(possibleHKLs.size());
 
-      for (auto &possibleHKL : possibleHKLs) {
-        if (lambdaFilter.isAllowed(possibleHKL)) {
-          calculateQAndAddToOutput(possibleHKL, orientedUB, goniometerMatrix);
-          ++allowedPeakCount;
-        }
-        prog.report();
-      }
-
-      logNumberOfPeaksFound(allowedPeakCount);
+      logNumberOfPeaksFound(allowedHKLs.size());
     }
   }
 
@@ -457,6 +458,14 @@ void PredictPeaks::fillPossibleHKLsUsingGenerator(
   double dMin = getProperty("MinDSpacing");
   double dMax = getProperty("MaxDSpacing");
 
+  // A reflection can only diffract wavelengths of up to twice its d-spacing,
+  // so those with shorter d-spacings than half the minimum wavelength would
+  // all be removed by the wavelength filter.
+  if (!getProperty("CalculateGoniometerForCW")) {
+    const double lambdaMin = getProperty("WavelengthMin");
+    dMin = std::max(dMin, 0.5 * lambdaMin);
+  }
+
   // --- Reflection condition ----
   // Use the primitive by default
   ReflectionCondition_sptr refCond =
@@ -545,6 +554,46 @@ void PredictPeaks::setStructureFactorCalculatorFromSample(
   }
 }
 
+/**
+ * @brief Calculates Q of all the HKLs allowed by the wavelength limits
+ *
+ * Q in the lab frame is calculated for every HKL in parallel using the
+ * oriented UB matrix (UB multiplied by the goniometer matrix) and the HKLs
+ * are filtered by wavelength.
+ *
+ * @param possibleHKLs :: HKLs to calculate Q for
+ * @param orientedUB :: UB multiplied by the goniometer matrix
+ * @param filter :: wavelength filter made with the same oriented UB matrix
+ * @param allowedHKLs :: filled with the allowed HKLs, in the same order
+ * @param qs :: filled with the Q lab vectors of the allowed HKLs
+ */
+void PredictPeaks::calculateQForAllowedHKLs(
+    const std::vector<V3D> &possibleHKLs, const DblMatrix &orientedUB,
+    const HKLFilterWavelength &filter, std::vector<V3D> &allowedHKLs,
+    std::vector<V3D> &qs) const {
+  const auto numHKLs = static_cast<int64_t>(possibleHKLs.size());
+  std::vector<V3D> qLab(possibleHKLs.size());
+  std::vector<char> allowed(possibleHKLs.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < numHKLs; ++i) {
+    allowed[i] = filter.isAllowed(possibleHKLs[i]);
+    if (allowed[i])
+      qLab[i] = orientedUB * possibleHKLs[i];
+  }
+
+  // The q-vector direction of the peak is = goniometer * ub * hkl_vector
+  // This is in inelastic convention: momentum transfer of the LATTICE!
+  // Also, q does have a 2pi factor = it is equal to 2pi/wavelength.
+  allowedHKLs.clear();
+  qs.clear();
+  for (size_t i = 0; i < possibleHKLs.size(); ++i) {
+    if (allowed[i]) {
+      allowedHKLs.push_back(possibleHKLs[i]);
+      qs.push_back(qLab[i] * (2.0 * M_PI * m_qConventionFactor));
+    }
+  }
+}
+
 /**
  * @brief Calculates Q from HKL and adds a peak to the output workspace
  *
@@ -565,17 +614,34 @@ void PredictPeaks::calculateQAndAddToOutput(const V3D &hkl,
   // This is in inelastic convention: momentum transfer of the LATTICE!
   // Also, q does have a 2pi factor = it is equal to 2pi/wavelength.
   const auto q = orientedUB * hkl * (2.0 * M_PI * m_qConventionFactor);
+  addPeakToOutput(hkl, q, m_detectorCacheSearch->findDetectorIndex(q),
+                  goniometerMatrix);
+}
+
+/**
+ * @brief Adds the peak of an HKL to the output workspace
+ *
+ * A Peak-object is created at the detector found for its Q-vector. If no
+ * detector was hit, the peak is only added if it can be placed in extended
+ * detector space.
+ *
+ * @param hkl :: HKL of the peak
+ * @param q :: Q lab vector of the peak
+ * @param searchResult :: the detector search result for the Q-vector
+ * @param goniometerMatrix :: the goniometer matrix of the peak
+ */
+void PredictPeaks::addPeakToOutput(
+    const V3D &hkl, const V3D &q,
+    const DetectorSearcher::DetectorSearchResult &searchResult,
+    const DblMatrix &goniometerMatrix) {
   const auto params = getPeakParametersFromQ(q);
   const auto detectorDir = std::get<0>(params);
   const auto wl = std::get<1>(params);
 
-  const bool useExtendedDetectorSpace =
-      getProperty("PredictPeaksOutsideDetectors");
-  const auto result = m_detectorCacheSearch->findDetectorIndex(q);
-  const auto hitDetector = std::get<0>(result);
-  const auto index = std::get<1>(result);
+  const auto hitDetector = std::get<0>(searchResult);
+  const auto index = std::get<1>(searchResult);
 
-  if (!hitDetector && !useExtendedDetectorSpace) {
+  if (!hitDetector && !m_useExtendedDetectorSpace) {
     return;
   }
 
@@ -589,7 +655,7 @@ void PredictPeaks::calculateQAndAddToOutput(const V3D &hkl,
     if (!peak->getDetector())
       return;
 
-  } else if (useExtendedDetectorSpace) {
+  } else if (m_useExtendedDetectorSpace) {
     // use extended detector space to try and guess peak position
     const auto returnedComponent =
         m_inst->getComponentByName("extended-detector-space");
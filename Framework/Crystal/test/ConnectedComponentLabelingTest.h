@@ -20,6 +20,7 @@
 #include "MantidCrystal/BackgroundStrategy.h"
 #include "MantidCrystal/ConnectedComponentLabeling.h"
 #include "MantidCrystal/HardThresholdBackground.h"
+#include "MantidCrystal/ICluster.h"
 #include "MantidTestHelpers/MDEventsTestHelper.h"
 #include "MockObjects.h"
 
@@ -96,7 +97,7 @@ public:
 
     MockBackgroundStrategy mockStrategy;
     EXPECT_CALL(mockStrategy, isBackground(_))
-        .Times(static_cast<int>(inWS->getNPoints()) * 2)
+        .Times(static_cast<int>(inWS->getNPoints()))
         .WillRepeatedly(Return(false)); // A filter that passes everything.
     EXPECT_CALL(mockStrategy, configureIterator(_)).Times(1);
     size_t labelingId = 1;
@@ -120,7 +121,7 @@ public:
 
     MockBackgroundStrategy mockStrategy;
     EXPECT_CALL(mockStrategy, isBackground(_))
-        .Times(static_cast<int>(inWS->getNPoints()) * 2)
+        .Times(static_cast<int>(inWS->getNPoints()))
         .WillRepeatedly(Return(false)); // A filter that passes everything.
     EXPECT_CALL(mockStrategy, configureIterator(_)).Times(1);
     size_t labelingId = 2;
@@ -160,14 +161,6 @@ public:
         .WillOnce(Return(false))
         .WillOnce(Return(false))
         .WillOnce(Return(false))
-        // And because we are calling it twice. Repeat pattern
-        .WillOnce(Return(false))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true)) // is background
-        .WillOnce(Return(false))
-        .WillOnce(Return(false))
-        .WillOnce(Return(false))
-
         .WillRepeatedly(Return(false));
 
     size_t labelingId = 1;
@@ -196,12 +189,6 @@ public:
     /*
      * We use the is background strategy to set up three disconected blocks for us.
      * */ EXPECT_CALL(mockStrategy, isBackground(_))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true)) // is background
-        .WillOnce(Return(false))
-        .WillOnce(Return(true)) // is background
-        .WillOnce(Return(false))
-        // Repeat pattern because we are calling twice
         .WillOnce(Return(false))
         .WillOnce(Return(true)) // is background
         .WillOnce(Return(false))
@@ -257,16 +244,6 @@ public:
     /*
      * We treat alternate cells as background, which actually should result in a single object. Think of a chequered flag.
      * */ EXPECT_CALL(mockStrategy, isBackground(_))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        // Repeat because called twice
         .WillOnce(Return(true))
         .WillOnce(Return(false))
         .WillOnce(Return(true))
@@ -302,34 +279,6 @@ public:
     /*
      * We treat alternate cells as background, which actually should result in a single object. Think of a chequered flag.
      * */ EXPECT_CALL(mockStrategy, isBackground(_))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        .WillOnce(Return(false))
-        .WillOnce(Return(true))
-        // Repeat because called twice.
         .WillOnce(Return(true))
         .WillOnce(Return(false))
         .WillOnce(Return(true))
@@ -623,6 +572,45 @@ public:
   void test_brige_link_schenario_multi_threaded() {
     do_test_brige_link_schenario(3);
   }
+
+  void test_labels_do_not_depend_on_number_of_threads() {
+    const double backgroundValue = 0;
+    IMDHistoWorkspace_sptr inWS = MDEventsTestHelper::makeFakeMDHistoWorkspace(
+        backgroundValue, 3, 10); // 10*10*10
+    // Scatter irregular clusters throughout the blocks of each thread
+    for (size_t i = 0; i < inWS->getNPoints(); ++i) {
+      if ((i * 761) % 1000 < 80)
+        inWS->setSignalAt(i, backgroundValue + 1);
+    }
+    HardThresholdBackground backgroundStrategy(backgroundValue,
+                                               NoNormalization);
+
+    size_t labelingId = 1;
+    Progress prog;
+    ConnectedComponentLabeling serialCCL(labelingId, 1);
+    auto serialClusters =
+        serialCCL.executeAndFetchClusters(inWS, &backgroundStrategy, prog);
+    ConnectedComponentLabeling parallelCCL(labelingId, 4);
+    auto parallelClusters =
+        parallelCCL.executeAndFetchClusters(inWS, &backgroundStrategy, prog);
+
+    auto serialWS = serialClusters.get<0>();
+    auto parallelWS = parallelClusters.get<0>();
+    for (size_t i = 0; i < inWS->getNPoints(); ++i) {
+      TS_ASSERT_EQUALS(serialWS->getSignalAt(i), parallelWS->getSignalAt(i));
+    }
+    auto &serialMap = serialClusters.get<1>();
+    auto &parallelMap = parallelClusters.get<1>();
+    TS_ASSERT_EQUALS(serialMap.size(), parallelMap.size());
+    for (const auto &labelCluster : serialMap) {
+      auto parallelCluster = parallelMap.find(labelCluster.first);
+      TS_ASSERT(parallelCluster != parallelMap.end());
+      if (parallelCluster != parallelMap.end()) {
+        TS_ASSERT_EQUALS(labelCluster.second->size(),
+                         parallelCluster->second->size());
+      }
+    }
+  }
 };
 
 //=====================================================================================
@@ -82,6 +82,41 @@ public:
     // Remove workspace from the data service.
     AnalysisDataService::Instance().remove(WSName);
   }
+
+  void test_exec_reusing_directions_gives_same_UB() {
+    std::string WSName("peaks_reuse");
+    LoadNexusProcessed loader;
+    loader.initialize();
+    loader.setPropertyValue("Filename", "TOPAZ_3007.peaks.nxs");
+    loader.setPropertyValue("OutputWorkspace", WSName);
+    TS_ASSERT(loader.execute());
+    auto ws =
+        AnalysisDataService::Instance().retrieveWS<PeaksWorkspace>(WSName);
+    TS_ASSERT(ws);
+    if (!ws)
+      return;
+
+    // The first run caches the cell edges that the second run starts from
+    std::vector<std::vector<double>> UBs;
+    for (int run = 0; run < 2; run++) {
+      FindUBUsingFFT alg;
+      alg.initialize();
+      alg.setPropertyValue("PeaksWorkspace", WSName);
+      alg.setPropertyValue("MinD", "8.0");
+      alg.setPropertyValue("MaxD", "13.0");
+      alg.setPropertyValue("Tolerance", "0.15");
+      alg.setProperty("ReuseDirections", true);
+      TS_ASSERT_THROWS_NOTHING(alg.execute());
+      TS_ASSERT(alg.isExecuted());
+      UBs.push_back(ws->sample().getOrientedLattice().getUB().getVector());
+    }
+
+    for (size_t i = 0; i < 9; i++) {
+      TS_ASSERT_DELTA(UBs[0][i], UBs[1][i], 5e-4);
+    }
+
+    AnalysisDataService::Instance().remove(WSName);
+  }
 };
 
 #endif /* MANTID_CRYSTAL_FIND_UB_USING_FFT_TEST_H_ */
@@ -11,8 +11,12 @@
 
 #include "MantidCrystal/PeakStatisticsTools.h"
 #include "MantidDataObjects/Peak.h"
+#include "MantidGeometry/Crystal/BasicHKLFilters.h"
+#include "MantidGeometry/Crystal/HKLGenerator.h"
 #include "MantidGeometry/Crystal/PointGroupFactory.h"
 
+#include <set>
+
 using namespace Mantid::Crystal;
 using namespace Mantid::Crystal::PeakStatisticsTools;
 using namespace Mantid::DataObjects;
@@ -287,6 +291,48 @@ public:
     TS_ASSERT_EQUALS(reflections.getUnobservedUniqueReflections().size(), 2);
   }
 
+  void test_UniqueReflectionCollectionFamiliesMatchPointGroup() {
+    for (const auto &symbol : {"-1", "2/m", "mmm", "-3", "-3m1", "6/mmm",
+                               "4/mmm", "m-3m"}) {
+      UniqueReflectionCollection reflections =
+          getUniqueReflectionCollection(5.0, "P", symbol, 1.0);
+      PointGroup_sptr pg =
+          PointGroupFactory::Instance().createPointGroup(symbol);
+
+      const UnitCell cell(5.0, 5.0, 5.0);
+      const HKLFilterDRange dFilter(cell, 1.0, 100.0);
+      std::set<V3D> families;
+      for (const auto &hkl : HKLGenerator(cell, 1.0)) {
+        if (dFilter.isAllowed(hkl))
+          families.insert(pg->getReflectionFamily(hkl));
+      }
+
+      TSM_ASSERT_EQUALS(symbol, reflections.getUniqueReflectionCount(),
+                        families.size());
+      for (const auto &reflection : reflections.getReflections()) {
+        TSM_ASSERT_EQUALS(symbol, reflection.first,
+                          pg->getReflectionFamily(reflection.first));
+      }
+
+      // All equivalents of one reflection end up in the same family.
+      const V3D hkl(3, 1, 2);
+      const auto equivalents = pg->getEquivalents(hkl);
+      std::vector<Peak> peaks;
+      for (const auto &equivalent : equivalents) {
+        const auto equivalentPeaks =
+            getPeaksWithIandSigma({1.0}, {1.0}, equivalent);
+        peaks.insert(peaks.end(), equivalentPeaks.begin(),
+                     equivalentPeaks.end());
+      }
+      reflections.addObservations(peaks);
+
+      TSM_ASSERT_EQUALS(symbol, reflections.getObservedUniqueReflectionCount(),
+                        1);
+      TSM_ASSERT_EQUALS(symbol, reflections.getReflection(hkl).count(),
+                        equivalents.size());
+    }
+  }
+
   void test_PeaksStatisticsNoObservation() {
     std::map<V3D, UniqueReflection> uniques;
     uniques.insert(
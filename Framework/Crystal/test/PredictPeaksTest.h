@@ -170,6 +170,34 @@ public:
     AnalysisDataService::Instance().remove(outWSName);
   }
 
+  void test_exec_with_invalid_wavelength_range_fails() {
+    do_test_invalid_wavelength_range("0.0", "10.0");
+    do_test_invalid_wavelength_range("2.0", "1.0");
+  }
+
+  void do_test_invalid_wavelength_range(const std::string &lambdaMin,
+                                        const std::string &lambdaMax) {
+    auto inWS = WorkspaceCreationHelper::create2DWorkspace(10000, 1);
+    auto inst =
+        ComponentCreationHelper::createTestInstrumentRectangular(1, 100);
+    inWS->setInstrument(inst);
+    WorkspaceCreationHelper::setOrientedLattice(inWS, 12.0, 12.0, 12.0);
+    WorkspaceCreationHelper::setGoniometer(inWS, 0., 0., 0.);
+
+    PredictPeaks alg;
+    alg.setChild(true);
+    alg.setRethrows(true);
+    TS_ASSERT_THROWS_NOTHING(alg.initialize())
+    TS_ASSERT_THROWS_NOTHING(alg.setProperty(
+        "InputWorkspace", boost::dynamic_pointer_cast<Workspace>(inWS)));
+    TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("OutputWorkspace", "out"));
+    TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("WavelengthMin", lambdaMin));
+    TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("WavelengthMax", lambdaMax));
+    TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("MinDSpacing", "1.0"));
+    TS_ASSERT_THROWS(alg.execute(), const std::range_error &);
+    TS_ASSERT(!alg.isExecuted());
+  }
+
   void test_exec_withInputHKLList() {
     std::vector<V3D> hkls{{-6, -9, 1}};
     do_test_exec("Primitive", 1, hkls);
@@ -13,6 +13,8 @@
 #include "MantidCurveFitting/Functions/BackgroundFunction.h"
 #include "MantidKernel/System.h"
 
+#include <unordered_map>
+
 namespace Mantid {
 namespace HistogramData {
 class HistogramX;
@@ -30,6 +32,11 @@ composite
 @date 2013-04-26 : original LeBailFunction is not used by any other functions.
 And thus
 it is rewritten.
+
+Each peak's values at unit height are cached within its support window,
+together with the peak parameters they were calculated from. A peak is only
+re-evaluated when one of its parameters other than the height has changed,
+and the peaks that need it are re-evaluated in parallel.
 */
 class DLLExport LeBailFunction {
 public:
@@ -137,6 +144,13 @@ private:
       const std::vector<double> &vecX, const std::vector<double> &vecY,
       std::vector<double> &vec_summedpeaks);
 
+  /// Re-evaluate the cached profiles of peaks whose parameters changed
+  void updatePeakProfiles(const std::vector<double> &xvalues) const;
+
+  /// Copy a peak's cached profile into a range of the x values
+  void getPeakProfile(size_t peakindex, size_t ileft,
+                      std::vector<double> &values) const;
+
   /// Group close peaks together
   void groupPeaks(
       std::vector<
@@ -165,6 +179,24 @@ private:
   /// Vector of all peak's Miller indexes
   std::map<std::vector<int>, API::IPowderDiffPeakFunction_sptr> m_mapHKLPeak;
 
+  /// Index of each peak in m_vecPeaks
+  std::unordered_map<const API::IPowderDiffPeakFunction *, size_t>
+      m_peakIndexMap;
+
+  /// Values of a peak at unit height within its support window and the
+  /// parameters they were calculated with
+  struct PeakProfile {
+    std::vector<double> parameters;
+    size_t firstIndex = 0;
+    std::vector<double> values;
+  };
+  /// Cached profiles, in the same order as m_vecPeaks
+  mutable std::vector<PeakProfile> m_peakProfiles;
+  /// X values the cached profiles refer to
+  mutable std::vector<double> m_peakProfileX;
+  /// Index of the peak height parameter, which does not change the profile
+  size_t m_heightIndex;
+
   /// Composite functions for all peaks and background
   API::CompositeFunction_sptr m_compsiteFunction;
   /// Background function
@@ -0,0 +1,56 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_CURVEFITTING_BLOCKSCHURSOLVER_H_
+#define MANTID_CURVEFITTING_BLOCKSCHURSOLVER_H_
+
+#include "MantidCurveFitting/DllConfig.h"
+#include "MantidCurveFitting/GSLMatrix.h"
+#include "MantidCurveFitting/GSLVector.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace CurveFitting {
+/**
+Solves a symmetric system of linear equations whose matrix couples many small
+blocks of unknowns only through a few shared unknowns, as the normal equations
+of a simultaneous fit do: the local parameters of each domain form a block and
+the global (tied) parameters couple all of them.
+
+The structure is found from the non-zero pattern of the matrix. Unknowns that
+are coupled to many more unknowns than typical are treated as shared and the
+rest are split into independent blocks. The blocks are eliminated in parallel
+and the shared unknowns are found from the Schur complement, which costs
+O(sum of block size^3 + shared^3) instead of O(n^3).
+*/
+class MANTID_CURVEFITTING_DLL BlockSchurSolver {
+public:
+  /// Find the block structure of a symmetric matrix
+  explicit BlockSchurSolver(const GSLMatrix &matrix);
+  /// Check whether the structure makes block elimination worthwhile
+  bool hasBlockStructure() const;
+  /// Indices of the unknowns in each independent block
+  const std::vector<std::vector<size_t>> &blocks() const { return m_blocks; }
+  /// Indices of the unknowns shared by the blocks
+  const std::vector<size_t> &shared() const { return m_shared; }
+  /// Solve matrix * x == rhs
+  void solve(const GSLMatrix &matrix, const GSLVector &rhs,
+             GSLVector &x) const;
+
+private:
+  /// Size of the system
+  size_t m_size;
+  /// Independent blocks of unknowns
+  std::vector<std::vector<size_t>> m_blocks;
+  /// Unknowns that couple the blocks
+  std::vector<size_t> m_shared;
+};
+
+} // namespace CurveFitting
+} // namespace Mantid
+
+#endif /*MANTID_CURVEFITTING_BLOCKSCHURSOLVER_H_*/
@@ -12,6 +12,8 @@
 #include "MantidCurveFitting/DllConfig.h"
 #include "MantidCurveFitting/FortranDefs.h"
 
+#include <vector>
+
 namespace Mantid {
 namespace CurveFitting {
 namespace Functions {
@@ -40,6 +42,20 @@ protected:
   /// Store the default domain size after first
   /// function evaluation
   mutable size_t m_defaultDomainSize;
+
+private:
+  /// The last computed eigensystem and the hamiltonian parameters it was
+  /// computed for. Fitting evaluates the function many times with unchanged
+  /// field parameters (e.g. derivatives over peak widths and intensity
+  /// scalings) so the diagonalisation is only repeated when they change.
+  struct EigenSystemCache {
+    std::vector<double> key;
+    DoubleFortranVector en;
+    ComplexFortranMatrix wf;
+    ComplexFortranMatrix ham;
+    ComplexFortranMatrix hz;
+  };
+  mutable EigenSystemCache m_eigenSystemCache;
 };
 
 class MANTID_CURVEFITTING_DLL CrystalFieldPeaksBaseImpl
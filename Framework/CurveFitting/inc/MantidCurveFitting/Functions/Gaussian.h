@@ -40,6 +40,7 @@ public:
   double centre() const override;
   double height() const override;
   double fwhm() const override;
+  bool usesPeakRadiusWindow() const override { return true; }
   double intensity() const override;
   void setCentre(const double c) override;
   void setHeight(const double h) override;
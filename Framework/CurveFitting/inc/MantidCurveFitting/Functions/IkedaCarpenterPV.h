@@ -31,6 +31,7 @@ public:
   double centre() const override;
   double height() const override;
   double fwhm() const override;
+  bool usesPeakRadiusWindow() const override { return true; }
   void setCentre(const double c) override;
   void setHeight(const double h) override;
   void setFwhm(const double w) override;
@@ -36,6 +36,7 @@ public:
   double centre() const override { return getParameter("PeakCentre"); }
   double height() const override;
   double fwhm() const override { return getParameter("FWHM"); }
+  bool usesPeakRadiusWindow() const override { return true; }
   double intensity() const override { return getParameter("Amplitude"); }
   void setCentre(const double c) override { setParameter("PeakCentre", c); }
   void setHeight(const double h) override;
@@ -38,6 +38,7 @@ public:
   double centre() const override { return getParameter("PeakCentre"); }
   double height() const override { return getParameter("Height"); }
   double fwhm() const override { return getParameter("FWHM"); }
+  bool usesPeakRadiusWindow() const override { return true; }
 
   void setCentre(const double c) override { setParameter("PeakCentre", c); }
   void setHeight(const double h) override { setParameter("Height", h); }
@@ -44,6 +44,8 @@ private:
   double height() const override;
   /// Return value of FWHM of peak
   double fwhm() const override;
+  /// The peak is evaluated within its peak radius only
+  bool usesPeakRadiusWindow() const override { return true; }
   /// Set the centre of the peak
   void setCentre(const double value) override;
   /// Set the height of the peak
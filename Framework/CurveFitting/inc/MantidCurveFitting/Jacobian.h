@@ -9,6 +9,7 @@
 
 #include "MantidAPI/Jacobian.h"
 
+#include <utility>
 #include <vector>
 
 namespace Mantid {
@@ -73,6 +74,22 @@ public:
   }
   /// overwrite base method
   void zero() override { m_data.assign(m_data.size(), 0.0); }
+  /// Get the range of data points outside which a column is zero
+  /// @param iP :: the index of the parameter
+  /// @return :: the first point and one past the last point with a non-zero
+  ///   derivative. Both are equal for an all-zero column.
+  std::pair<size_t, size_t> nonZeroRange(size_t iP) const {
+    if (iP >= m_np) {
+      throw Kernel::Exception::FitSizeWarning(m_np);
+    }
+    size_t first = 0;
+    while (first < m_ny && m_data[first * m_np + iP] == 0.0)
+      ++first;
+    size_t last = m_ny;
+    while (last > first && m_data[(last - 1) * m_np + iP] == 0.0)
+      --last;
+    return std::make_pair(first, last);
+  }
 };
 
 } // namespace CurveFitting
@@ -11,6 +11,7 @@
 #include "MantidCurveFitting/Constraints/BoundaryConstraint.h"
 #include "MantidHistogramData/HistogramX.h"
 #include "MantidHistogramData/HistogramY.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/System.h"
 
 #include <sstream>
@@ -71,6 +72,7 @@ LeBailFunction::LeBailFunction(std::string peaktype) {
   }
 
   m_peakParameterNameVec = peakfunc->getParameterNames();
+  m_heightIndex = peakfunc->parameterIndex("Height");
   m_orderedProfileParameterNames = m_peakParameterNameVec;
   sort(m_orderedProfileParameterNames.begin(),
        m_orderedProfileParameterNames.end());
@@ -116,13 +118,13 @@ LeBailFunction::function(const Mantid::HistogramData::HistogramX &xvalues,
 
   // Peaks
   if (calpeaks) {
+    updatePeakProfiles(xvals);
     for (size_t ipk = 0; ipk < m_numPeaks; ++ipk) {
-      // Reset temporary vector for output
-      vector<double> temp(xvalues.size(), 0);
-      IPowderDiffPeakFunction_sptr peak = m_vecPeaks[ipk];
-      peak->function(temp, xvals);
-      transform(out.begin(), out.end(), temp.begin(), out.begin(),
-                ::plus<double>());
+      // Scale the cached profile by the peak's current height
+      const PeakProfile &profile = m_peakProfiles[ipk];
+      const double height = m_vecPeaks[ipk]->height();
+      for (size_t i = 0; i < profile.values.size(); ++i)
+        out[profile.firstIndex + i] += height * profile.values[i];
     }
   }
 
@@ -165,6 +167,87 @@ HistogramY LeBailFunction::calPeak(size_t ipk,
   return HistogramY(out);
 }
 
+//----------------------------------------------------------------------------------------------
+/** Re-evaluate the cached profiles of peaks whose parameters changed
+ * A profile holds the peak's values at unit height for the x values within
+ * PEAKRANGECONSTANT times FWHM of the centre, the same range the peak
+ * functions evaluate. Profiles depend on all peak parameters except the
+ * height, so a change of one profile parameter only causes the peaks to be
+ * re-evaluated, not their heights.
+ * @param xvalues :: x values to evaluate the peaks on
+ */
+void LeBailFunction::updatePeakProfiles(const vector<double> &xvalues) const {
+  if (m_peakProfileX != xvalues) {
+    m_peakProfileX = xvalues;
+    m_peakProfiles.clear();
+  }
+  m_peakProfiles.resize(m_numPeaks);
+
+  // Find the peaks to re-evaluate and their range.  Peak parameters are
+  // calculated here, as exceptions can not leave the parallel loop below.
+  vector<size_t> changedpeaks;
+  vector<pair<size_t, size_t>> ranges;
+  for (size_t ipk = 0; ipk < m_numPeaks; ++ipk) {
+    IPowderDiffPeakFunction_sptr peak = m_vecPeaks[ipk];
+    PeakProfile &profile = m_peakProfiles[ipk];
+
+    const size_t numparams = peak->nParams();
+    bool changed = profile.parameters.size() != numparams;
+    for (size_t i = 0; i < numparams && !changed; ++i) {
+      if (i != m_heightIndex && profile.parameters[i] != peak->getParameter(i))
+        changed = true;
+    }
+    if (!changed)
+      continue;
+
+    profile.parameters.resize(numparams);
+    for (size_t i = 0; i < numparams; ++i)
+      profile.parameters[i] = peak->getParameter(i);
+
+    const double centre = peak->centre();
+    const double range = PEAKRANGECONSTANT * peak->fwhm();
+    auto first = lower_bound(xvalues.begin(), xvalues.end(), centre - range);
+    auto last = lower_bound(first, xvalues.end(), centre + range);
+
+    changedpeaks.push_back(ipk);
+    ranges.emplace_back(static_cast<size_t>(first - xvalues.begin()),
+                        static_cast<size_t>(last - xvalues.begin()));
+  }
+
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(changedpeaks.size()); ++i) {
+    const size_t ipk = changedpeaks[i];
+    IPowderDiffPeakFunction_sptr peak = m_vecPeaks[ipk];
+    PeakProfile &profile = m_peakProfiles[ipk];
+
+    const vector<double> datax(xvalues.begin() + ranges[i].first,
+                               xvalues.begin() + ranges[i].second);
+    profile.firstIndex = ranges[i].first;
+    profile.values.assign(datax.size(), 0.0);
+
+    const double height = peak->height();
+    peak->setHeight(1.0);
+    peak->function(profile.values, datax);
+    peak->setHeight(height);
+  }
+}
+
+//----------------------------------------------------------------------------------------------
+/** Copy a peak's cached profile into a range of the x values
+ * @param peakindex :: index of the peak in m_vecPeaks
+ * @param ileft :: index of the x value corresponding to values[0]
+ * @param values :: output, zero outside of the peak's support window
+ */
+void LeBailFunction::getPeakProfile(size_t peakindex, size_t ileft,
+                                    vector<double> &values) const {
+  const PeakProfile &profile = m_peakProfiles[peakindex];
+  const size_t first = std::max(ileft, profile.firstIndex);
+  const size_t last = std::min(ileft + values.size(),
+                               profile.firstIndex + profile.values.size());
+  for (size_t i = first; i < last; ++i)
+    values[i - ileft] = profile.values[i - profile.firstIndex];
+}
+
 //----------------------------------------------------------------------------------------------
 /** Check whether a parameter is a profile parameter
  * @param paramname :: parameter name to check with
@@ -293,6 +376,7 @@ void LeBailFunction::addPeaks(std::vector<std::vector<int>> peakhkls) {
       double dsp = newpeak->getPeakParameter("d_h");
 
       // Add new peak to all related data storage
+      m_peakIndexMap.emplace(newpeak.get(), m_vecPeaks.size());
       m_vecPeaks.push_back(newpeak);
       // FIXME - Refining lattice size is not considered here!
       m_dspPeakVec.emplace_back(dsp, newpeak);
@@ -354,6 +438,9 @@ bool LeBailFunction::calculatePeaksIntensities(
   double xmax = vecX.back();
   groupPeaks(peakgroupvec, outboundpeakvec, xmin, xmax);
 
+  // Peaks are evaluated once here and scaled by their heights afterwards
+  updatePeakProfiles(vecX);
+
   // Calculate each peak's intensity and set
   bool allpeakheightsphysical = true;
   for (size_t ig = 0; ig < peakgroupvec.size(); ++ig) {
@@ -510,7 +597,7 @@ bool LeBailFunction::calculateGroupPeakIntensities(
     IPowderDiffPeakFunction_sptr peak = peakgroup[ipk].second;
     peak->setHeight(1.0);
     vector<double> localpeakvalue(ndata, 0.0);
-    peak->function(localpeakvalue, datax);
+    getPeakProfile(m_peakIndexMap.at(peak.get()), ileft, localpeakvalue);
 
     // check data
     size_t numbadpts(0);
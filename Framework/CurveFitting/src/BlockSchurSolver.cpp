@@ -0,0 +1,240 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidCurveFitting/BlockSchurSolver.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_linalg.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Mantid {
+namespace CurveFitting {
+
+namespace {
+/// An unknown is treated as shared if it is coupled to more than this many
+/// times the median number of couplings
+const size_t SHARED_DEGREE_FACTOR = 2;
+
+/// Throw if a GSL linear algebra call failed
+void checkGSLResult(int res) {
+  if (res != GSL_SUCCESS) {
+    std::string message = "Failed to solve system of linear equations.\n"
+                          "Error message returned by the GSL:\n" +
+                          std::string(gsl_strerror(res));
+    throw std::runtime_error(message);
+  }
+}
+} // namespace
+
+/// Constructor.
+/// @param matrix :: A symmetric matrix to analyse. Only the positions of the
+///   non-zero elements are used.
+BlockSchurSolver::BlockSchurSolver(const GSLMatrix &matrix)
+    : m_size(matrix.size1()) {
+  if (matrix.size2() != m_size) {
+    throw std::invalid_argument(
+        "System of linear equations: the matrix must be square.");
+  }
+  if (m_size < 3) {
+    return;
+  }
+
+  // count the off-diagonal couplings of each unknown
+  std::vector<size_t> degree(m_size, 0);
+  for (size_t i = 0; i < m_size; ++i) {
+    for (size_t j = 0; j < m_size; ++j) {
+      if (i != j && matrix.get(i, j) != 0.0) {
+        ++degree[i];
+      }
+    }
+  }
+  std::vector<size_t> sorted(degree);
+  std::nth_element(sorted.begin(), sorted.begin() + m_size / 2, sorted.end());
+  const size_t threshold = SHARED_DEGREE_FACTOR * sorted[m_size / 2] + 1;
+
+  std::vector<bool> isShared(m_size, false);
+  for (size_t i = 0; i < m_size; ++i) {
+    if (degree[i] > threshold) {
+      isShared[i] = true;
+      m_shared.push_back(i);
+    }
+  }
+
+  // the remaining unknowns fall into connected components
+  std::vector<bool> visited(isShared);
+  std::vector<size_t> stack;
+  for (size_t start = 0; start < m_size; ++start) {
+    if (visited[start]) {
+      continue;
+    }
+    std::vector<size_t> block;
+    visited[start] = true;
+    stack.push_back(start);
+    while (!stack.empty()) {
+      const size_t i = stack.back();
+      stack.pop_back();
+      block.push_back(i);
+      for (size_t j = 0; j < m_size; ++j) {
+        if (!visited[j] && matrix.get(i, j) != 0.0) {
+          visited[j] = true;
+          stack.push_back(j);
+        }
+      }
+    }
+    std::sort(block.begin(), block.end());
+    m_blocks.push_back(std::move(block));
+  }
+}
+
+/// Block elimination only pays off if there are several blocks and none of
+/// them is as large as the rest of the system put together.
+bool BlockSchurSolver::hasBlockStructure() const {
+  if (m_blocks.size() < 2) {
+    return false;
+  }
+  auto largest = std::max_element(m_blocks.cbegin(), m_blocks.cend(),
+                                  [](const std::vector<size_t> &a,
+                                     const std::vector<size_t> &b) {
+                                    return a.size() < b.size();
+                                  });
+  return largest->size() + m_shared.size() <= m_size / 2;
+}
+
+/// Solve a system of linear equations.
+/// @param matrix :: The matrix of the system. It must have the non-zero
+///   pattern that was used to construct this solver.
+/// @param rhs :: The right-hand side vector.
+/// @param x :: The solution vector.
+void BlockSchurSolver::solve(const GSLMatrix &matrix, const GSLVector &rhs,
+                             GSLVector &x) const {
+  if (matrix.size1() != m_size || matrix.size2() != m_size) {
+    throw std::invalid_argument(
+        "System of linear equations: the matrix has wrong size.");
+  }
+  if (rhs.size() != m_size) {
+    throw std::invalid_argument(
+        "System of linear equations: right-hand side vector has wrong size.");
+  }
+  x.resize(m_size);
+  const size_t nShared = m_shared.size();
+  const int nBlocks = static_cast<int>(m_blocks.size());
+
+  // Schur complement of the blocks: S = D - sum(C^T * A^-1 * C) and the
+  // matching right-hand side t = b_shared - sum(C^T * A^-1 * b_block)
+  std::vector<double> schur(nShared * nShared);
+  std::vector<double> schurRhs(nShared);
+  for (size_t i = 0; i < nShared; ++i) {
+    for (size_t j = 0; j < nShared; ++j) {
+      schur[i * nShared + j] = matrix.get(m_shared[i], m_shared[j]);
+    }
+    schurRhs[i] = rhs.get(m_shared[i]);
+  }
+
+  // A^-1 * [b_block | C] for each block: column 0 is the block's solution
+  // for zero shared unknowns and the others its response to each of them
+  std::vector<GSLMatrix> eliminated(m_blocks.size());
+  // C^T * A^-1 * [b_block | C] for each block, subtracted from the Schur
+  // complement in block order afterwards so the result does not depend on
+  // the order in which the threads finish
+  std::vector<std::vector<double>> updates(m_blocks.size());
+  std::vector<int> blockResults(m_blocks.size(), GSL_SUCCESS);
+
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int ib = 0; ib < nBlocks; ++ib) {
+    const auto &block = m_blocks[ib];
+    const size_t n = block.size();
+    GSLMatrix a(n, n);
+    GSLMatrix y(n, nShared + 1);
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        a.set(i, j, matrix.get(block[i], block[j]));
+      }
+      y.set(i, 0, rhs.get(block[i]));
+      for (size_t k = 0; k < nShared; ++k) {
+        y.set(i, k + 1, matrix.get(block[i], m_shared[k]));
+      }
+    }
+
+    int s;
+    gsl_permutation *p = gsl_permutation_alloc(n);
+    int res = gsl_linalg_LU_decomp(a.gsl(), p, &s);
+    for (size_t k = 0; res == GSL_SUCCESS && k <= nShared; ++k) {
+      gsl_vector_view column = gsl_matrix_column(y.gsl(), k);
+      res = gsl_linalg_LU_svx(a.gsl(), p, &column.vector);
+    }
+    gsl_permutation_free(p);
+    if (res != GSL_SUCCESS) {
+      blockResults[ib] = res;
+      continue;
+    }
+
+    // C^T * A^-1 * [b_block | C]
+    auto &update = updates[ib];
+    update.assign(nShared * (nShared + 1), 0.0);
+    for (size_t k = 0; k < nShared; ++k) {
+      for (size_t i = 0; i < n; ++i) {
+        const double c = matrix.get(block[i], m_shared[k]);
+        if (c == 0.0) {
+          continue;
+        }
+        for (size_t l = 0; l <= nShared; ++l) {
+          update[k * (nShared + 1) + l] += c * y.get(i, l);
+        }
+      }
+    }
+    eliminated[ib] = y;
+  }
+  for (const auto res : blockResults) {
+    checkGSLResult(res);
+  }
+  for (const auto &update : updates) {
+    for (size_t k = 0; k < nShared; ++k) {
+      schurRhs[k] -= update[k * (nShared + 1)];
+      for (size_t l = 0; l < nShared; ++l) {
+        schur[k * nShared + l] -= update[k * (nShared + 1) + l + 1];
+      }
+    }
+  }
+
+  // solve for the shared unknowns
+  std::vector<double> sharedSolution(schurRhs);
+  if (nShared > 0) {
+    gsl_matrix_view s =
+        gsl_matrix_view_array(schur.data(), nShared, nShared);
+    gsl_vector_view t = gsl_vector_view_array(sharedSolution.data(), nShared);
+    int sign;
+    gsl_permutation *p = gsl_permutation_alloc(nShared);
+    int res = gsl_linalg_LU_decomp(&s.matrix, p, &sign);
+    if (res == GSL_SUCCESS) {
+      res = gsl_linalg_LU_svx(&s.matrix, p, &t.vector);
+    }
+    gsl_permutation_free(p);
+    checkGSLResult(res);
+  }
+  for (size_t k = 0; k < nShared; ++k) {
+    x.set(m_shared[k], sharedSolution[k]);
+  }
+
+  // back substitute into the blocks: x_block = A^-1 * (b_block - C * x_shared)
+  for (size_t ib = 0; ib < m_blocks.size(); ++ib) {
+    const auto &block = m_blocks[ib];
+    const auto &y = eliminated[ib];
+    for (size_t i = 0; i < block.size(); ++i) {
+      double value = y.get(i, 0);
+      for (size_t k = 0; k < nShared; ++k) {
+        value -= y.get(i, k + 1) * sharedSolution[k];
+      }
+      x.set(block[i], value);
+    }
+  }
+}
+
+} // namespace CurveFitting
+} // namespace Mantid
@@ -270,6 +270,14 @@ void CostFuncLeastSquares::addValDerivHessian(API::IFunction_sptr function,
   if (!evalHessian)
     return;
 
+  // In a multi-domain fit most parameters affect only the points of their own
+  // domain: only sum over the points where both derivatives can be non-zero.
+  std::vector<std::pair<size_t, size_t>> nonZero(np);
+  for (size_t i = 0; i < np; ++i) {
+    if (function->isActive(i))
+      nonZero[i] = jacobian.nonZeroRange(i);
+  }
+
   size_t i1 = 0;                  // active parameter index
   for (size_t i = 0; i < np; ++i) // over parameters
   {
@@ -280,8 +288,10 @@ void CostFuncLeastSquares::addValDerivHessian(API::IFunction_sptr function,
     {
       if (!function->isActive(j))
         continue;
+      const size_t kStart = std::max(nonZero[i].first, nonZero[j].first);
+      const size_t kEnd = std::min(nonZero[i].second, nonZero[j].second);
       double d = 0.0;
-      for (size_t k = 0; k < ny; ++k) // over fitting data
+      for (size_t k = kStart; k < kEnd; ++k) // over fitting data
       {
         double w = weights[k];
         d += jacobian.get(k, i) * jacobian.get(k, j) * w * w;
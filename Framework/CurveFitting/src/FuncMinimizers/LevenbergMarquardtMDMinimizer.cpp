@@ -8,6 +8,7 @@
 // Includes
 //----------------------------------------------------------------------
 #include "MantidCurveFitting/FuncMinimizers/LevenbergMarquardtMDMinimizer.h"
+#include "MantidCurveFitting/BlockSchurSolver.h"
 #include "MantidCurveFitting/CostFunctions/CostFuncLeastSquares.h"
 
 #include "MantidAPI/CostFunctionFactory.h"
@@ -155,9 +156,16 @@ bool LevenbergMarquardtMDMinimizer::iterate(size_t) {
   // Parameter corrections
   GSLVector dx(n);
   // To find dx solve the system of linear equations   H * dx == -m_der
+  // Simultaneous fits couple the local parameters of each domain only through
+  // the shared ones: solve such systems block by block.
   dd *= -1.0;
   try {
-    H.solve(dd, dx);
+    BlockSchurSolver blockSolver(H);
+    if (blockSolver.hasBlockStructure()) {
+      blockSolver.solve(H, dd, dx);
+    } else {
+      H.solve(dd, dx);
+    }
   } catch (std::runtime_error &error) {
     m_errorString = error.what();
     return false;
@@ -21,10 +21,12 @@
 #include "MantidAPI/ParameterTie.h"
 
 #include "MantidKernel/Exception.h"
+#include "MantidKernel/MultiThreaded.h"
 
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/regex.hpp>
+#include <exception>
 #include <iostream>
 #include <limits>
 
@@ -101,6 +103,74 @@ public:
   }
 };
 
+/// Eigensystem of the crystal field of a single ion.
+struct IonEigenSystem {
+  DoubleFortranVector energies;
+  ComplexFortranMatrix waveFunctions;
+  /// The crystal field hamiltonian including the Zeeman term
+  ComplexFortranMatrix hamiltonian;
+  int nre = 0;
+};
+
+/// Diagonalise the hamiltonians of all ions of a multi-site source. The ions
+/// are independent of each other so they are solved in parallel.
+/// @param compSource :: A composite with a CrystalFieldPeaksBase per ion.
+std::vector<IonEigenSystem>
+calculateIonEigenSystems(const CompositeFunction &compSource) {
+  const auto nIons = static_cast<int>(compSource.nFunctions());
+  std::vector<const CrystalFieldPeaksBase *> peakCalculators;
+  for (int ionIndex = 0; ionIndex < nIons; ++ionIndex) {
+    peakCalculators.push_back(&dynamic_cast<const CrystalFieldPeaksBase &>(
+        *compSource.getFunction(ionIndex)));
+  }
+  std::vector<IonEigenSystem> ions(nIons);
+  std::exception_ptr error;
+  PARALLEL_FOR_IF(nIons > 1)
+  for (int ionIndex = 0; ionIndex < nIons; ++ionIndex) {
+    try {
+      auto &ion = ions[ionIndex];
+      ComplexFortranMatrix hamiltonianZeeman;
+      peakCalculators[ionIndex]->calculateEigenSystem(
+          ion.energies, ion.waveFunctions, ion.hamiltonian, hamiltonianZeeman,
+          ion.nre);
+      ion.hamiltonian += hamiltonianZeeman;
+    } catch (...) {
+      PARALLEL_CRITICAL(CrystalFieldFunction_ionEigenSystems) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+  return ions;
+}
+
+/// Calculate the peaks (excitation energies followed by their intensities)
+/// of all ions of a multi-site source in parallel.
+/// @param compSource :: A composite with a CrystalFieldPeaks per ion.
+std::vector<FunctionValues>
+calculateIonPeaks(const CompositeFunction &compSource) {
+  const auto nIons = static_cast<int>(compSource.nFunctions());
+  std::vector<FunctionValues> ionValues(nIons);
+  std::exception_ptr error;
+  PARALLEL_FOR_IF(nIons > 1)
+  for (int ionIndex = 0; ionIndex < nIons; ++ionIndex) {
+    try {
+      FunctionDomainGeneral domain;
+      compSource.getFunction(ionIndex)->function(domain, ionValues[ionIndex]);
+    } catch (...) {
+      PARALLEL_CRITICAL(CrystalFieldFunction_ionPeaks) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+  return ionValues;
+}
+
 } // namespace
 
 /// Constructor
@@ -794,12 +864,8 @@ void CrystalFieldFunction::buildMultiSiteSingleSpectrum() const {
   auto xVec = m_control.getAttribute("FWHMX").asVector();
   auto yVec = m_control.getAttribute("FWHMY").asVector();
 
-  auto &compSource = compositeSource();
-  for (size_t ionIndex = 0; ionIndex < compSource.nFunctions(); ++ionIndex) {
-    FunctionDomainGeneral domain;
-    FunctionValues values;
-    compSource.getFunction(ionIndex)->function(domain, values);
-
+  const auto ionValues = calculateIonPeaks(compositeSource());
+  for (const auto &values : ionValues) {
     if (values.size() == 0) {
       continue;
     }
@@ -836,17 +902,12 @@ void CrystalFieldFunction::buildMultiSiteMultiSpectrum() const {
                 []() { return boost::make_shared<CompositeFunction>(); });
 
   auto &compSource = compositeSource();
-  for (size_t ionIndex = 0; ionIndex < compSource.nFunctions(); ++ionIndex) {
-    DoubleFortranVector energies;
-    ComplexFortranMatrix waveFunctions;
-    ComplexFortranMatrix hamiltonian;
-    ComplexFortranMatrix hamiltonianZeeman;
-    int nre = 0;
-    auto &peakCalculator = dynamic_cast<CrystalFieldPeaksBase &>(
-        *compSource.getFunction(ionIndex));
-    peakCalculator.calculateEigenSystem(energies, waveFunctions, hamiltonian,
-                                        hamiltonianZeeman, nre);
-    hamiltonian += hamiltonianZeeman;
+  const auto ions = calculateIonEigenSystems(compSource);
+  for (size_t ionIndex = 0; ionIndex < ions.size(); ++ionIndex) {
+    const auto &energies = ions[ionIndex].energies;
+    const auto &waveFunctions = ions[ionIndex].waveFunctions;
+    const auto &hamiltonian = ions[ionIndex].hamiltonian;
+    const auto nre = ions[ionIndex].nre;
 
     auto &temperatures = m_control.temperatures();
     auto &FWHMs = m_control.FWHMs();
@@ -1119,12 +1180,9 @@ void CrystalFieldFunction::updateMultiSiteSingleSpectrum() const {
   auto defaultFWHM = FWHMs.empty() ? 0.0 : FWHMs[0];
 
   size_t spectrumIndexShift = hasBackground() ? 1 : 0;
-  auto &compSource = compositeSource();
-  for (size_t ionIndex = 0; ionIndex < compSource.nFunctions(); ++ionIndex) {
-    FunctionDomainGeneral domain;
-    FunctionValues values;
-    compSource.getFunction(ionIndex)->function(domain, values);
-
+  const auto ionValues = calculateIonPeaks(compositeSource());
+  for (size_t ionIndex = 0; ionIndex < ionValues.size(); ++ionIndex) {
+    const auto &values = ionValues[ionIndex];
     auto &ionSpectrum = dynamic_cast<CompositeFunction &>(
         *m_target->getFunction(ionIndex + spectrumIndexShift));
     CrystalFieldUtils::updateSpectrumFunction(ionSpectrum, peakShape, values, 0,
@@ -1135,18 +1193,12 @@ void CrystalFieldFunction::updateMultiSiteSingleSpectrum() const {
 
 /// Update the target function in a multi site - multi spectrum case.
 void CrystalFieldFunction::updateMultiSiteMultiSpectrum() const {
-  auto &compSource = compositeSource();
-  for (size_t ionIndex = 0; ionIndex < compSource.nFunctions(); ++ionIndex) {
-    DoubleFortranVector energies;
-    ComplexFortranMatrix waveFunctions;
-    ComplexFortranMatrix hamiltonian;
-    ComplexFortranMatrix hamiltonianZeeman;
-    int nre = 0;
-    auto &peakCalculator = dynamic_cast<CrystalFieldPeaksBase &>(
-        *compSource.getFunction(ionIndex));
-    peakCalculator.calculateEigenSystem(energies, waveFunctions, hamiltonian,
-                                        hamiltonianZeeman, nre);
-    hamiltonian += hamiltonianZeeman;
+  const auto ions = calculateIonEigenSystems(compositeSource());
+  for (size_t ionIndex = 0; ionIndex < ions.size(); ++ionIndex) {
+    const auto &energies = ions[ionIndex].energies;
+    const auto &waveFunctions = ions[ionIndex].waveFunctions;
+    const auto &hamiltonian = ions[ionIndex].hamiltonian;
+    const auto nre = ions[ionIndex].nre;
     size_t iFirst = ionIndex == 0 && hasBackground() ? 1 : 0;
 
     auto &temperatures = m_control.temperatures();
@@ -11,6 +11,7 @@
 #include <cctype>
 #include <functional>
 #include <map>
+#include <utility>
 
 namespace Mantid {
 namespace CurveFitting {
@@ -431,7 +432,29 @@ void CrystalFieldPeaksBase::calculateEigenSystem(DoubleFortranVector &en,
   bkq(6, 5) = ComplexType(B65, IB65);
   bkq(6, 6) = ComplexType(B66, IB66);
 
-  calculateEigensystem(en, wf, ham, hz, nre, bmol, bext, bkq);
+  std::vector<double> key{static_cast<double>(nre), bmol(1), bmol(2),
+                          bmol(3), bext(1), bext(2), bext(3)};
+  key.reserve(key.size() + 2 * bkq.size1() * bkq.size2());
+  for (int k = 0; k <= 6; ++k) {
+    for (int q = 0; q <= 6; ++q) {
+      const auto b = static_cast<ComplexType>(bkq(k, q));
+      key.push_back(b.real());
+      key.push_back(b.imag());
+    }
+  }
+
+  auto &cache = m_eigenSystemCache;
+  if (key != cache.key) {
+    // Invalidate first so a failed calculation is not reused
+    cache.key.clear();
+    calculateEigensystem(cache.en, cache.wf, cache.ham, cache.hz, nre, bmol,
+                         bext, bkq);
+    cache.key = std::move(key);
+  }
+  en = cache.en;
+  wf = cache.wf;
+  ham = cache.ham;
+  hz = cache.hz;
   // MaxPeakCount is a read-only "mutable" attribute.
   const_cast<CrystalFieldPeaksBase *>(this)->setAttributeValue(
       "MaxPeakCount", static_cast<int>(en.size()));
@@ -239,6 +239,52 @@ public:
     return;
   }
 
+  //----------------------------------------------------------------------------------------------
+  /** Test that the pattern follows changes of the profile parameters, i.e.,
+   * that cached peak values are re-calculated when the peaks change
+   */
+  void test_PatternFollowsProfileParameterChanges() {
+    LeBailFunction lebailfunction("ThermalNeutronBk2BkExpConvPVoigt");
+
+    map<string, double> parammap{
+        {"Dtt1", 29671.7500}, {"Dtt2", 0.0},          {"Dtt1t", 29671.750},
+        {"Dtt2t", 0.30},      {"Zero", 0.0},          {"Zerot", 33.70},
+        {"Alph0", 4.026},     {"Alph1", 7.362},       {"Beta0", 3.489},
+        {"Beta1", 19.535},    {"Alph0t", 60.683},     {"Alph1t", 39.730},
+        {"Beta0t", 96.864},   {"Beta1t", 96.864},     {"Sig2", sqrt(11.380)},
+        {"Sig1", sqrt(9.901)}, {"Sig0", sqrt(17.370)}, {"Width", 1.0055},
+        {"Tcross", 0.4700},   {"Gam0", 0.0},          {"Gam1", 0.0},
+        {"Gam2", 0.0},        {"LatticeConstant", 4.156890}};
+    lebailfunction.setProfileParameterValues(parammap);
+    lebailfunction.addPeaks({{1, 1, 1}, {1, 1, 0}});
+
+    MatrixWorkspace_sptr testws = createDataWorkspace(1);
+    const vector<double> vecX = testws->readX(0);
+    const vector<double> vecY = testws->readY(0);
+
+    for (const double sig1 : {sqrt(9.901), 2.0 * sqrt(9.901)}) {
+      parammap["Sig1"] = sig1;
+      lebailfunction.setProfileParameterValues(parammap);
+      TS_ASSERT(lebailfunction.isParameterValid());
+
+      vector<double> summedpeaksvalue(vecY.size(), 0.);
+      lebailfunction.calculatePeaksIntensities(vecX, vecY, summedpeaksvalue);
+
+      // Evaluate each peak on its own and compare to the cached values
+      vector<double> expected(vecX.size(), 0.);
+      for (size_t ipk = 0; ipk < lebailfunction.getNumberOfPeaks(); ++ipk) {
+        auto peak = lebailfunction.calPeak(ipk, vecX, vecX.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+          expected[i] += peak[i];
+      }
+
+      auto out = lebailfunction.function(vecX, true, false);
+      TS_ASSERT_EQUALS(out.size(), expected.size());
+      for (size_t i = 0; i < expected.size(); ++i)
+        TS_ASSERT_DELTA(out[i], expected[i], 1.0E-10);
+    }
+  }
+
   //----------------------------------------------------------------------------------------------
   /** Test LeBailFunction on calculating overalapped peaks
    *  The test data are of reflection (932) and (852) @ TOF = 12721.91 and
@@ -0,0 +1,116 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef BLOCKSCHURSOLVERTEST_H_
+#define BLOCKSCHURSOLVERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidCurveFitting/BlockSchurSolver.h"
+
+using namespace Mantid::CurveFitting;
+
+class BlockSchurSolverTest : public CxxTest::TestSuite {
+public:
+  void test_block_structure_is_found() {
+    auto m = makeSimultaneousFitMatrix(4, 3, 2);
+    BlockSchurSolver solver(m);
+    TS_ASSERT(solver.hasBlockStructure());
+    TS_ASSERT_EQUALS(solver.blocks().size(), 4);
+    TS_ASSERT_EQUALS(solver.shared().size(), 2);
+    TS_ASSERT_EQUALS(solver.shared()[0], 12);
+    TS_ASSERT_EQUALS(solver.shared()[1], 13);
+    for (size_t ib = 0; ib < solver.blocks().size(); ++ib) {
+      const auto &block = solver.blocks()[ib];
+      TS_ASSERT_EQUALS(block.size(), 3);
+      TS_ASSERT_EQUALS(block.front(), 3 * ib);
+    }
+  }
+
+  void test_solution_matches_dense_solve() {
+    auto m = makeSimultaneousFitMatrix(10, 5, 3);
+    const size_t n = m.size1();
+    GSLVector rhs(n);
+    for (size_t i = 0; i < n; ++i) {
+      rhs.set(i, 1.0 + 0.1 * static_cast<double>(i % 7));
+    }
+
+    BlockSchurSolver solver(m);
+    TS_ASSERT(solver.hasBlockStructure());
+    GSLVector x;
+    solver.solve(m, rhs, x);
+
+    GSLMatrix dense(m);
+    GSLVector expected;
+    dense.solve(rhs, expected);
+
+    TS_ASSERT_EQUALS(x.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+      TS_ASSERT_DELTA(x.get(i), expected.get(i), 1e-10);
+    }
+  }
+
+  void test_block_diagonal_without_shared_unknowns() {
+    auto m = makeSimultaneousFitMatrix(5, 2, 0);
+    BlockSchurSolver solver(m);
+    TS_ASSERT(solver.hasBlockStructure());
+    TS_ASSERT(solver.shared().empty());
+
+    GSLVector rhs(m.size1());
+    for (size_t i = 0; i < rhs.size(); ++i) {
+      rhs.set(i, static_cast<double>(i));
+    }
+    GSLVector x;
+    solver.solve(m, rhs, x);
+    GSLVector check = m * x;
+    for (size_t i = 0; i < rhs.size(); ++i) {
+      TS_ASSERT_DELTA(check.get(i), rhs.get(i), 1e-10);
+    }
+  }
+
+  void test_dense_matrix_has_no_block_structure() {
+    GSLMatrix m({{4.0, 1.0, 1.0}, {1.0, 3.0, 1.0}, {1.0, 1.0, 2.0}});
+    BlockSchurSolver solver(m);
+    TS_ASSERT(!solver.hasBlockStructure());
+  }
+
+private:
+  /// Create a symmetric positive definite matrix with the structure of the
+  /// normal equations of a simultaneous fit: nBlocks domains with nLocal
+  /// parameters each, followed by nShared global parameters
+  GSLMatrix makeSimultaneousFitMatrix(size_t nBlocks, size_t nLocal,
+                                      size_t nShared) {
+    const size_t n = nBlocks * nLocal + nShared;
+    GSLMatrix m(n, n);
+    m.zero();
+    for (size_t ib = 0; ib < nBlocks; ++ib) {
+      for (size_t i = 0; i < nLocal; ++i) {
+        for (size_t j = 0; j < nLocal; ++j) {
+          const size_t row = ib * nLocal + i;
+          const size_t col = ib * nLocal + j;
+          m.set(row, col, i == j ? 10.0 + static_cast<double>(ib) : 0.5);
+        }
+        for (size_t k = 0; k < nShared; ++k) {
+          const size_t row = ib * nLocal + i;
+          const size_t col = nBlocks * nLocal + k;
+          const double c = 0.1 * static_cast<double>(1 + (i + k) % 3);
+          m.set(row, col, c);
+          m.set(col, row, c);
+        }
+      }
+    }
+    for (size_t k = 0; k < nShared; ++k) {
+      for (size_t l = 0; l < nShared; ++l) {
+        const size_t row = nBlocks * nLocal + k;
+        const size_t col = nBlocks * nLocal + l;
+        m.set(row, col, k == l ? 50.0 : 1.0);
+      }
+    }
+    return m;
+  }
+};
+
+#endif /*BLOCKSCHURSOLVERTEST_H_*/
@@ -9,10 +9,12 @@
 
 #include <cxxtest/TestSuite.h>
 
+#include "MantidAPI/CompositeFunction.h"
 #include "MantidAPI/FunctionDomain1D.h"
 #include "MantidAPI/FunctionValues.h"
 #include "MantidCurveFitting/Functions/BackToBackExponential.h"
 
+#include <boost/make_shared.hpp>
 #include <cmath>
 
 using Mantid::CurveFitting::Functions::BackToBackExponential;
@@ -191,6 +193,41 @@ public:
     TS_ASSERT_EQUALS(b2bExp.intensity(), 3.0);
     TS_ASSERT_EQUALS(b2bExp.getParameter("I"), 3.0);
   }
+
+  // the exponential tails reach far beyond the peak radius, which the peak
+  // does not use, so a composite must not cut them off
+  void test_composite_with_peak_radius_keeps_tails() {
+    auto composite = boost::make_shared<Mantid::API::CompositeFunction>();
+    const std::vector<double> centres{-2.0, 3.0};
+    for (const auto centre : centres) {
+      auto peak = boost::make_shared<BackToBackExponential>();
+      peak->initialize();
+      peak->setParameter("I", 1.0);
+      peak->setParameter("A", 0.5);
+      peak->setParameter("B", 0.3);
+      peak->setParameter("X0", centre);
+      peak->setParameter("S", 0.1);
+      composite->addFunction(peak);
+    }
+
+    Mantid::API::FunctionDomain1DVector x(-10, 10, 201);
+    x.setPeakRadius(2);
+    Mantid::API::FunctionValues values(x);
+    composite->function(x, values);
+
+    Mantid::API::FunctionValues expected(x);
+    expected.zeroCalculated();
+    for (size_t i = 0; i < composite->nFunctions(); ++i) {
+      Mantid::API::FunctionValues member(x);
+      composite->getFunction(i)->function(x, member);
+      expected += member;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+      TS_ASSERT_DELTA(values[i], expected[i], 1e-12);
+    }
+    // far outside 2 * fwhm of either peak the tails are still there
+    TS_ASSERT(values[200] > 1e-3);
+  }
 };
 
 #endif /*BACKTOBACKEXPONENTIALTEST_H_*/
@@ -132,6 +132,40 @@ public:
     TS_ASSERT_EQUALS(nre, -4);
   }
 
+  void test_eigensystem_follows_parameter_changes() {
+    using Mantid::CurveFitting::DoubleFortranVector;
+    using Mantid::CurveFitting::ComplexFortranMatrix;
+    CrystalFieldPeaks peaks;
+    peaks.setParameter("B20", 0.37737);
+    peaks.setParameter("B22", 3.9770);
+    peaks.setParameter("B44", -0.12544);
+    peaks.setAttributeValue("Ion", "Ce");
+    DoubleFortranVector en1, en2, en3;
+    ComplexFortranMatrix wf1, wf2, wf3;
+    int nre = 0;
+    peaks.calculateEigenSystem(en1, wf1, nre);
+    peaks.setParameter("B20", 0.5);
+    peaks.calculateEigenSystem(en2, wf2, nre);
+    peaks.setParameter("B20", 0.37737);
+    peaks.calculateEigenSystem(en3, wf3, nre);
+
+    TS_ASSERT_EQUALS(en1.size(), 6);
+    TS_ASSERT_EQUALS(en2.size(), 6);
+    TS_ASSERT_EQUALS(en3.size(), 6);
+    TS_ASSERT(std::abs(en1.get(5) - en2.get(5)) > 1e-3);
+    for (size_t i = 0; i < en1.size(); ++i) {
+      TS_ASSERT_EQUALS(en1.get(i), en3.get(i));
+    }
+    TS_ASSERT_EQUALS(wf1.size1(), wf3.size1());
+    TS_ASSERT_EQUALS(wf1.size2(), wf3.size2());
+
+    peaks.setAttributeValue("Ion", "Pr");
+    peaks.calculateEigenSystem(en3, wf3, nre);
+    TS_ASSERT_EQUALS(nre, 2);
+    TS_ASSERT_EQUALS(en3.size(), 9);
+    TS_ASSERT_EQUALS(peaks.getAttribute("MaxPeakCount").asInt(), 9);
+  }
+
   void test_evaluate_alg_no_input_workspace() {
     IFunction_sptr fun(new CrystalFieldPeaks);
     FunctionDomainGeneral domain;
@@ -180,6 +180,7 @@ private:
   LoadEventNexus::LoaderType
   defineLoaderType(const bool haveWeights, const bool oldNeXusFileNames,
                    const std::string &classType) const;
+  void compressLoadedEvents(DataObjects::EventWorkspace &ws) const;
 
   DataObjects::EventWorkspace_sptr createEmptyEventWorkspace();
 
@@ -16,6 +16,11 @@ namespace Mantid {
 namespace DataObjects {
 class EventWorkspace;
 }
+namespace Parallel {
+namespace IO {
+struct EventFilter;
+}
+} // namespace Parallel
 namespace DataHandling {
 
 /** Loader for event data from Nexus files with parallelism based on multiple
@@ -38,7 +43,8 @@ public:
                                const std::string &groupName,
                                const std::vector<std::string> &bankNames,
                                const bool eventIDIsSpectrumNumber,
-                               const bool precalcEvents);
+                               const bool precalcEvents,
+                               const Parallel::IO::EventFilter &filter);
 };
 
 } // namespace DataHandling
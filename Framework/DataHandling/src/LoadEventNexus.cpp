@@ -27,6 +27,7 @@
 #include "MantidKernel/Timer.h"
 #include "MantidKernel/UnitFactory.h"
 #include "MantidKernel/VisibleWhenProperty.h"
+#include "MantidParallel/IO/EventFilter.h"
 
 #include <H5Cpp.h>
 #include <boost/function.hpp>
@@ -278,9 +279,13 @@ void LoadEventNexus::init() {
 
   auto loadTypeValidator = boost::make_shared<StringListValidator>(loadType);
   declareProperty("LoadType", "Default", loadTypeValidator,
-                  "Set type of loader. 2 options {Default, Multiproceess},"
-                  "'Multiprocess' should work faster for big files and it is "
-                  "experimental, available only in Linux");
+                  "Set type of loader. 2 options {Default, Multiprocess}. "
+                  "'Multiprocess' reads the file in several processes, "
+                  "which is faster for big files. It supports filtering by "
+                  "time and bank and compressing events, it falls back to "
+                  "the default loader for weighted events, several "
+                  "periods or a selection of spectra. Available only on "
+                  "Linux and macOS");
 
   declareProperty(make_unique<PropertyWithValue<bool>>("LoadNexusInstrumentXML",
                                                        true, Direction::Input),
@@ -946,14 +951,19 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
         }
       };
 
+      Parallel::IO::EventFilter filter;
+      filter.tofMin = filter_tof_min;
+      filter.tofMax = filter_tof_max;
+      filter.pulseTimeMin = filter_time_start.totalNanoseconds();
+      filter.pulseTimeMax = filter_time_stop.totalNanoseconds();
       try {
         ParallelEventLoader::loadMultiProcess(*ws, m_filename, m_top_entry_name,
                                               bankNames, event_id_is_spec,
-                                              getProperty("Precount"));
+                                              getProperty("Precount"), filter);
         g_log.information() << "Used Multiprocess ParallelEventLoader.\n";
         loaded = true;
-        shortest_tof = 0.0;
-        longest_tof = 1e10;
+        compressLoadedEvents(*ws);
+        ws->getEventXMinMax(shortest_tof, longest_tof);
       } catch (const std::exception &e) {
         ExceptionOutput::out(g_log, e);
         g_log.warning() << "\nMultiprocess event loader failed, falling back "
@@ -1492,23 +1502,39 @@ LoadEventNexus::defineLoaderType(const bool haveWeights,
   noParallelConstrictions &= !haveWeights;
   noParallelConstrictions &= !oldNeXusFileNames;
   noParallelConstrictions &=
-      !(filter_tof_min != -1e20 || filter_tof_max != 1e20);
-  noParallelConstrictions &=
-      !((filter_time_start != Types::Core::DateAndTime::minimum() ||
-         filter_time_stop != Types::Core::DateAndTime::maximum()));
-  noParallelConstrictions &=
-      !((!isDefault("CompressTolerance") || !isDefault("SpectrumMin") ||
-         !isDefault("SpectrumMax") || !isDefault("SpectrumList") ||
-         !isDefault("ChunkNumber")));
+      !((!isDefault("SpectrumMin") || !isDefault("SpectrumMax") ||
+         !isDefault("SpectrumList") || !isDefault("ChunkNumber")));
   noParallelConstrictions &= !(classType != "NXevent_data");
 
   if (!noParallelConstrictions)
     return LoaderType::DEFAULT;
-#ifndef MPI_EXPERIMENTAL
-  return LoaderType::MULTIPROCESS;
-#else
-  return propVal == "MPI" ? LoaderType::MPI : LoaderType::MULTIPROCESS;
+#ifdef MPI_EXPERIMENTAL
+  if (propVal == "MPI") {
+    // Unlike the multiprocess loader the MPI loader cannot filter or compress
+    const bool filtered =
+        filter_tof_min != -1e20 || filter_tof_max != 1e20 ||
+        filter_time_start != Types::Core::DateAndTime::minimum() ||
+        filter_time_stop != Types::Core::DateAndTime::maximum();
+    if (filtered || !isDefault("CompressTolerance"))
+      return LoaderType::DEFAULT;
+    return LoaderType::MPI;
+  }
 #endif
+  return LoaderType::MULTIPROCESS;
+}
+
+/// Compress the events of every spectrum if a CompressTolerance was given.
+/// The default loader compresses each bank as it is loaded instead.
+void LoadEventNexus::compressLoadedEvents(
+    DataObjects::EventWorkspace &ws) const {
+  if (compressTolerance < 0)
+    return;
+  const auto numberOfSpectra = static_cast<int64_t>(ws.getNumberHistograms());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < numberOfSpectra; ++i) {
+    auto &eventList = ws.getSpectrum(i);
+    eventList.compressEvents(compressTolerance, &eventList);
+  }
 }
 
 Parallel::ExecutionMode LoadEventNexus::getParallelExecutionMode(
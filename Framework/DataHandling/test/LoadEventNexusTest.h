@@ -38,12 +38,16 @@ using namespace Mantid::DataHandling;
 using Mantid::Types::Core::DateAndTime;
 using Mantid::Types::Event::TofEvent;
 
-void run_multiprocess_load(const std::string &file, bool precount) {
+void run_multiprocess_load(
+    const std::string &file, bool precount,
+    const std::map<std::string, std::string> &properties = {}) {
   Mantid::API::FrameworkManager::Instance();
   LoadEventNexus ld;
   ld.initialize();
   ld.setPropertyValue("Loadtype", "Multiprocess (experimental)");
   std::string outws_name = "multiprocess";
+  for (const auto &property : properties)
+    ld.setPropertyValue(property.first, property.second);
   ld.setPropertyValue("Filename", file);
   ld.setPropertyValue("OutputWorkspace", outws_name);
   ld.setPropertyValue("Precount", std::to_string(precount));
@@ -59,6 +63,8 @@ void run_multiprocess_load(const std::string &file, bool precount) {
   ldRef.initialize();
   ldRef.setPropertyValue("Loadtype", "Default");
   outws_name = "reference";
+  for (const auto &property : properties)
+    ldRef.setPropertyValue(property.first, property.second);
   ldRef.setPropertyValue("Filename", file);
   ldRef.setPropertyValue("OutputWorkspace", outws_name);
   ldRef.setPropertyValue("Precount", "1");
@@ -288,6 +294,18 @@ public:
     }
   }
 
+  void test_multiprocess_loader_with_filters() {
+    if (!windows) {
+      const std::map<std::string, std::string> filters{
+          {"FilterByTofMin", "10000"},
+          {"FilterByTofMax", "60000"},
+          {"FilterByTimeStart", "100"},
+          {"FilterByTimeStop", "1000"}};
+      run_multiprocess_load("SANS2D00022048.nxs", true, filters);
+      run_multiprocess_load("SANS2D00022048.nxs", false, filters);
+    }
+  }
+
   void test_SingleBank_PixelsOnlyInThatBank() { doTestSingleBank(true, false); }
 
   void test_load_event_nexus_ornl_eqsans() {
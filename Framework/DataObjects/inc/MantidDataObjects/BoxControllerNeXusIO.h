@@ -57,6 +57,9 @@ public:
   void setDataType(const size_t blockSize,
                    const std::string &typeName) override;
   void getDataType(size_t &CoordSize, std::string &typeName) const override;
+  /// Compress the events if the file creates a new events data block. Has to
+  /// be set before the file is opened. Existing files keep their settings.
+  void setCompression(const bool compress) { m_compress = compress; }
   //------------------------------------------------------------------------------------------------------------------------
   // Auxiliary functions (non-virtual, used for testing)
   int64_t getNDataColums() const { return m_BlockSize[1]; }
@@ -90,6 +93,8 @@ private:
   std::vector<int64_t> m_BlockSize;
   /// lock Nexus file operations as Nexus is not thread safe
   mutable std::mutex m_fileMutex;
+  /// compress the events data block when creating it
+  bool m_compress{false};
 
   // Mainly static information which may be split into different IO classes
   // selected through chein of responsibility.
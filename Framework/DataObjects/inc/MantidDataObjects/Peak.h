@@ -168,6 +168,11 @@ public:
 
   double getValueByColName(const std::string &name_in) const;
 
+  /// Function getting the value of a numeric column from a peak
+  using ColumnValueFunction = double (*)(const Peak &);
+  static ColumnValueFunction
+  getValueFunctionByColName(const std::string &name_in);
+
   /// Get the peak shape.
   const Mantid::Geometry::PeakShape &getPeakShape() const override;
 
@@ -110,6 +110,10 @@ public:
 
   std::vector<Peak> &getPeaks();
   const std::vector<Peak> &getPeaks() const;
+  /// Get the values of a numeric column for all the peaks at once
+  std::vector<double> getColumnValues(const std::string &name) const;
+  /// Get the Q vectors of all the peaks at once
+  std::vector<Kernel::V3D> getQSampleFrames() const;
   bool hasIntegratedPeaks() const override;
   size_t getMemorySize() const override;
 
@@ -284,6 +284,38 @@ void CoordTransformAffine::apply(const coord_t *inputVector,
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to a batch of vectors. Each output
+ * coordinate is summed in the same order as apply() so the results are
+ * identical, but the loop over the batch is innermost so that it vectorises.
+ *
+ * @param inputVectors :: numVectors input vectors of size inD, one after the
+ *other
+ * @param outVectors :: numVectors output vectors of size outD, one after the
+ *other
+ * @param numVectors :: number of vectors to transform
+ */
+void CoordTransformAffine::applyBatch(const coord_t *inputVectors,
+                                      coord_t *outVectors,
+                                      const size_t numVectors) const {
+  for (size_t out = 0; out < outD; ++out) {
+    const coord_t *rawMatrixRow = m_rawMatrix[out];
+    coord_t *outVal = outVectors + out;
+    for (size_t i = 0; i < numVectors; ++i)
+      outVal[i * outD] = 0.0;
+    for (size_t in = 0; in < inD; ++in) {
+      const coord_t matrixElement = rawMatrixRow[in];
+      const coord_t *inVal = inputVectors + in;
+      for (size_t i = 0; i < numVectors; ++i)
+        outVal[i * outD] += matrixElement * inVal[i * inD];
+    }
+    // The last input coordinate is "1" always
+    const coord_t offset = rawMatrixRow[inD];
+    for (size_t i = 0; i < numVectors; ++i)
+      outVal[i * outD] += offset;
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Serialize the coordinate transform
  *
@@ -970,38 +970,52 @@ double Peak::getL2() const { return (detPos - samplePos).norm(); }
  *double.
  */
 double Peak::getValueByColName(const std::string &name_in) const {
+  return getValueFunctionByColName(name_in)(*this);
+}
+
+// -------------------------------------------------------------------------------------
+/** Look up the function getting the value of a numeric column, so the values
+ * of many peaks can be read without finding the column by name for each one.
+ *
+ * @param name_in :: name of the column in the table workspace
+ * @return a function returning the value of that column for a peak
+ * @throw std::runtime_error if you asked for a column that can't convert to
+ *double.
+ */
+Peak::ColumnValueFunction
+Peak::getValueFunctionByColName(const std::string &name_in) {
   std::string name = name_in;
   std::transform(name.begin(), name.end(), name.begin(), ::tolower);
   if (name == "runnumber")
-    return double(this->getRunNumber());
+    return [](const Peak &p) { return double(p.getRunNumber()); };
   else if (name == "detid")
-    return double(this->getDetectorID());
+    return [](const Peak &p) { return double(p.getDetectorID()); };
   else if (name == "h")
-    return this->getH();
+    return [](const Peak &p) { return p.getH(); };
   else if (name == "k")
-    return this->getK();
+    return [](const Peak &p) { return p.getK(); };
   else if (name == "l")
-    return this->getL();
+    return [](const Peak &p) { return p.getL(); };
   else if (name == "wavelength")
-    return this->getWavelength();
+    return [](const Peak &p) { return p.getWavelength(); };
   else if (name == "energy")
-    return this->getInitialEnergy();
+    return [](const Peak &p) { return p.getInitialEnergy(); };
   else if (name == "tof")
-    return this->getTOF();
+    return [](const Peak &p) { return p.getTOF(); };
   else if (name == "dspacing")
-    return this->getDSpacing();
+    return [](const Peak &p) { return p.getDSpacing(); };
   else if (name == "intens")
-    return this->getIntensity();
+    return [](const Peak &p) { return p.getIntensity(); };
   else if (name == "sigint")
-    return this->getSigmaIntensity();
+    return [](const Peak &p) { return p.getSigmaIntensity(); };
   else if (name == "bincount")
-    return this->getBinCount();
+    return [](const Peak &p) { return p.getBinCount(); };
   else if (name == "row")
-    return this->getRow();
+    return [](const Peak &p) { return double(p.getRow()); };
   else if (name == "col")
-    return this->getCol();
+    return [](const Peak &p) { return double(p.getCol()); };
   else if (name == "peaknumber")
-    return double(this->getPeakNumber());
+    return [](const Peak &p) { return double(p.getPeakNumber()); };
   else
     throw std::runtime_error(
         "Peak::getValueByColName() unknown column or column is not a number: " +
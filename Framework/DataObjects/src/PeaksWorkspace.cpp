@@ -19,6 +19,7 @@
 #include "MantidGeometry/Instrument/Goniometer.h"
 #include "MantidKernel/DateAndTime.h"
 #include "MantidKernel/Logger.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/PhysicalConstants.h"
 #include "MantidKernel/Quat.h"
 #include "MantidKernel/Unit.h"
@@ -32,6 +33,7 @@
 #include <cstdlib>
 #include <exception>
 #include <fstream>
+#include <numeric>
 // clang-format off
 #include <nexus/NeXusFile.hpp>
 #include <nexus/NeXusException.hpp>
@@ -77,66 +79,63 @@ PeaksWorkspace::PeaksWorkspace(const PeaksWorkspace &other)
   setNumberOfDetectorGroups(0);
 }
 
-//=====================================================================================
-//=====================================================================================
-/** Comparator class for sorting peaks by one or more criteria
+//---------------------------------------------------------------------------------------------
+/** Sort the peaks by one or more criteria
+ *
+ * The values of each criterion are gathered into a column first, so peaks
+ * are compared without looking up their values by name, and each peak is
+ * moved only once.
+ *
+ * @param criteria : a vector with a list of pairs: column name, bool;
+ *        where bool = true for ascending, false for descending sort.
+ *        The peaks are sorted by the first criterion first, then the 2nd if
+ *equal, etc.
  */
-class PeakComparator : public std::binary_function<Peak, Peak, bool> {
-public:
-  std::vector<std::pair<std::string, bool>> &criteria;
+void PeaksWorkspace::sort(std::vector<std::pair<std::string, bool>> &criteria) {
+  std::vector<std::vector<double>> values(criteria.size());
+  std::vector<std::vector<std::string>> bankNames(criteria.size());
+  for (size_t i = 0; i < criteria.size(); ++i) {
+    if (criteria[i].first == "BankName") {
+      bankNames[i].reserve(peaks.size());
+      for (const auto &peak : peaks)
+        bankNames[i].push_back(peak.getBankName());
+    } else {
+      values[i] = getColumnValues(criteria[i].first);
+    }
+  }
 
-  /** Constructor for the comparator for sorting peaks
-   * @param criteria : a vector with a list of pairs: column name, bool;
-   *        where bool = true for ascending, false for descending sort.
-   */
-  explicit PeakComparator(std::vector<std::pair<std::string, bool>> &criteria)
-      : criteria(criteria) {}
-
-  /** Compare two peaks using the stored criteria */
-  inline bool operator()(const Peak &a, const Peak &b) {
-    for (auto &name : criteria) {
-      std::string &col = name.first;
-      bool ascending = name.second;
+  std::vector<size_t> order(peaks.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    for (size_t i = 0; i < criteria.size(); ++i) {
       bool lessThan = false;
-      if (col == "BankName") {
-        // If this criterion is equal, move on to the next one
-        std::string valA = a.getBankName();
-        std::string valB = b.getBankName();
+      if (!bankNames[i].empty()) {
+        const auto &valA = bankNames[i][a];
+        const auto &valB = bankNames[i][b];
         // Move on to lesser criterion if equal
         if (valA == valB)
           continue;
         lessThan = (valA < valB);
       } else {
-        // General double comparison
-        double valA = a.getValueByColName(col);
-        double valB = b.getValueByColName(col);
+        const double valA = values[i][a];
+        const double valB = values[i][b];
         // Move on to lesser criterion if equal
         if (valA == valB)
           continue;
         lessThan = (valA < valB);
       }
       // Flip the sign of comparison if descending.
-      if (ascending)
-        return lessThan;
-      else
-        return !lessThan;
+      return criteria[i].second ? lessThan : !lessThan;
     }
     // If you reach here, all criteria were ==; so not <, so return false
     return false;
-  }
-};
+  });
 
-//---------------------------------------------------------------------------------------------
-/** Sort the peaks by one or more criteria
- *
- * @param criteria : a vector with a list of pairs: column name, bool;
- *        where bool = true for ascending, false for descending sort.
- *        The peaks are sorted by the first criterion first, then the 2nd if
- *equal, etc.
- */
-void PeaksWorkspace::sort(std::vector<std::pair<std::string, bool>> &criteria) {
-  PeakComparator comparator(criteria);
-  std::stable_sort(peaks.begin(), peaks.end(), comparator);
+  std::vector<Peak> sorted;
+  sorted.reserve(peaks.size());
+  for (const auto index : order)
+    sorted.push_back(std::move(peaks[index]));
+  peaks.swap(sorted);
 }
 
 //---------------------------------------------------------------------------------------------
@@ -167,18 +166,15 @@ void PeaksWorkspace::removePeak(const int peakNum) {
 void PeaksWorkspace::removePeaks(std::vector<int> badPeaks) {
   if (badPeaks.empty())
     return;
+  std::vector<char> isBad(peaks.size(), false);
+  for (const int badPeak : badPeaks) {
+    if (badPeak >= 0 && badPeak < static_cast<int>(peaks.size()))
+      isBad[badPeak] = true;
+  }
   // if index of peak is in badPeaks remove
-  int ip = -1;
-  auto it =
-      std::remove_if(peaks.begin(), peaks.end(), [&ip, badPeaks](Peak &pk) {
-        (void)pk;
-        ip++;
-        for (int badPeak : badPeaks) {
-          if (badPeak == ip)
-            return true;
-        }
-        return false;
-      });
+  size_t ip = 0;
+  auto it = std::remove_if(peaks.begin(), peaks.end(),
+                           [&ip, &isBad](const Peak &) { return isBad[ip++]; });
   peaks.erase(it, peaks.end());
 }
 
@@ -209,7 +205,9 @@ void PeaksWorkspace::addPeak(const V3D &position,
 /** Add a peak to the list
  * @param peak :: Peak object to add (move) into this.
  */
-void PeaksWorkspace::addPeak(Peak &&peak) { peaks.push_back(peak); }
+void PeaksWorkspace::addPeak(Peak &&peak) {
+  peaks.push_back(std::move(peak));
+}
 
 //---------------------------------------------------------------------------------------------
 /** Return a reference to the Peak
@@ -594,6 +592,41 @@ std::vector<Peak> &PeaksWorkspace::getPeaks() { return peaks; }
 /** Return a const reference to the Peaks vector */
 const std::vector<Peak> &PeaksWorkspace::getPeaks() const { return peaks; }
 
+//---------------------------------------------------------------------------------------------
+/** Get the values of a numeric column for all the peaks at once. The column
+ * is looked up by name only once and the values are read in parallel.
+ *
+ * @param name :: name of the column, as accepted by Peak::getValueByColName
+ * @return the value of the column for each peak, in the order of the peaks
+ * @throw std::runtime_error if the column is unknown or not a number
+ */
+std::vector<double>
+PeaksWorkspace::getColumnValues(const std::string &name) const {
+  const auto valueOf = Peak::getValueFunctionByColName(name);
+  const auto nPeaks = static_cast<int64_t>(peaks.size());
+  std::vector<double> values(peaks.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < nPeaks; ++i) {
+    values[i] = valueOf(peaks[i]);
+  }
+  return values;
+}
+
+//---------------------------------------------------------------------------------------------
+/** Get the Q vectors in the sample frame of all the peaks at once
+ *
+ * @return the Q vector of each peak, in the order of the peaks
+ */
+std::vector<V3D> PeaksWorkspace::getQSampleFrames() const {
+  const auto nPeaks = static_cast<int64_t>(peaks.size());
+  std::vector<V3D> qs(peaks.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < nPeaks; ++i) {
+    qs[i] = peaks[i].getQSampleFrame();
+  }
+  return qs;
+}
+
 /** Getter for the integration status.
  @return TRUE if it has been integrated using a peak integration algorithm.
  */
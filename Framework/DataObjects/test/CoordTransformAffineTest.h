@@ -126,6 +126,33 @@ public:
                                ct.applyVMD(VMD(1.0, 2.0, 3.0)));
   }
 
+  /** applyBatch() gives exactly what apply() does for each vector */
+  void test_applyBatch() {
+    CoordTransformAffine ct(3, 2);
+    Matrix<coord_t> mat(3, 4);
+    mat[0][0] = 0.3f;
+    mat[0][1] = -1.7f;
+    mat[0][2] = 2.1f;
+    mat[0][3] = 0.25f;
+    mat[1][0] = 1.1f;
+    mat[1][2] = 0.9f;
+    mat[1][3] = -3.5f;
+    mat[2][3] = 1.0f;
+    ct.setMatrix(mat);
+
+    std::vector<coord_t> in(7 * 3);
+    for (size_t i = 0; i < in.size(); ++i)
+      in[i] = static_cast<coord_t>(i) * 0.37f - 2.0f;
+    std::vector<coord_t> out(7 * 2);
+    ct.applyBatch(in.data(), out.data(), 7);
+    coord_t expected[2];
+    for (size_t i = 0; i < 7; ++i) {
+      ct.apply(in.data() + i * 3, expected);
+      TS_ASSERT_EQUALS(out[i * 2], expected[0]);
+      TS_ASSERT_EQUALS(out[i * 2 + 1], expected[1]);
+    }
+  }
+
   /** Test rotation in isolation */
   void test_rotation() {
     using Mantid::Kernel::V3D;
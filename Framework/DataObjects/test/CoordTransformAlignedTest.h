@@ -77,6 +77,24 @@ public:
     TS_ASSERT_DELTA(output[2], 3.0, 1e-6);
   }
 
+  void test_applyBatch() {
+    size_t dimToBinFrom[3] = {3, 1, 0};
+    coord_t origin[3] = {5, 10, 15};
+    coord_t scaling[3] = {1, 2, 3};
+    CoordTransformAligned ct(4, 3, dimToBinFrom, origin, scaling);
+
+    coord_t input[8] = {16, 11, 11111111 /*ignored*/, 6,
+                        17, 13, 11111111 /*ignored*/, 8};
+    coord_t output[6] = {0, 0, 0, 0, 0, 0};
+    ct.applyBatch(input, output, 2);
+    TS_ASSERT_DELTA(output[0], 1.0, 1e-6);
+    TS_ASSERT_DELTA(output[1], 2.0, 1e-6);
+    TS_ASSERT_DELTA(output[2], 3.0, 1e-6);
+    TS_ASSERT_DELTA(output[3], 3.0, 1e-6);
+    TS_ASSERT_DELTA(output[4], 6.0, 1e-6);
+    TS_ASSERT_DELTA(output[5], 6.0, 1e-6);
+  }
+
   /// Clone the transform, check that it still works
   void test_clone() {
     size_t dimToBinFrom[3] = {3, 1, 0};
@@ -553,6 +553,37 @@ public:
     std::vector<int> badPeaks{0, 2, 3};
     pw->removePeaks(std::move(badPeaks));
     TS_ASSERT_EQUALS(pw->getNumberPeaks(), 1);
+    TS_ASSERT_EQUALS(pw->getPeak(0).getDetectorID(), 1);
+    TS_ASSERT_DELTA(pw->getPeak(0).getWavelength(), 3.0, 1e-5);
+  }
+
+  void test_getColumnValues() {
+    auto pw = buildPW();
+    Instrument_const_sptr inst = pw->getInstrument();
+    pw->addPeak(Peak(inst, 2, 4.0));
+    pw->addPeak(Peak(inst, 3, 5.0));
+
+    const auto detIDs = pw->getColumnValues("DetID");
+    TS_ASSERT_EQUALS(detIDs, std::vector<double>({1, 2, 3}));
+    const auto wavelengths = pw->getColumnValues("Wavelength");
+    TS_ASSERT_EQUALS(wavelengths.size(), 3);
+    for (int i = 0; i < pw->getNumberPeaks(); ++i) {
+      TS_ASSERT_EQUALS(wavelengths[i], pw->getPeak(i).getWavelength());
+    }
+    TS_ASSERT_THROWS(pw->getColumnValues("BankName"),
+                     const std::runtime_error &);
+  }
+
+  void test_getQSampleFrames() {
+    auto pw = buildPW();
+    Instrument_const_sptr inst = pw->getInstrument();
+    pw->addPeak(Peak(inst, 2, 4.0));
+
+    const auto qs = pw->getQSampleFrames();
+    TS_ASSERT_EQUALS(qs.size(), 2);
+    for (int i = 0; i < pw->getNumberPeaks(); ++i) {
+      TS_ASSERT_EQUALS(qs[i], pw->getPeak(i).getQSampleFrame());
+    }
   }
 
 private:
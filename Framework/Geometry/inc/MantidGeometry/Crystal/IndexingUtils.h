@@ -53,7 +53,9 @@ public:
   static double Find_UB(Kernel::DblMatrix &UB,
                         const std::vector<Kernel::V3D> &q_vectors, double min_d,
                         double max_d, double required_tolerance,
-                        double degrees_per_step, int iterations = 4);
+                        double degrees_per_step, int iterations = 4,
+                        const std::vector<Kernel::V3D> &prior_directions =
+                            std::vector<Kernel::V3D>());
 
   /// Find the UB matrix that most nearly maps hkl to qxyz for 3 or more peaks
   static double Optimize_UB(Kernel::DblMatrix &UB,
@@ -92,6 +94,14 @@ public:
                                       double required_tolerance,
                                       double degrees_per_step);
 
+  /// Refine possible real space unit cell edges for the q_vectors and keep
+  /// those that index the most peaks
+  static size_t RefineDirections(std::vector<Kernel::V3D> &directions,
+                                 const std::vector<Kernel::V3D> &candidates,
+                                 const std::vector<Kernel::V3D> &q_vectors,
+                                 double min_d, double max_d,
+                                 double required_tolerance);
+
   /// Get the magnitude of the FFT of the projections of the q_vectors on
   /// the current direction vector.
   static double GetMagFFT(const std::vector<Kernel::V3D> &q_vectors,
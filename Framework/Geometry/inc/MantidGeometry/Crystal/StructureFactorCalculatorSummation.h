@@ -9,6 +9,7 @@
 
 #include "MantidGeometry/Crystal/StructureFactorCalculator.h"
 #include "MantidGeometry/DllConfig.h"
+#include "MantidKernel/Matrix.h"
 
 namespace Mantid {
 namespace Geometry {
@@ -20,6 +21,11 @@ namespace Geometry {
   the unit cell by combining the space group and the scatterers located in the
   asymmetric unit (both taken from CrystalStructure) and stores them.
 
+  When all scatterers are IsotropicAtomBraggScatterer, their parameters and
+  equivalent positions are additionally copied into flat arrays, so that
+  structure factors are summed without virtual calls and property lookups.
+  Lists of HKLs passed to getFs and getFsSquared are processed in parallel.
+
       @author Michael Wedel, ESS
       @date 05/09/2015
 */
@@ -29,14 +35,36 @@ public:
   StructureFactorCalculatorSummation();
   StructureFactor getF(const Kernel::V3D &hkl) const override;
 
+  std::vector<StructureFactor>
+  getFs(const std::vector<Kernel::V3D> &hkls) const override;
+  std::vector<double>
+  getFsSquared(const std::vector<Kernel::V3D> &hkls) const override;
+
 protected:
+  /// Parameters of one atom in the asymmetric unit and the fractional
+  /// coordinates of all its equivalents in the unit cell.
+  struct AtomSite {
+    double occupancy;
+    double u;
+    double scatteringLength;
+    Kernel::DblMatrix b;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+  };
+
   void
   crystalStructureSetHook(const CrystalStructure &crystalStructure) override;
 
   void updateUnitCellScatterers(const CrystalStructure &crystalStructure);
   std::string getV3DasString(const Kernel::V3D &point) const;
 
+  void updateAtomSites(const std::vector<size_t> &positionsPerSite);
+  StructureFactor getFFromAtomSites(const Kernel::V3D &hkl) const;
+
   CompositeBraggScatterer_sptr m_unitCellScatterers;
+  std::vector<AtomSite> m_atomSites;
+  bool m_useAtomSites;
 };
 
 using StructureFactorSummation_sptr =
@@ -7,6 +7,7 @@
 #include "MantidGeometry/Crystal/IndexingUtils.h"
 #include "MantidGeometry/Crystal/NiggliCell.h"
 #include "MantidKernel/EigenConversionHelpers.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/Quat.h"
 
 #include <boost/math/special_functions/round.hpp>
@@ -31,6 +32,75 @@ using Mantid::Kernel::V3D;
 namespace {
 const constexpr double DEG_TO_RAD = M_PI / 180.;
 const constexpr double RAD_TO_DEG = 180. / M_PI;
+
+/// The fraction of the peaks that the cell edges of an earlier solution
+/// must index to be used without scanning all directions
+const constexpr double MIN_PRIOR_INDEXED_FRACTION = 0.75;
+
+/// Q vectors divided by 2 pi, stored by component so that their projections
+/// on a direction are calculated in batches the compiler can vectorise
+struct ScaledQs {
+  explicit ScaledQs(const std::vector<V3D> &q_vectors) {
+    x.reserve(q_vectors.size());
+    y.reserve(q_vectors.size());
+    z.reserve(q_vectors.size());
+    for (const auto &q_vector : q_vectors) {
+      const V3D q_vec = q_vector / (2.0 * M_PI);
+      x.push_back(q_vec.X());
+      y.push_back(q_vec.Y());
+      z.push_back(q_vec.Z());
+    }
+  }
+  std::vector<double> x, y, z;
+};
+
+/// Histogram the projections of the Q vectors on a direction and return the
+/// largest magnitude of its FFT past DC. See IndexingUtils::GetMagFFT.
+double magnitudeFFT(const ScaledQs &qs, const V3D &current_dir, const size_t N,
+                    double projections[], double index_factor,
+                    double magnitude_fft[]) {
+  constexpr size_t BATCH_SIZE = 64;
+  std::fill(projections, projections + N, 0.0);
+  // project onto direction
+  const double dir_x = current_dir.X();
+  const double dir_y = current_dir.Y();
+  const double dir_z = current_dir.Z();
+  const size_t num_qs = qs.x.size();
+  double dot_prods[BATCH_SIZE];
+  for (size_t start = 0; start < num_qs; start += BATCH_SIZE) {
+    const size_t batch = std::min(BATCH_SIZE, num_qs - start);
+    const double *x = qs.x.data() + start;
+    const double *y = qs.y.data() + start;
+    const double *z = qs.z.data() + start;
+    for (size_t i = 0; i < batch; i++)
+      dot_prods[i] = fabs(index_factor *
+                          (dir_x * x[i] + dir_y * y[i] + dir_z * z[i]));
+    for (size_t i = 0; i < batch; i++) {
+      size_t index = static_cast<size_t>(dot_prods[i]);
+      if (index < N)
+        projections[index] += 1;
+      else
+        projections[N - 1] += 1; // This should not happen, but trap it in
+    }                            // case of rounding errors.
+  }
+
+  // get the |FFT|
+  gsl_fft_real_radix2_transform(projections, 1, N);
+  for (size_t i = 1; i < N / 2; i++) {
+    magnitude_fft[i] = sqrt(projections[i] * projections[i] +
+                            projections[N - i] * projections[N - i]);
+  }
+
+  magnitude_fft[0] = fabs(projections[0]);
+
+  size_t dc_end = 5; // we may need a better estimate of this
+  double max_mag_fft = 0.0;
+  for (size_t i = dc_end; i < N / 2; i++)
+    if (magnitude_fft[i] > max_mag_fft)
+      max_mag_fft = magnitude_fft[i];
+
+  return max_mag_fft;
+}
 } // namespace
 
 /**
@@ -457,6 +527,11 @@ double IndexingUtils::Find_UB(DblMatrix &UB, const std::vector<V3D> &q_vectors,
   @param  degrees_per_step    The number of degrees between different
                               orientations used during the initial scan.
   @param  iterations          Number of refinements of UB
+  @param  prior_directions    Real space unit cell edges of an earlier
+                              solution for the same crystal, e.g. from the
+                              previous run of a rotation series. If, once
+                              refined, they index enough of the peaks, the
+                              scan through all directions is skipped.
 
   @return  This will return the sum of the squares of the residual errors.
 
@@ -473,7 +548,8 @@ double IndexingUtils::Find_UB(DblMatrix &UB, const std::vector<V3D> &q_vectors,
 double IndexingUtils::Find_UB(DblMatrix &UB, const std::vector<V3D> &q_vectors,
                               double min_d, double max_d,
                               double required_tolerance,
-                              double degrees_per_step, int iterations) {
+                              double degrees_per_step, int iterations,
+                              const std::vector<V3D> &prior_directions) {
   if (UB.numRows() != 3 || UB.numCols() != 3) {
     throw std::invalid_argument("Find_UB(): UB matrix NULL or not 3X3");
   }
@@ -497,33 +573,47 @@ double IndexingUtils::Find_UB(DblMatrix &UB, const std::vector<V3D> &q_vectors,
   }
 
   std::vector<V3D> directions;
+  double min_vol = min_d * min_d * min_d / 4.0;
 
   // NOTE: we use a somewhat higher tolerance when
   // finding individual directions since it is easier
   // to index one direction individually compared to
   // indexing three directions simultaneously.
-  size_t max_indexed =
-      FFTScanFor_Directions(directions, q_vectors, min_d, max_d,
-                            0.75f * required_tolerance, degrees_per_step);
-
-  if (max_indexed == 0) {
-    throw std::invalid_argument(
-        "Find_UB(): Could not find any a,b,c vectors to index Qs");
+  bool found_UB = false;
+  if (!prior_directions.empty()) {
+    RefineDirections(directions, prior_directions, q_vectors, min_d, max_d,
+                     0.75f * required_tolerance);
+    std::sort(directions.begin(), directions.end(), V3D::compareMagnitude);
+    found_UB = directions.size() >= 3 &&
+               FormUB_From_abc_Vectors(UB, directions, q_vectors,
+                                       required_tolerance, min_vol) &&
+               NumberIndexed(UB, q_vectors, required_tolerance) >=
+                   MIN_PRIOR_INDEXED_FRACTION *
+                       static_cast<double>(q_vectors.size());
   }
 
-  if (directions.size() < 3) {
-    throw std::invalid_argument(
-        "Find_UB(): Could not find enough a,b,c vectors");
-  }
+  if (!found_UB) {
+    size_t max_indexed =
+        FFTScanFor_Directions(directions, q_vectors, min_d, max_d,
+                              0.75f * required_tolerance, degrees_per_step);
 
-  std::sort(directions.begin(), directions.end(), V3D::compareMagnitude);
+    if (max_indexed == 0) {
+      throw std::invalid_argument(
+          "Find_UB(): Could not find any a,b,c vectors to index Qs");
+    }
 
-  double min_vol = min_d * min_d * min_d / 4.0;
+    if (directions.size() < 3) {
+      throw std::invalid_argument(
+          "Find_UB(): Could not find enough a,b,c vectors");
+    }
 
-  if (!FormUB_From_abc_Vectors(UB, directions, q_vectors, required_tolerance,
-                               min_vol)) {
-    throw std::invalid_argument(
-        "Find_UB(): Could not form UB matrix from a,b,c vectors");
+    std::sort(directions.begin(), directions.end(), V3D::compareMagnitude);
+
+    if (!FormUB_From_abc_Vectors(UB, directions, q_vectors,
+                                 required_tolerance, min_vol)) {
+      throw std::invalid_argument(
+          "Find_UB(): Could not form UB matrix from a,b,c vectors");
+    }
   }
 
   Matrix<double> temp_UB(3, 3, false);
@@ -1213,9 +1303,6 @@ size_t IndexingUtils::FFTScanFor_Directions(std::vector<V3D> &directions,
   constexpr size_t N_FFT_STEPS = 512;
   constexpr size_t HALF_FFT_STEPS = 256;
 
-  double fit_error;
-  int max_indexed = 0;
-
   // first, make hemisphere of possible directions
   // with specified resolution.
   int num_steps = boost::math::iround(90.0 / degrees_per_step);
@@ -1232,38 +1319,31 @@ size_t IndexingUtils::FFTScanFor_Directions(std::vector<V3D> &directions,
 
   max_mag_Q *= 1.1f; // allow for a little "headroom" for FFT range
 
-  // apply the FFT to each of the directions, and
-  // keep track of their maximum magnitude past DC
-  double max_mag_fft;
-  std::vector<double> max_fft_val;
-  max_fft_val.resize(full_list.size());
-
-  double projections[N_FFT_STEPS];
-  double magnitude_fft[HALF_FFT_STEPS];
-
+  const ScaledQs scaled_qs(q_vectors);
   double index_factor = N_FFT_STEPS / max_mag_Q; // maps |proj Q| to index
 
-  for (size_t dir_num = 0; dir_num < full_list.size(); dir_num++) {
-    V3D current_dir = full_list[dir_num];
-    max_mag_fft = GetMagFFT(q_vectors, current_dir, N_FFT_STEPS, projections,
-                            index_factor, magnitude_fft);
-
-    max_fft_val[dir_num] = max_mag_fft;
+  // apply the FFT to each of the directions, and
+  // keep track of their maximum magnitude past DC.
+  // The directions are independent so are scanned in parallel.
+  std::vector<double> max_fft_val(full_list.size());
+  const auto num_directions = static_cast<int64_t>(full_list.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t dir_num = 0; dir_num < num_directions; dir_num++) {
+    double projections[N_FFT_STEPS];
+    double magnitude_fft[HALF_FFT_STEPS];
+    max_fft_val[dir_num] =
+        magnitudeFFT(scaled_qs, full_list[dir_num], N_FFT_STEPS, projections,
+                     index_factor, magnitude_fft);
   }
   // find the directions with the 500 largest
   // fft values, and place them in temp_dirs vector
   int N_TO_TRY = 500;
 
-  std::vector<double> max_fft_copy;
-  max_fft_copy.resize(full_list.size());
-  for (size_t i = 0; i < max_fft_copy.size(); i++) {
-    max_fft_copy[i] = max_fft_val[i];
-  }
-
+  std::vector<double> max_fft_copy(max_fft_val);
   std::sort(max_fft_copy.begin(), max_fft_copy.end());
 
   size_t index = max_fft_copy.size() - 1;
-  max_mag_fft = max_fft_copy[index];
+  double max_mag_fft = max_fft_copy[index];
 
   double threshold = max_mag_fft;
   while ((index > max_fft_copy.size() - N_TO_TRY) &&
@@ -1282,12 +1362,15 @@ size_t IndexingUtils::FFTScanFor_Directions(std::vector<V3D> &directions,
   // FFT to find the cell edge length that
   // corresponds to the max_mag_fft.  Only keep
   // directions with length nearly in bounds
-  V3D temp;
-  std::vector<V3D> temp_dirs_2;
-
-  for (auto &temp_dir : temp_dirs) {
-    GetMagFFT(q_vectors, temp_dir, N_FFT_STEPS, projections, index_factor,
-              magnitude_fft);
+  std::vector<V3D> scaled_dirs(temp_dirs.size());
+  std::vector<char> in_bounds(temp_dirs.size(), false);
+  const auto num_temp_dirs = static_cast<int64_t>(temp_dirs.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < num_temp_dirs; i++) {
+    double projections[N_FFT_STEPS];
+    double magnitude_fft[HALF_FFT_STEPS];
+    magnitudeFFT(scaled_qs, temp_dirs[i], N_FFT_STEPS, projections,
+                 index_factor, magnitude_fft);
 
     double position =
         GetFirstMaxIndex(magnitude_fft, HALF_FFT_STEPS, threshold);
@@ -1295,52 +1378,92 @@ size_t IndexingUtils::FFTScanFor_Directions(std::vector<V3D> &directions,
       double q_val = max_mag_Q / position;
       double d_val = 1 / q_val;
       if (d_val >= 0.8 * min_d && d_val <= 1.2 * max_d) {
-        temp = temp_dir * d_val;
-        temp_dirs_2.push_back(temp);
+        scaled_dirs[i] = temp_dirs[i] * d_val;
+        in_bounds[i] = true;
       }
     }
   }
+  std::vector<V3D> temp_dirs_2;
+  for (size_t i = 0; i < scaled_dirs.size(); i++) {
+    if (in_bounds[i])
+      temp_dirs_2.push_back(scaled_dirs[i]);
+  }
   // look at how many peaks were indexed
   // for each of the initial directions
-  max_indexed = 0;
-  int num_indexed;
-  V3D current_dir;
-  for (auto &dir_num : temp_dirs_2) {
-    current_dir = dir_num;
-    num_indexed = NumberIndexed_1D(current_dir, q_vectors, required_tolerance);
-    if (num_indexed > max_indexed)
-      max_indexed = num_indexed;
+  std::vector<int> num_indexed(temp_dirs_2.size());
+  const auto num_temp_dirs_2 = static_cast<int64_t>(temp_dirs_2.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < num_temp_dirs_2; i++) {
+    num_indexed[i] =
+        NumberIndexed_1D(temp_dirs_2[i], q_vectors, required_tolerance);
   }
+  int max_indexed = 0;
+  for (const auto count : num_indexed)
+    max_indexed = std::max(max_indexed, count);
 
   // only keep original directions that index
   // at least 50% of max num indexed
   temp_dirs.clear();
-  for (auto &dir_num : temp_dirs_2) {
-    current_dir = dir_num;
-    num_indexed = NumberIndexed_1D(current_dir, q_vectors, required_tolerance);
-    if (num_indexed >= 0.50 * max_indexed)
-      temp_dirs.push_back(current_dir);
+  for (size_t i = 0; i < temp_dirs_2.size(); i++) {
+    if (num_indexed[i] >= 0.50 * max_indexed)
+      temp_dirs.push_back(temp_dirs_2[i]);
   }
+
+  return RefineDirections(directions, temp_dirs, q_vectors, min_d, max_d,
+                          required_tolerance);
+}
+
+/**
+   Refine possible edge vectors for the real space unit cell so that they
+   best index the specified q_vectors, and keep those that index the most
+   peaks.  Each direction is refined by repeatedly optimizing it for the
+   peaks it indexes.  Only the refined directions with lengths nearly in
+   bounds, that index at least 75% of the most peaks indexed by any of them,
+   are kept and duplicates are discarded.  This is the last step of
+   FFTScanFor_Directions, and can be applied on its own to the unit cell edges
+   found for an earlier set of peaks from the same crystal.
+    @param  directions          Vector that will be filled with the refined
+                                directions, in order of increasing length.
+    @param  candidates          Vector of possible unit cell edge vectors.
+    @param  q_vectors           Vector of new Vector3D objects that contains
+                                the list of q_vectors that are to be indexed.
+    @param  min_d               Lower bound on shortest unit cell edge length.
+    @param  max_d               Upper bound on longest unit cell edge length.
+    @param  required_tolerance  The maximum allowed deviation of Miller indices
+                                from integer values for a peak to be indexed.
+    @return The maximum number of peaks indexed by one of the refined
+            directions.
+ */
+size_t IndexingUtils::RefineDirections(std::vector<V3D> &directions,
+                                       const std::vector<V3D> &candidates,
+                                       const std::vector<V3D> &q_vectors,
+                                       double min_d, double max_d,
+                                       double required_tolerance) {
   // refine directions and again find the
   // max number indexed, for the optimized
   // directions
-  max_indexed = 0;
-  std::vector<int> index_vals;
-  std::vector<V3D> indexed_qs;
-  for (auto &temp_dir : temp_dirs) {
-    num_indexed = GetIndexedPeaks_1D(temp_dir, q_vectors, required_tolerance,
-                                     index_vals, indexed_qs, fit_error);
+  std::vector<V3D> temp_dirs(candidates);
+  std::vector<int> max_refined_indexed(temp_dirs.size(), 0);
+  const auto num_temp_dirs = static_cast<int64_t>(temp_dirs.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < num_temp_dirs; i++) {
+    auto &temp_dir = temp_dirs[i];
+    std::vector<int> index_vals;
+    std::vector<V3D> indexed_qs;
+    double fit_error;
+    GetIndexedPeaks_1D(temp_dir, q_vectors, required_tolerance, index_vals,
+                       indexed_qs, fit_error);
     try {
       int count = 0;
       while (count < 5) // 5 iterations should be enough for
       {                 // the optimization to stabilize
         Optimize_Direction(temp_dir, index_vals, indexed_qs);
 
-        num_indexed =
+        int num_indexed =
             GetIndexedPeaks_1D(temp_dir, q_vectors, required_tolerance,
                                index_vals, indexed_qs, fit_error);
-        if (num_indexed > max_indexed)
-          max_indexed = num_indexed;
+        if (num_indexed > max_refined_indexed[i])
+          max_refined_indexed[i] = num_indexed;
 
         count++;
       }
@@ -1348,20 +1471,23 @@ size_t IndexingUtils::FFTScanFor_Directions(std::vector<V3D> &directions,
       // don't continue to refine if the direction fails to optimize properly
     }
   }
+  int max_indexed = 0;
+  for (const auto count : max_refined_indexed)
+    max_indexed = std::max(max_indexed, count);
+
   // discard those with length out of bounds
-  temp_dirs_2.clear();
+  std::vector<V3D> temp_dirs_2;
   for (auto &temp_dir : temp_dirs) {
-    current_dir = temp_dir;
-    double length = current_dir.norm();
+    double length = temp_dir.norm();
     if (length >= 0.8 * min_d && length <= 1.2 * max_d)
-      temp_dirs_2.push_back(current_dir);
+      temp_dirs_2.push_back(temp_dir);
   }
   // only keep directions that index at
   // least 75% of the max number of peaks
   temp_dirs.clear();
-  for (auto &dir_num : temp_dirs_2) {
-    current_dir = dir_num;
-    num_indexed = NumberIndexed_1D(current_dir, q_vectors, required_tolerance);
+  for (auto &current_dir : temp_dirs_2) {
+    int num_indexed =
+        NumberIndexed_1D(current_dir, q_vectors, required_tolerance);
     if (num_indexed > max_indexed * 0.75)
       temp_dirs.push_back(current_dir);
   }
@@ -1404,37 +1530,8 @@ double IndexingUtils::GetMagFFT(const std::vector<V3D> &q_vectors,
                                 const V3D &current_dir, const size_t N,
                                 double projections[], double index_factor,
                                 double magnitude_fft[]) {
-  for (size_t i = 0; i < N; i++) {
-    projections[i] = 0.0;
-  }
-  // project onto direction
-  V3D q_vec;
-  for (const auto &q_vector : q_vectors) {
-    q_vec = q_vector / (2.0 * M_PI);
-    double dot_prod = current_dir.scalar_prod(q_vec);
-    size_t index = static_cast<size_t>(fabs(index_factor * dot_prod));
-    if (index < N)
-      projections[index] += 1;
-    else
-      projections[N - 1] += 1; // This should not happen, but trap it in
-  }                            // case of rounding errors.
-
-  // get the |FFT|
-  gsl_fft_real_radix2_transform(projections, 1, N);
-  for (size_t i = 1; i < N / 2; i++) {
-    magnitude_fft[i] = sqrt(projections[i] * projections[i] +
-                            projections[N - i] * projections[N - i]);
-  }
-
-  magnitude_fft[0] = fabs(projections[0]);
-
-  size_t dc_end = 5; // we may need a better estimate of this
-  double max_mag_fft = 0.0;
-  for (size_t i = dc_end; i < N / 2; i++)
-    if (magnitude_fft[i] > max_mag_fft)
-      max_mag_fft = magnitude_fft[i];
-
-  return max_mag_fft;
+  return magnitudeFFT(ScaledQs(q_vectors), current_dir, N, projections,
+                      index_factor, magnitude_fft);
 }
 
 /**
@@ -6,8 +6,11 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidGeometry/Crystal/StructureFactorCalculatorSummation.h"
 #include "MantidGeometry/Crystal/BraggScattererInCrystalStructure.h"
+#include "MantidGeometry/Crystal/IsotropicAtomBraggScatterer.h"
+#include "MantidKernel/MultiThreaded.h"
 
 #include <iomanip>
+#include <typeinfo>
 
 namespace Mantid {
 namespace Geometry {
@@ -16,14 +19,86 @@ using namespace Kernel;
 
 StructureFactorCalculatorSummation::StructureFactorCalculatorSummation()
     : StructureFactorCalculator(),
-      m_unitCellScatterers(CompositeBraggScatterer::create()) {}
+      m_unitCellScatterers(CompositeBraggScatterer::create()), m_atomSites(),
+      m_useAtomSites(false) {}
 
 /// Returns the structure factor obtained from the stored scatterers.
 StructureFactor
 StructureFactorCalculatorSummation::getF(const Kernel::V3D &hkl) const {
+  if (m_useAtomSites) {
+    return getFFromAtomSites(hkl);
+  }
+
   return m_unitCellScatterers->calculateStructureFactor(hkl);
 }
 
+/// Returns the structure factors for all HKLs, which are processed in
+/// parallel.
+std::vector<StructureFactor> StructureFactorCalculatorSummation::getFs(
+    const std::vector<Kernel::V3D> &hkls) const {
+  std::vector<StructureFactor> structureFactors(hkls.size());
+
+  PARALLEL_FOR_IF(m_useAtomSites)
+  for (int64_t i = 0; i < static_cast<int64_t>(hkls.size()); ++i) {
+    structureFactors[i] = getF(hkls[i]);
+  }
+
+  return structureFactors;
+}
+
+/// Returns the squared structure factors for all HKLs, which are processed in
+/// parallel.
+std::vector<double> StructureFactorCalculatorSummation::getFsSquared(
+    const std::vector<Kernel::V3D> &hkls) const {
+  std::vector<double> fSquareds(hkls.size());
+
+  PARALLEL_FOR_IF(m_useAtomSites)
+  for (int64_t i = 0; i < static_cast<int64_t>(hkls.size()); ++i) {
+    fSquareds[i] = getFSquared(hkls[i]);
+  }
+
+  return fSquareds;
+}
+
+/**
+ * Sums the structure factor over the stored atom sites
+ *
+ * The terms are the same as in IsotropicAtomBraggScatterer and are added in
+ * the same order as CompositeBraggScatterer does, but the Debye-Waller factor
+ * is evaluated once per site instead of once per equivalent position.
+ *
+ * @param hkl :: HKL for which the structure factor should be calculated
+ * @return Structure factor (complex).
+ */
+StructureFactor StructureFactorCalculatorSummation::getFFromAtomSites(
+    const Kernel::V3D &hkl) const {
+  const double h = hkl.X();
+  const double k = hkl.Y();
+  const double l = hkl.Z();
+
+  double real = 0.0;
+  double imag = 0.0;
+  for (const auto &site : m_atomSites) {
+    const V3D dstar = site.b * hkl;
+    const double amplitude =
+        site.occupancy *
+        exp(-2.0 * M_PI * M_PI * site.u * dstar.norm2()) *
+        site.scatteringLength;
+
+    const double *x = site.x.data();
+    const double *y = site.y.data();
+    const double *z = site.z.data();
+    const size_t nPositions = site.x.size();
+    for (size_t i = 0; i < nPositions; ++i) {
+      const double phase = 2.0 * M_PI * (x[i] * h + y[i] * k + z[i] * l);
+      real += amplitude * cos(phase);
+      imag += amplitude * sin(phase);
+    }
+  }
+
+  return StructureFactor(real, imag);
+}
+
 /// Calls updateUnitCellScatterers() to rebuild the complete list of scatterers.
 void StructureFactorCalculatorSummation::crystalStructureSetHook(
     const CrystalStructure &crystalStructure) {
@@ -42,6 +117,8 @@ void StructureFactorCalculatorSummation::crystalStructureSetHook(
 void StructureFactorCalculatorSummation::updateUnitCellScatterers(
     const CrystalStructure &crystalStructure) {
   m_unitCellScatterers->removeAllScatterers();
+  m_atomSites.clear();
+  m_useAtomSites = false;
 
   CompositeBraggScatterer_sptr scatterersInAsymmetricUnit =
       crystalStructure.getScatterers();
@@ -51,6 +128,8 @@ void StructureFactorCalculatorSummation::updateUnitCellScatterers(
     std::vector<BraggScatterer_sptr> braggScatterers;
     braggScatterers.reserve(scatterersInAsymmetricUnit->nScatterers() *
                             spaceGroup->order());
+    bool allIsotropicAtoms = true;
+    std::vector<size_t> positionsPerSite;
 
     for (size_t i = 0; i < scatterersInAsymmetricUnit->nScatterers(); ++i) {
       BraggScattererInCrystalStructure_sptr current =
@@ -61,6 +140,11 @@ void StructureFactorCalculatorSummation::updateUnitCellScatterers(
         std::vector<V3D> positions =
             spaceGroup->getEquivalentPositions(current->getPosition());
 
+        allIsotropicAtoms =
+            allIsotropicAtoms &&
+            typeid(*current) == typeid(IsotropicAtomBraggScatterer);
+        positionsPerSite.push_back(positions.size());
+
         for (auto &position : positions) {
           BraggScatterer_sptr clone = current->clone();
           clone->setProperty("Position", getV3DasString(position));
@@ -71,7 +155,51 @@ void StructureFactorCalculatorSummation::updateUnitCellScatterers(
     }
 
     m_unitCellScatterers->setScatterers(braggScatterers);
+
+    if (allIsotropicAtoms) {
+      updateAtomSites(positionsPerSite);
+    }
+  }
+}
+
+/**
+ * Copies the parameters of the unit cell scatterers into m_atomSites
+ *
+ * The values are read from the scatterers stored in m_unitCellScatterers, so
+ * they are exactly the ones IsotropicAtomBraggScatterer would use. All of
+ * them must be IsotropicAtomBraggScatterer.
+ *
+ * @param positionsPerSite :: Number of consecutive scatterers for each atom in
+ *the asymmetric unit.
+ */
+void StructureFactorCalculatorSummation::updateAtomSites(
+    const std::vector<size_t> &positionsPerSite) {
+  size_t scattererIndex = 0;
+  for (auto nPositions : positionsPerSite) {
+    AtomSite site;
+    for (size_t i = 0; i < nPositions; ++i) {
+      auto atom = boost::static_pointer_cast<IsotropicAtomBraggScatterer>(
+          m_unitCellScatterers->getScatterer(scattererIndex++));
+
+      if (i == 0) {
+        site.occupancy = atom->getOccupancy();
+        site.u = atom->getU();
+        site.scatteringLength = atom->getNeutronAtom().coh_scatt_length_real;
+        site.b = atom->getCell().getB();
+      }
+
+      const V3D position = atom->getPosition();
+      site.x.push_back(position.X());
+      site.y.push_back(position.Y());
+      site.z.push_back(position.Z());
+    }
+
+    if (nPositions > 0) {
+      m_atomSites.push_back(std::move(site));
+    }
   }
+
+  m_useAtomSites = true;
 }
 
 /// Return V3D as string without losing precision.
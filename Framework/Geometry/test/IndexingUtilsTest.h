@@ -207,6 +207,75 @@ public:
     }
   }
 
+  void test_Find_UB_using_FFT_starting_from_prior_directions() {
+    std::vector<V3D> q_vectors = getNatroliteQs();
+    double d_min = 6;
+    double d_max = 10;
+    double required_tolerance = 0.08;
+    double degrees_per_step = 1;
+
+    Matrix<double> UB(3, 3, false);
+    IndexingUtils::Find_UB(UB, q_vectors, d_min, d_max, required_tolerance,
+                           degrees_per_step);
+
+    // Cell edges of the solution, slightly off as for another run
+    Matrix<double> UB_inv(UB);
+    UB_inv.Invert();
+    std::vector<V3D> prior_directions;
+    for (size_t row = 0; row < 3; row++)
+      prior_directions.emplace_back(UB_inv[row][0] * 1.001,
+                                    UB_inv[row][1] - 0.002, UB_inv[row][2]);
+
+    Matrix<double> UB_from_prior(3, 3, false);
+    IndexingUtils::Find_UB(UB_from_prior, q_vectors, d_min, d_max,
+                           required_tolerance, degrees_per_step, 4,
+                           prior_directions);
+
+    TS_ASSERT_EQUALS(12, IndexingUtils::NumberIndexed(UB_from_prior, q_vectors,
+                                                      required_tolerance));
+    std::vector<double> UB_expected = UB.getVector();
+    std::vector<double> UB_returned = UB_from_prior.getVector();
+    for (size_t i = 0; i < 9; i++) {
+      TS_ASSERT_DELTA(UB_returned[i], UB_expected[i], 1e-4);
+    }
+  }
+
+  void test_Find_UB_using_FFT_ignores_prior_directions_that_do_not_index() {
+    std::vector<V3D> q_vectors = getNatroliteQs();
+    std::vector<V3D> prior_directions{{7.1, 0, 0}, {0, 8.3, 0}, {0, 0, 9.2}};
+
+    Matrix<double> UB(3, 3, false);
+    IndexingUtils::Find_UB(UB, q_vectors, 6, 10, 0.08, 1);
+    Matrix<double> UB_from_prior(3, 3, false);
+    IndexingUtils::Find_UB(UB_from_prior, q_vectors, 6, 10, 0.08, 1, 4,
+                           prior_directions);
+
+    std::vector<double> UB_expected = UB.getVector();
+    std::vector<double> UB_returned = UB_from_prior.getVector();
+    for (size_t i = 0; i < 9; i++) {
+      TS_ASSERT_DELTA(UB_returned[i], UB_expected[i], 1e-10);
+    }
+  }
+
+  void test_RefineDirections() {
+    std::vector<V3D> q_vectors = getNatroliteQs();
+    // The two shortest directions found by FFTScanFor_Directions
+    std::vector<V3D> candidates{{-2.58222370, 3.97345330, -4.5514464},
+                                {-9.59519700, 0.73589927, 1.3474168}};
+    std::vector<V3D> directions;
+
+    size_t max_indexed = IndexingUtils::RefineDirections(
+        directions, candidates, q_vectors, 6, 10, 0.12);
+
+    TS_ASSERT(max_indexed > 0);
+    TS_ASSERT_EQUALS(2, directions.size());
+    for (size_t i = 0; i < directions.size() && i < candidates.size(); i++) {
+      for (size_t j = 0; j < 3; j++) {
+        TS_ASSERT_DELTA(directions[i][j], candidates[i][j], 1e-3);
+      }
+    }
+  }
+
   void test_Optimize_UB_given_indexing() {
     std::vector<V3D> q_list = getNatroliteQs();
     std::vector<V3D> hkl_list = getNatroliteIndices();
@@ -17,6 +17,17 @@
 using namespace Mantid::Geometry;
 using namespace Mantid::Kernel;
 
+namespace {
+/// Exposes the structure factor summed by the unit cell scatterers.
+class TestableStructureFactorCalculatorSummation
+    : public StructureFactorCalculatorSummation {
+public:
+  StructureFactor getFFromScatterers(const V3D &hkl) const {
+    return m_unitCellScatterers->calculateStructureFactor(hkl);
+  }
+};
+} // namespace
+
 class StructureFactorCalculatorSummationTest : public CxxTest::TestSuite {
 public:
   // This pair of boilerplate methods prevent the suite being created statically
@@ -64,6 +75,47 @@ public:
     TS_ASSERT_LESS_THAN(calculator->getFSquared(V3D(2, 2, 2)), 1e-9);
   }
 
+  void testFsForListOfHKLsMatchScatterers() {
+    CompositeBraggScatterer_sptr scatterers = CompositeBraggScatterer::create();
+    scatterers->addScatterer(BraggScattererFactory::Instance().createScatterer(
+        "IsotropicAtomBraggScatterer",
+        R"({"Element":"Si","Position":"0.1,0.2,0.3","U":"0.02"})"));
+    scatterers->addScatterer(BraggScattererFactory::Instance().createScatterer(
+        "IsotropicAtomBraggScatterer",
+        R"({"Element":"O","Position":"0.3,0.05,0.4","U":"0.04",)"
+        R"("Occupancy":"0.7"})"));
+
+    CrystalStructure structure(
+        UnitCell(5.2, 6.3, 7.1, 90.0, 104.0, 90.0),
+        SpaceGroupFactory::Instance().createSpaceGroup("P 1 21/c 1"),
+        scatterers);
+
+    TestableStructureFactorCalculatorSummation calculator;
+    calculator.setCrystalStructure(structure);
+
+    std::vector<V3D> hkls;
+    for (int h = -3; h <= 3; ++h) {
+      for (int k = -2; k <= 2; ++k) {
+        for (int l = 0; l <= 4; ++l) {
+          hkls.emplace_back(h, k, l);
+        }
+      }
+    }
+
+    const auto fs = calculator.getFs(hkls);
+    const auto fSquareds = calculator.getFsSquared(hkls);
+    TS_ASSERT_EQUALS(fs.size(), hkls.size());
+    TS_ASSERT_EQUALS(fSquareds.size(), hkls.size());
+
+    for (size_t i = 0; i < hkls.size(); ++i) {
+      const StructureFactor expected = calculator.getFFromScatterers(hkls[i]);
+      TS_ASSERT_DELTA(fs[i].real(), expected.real(), 1e-12);
+      TS_ASSERT_DELTA(fs[i].imag(), expected.imag(), 1e-12);
+      TS_ASSERT_DELTA(fSquareds[i], std::norm(expected), 1e-9);
+      TS_ASSERT_EQUALS(calculator.getF(hkls[i]), fs[i]);
+    }
+  }
+
 private:
   CrystalStructure getCrystalStructure() {
     CompositeBraggScatterer_sptr scatterers = CompositeBraggScatterer::create();
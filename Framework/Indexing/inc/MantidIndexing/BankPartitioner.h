@@ -0,0 +1,45 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_INDEXING_BANKPARTITIONER_H_
+#define MANTID_INDEXING_BANKPARTITIONER_H_
+
+#include "MantidIndexing/DllConfig.h"
+#include "MantidIndexing/Partitioner.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace Indexing {
+
+/** A partitioning that never splits a bank, given as a block of consecutive
+  indices, between partitions. Algorithms grouping or focussing by bank can
+  then work on each bank without communication. Banks are distributed to
+  balance the total weight per partition, where the weight of a bank is the sum
+  of the weights of its indices (e.g. event counts) or, if no weights are
+  given, its number of indices.
+*/
+class MANTID_INDEXING_DLL BankPartitioner : public Partitioner {
+public:
+  BankPartitioner(const int numberOfPartitions, const PartitionIndex partition,
+                  const MonitorStrategy monitorStrategy,
+                  std::vector<GlobalSpectrumIndex> monitors,
+                  const std::vector<size_t> &bankSizes,
+                  const std::vector<double> &weights = {});
+
+private:
+  PartitionIndex doIndexOf(const GlobalSpectrumIndex index) const override;
+
+  /// One past the last index of each bank
+  std::vector<size_t> m_bankEnds;
+  /// The partition each bank is assigned to
+  std::vector<PartitionIndex> m_bankPartitions;
+};
+
+} // namespace Indexing
+} // namespace Mantid
+
+#endif /* MANTID_INDEXING_BANKPARTITIONER_H_ */
@@ -13,6 +13,7 @@
 #include "MantidParallel/StorageMode.h"
 
 #include <functional>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -23,6 +24,7 @@ class Communicator;
 }
 namespace Indexing {
 class GlobalSpectrumIndex;
+class Partitioner;
 class SpectrumIndexSet;
 class SpectrumNumberTranslator;
 
@@ -68,6 +70,10 @@ public:
   IndexInfo(std::vector<SpectrumNumber> spectrumNumbers,
             const Parallel::StorageMode storageMode,
             const Parallel::Communicator &communicator);
+  IndexInfo(std::vector<SpectrumNumber> spectrumNumbers,
+            const Parallel::StorageMode storageMode,
+            const Parallel::Communicator &communicator,
+            std::shared_ptr<const Partitioner> partitioner);
   template <class IndexType>
   IndexInfo(std::vector<IndexType> indices, const IndexInfo &parent);
 
@@ -116,6 +122,8 @@ private:
 
   Parallel::StorageMode m_storageMode;
   std::unique_ptr<Parallel::Communicator> m_communicator;
+  /// Custom partitioner, nullptr for the default round-robin partitioning.
+  std::shared_ptr<const Partitioner> m_partitioner;
 
   Kernel::cow_ptr<std::vector<SpectrumDefinition>> m_spectrumDefinitions{
       nullptr};
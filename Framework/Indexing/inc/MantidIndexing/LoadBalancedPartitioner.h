@@ -0,0 +1,42 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_INDEXING_LOADBALANCEDPARTITIONER_H_
+#define MANTID_INDEXING_LOADBALANCEDPARTITIONER_H_
+
+#include "MantidIndexing/DllConfig.h"
+#include "MantidIndexing/Partitioner.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace Indexing {
+
+/** A partitioning into contiguous blocks of indices with roughly equal total
+  weight per partition, e.g., using the number of events in each spectrum as
+  weight. Contiguous blocks keep neighbouring spectra, which typically share
+  geometry and calibration, on the same partition. If all weights are zero
+  every index is given the same weight.
+*/
+class MANTID_INDEXING_DLL LoadBalancedPartitioner : public Partitioner {
+public:
+  LoadBalancedPartitioner(const int numberOfPartitions,
+                          const PartitionIndex partition,
+                          const MonitorStrategy monitorStrategy,
+                          std::vector<GlobalSpectrumIndex> monitors,
+                          const std::vector<double> &weights);
+
+private:
+  PartitionIndex doIndexOf(const GlobalSpectrumIndex index) const override;
+
+  /// One past the last index of each partition
+  std::vector<size_t> m_ends;
+};
+
+} // namespace Indexing
+} // namespace Mantid
+
+#endif /* MANTID_INDEXING_LOADBALANCEDPARTITIONER_H_ */
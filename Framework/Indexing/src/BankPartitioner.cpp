@@ -0,0 +1,78 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidIndexing/BankPartitioner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace Mantid {
+namespace Indexing {
+
+/** Construct with the number of indices in each bank, in order of increasing
+ * index, and optionally the weight of each index. Monitors handled by cloning
+ * or a dedicated partition do not count towards the balance. */
+BankPartitioner::BankPartitioner(const int numberOfPartitions,
+                                 const PartitionIndex partition,
+                                 const MonitorStrategy monitorStrategy,
+                                 std::vector<GlobalSpectrumIndex> monitors,
+                                 const std::vector<size_t> &bankSizes,
+                                 const std::vector<double> &weights)
+    : Partitioner(numberOfPartitions, partition, monitorStrategy,
+                  std::move(monitors)) {
+  m_bankEnds.resize(bankSizes.size());
+  std::partial_sum(bankSizes.begin(), bankSizes.end(), m_bankEnds.begin());
+  if (!weights.empty() &&
+      (m_bankEnds.empty() || weights.size() < m_bankEnds.back()))
+    throw std::invalid_argument(
+        "BankPartitioner: a weight must be given for every index in a bank.");
+
+  std::vector<double> bankWeights(bankSizes.size(), 0.0);
+  size_t index = 0;
+  for (size_t bank = 0; bank < bankSizes.size(); ++bank) {
+    for (; index < m_bankEnds[bank]; ++index) {
+      if (isMonitor(GlobalSpectrumIndex(index)))
+        continue;
+      const double weight = weights.empty() ? 1.0 : weights[index];
+      if (!(weight >= 0.0))
+        throw std::invalid_argument(
+            "BankPartitioner: weights must not be negative.");
+      bankWeights[bank] += weight;
+    }
+  }
+
+  // Longest processing time first: the heaviest remaining bank goes to the
+  // least loaded partition. Ties are broken by index so that every partition
+  // computes the same assignment.
+  std::vector<size_t> order(bankSizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return bankWeights[a] > bankWeights[b];
+  });
+  std::vector<double> load(numberOfNonMonitorPartitions(), 0.0);
+  m_bankPartitions.resize(bankSizes.size());
+  for (const auto bank : order) {
+    const auto lightest = std::min_element(load.begin(), load.end());
+    *lightest += bankWeights[bank];
+    m_bankPartitions[bank] =
+        PartitionIndex(static_cast<int>(lightest - load.begin()));
+  }
+}
+
+PartitionIndex
+BankPartitioner::doIndexOf(const GlobalSpectrumIndex index) const {
+  const auto i = static_cast<size_t>(index);
+  const auto bank = std::upper_bound(m_bankEnds.begin(), m_bankEnds.end(), i);
+  if (bank == m_bankEnds.end())
+    throw std::out_of_range("BankPartitioner: spectrum index " +
+                            std::to_string(i) + " is not in any bank");
+  return m_bankPartitions[bank - m_bankEnds.begin()];
+}
+
+} // namespace Indexing
+} // namespace Mantid
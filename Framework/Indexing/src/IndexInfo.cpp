@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <functional>
 #include <numeric>
+#include <stdexcept>
 
 namespace Mantid {
 namespace Indexing {
@@ -58,6 +59,22 @@ IndexInfo::IndexInfo(std::vector<SpectrumNumber> spectrumNumbers,
   makeSpectrumNumberTranslator(std::move(spectrumNumbers));
 }
 
+/** Construct with given spectrum number for each index and no spectrum
+ * definitions, partitioned by the given partitioner instead of the default
+ * round-robin partitioning. For StorageMode::Distributed the partitioner must
+ * have as many partitions as the communicator has ranks. For other storage
+ * modes there is only one partition and the partitioner is not used. The
+ * partitioner is kept and reused when the spectrum numbers are changed. */
+IndexInfo::IndexInfo(std::vector<SpectrumNumber> spectrumNumbers,
+                     const Parallel::StorageMode storageMode,
+                     const Parallel::Communicator &communicator,
+                     std::shared_ptr<const Partitioner> partitioner)
+    : m_storageMode(storageMode),
+      m_communicator(Kernel::make_unique<Parallel::Communicator>(communicator)),
+      m_partitioner(std::move(partitioner)) {
+  makeSpectrumNumberTranslator(std::move(spectrumNumbers));
+}
+
 /** Construct with given index subset of parent.
  *
  * The template argument IndexType can be SpectrumNumber or GlobalSpectrumIndex.
@@ -86,6 +103,7 @@ IndexInfo::IndexInfo(const IndexInfo &other)
     : m_storageMode(other.m_storageMode),
       m_communicator(
           Kernel::make_unique<Parallel::Communicator>(*other.m_communicator)),
+      m_partitioner(other.m_partitioner),
       m_spectrumDefinitions(other.m_spectrumDefinitions),
       m_spectrumNumberTranslator(other.m_spectrumNumberTranslator) {}
 
@@ -406,11 +424,19 @@ void IndexInfo::makeSpectrumNumberTranslator(
     throw std::runtime_error("IndexInfo: unknown storage mode " +
                              Parallel::toString(m_storageMode));
   }
-  auto partitioner = Kernel::make_unique<RoundRobinPartitioner>(
+  if (m_partitioner && m_storageMode == Parallel::StorageMode::Distributed) {
+    if (m_partitioner->numberOfPartitions() != numberOfPartitions)
+      throw std::invalid_argument(
+          "IndexInfo: the partitioner must have one partition per rank.");
+    m_spectrumNumberTranslator = Kernel::make_cow<SpectrumNumberTranslator>(
+        std::move(spectrumNumbers), *m_partitioner, partition);
+    return;
+  }
+  auto roundRobin = Kernel::make_unique<RoundRobinPartitioner>(
       numberOfPartitions, partition,
       Partitioner::MonitorStrategy::TreatAsNormalSpectrum);
   m_spectrumNumberTranslator = Kernel::make_cow<SpectrumNumberTranslator>(
-      std::move(spectrumNumbers), *partitioner, partition);
+      std::move(spectrumNumbers), *roundRobin, partition);
 }
 
 template MANTID_INDEXING_DLL IndexInfo::IndexInfo(std::vector<SpectrumNumber>,
@@ -0,0 +1,71 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidIndexing/LoadBalancedPartitioner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace Mantid {
+namespace Indexing {
+
+/** Construct with the weight of each global spectrum index. Monitors handled
+ * by cloning or a dedicated partition do not count towards the balance. */
+LoadBalancedPartitioner::LoadBalancedPartitioner(
+    const int numberOfPartitions, const PartitionIndex partition,
+    const MonitorStrategy monitorStrategy,
+    std::vector<GlobalSpectrumIndex> monitors,
+    const std::vector<double> &weights)
+    : Partitioner(numberOfPartitions, partition, monitorStrategy,
+                  std::move(monitors)) {
+  if (weights.empty())
+    throw std::invalid_argument(
+        "LoadBalancedPartitioner: weights must not be empty.");
+  std::vector<double> balanced(weights);
+  for (size_t i = 0; i < balanced.size(); ++i) {
+    if (!(balanced[i] >= 0.0))
+      throw std::invalid_argument(
+          "LoadBalancedPartitioner: weights must not be negative.");
+    if (isMonitor(GlobalSpectrumIndex(i)))
+      balanced[i] = 0.0;
+  }
+  double total = std::accumulate(balanced.begin(), balanced.end(), 0.0);
+  if (total == 0.0) {
+    std::fill(balanced.begin(), balanced.end(), 1.0);
+    total = static_cast<double>(balanced.size());
+  }
+
+  // Assign each index by the midpoint of its weight in the cumulative sum.
+  // The midpoints increase monotonically so every partition is contiguous.
+  const auto partitions = numberOfNonMonitorPartitions();
+  m_ends.assign(partitions, balanced.size());
+  double cumulative = 0.0;
+  int current = 0;
+  for (size_t i = 0; i < balanced.size(); ++i) {
+    const double midpoint = cumulative + 0.5 * balanced[i];
+    cumulative += balanced[i];
+    const int target = std::min(
+        partitions - 1, static_cast<int>(midpoint / total * partitions));
+    for (; current < target; ++current)
+      m_ends[current] = i;
+  }
+}
+
+PartitionIndex
+LoadBalancedPartitioner::doIndexOf(const GlobalSpectrumIndex index) const {
+  const auto i = static_cast<size_t>(index);
+  if (i >= m_ends.back())
+    throw std::out_of_range(
+        "LoadBalancedPartitioner: no weight given for spectrum index " +
+        std::to_string(i));
+  return PartitionIndex(static_cast<int>(
+      std::upper_bound(m_ends.begin(), m_ends.end(), i) - m_ends.begin()));
+}
+
+} // namespace Indexing
+} // namespace Mantid
@@ -0,0 +1,75 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_INDEXING_BANKPARTITIONERTEST_H_
+#define MANTID_INDEXING_BANKPARTITIONERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidIndexing/BankPartitioner.h"
+
+using namespace Mantid::Indexing;
+
+class BankPartitionerTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static BankPartitionerTest *createSuite() {
+    return new BankPartitionerTest();
+  }
+  static void destroySuite(BankPartitionerTest *suite) { delete suite; }
+
+  void test_banks_are_not_split() {
+    BankPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {3, 3});
+    TS_ASSERT_EQUALS(partitioner.numberOfPartitions(), 2);
+    for (size_t i = 0; i < 3; ++i)
+      TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(i)), 0);
+    for (size_t i = 3; i < 6; ++i)
+      TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(i)), 1);
+  }
+
+  void test_banks_are_balanced_by_size() {
+    // The large bank fills one partition, the three small ones the other
+    BankPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {1, 6, 2, 3});
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(0)), 1);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(1)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(6)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(7)), 1);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(9)), 1);
+  }
+
+  void test_banks_are_balanced_by_weight() {
+    BankPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {2, 2, 2},
+        {1.0, 1.0, 50.0, 50.0, 1.0, 1.0});
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(2)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(0)), 1);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(4)), 1);
+  }
+
+  void test_index_outside_banks_throws() {
+    BankPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {2, 2});
+    TS_ASSERT_THROWS(partitioner.indexOf(GlobalSpectrumIndex(4)),
+                     const std::out_of_range &);
+  }
+
+  void test_missing_weights_throw() {
+    TS_ASSERT_THROWS(BankPartitioner(
+                         2, PartitionIndex(0),
+                         Partitioner::MonitorStrategy::CloneOnEachPartition,
+                         {}, {2, 2}, {1.0, 1.0}),
+                     const std::invalid_argument &);
+  }
+};
+
+#endif /* MANTID_INDEXING_BANKPARTITIONERTEST_H_ */
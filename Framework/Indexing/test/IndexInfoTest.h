@@ -11,11 +11,14 @@
 
 #include "MantidIndexing/GlobalSpectrumIndex.h"
 #include "MantidIndexing/IndexInfo.h"
+#include "MantidIndexing/LoadBalancedPartitioner.h"
 #include "MantidKernel/make_cow.h"
 #include "MantidParallel/Communicator.h"
 #include "MantidTypes/SpectrumDefinition.h"
 
 #include "MantidTestHelpers/ParallelRunner.h"
+#include <memory>
+#include <numeric>
 #ifdef MPI_EXPERIMENTAL
 #include <boost/mpi/environment.hpp>
 #endif
@@ -51,6 +54,65 @@ void run_StorageMode_Distributed(const Parallel::Communicator &comm) {
   TS_ASSERT_EQUALS(i.size(), expectedSize);
 }
 
+void run_StorageMode_Distributed_custom_partitioner(
+    const Parallel::Communicator &comm) {
+  // Most of the weight is in the first spectrum, so rank 0 gets at most that
+  // one
+  std::vector<double> weights(20, 1.0);
+  weights[0] = 1000.0;
+  auto partitioner = std::make_shared<LoadBalancedPartitioner>(
+      comm.size(), PartitionIndex(comm.rank()),
+      Partitioner::MonitorStrategy::TreatAsNormalSpectrum,
+      std::vector<GlobalSpectrumIndex>{}, weights);
+  std::vector<SpectrumNumber> specNums(weights.size());
+  std::iota(specNums.begin(), specNums.end(), 1);
+  IndexInfo i(specNums, Parallel::StorageMode::Distributed, comm, partitioner);
+  TS_ASSERT_EQUALS(i.globalSize(), weights.size());
+  size_t expectedSize = 0;
+  for (size_t globalIndex = 0; globalIndex < i.globalSize(); ++globalIndex) {
+    if (partitioner->indexOf(GlobalSpectrumIndex(globalIndex)) == comm.rank()) {
+      TS_ASSERT_EQUALS(i.spectrumNumber(expectedSize),
+                       specNums[globalIndex]);
+      ++expectedSize;
+    }
+  }
+  TS_ASSERT_EQUALS(i.size(), expectedSize);
+  if (comm.size() > 1 && comm.rank() == 0) {
+    TS_ASSERT(i.size() <= 1);
+  }
+}
+
+void run_StorageMode_Distributed_custom_partitioner_is_kept(
+    const Parallel::Communicator &comm) {
+  std::vector<double> weights(20, 1.0);
+  weights[0] = 1000.0;
+  auto partitioner = std::make_shared<LoadBalancedPartitioner>(
+      comm.size(), PartitionIndex(comm.rank()),
+      Partitioner::MonitorStrategy::TreatAsNormalSpectrum,
+      std::vector<GlobalSpectrumIndex>{}, weights);
+  std::vector<SpectrumNumber> specNums(weights.size());
+  std::iota(specNums.begin(), specNums.end(), 1);
+  const IndexInfo original(specNums, Parallel::StorageMode::Distributed, comm,
+                           partitioner);
+  IndexInfo i(original);
+  std::vector<SpectrumNumber> newSpecNums(weights.size());
+  std::iota(newSpecNums.begin(), newSpecNums.end(), 101);
+  i.setSpectrumNumbers(std::vector<SpectrumNumber>(newSpecNums));
+  TS_ASSERT_EQUALS(i.size(), original.size());
+  IndexInfo range(original);
+  range.setSpectrumNumbers(101, 120);
+  TS_ASSERT_EQUALS(range.size(), original.size());
+  size_t localIndex = 0;
+  for (size_t globalIndex = 0; globalIndex < weights.size(); ++globalIndex) {
+    if (partitioner->indexOf(GlobalSpectrumIndex(globalIndex)) == comm.rank()) {
+      TS_ASSERT_EQUALS(i.spectrumNumber(localIndex), newSpecNums[globalIndex]);
+      TS_ASSERT_EQUALS(range.spectrumNumber(localIndex),
+                       newSpecNums[globalIndex]);
+      ++localIndex;
+    }
+  }
+}
+
 void run_StorageMode_MasterOnly(const Parallel::Communicator &comm) {
   if (comm.rank() == 0) {
     IndexInfo i(3, Parallel::StorageMode::MasterOnly, comm);
@@ -417,6 +479,27 @@ public:
     run_StorageMode_Distributed(Parallel::Communicator{});
   }
 
+  void test_StorageMode_Distributed_custom_partitioner() {
+    runParallel(run_StorageMode_Distributed_custom_partitioner);
+    run_StorageMode_Distributed_custom_partitioner(Parallel::Communicator{});
+  }
+
+  void test_StorageMode_Distributed_custom_partitioner_is_kept() {
+    runParallel(run_StorageMode_Distributed_custom_partitioner_is_kept);
+    run_StorageMode_Distributed_custom_partitioner_is_kept(
+        Parallel::Communicator{});
+  }
+
+  void test_partitioner_with_wrong_number_of_partitions_throws() {
+    auto partitioner = std::make_shared<LoadBalancedPartitioner>(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::TreatAsNormalSpectrum,
+        std::vector<GlobalSpectrumIndex>{}, std::vector<double>{1.0, 1.0});
+    TS_ASSERT_THROWS(IndexInfo({1, 2}, Parallel::StorageMode::Distributed,
+                               Parallel::Communicator{}, partitioner),
+                     const std::invalid_argument &);
+  }
+
   void test_StorageMode_MasterOnly() {
     runParallel(run_StorageMode_MasterOnly);
     // Trivial: Run with one partition.
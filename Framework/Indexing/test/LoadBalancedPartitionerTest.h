@@ -0,0 +1,101 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_INDEXING_LOADBALANCEDPARTITIONERTEST_H_
+#define MANTID_INDEXING_LOADBALANCEDPARTITIONERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidIndexing/LoadBalancedPartitioner.h"
+
+using namespace Mantid::Indexing;
+
+class LoadBalancedPartitionerTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static LoadBalancedPartitionerTest *createSuite() {
+    return new LoadBalancedPartitionerTest();
+  }
+  static void destroySuite(LoadBalancedPartitionerTest *suite) {
+    delete suite;
+  }
+
+  void test_1_rank() {
+    LoadBalancedPartitioner partitioner(
+        1, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {1.0, 5.0});
+    TS_ASSERT_EQUALS(partitioner.numberOfPartitions(), 1);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(0)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(1)), 0);
+  }
+
+  void test_equal_weights_give_contiguous_blocks() {
+    LoadBalancedPartitioner partitioner(
+        3, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {},
+        std::vector<double>(6, 2.0));
+    for (size_t i = 0; i < 6; ++i)
+      TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(i)),
+                       static_cast<int>(i / 2));
+  }
+
+  void test_heavy_spectra_get_their_own_partition() {
+    LoadBalancedPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {},
+        {100.0, 1.0, 1.0, 1.0, 1.0, 1.0});
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(0)), 0);
+    for (size_t i = 1; i < 6; ++i)
+      TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(i)), 1);
+  }
+
+  void test_zero_weights_are_balanced_by_count() {
+    LoadBalancedPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {},
+        std::vector<double>(4, 0.0));
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(1)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(2)), 1);
+  }
+
+  void test_monitors_on_dedicated_partition_are_ignored() {
+    LoadBalancedPartitioner partitioner(
+        3, PartitionIndex(0), Partitioner::MonitorStrategy::DedicatedPartition,
+        {GlobalSpectrumIndex(0)}, {1000.0, 1.0, 1.0, 1.0, 1.0});
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(0)), 2);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(1)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(2)), 0);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(3)), 1);
+    TS_ASSERT_EQUALS(partitioner.indexOf(GlobalSpectrumIndex(4)), 1);
+  }
+
+  void test_negative_weight_throws() {
+    TS_ASSERT_THROWS(LoadBalancedPartitioner(
+                         2, PartitionIndex(0),
+                         Partitioner::MonitorStrategy::CloneOnEachPartition,
+                         {}, {1.0, -1.0}),
+                     const std::invalid_argument &);
+  }
+
+  void test_empty_weights_throw() {
+    TS_ASSERT_THROWS(LoadBalancedPartitioner(
+                         2, PartitionIndex(0),
+                         Partitioner::MonitorStrategy::CloneOnEachPartition,
+                         {}, std::vector<double>{}),
+                     const std::invalid_argument &);
+  }
+
+  void test_index_without_weight_throws() {
+    LoadBalancedPartitioner partitioner(
+        2, PartitionIndex(0),
+        Partitioner::MonitorStrategy::CloneOnEachPartition, {}, {1.0, 1.0});
+    TS_ASSERT_THROWS(partitioner.indexOf(GlobalSpectrumIndex(2)),
+                     const std::out_of_range &);
+  }
+};
+
+#endif /* MANTID_INDEXING_LOADBALANCEDPARTITIONERTEST_H_ */
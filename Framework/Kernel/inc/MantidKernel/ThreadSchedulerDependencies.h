@@ -0,0 +1,131 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_THREADSCHEDULERDEPENDENCIES_H_
+#define MANTID_KERNEL_THREADSCHEDULERDEPENDENCIES_H_
+
+#include "MantidKernel/DllConfig.h"
+#include "MantidKernel/ThreadScheduler.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+
+/** ThreadSchedulerDependencies : a First-In-First-Out scheduler where a
+ * task may be made to wait for the completion of other tasks.
+ *
+ * pop() hands out the oldest task whose dependencies have all finished and
+ * returns NULL while every queued task is still waiting; ThreadPoolRunnable
+ * then sleeps briefly and asks again. Dependencies are tracked by pointer
+ * and are dropped as soon as a task is reported finished, so only tasks that
+ * are queued or running at the time of the push are waited for.
+ *
+ * NOTE: Dependencies are not checked for cycles. A cycle leaves its tasks
+ * queued forever, so the caller must order them.
+ */
+class DLLExport ThreadSchedulerDependencies : public ThreadScheduler {
+public:
+  ThreadSchedulerDependencies() = default;
+
+  ~ThreadSchedulerDependencies() override { clear(); }
+
+  //-------------------------------------------------------------------------------
+  /// Add a task with no dependencies
+  void push(Task *newTask) override { push(newTask, std::vector<Task *>()); }
+
+  //-------------------------------------------------------------------------------
+  /** Add a task that may only start once the given tasks have finished.
+   *
+   * @param newTask :: Task to add to queue
+   * @param dependencies :: tasks that must finish before newTask runs.
+   *        Tasks unknown to this scheduler (or already finished) are ignored.
+   */
+  void push(Task *newTask, const std::vector<Task *> &dependencies) {
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    m_cost += newTask->cost();
+    std::set<Task *> waitFor;
+    for (auto dependency : dependencies) {
+      if (dependency != newTask && (m_running.count(dependency) > 0 ||
+                                    m_waitingOn.count(dependency) > 0))
+        waitFor.insert(dependency);
+    }
+    m_queue.push_back(newTask);
+    m_waitingOn.emplace(newTask, std::move(waitFor));
+  }
+
+  //-------------------------------------------------------------------------------
+  Task *pop(size_t threadnum) override {
+    UNUSED_ARG(threadnum);
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    auto ready = std::find_if(m_queue.begin(), m_queue.end(), [this](Task *t) {
+      return m_waitingOn[t].empty();
+    });
+    if (ready == m_queue.end())
+      return nullptr;
+    Task *temp = *ready;
+    m_queue.erase(ready);
+    m_waitingOn.erase(temp);
+    m_running.insert(temp);
+    m_costExecuted += temp->cost();
+    return temp;
+  }
+
+  //-----------------------------------------------------------------------------------
+  /** Signal to the scheduler that a task is complete. Any queued task
+   * waiting on it is released.
+   *
+   * @param task :: the Task that was completed.
+   * @param threadnum :: unused argument
+   */
+  void finished(Task *task, size_t threadnum) override {
+    UNUSED_ARG(threadnum);
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    m_running.erase(task);
+    for (auto &waiting : m_waitingOn)
+      waiting.second.erase(task);
+  }
+
+  //-------------------------------------------------------------------------------
+  size_t size() override {
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    return m_queue.size();
+  }
+
+  //-------------------------------------------------------------------------------
+  /// @return true if the queue is empty
+  bool empty() override {
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    return m_queue.empty();
+  }
+
+  //-------------------------------------------------------------------------------
+  void clear() override {
+    std::lock_guard<std::mutex> lock(m_queueLock);
+    // Empty out the queue and delete the pointers!
+    for (auto task : m_queue)
+      delete task;
+    m_queue.clear();
+    m_waitingOn.clear();
+    m_cost = 0;
+    m_costExecuted = 0;
+  }
+
+protected:
+  /// Queued tasks in the order they were pushed
+  std::vector<Task *> m_queue;
+  /// The unfinished dependencies of each queued task
+  std::map<Task *, std::set<Task *>> m_waitingOn;
+  /// Tasks that have been popped but not yet reported as finished
+  std::set<Task *> m_running;
+};
+
+} // namespace Kernel
+} // namespace Mantid
+
+#endif /* MANTID_KERNEL_THREADSCHEDULERDEPENDENCIES_H_ */
@@ -0,0 +1,124 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_KERNEL_THREADSCHEDULERDEPENDENCIESTEST_H_
+#define MANTID_KERNEL_THREADSCHEDULERDEPENDENCIESTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidKernel/ThreadPool.h"
+#include "MantidKernel/ThreadSchedulerDependencies.h"
+
+#include <atomic>
+
+using namespace Mantid::Kernel;
+
+int ThreadSchedulerDependenciesTest_timesDeleted;
+
+class ThreadSchedulerDependenciesTest : public CxxTest::TestSuite {
+public:
+  /** A Task that counts its deletions and records when it ran */
+  class CountingTask : public Task {
+  public:
+    CountingTask(std::atomic<int> *clock = nullptr, int *ranAt = nullptr)
+        : m_clock(clock), m_ranAt(ranAt) {}
+
+    ~CountingTask() override { ThreadSchedulerDependenciesTest_timesDeleted++; }
+
+    void run() override {
+      if (m_clock && m_ranAt)
+        *m_ranAt = (*m_clock)++;
+    }
+
+  private:
+    std::atomic<int> *m_clock;
+    int *m_ranAt;
+  };
+
+  void test_push() {
+    ThreadSchedulerDependencies sc;
+    auto task1 = new CountingTask();
+    auto task2 = new CountingTask();
+    sc.push(task1);
+    TS_ASSERT_EQUALS(sc.size(), 1);
+    sc.push(task2, {task1});
+    TS_ASSERT_EQUALS(sc.size(), 2);
+    TS_ASSERT(!sc.empty());
+  }
+
+  void test_pop_waits_for_dependencies() {
+    ThreadSchedulerDependencies sc;
+    auto task1 = new CountingTask();
+    auto task2 = new CountingTask();
+    auto task3 = new CountingTask();
+    sc.push(task1);
+    sc.push(task2, {task1});
+    sc.push(task3);
+
+    // task2 must wait for task1, so task3 overtakes it
+    TS_ASSERT_EQUALS(sc.pop(0), task1);
+    TS_ASSERT_EQUALS(sc.pop(0), task3);
+    TS_ASSERT(!sc.pop(0));
+    TS_ASSERT_EQUALS(sc.size(), 1);
+
+    sc.finished(task3, 0);
+    TS_ASSERT(!sc.pop(0));
+    sc.finished(task1, 0);
+    TS_ASSERT_EQUALS(sc.pop(0), task2);
+    TS_ASSERT(sc.empty());
+
+    delete task1;
+    delete task2;
+    delete task3;
+  }
+
+  void test_finished_dependencies_are_ignored() {
+    ThreadSchedulerDependencies sc;
+    auto task1 = new CountingTask();
+    auto task2 = new CountingTask();
+    sc.push(task1);
+    TS_ASSERT_EQUALS(sc.pop(0), task1);
+    sc.finished(task1, 0);
+    // task1 is no longer known to the scheduler, so nothing to wait for
+    sc.push(task2, {task1});
+    TS_ASSERT_EQUALS(sc.pop(0), task2);
+    delete task1;
+    delete task2;
+  }
+
+  void test_clear() {
+    ThreadSchedulerDependencies sc;
+    Task *previous = nullptr;
+    for (size_t i = 0; i < 10; i++) {
+      auto task = new CountingTask();
+      sc.push(task, {previous});
+      previous = task;
+    }
+    TS_ASSERT_EQUALS(sc.size(), 10);
+    ThreadSchedulerDependenciesTest_timesDeleted = 0;
+    sc.clear();
+    TS_ASSERT_EQUALS(sc.size(), 0);
+    TS_ASSERT_EQUALS(ThreadSchedulerDependenciesTest_timesDeleted, 10);
+  }
+
+  void test_thread_pool_respects_chain() {
+    auto sc = new ThreadSchedulerDependencies();
+    ThreadPool pool(sc, 4);
+    std::atomic<int> clock(0);
+    std::vector<int> ranAt(20, -1);
+    Task *previous = nullptr;
+    for (size_t i = 0; i < ranAt.size(); i++) {
+      auto task = new CountingTask(&clock, &ranAt[i]);
+      sc->push(task, {previous});
+      previous = task;
+    }
+    TS_ASSERT_THROWS_NOTHING(pool.joinAll());
+    for (size_t i = 0; i < ranAt.size(); i++)
+      TS_ASSERT_EQUALS(ranAt[i], static_cast<int>(i));
+  }
+};
+
+#endif /* MANTID_KERNEL_THREADSCHEDULERDEPENDENCIESTEST_H_ */
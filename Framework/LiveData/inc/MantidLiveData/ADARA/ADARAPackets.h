@@ -11,6 +11,7 @@
 #include <cstring>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "ADARA.h"
 #include "MantidKernel/System.h"
@@ -236,6 +237,21 @@ public:
   uint32_t getSourceTOFOffset() const { return m_TOFOffset; }
   uint32_t curBankId() const { return m_bankId; }
 
+  // The events of one bank, which are contiguous in the packet, along with
+  // the COR flag and TOF offset of the source section holding the bank
+  struct BankSection {
+    uint32_t bankId;
+    bool isCorrected;
+    uint32_t tofOffset;
+    const Event *events;
+    uint32_t eventCount;
+  };
+
+  // All of the non-empty banks in the packet, in order.  Lets callers
+  // process a whole bank at a time instead of calling nextEvent() for
+  // every event.  Independent of the firstEvent()/nextEvent() state.
+  std::vector<BankSection> bankSections() const;
+
   //        uint32_t curEventCount() const { return ((uint32_t *)m_curBank)[1];
   //        }
 
@@ -13,6 +13,11 @@
 #include "MantidLiveData/Kafka/IKafkaStreamDecoder.h"
 #include "MantidLiveData/Kafka/IKafkaStreamSubscriber.h"
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+
 namespace Mantid {
 namespace LiveData {
 
@@ -22,6 +27,11 @@ namespace LiveData {
 
   A call to capture() starts the process of capturing the stream on a separate
   thread.
+
+  Event messages are handed from the capture thread to a small pool of decode
+  threads. Each decode thread collects its events in its own buffers, which
+  are merged into the local workspaces when the data is extracted, so no lock
+  is taken per message or per event while decoding.
 */
 class DLLExport KafkaEventStreamDecoder : public IKafkaStreamDecoder {
 public:
@@ -41,15 +51,37 @@ public:
   bool hasReachedEndOfRun() noexcept override;
   ///@}
 
+  void setNumberOfDecodeThreads(size_t nthreads);
+
 private:
+  /// Events decoded by a single decode thread that have not yet been moved
+  /// to the local workspaces
+  struct DecodedEvents {
+    DecodedEvents(size_t nperiods, size_t nblocks);
+    /// (workspace index, event) pairs for each period, grouped by blocks of
+    /// workspace indices so that the blocks can be merged concurrently
+    std::vector<
+        std::vector<std::vector<std::pair<size_t, Types::Event::TofEvent>>>>
+        events;
+    /// (pulse time, proton charge) pairs for each period
+    std::vector<std::vector<std::pair<Types::Core::DateAndTime, double>>>
+        protonCharge;
+  };
+
   void captureImplExcept() override;
 
   /// Create the cache workspaces, LoadLiveData extracts data from these
   void initLocalCaches(const std::string &rawMsgBuffer,
                        const RunStartStruct &runStartData) override;
 
-  /// Populate cache workspaces with data from messages
-  void eventDataFromMessage(const std::string &buffer);
+  /// Decode an event message into the buffers of a decode thread
+  void eventDataFromMessage(const std::string &buffer, DecodedEvents &decoded);
+
+  void startDecodeThreads();
+  void stopDecodeThreads();
+  void decodeThread(size_t threadIndex);
+  void queueEventMessage(std::string &buffer);
+  void mergeDecodedEvents();
 
   void sampleDataFromMessage(const std::string &buffer) override;
 
@@ -58,6 +90,25 @@ private:
 
   /// Local event workspace buffers
   std::vector<DataObjects::EventWorkspace_sptr> m_localEvents;
+
+  /// Number of threads decoding event messages
+  size_t m_numDecodeThreads;
+  /// Threads decoding event messages
+  std::vector<std::thread> m_decodeThreads;
+  /// Decoded events waiting to be merged, one entry per decode thread
+  std::vector<DecodedEvents> m_decodedEvents;
+  /// Event messages waiting to be decoded
+  std::deque<std::string> m_decodeQueue;
+  /// Number of messages being decoded right now
+  size_t m_busyDecoders;
+  /// Set to ask the decode threads to finish once the queue is empty
+  bool m_stopDecoding;
+  /// First exception thrown by a decode thread
+  std::exception_ptr m_decodeError;
+  /// Guards the decode queue, the decoded events and the flags above
+  std::mutex m_decodeMutex;
+  /// Signals a change of the queue or of the number of busy decoders
+  std::condition_variable m_decodeCv;
 };
 
 } // namespace LiveData
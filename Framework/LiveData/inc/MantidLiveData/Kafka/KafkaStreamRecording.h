@@ -0,0 +1,85 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_LIVEDATA_KAFKASTREAMRECORDING_H_
+#define MANTID_LIVEDATA_KAFKASTREAMRECORDING_H_
+
+#include "MantidLiveData/Kafka/IKafkaBroker.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace Mantid {
+namespace LiveData {
+
+/**
+  Wraps another broker and records everything its subscribers return to a
+  file: the topics of each subscription, every message consumed (with the
+  time it arrived relative to the start of the recording) and the results of
+  the offset queries. The file can be played back with KafkaReplayBroker to
+  drive a stream decoder offline with realistic message timing.
+*/
+class DLLExport KafkaRecordingBroker : public IKafkaBroker {
+public:
+  KafkaRecordingBroker(std::shared_ptr<IKafkaBroker> broker,
+                       const std::string &filename);
+  ~KafkaRecordingBroker() override;
+
+  std::unique_ptr<IKafkaStreamSubscriber>
+  subscribe(std::vector<std::string> topics,
+            SubscribeAtOption subscribeOption) const override;
+  std::unique_ptr<IKafkaStreamSubscriber>
+  subscribe(std::vector<std::string> topics, int64_t offset,
+            SubscribeAtOption subscribeOption) const override;
+
+  class Writer;
+
+private:
+  std::unique_ptr<IKafkaStreamSubscriber>
+  record(std::unique_ptr<IKafkaStreamSubscriber> subscriber,
+         const std::vector<std::string> &topics) const;
+
+  std::shared_ptr<IKafkaBroker> m_broker;
+  std::shared_ptr<Writer> m_writer;
+};
+
+/**
+  Plays back a file written by KafkaRecordingBroker. Subscriptions are
+  matched to the recorded ones with the same topics, in the order they were
+  made, and each hands back the messages and offsets its recorded
+  counterpart saw. Messages become available at the time they arrived during
+  the recording, scaled by the replay speed, or immediately if the speed
+  is 0. Seeking is ignored as its effect is already part of the recording.
+*/
+class DLLExport KafkaReplayBroker : public IKafkaBroker {
+public:
+  KafkaReplayBroker(const std::string &filename, double speed = 1.0);
+
+  std::unique_ptr<IKafkaStreamSubscriber>
+  subscribe(std::vector<std::string> topics,
+            SubscribeAtOption subscribeOption) const override;
+  std::unique_ptr<IKafkaStreamSubscriber>
+  subscribe(std::vector<std::string> topics, int64_t offset,
+            SubscribeAtOption subscribeOption) const override;
+
+  struct Recording;
+
+private:
+  std::shared_ptr<Recording> m_recording;
+  double m_speed;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/// Create the broker for a Kafka listener, recording or replaying the stream
+/// if requested in the configuration
+DLLExport std::shared_ptr<IKafkaBroker>
+createKafkaBroker(const std::string &address);
+
+} // namespace LiveData
+} // namespace Mantid
+
+#endif /* MANTID_LIVEDATA_KAFKASTREAMRECORDING_H_ */
@@ -38,12 +38,15 @@ private:
   void init() override;
 
   Mantid::API::Workspace_sptr runProcessing(Mantid::API::Workspace_sptr inputWS,
-                                            bool PostProcess);
+                                            bool PostProcess, bool isChunk);
   Mantid::API::Workspace_sptr processChunk(Mantid::API::Workspace_sptr chunkWS);
   void runPostProcessing();
+  void runIncrementalPostProcessing(Mantid::API::Workspace_sptr chunkWS);
 
   void replaceChunk(Mantid::API::Workspace_sptr chunkWS);
   void addChunk(Mantid::API::Workspace_sptr chunkWS);
+  void addChunk(Mantid::API::Workspace_sptr &accumWS,
+                Mantid::API::Workspace_sptr chunkWS);
   void addMatrixWSChunk(API::Workspace_sptr accumWS,
                         API::Workspace_sptr chunkWS);
   void addMDWSChunk(API::Workspace_sptr &accumWS,
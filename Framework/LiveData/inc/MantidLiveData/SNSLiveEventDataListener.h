@@ -101,15 +101,9 @@ private:
   // Returns true if we've got a value for every log listed in m_requiredLogs
   bool haveRequiredLogs();
 
-  void appendEvent(const uint32_t pixelId, const double tof,
-                   const Mantid::Types::Core::DateAndTime pulseTime);
-  // tof is "Time Of Flight" and is in units of microsecondss relative to the
-  // start of the pulse
-  // (There's some documentation that says nanoseconds, but Russell Taylor
-  // assures me it's really is microseconds!)
-  // pulseTime is the start of the pulse relative to Jan 1, 1990.
-  // Both values are designed to be passed straight into the TofEvent
-  // constructor.
+  // Returns false if the pixel id doesn't belong to the workspace
+  bool pixelToWorkspaceIndex(const uint32_t pixelId,
+                             std::size_t &workspaceIndex) const;
 
   ILiveListener::RunStatus m_status{RunStatus::NoRun};
   int m_runNumber{0};
@@ -120,6 +114,12 @@ private:
   std::string m_wsName;
   detid2index_map m_indexMap;        // maps pixel id's to workspace indexes
   detid2index_map m_monitorIndexMap; // Same as above for the monitor workspace
+  // Flat version of m_indexMap indexed by pixel id (empty if the ids are too
+  // sparse for it to be worthwhile)
+  std::vector<std::size_t> m_pixelIndexes;
+  // Events decoded from a banked event packet, waiting to be appended to
+  // m_eventBuffer.  Kept as a member so the memory is reused between packets.
+  std::vector<std::pair<std::size_t, Types::Event::TofEvent>> m_stagedEvents;
 
   // We need these 2 strings to initialize m_buffer
   std::string m_instrumentName;
@@ -6,6 +6,7 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidLiveData/ADARA/ADARAPackets.h"
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <cstring>
 
@@ -267,6 +268,38 @@ void BankedEventPkt::firstEventInBank() const {
   }
 }
 
+std::vector<BankedEventPkt::BankSection> BankedEventPkt::bankSections() const {
+  std::vector<BankSection> sections;
+  const unsigned numFields = m_lastFieldIndex + 1;
+  unsigned index = 4; // the first source section follows the packet header
+  while (index + 4 <= numFields) {
+    // Source section header: the TOF offset & COR flag are in the third
+    // field and the bank count in the fourth.  The offset is decoded the
+    // same way as in firstEventInSource().
+    const uint32_t tofField = m_fields[index + 2];
+    const uint32_t tofOffset = ((tofField & 0x7FFFFFFF) != 0);
+    const bool isCorrected = ((tofField & 0x80000000) != 0);
+    const uint32_t bankCount = m_fields[index + 3];
+    index += 4;
+
+    for (uint32_t bank = 0; bank < bankCount && index + 2 <= numFields;
+         ++bank) {
+      // Bank header: bank id and event count, followed by 2 fields per event.
+      // Don't trust the event count beyond the end of the payload.
+      const uint32_t eventCount =
+          std::min(m_fields[index + 1], (numFields - index - 2) / 2);
+      if (eventCount > 0) {
+        sections.push_back(
+            {m_fields[index], isCorrected, tofOffset,
+             reinterpret_cast<const Event *>(&m_fields[index + 2]),
+             eventCount});
+      }
+      index += 2 + 2 * eventCount;
+    }
+  }
+  return sections;
+}
+
 /* ------------------------------------------------------------------------ */
 
 BeamMonitorPkt::BeamMonitorPkt(const uint8_t *data, uint32_t len)
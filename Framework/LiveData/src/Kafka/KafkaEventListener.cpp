@@ -7,8 +7,8 @@
 #include "MantidLiveData/Kafka/KafkaEventListener.h"
 #include "MantidAPI/IAlgorithm.h"
 #include "MantidAPI/LiveListenerFactory.h"
-#include "MantidLiveData/Kafka/KafkaBroker.h"
 #include "MantidLiveData/Kafka/KafkaEventStreamDecoder.h"
+#include "MantidLiveData/Kafka/KafkaStreamRecording.h"
 #include "MantidLiveData/Kafka/KafkaTopicSubscriber.h"
 
 namespace {
@@ -38,8 +38,8 @@ bool KafkaEventListener::connect(const Poco::Net::SocketAddress &address) {
     g_log.error(
         "KafkaEventListener::connect requires a non-empty instrument name");
   }
-  auto broker = std::make_shared<KafkaBroker>(address.toString());
   try {
+    auto broker = createKafkaBroker(address.toString());
     const std::string eventTopic(m_instrumentName +
                                  KafkaTopicSubscriber::EVENT_TOPIC_SUFFIX),
         runInfoTopic(m_instrumentName + KafkaTopicSubscriber::RUN_TOPIC_SUFFIX),
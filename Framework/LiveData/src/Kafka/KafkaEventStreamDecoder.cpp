@@ -10,6 +10,7 @@
 #include "MantidAPI/WorkspaceGroup.h"
 #include "MantidKernel/DateAndTimeHelpers.h"
 #include "MantidKernel/Logger.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/TimeSeriesProperty.h"
 #include "MantidKernel/WarningSuppressions.h"
 #include "MantidKernel/make_unique.h"
@@ -25,6 +26,8 @@ GNU_DIAG_OFF("conversion")
 #include "private/Schema/is84_isis_events_generated.h"
 GNU_DIAG_ON("conversion")
 
+#include <algorithm>
+
 using namespace Mantid::Types;
 using namespace LogSchema;
 
@@ -41,6 +44,13 @@ const std::string RUN_MESSAGE_ID = "ba57";
 const std::string EVENT_MESSAGE_ID = "ev42";
 const std::string SAMPLE_MESSAGE_ID = "f142";
 
+/// Upper limit on the default number of threads decoding event messages
+const size_t MAX_DEFAULT_DECODE_THREADS = 4;
+/// Number of messages per decode thread that may wait to be decoded
+const size_t QUEUED_MESSAGES_PER_DECODE_THREAD = 8;
+/// Number of blocks of workspace indices that are merged concurrently
+const size_t MERGE_BLOCKS = 64;
+
 /**
  * Append sample log data to existing log or create a new log if one with
  * specified name does not already exist
@@ -85,13 +95,30 @@ KafkaEventStreamDecoder::KafkaEventStreamDecoder(
     const std::string &runInfoTopic, const std::string &spDetTopic,
     const std::string &sampleEnvTopic)
     : IKafkaStreamDecoder(broker, eventTopic, runInfoTopic, spDetTopic,
-                          sampleEnvTopic) {}
+                          sampleEnvTopic),
+      m_numDecodeThreads(std::max<size_t>(
+          1, std::min<size_t>(MAX_DEFAULT_DECODE_THREADS,
+                              std::thread::hardware_concurrency()))),
+      m_busyDecoders(0), m_stopDecoding(false) {}
 
 /**
  * Destructor.
- * Stops capturing from the stream
+ * Stops capturing from the stream. This is done here as well as in the base
+ * class because the capture and decode threads use members of this class.
  */
-KafkaEventStreamDecoder::~KafkaEventStreamDecoder() {}
+KafkaEventStreamDecoder::~KafkaEventStreamDecoder() { stopCapture(); }
+
+/**
+ * Set the number of threads decoding event messages. Takes effect the next
+ * time capturing starts.
+ * @param nthreads The number of decode threads, at least 1
+ */
+void KafkaEventStreamDecoder::setNumberOfDecodeThreads(size_t nthreads) {
+  if (nthreads == 0)
+    throw std::invalid_argument("KafkaEventStreamDecoder - at least one decode "
+                                "thread is required");
+  m_numDecodeThreads = nthreads;
+}
 
 /**
  * Check if there is data available to extract
@@ -128,6 +155,7 @@ bool KafkaEventStreamDecoder::hasReachedEndOfRun() noexcept {
 
 API::Workspace_sptr KafkaEventStreamDecoder::extractDataImpl() {
   std::lock_guard<std::mutex> lock(m_mutex);
+  mergeDecodedEvents();
   if (m_localEvents.size() == 1) {
     auto temp = createBufferWorkspace<DataObjects::EventWorkspace>(
         "EventWorkspace", m_localEvents.front());
@@ -175,54 +203,69 @@ void KafkaEventStreamDecoder::captureImplExcept() {
   std::unordered_map<std::string, std::vector<bool>> reachedEnd;
   bool checkOffsets = false;
 
-  while (!m_interrupt) {
-    if (m_endRun) {
-      waitForRunEndObservation();
-      continue;
-    } else {
-      waitForDataExtraction();
-    }
-    // Pull in events
-    m_dataStream->consumeMessage(&buffer, offset, partition, topicName);
-    // No events, wait for some to come along...
-    if (buffer.empty()) {
-      m_cbIterationEnd();
-      continue;
-    }
-
-    if (checkOffsets) {
-      checkRunEnd(topicName, checkOffsets, offset, partition, stopOffsets,
-                  reachedEnd);
-      if (offset > stopOffsets[topicName][static_cast<size_t>(partition)]) {
-        // If the offset is beyond the end of the current run, then skip to
-        // the next iteration and don't process the message
+  try {
+    startDecodeThreads();
+    while (!m_interrupt) {
+      if (m_endRun) {
+        waitForRunEndObservation();
+        continue;
+      } else {
+        waitForDataExtraction();
+      }
+      // Pull in events
+      m_dataStream->consumeMessage(&buffer, offset, partition, topicName);
+      // No events, wait for some to come along...
+      if (buffer.empty()) {
         m_cbIterationEnd();
         continue;
       }
-    }
 
-    // Check if we have an event message
-    // Most will be event messages so we check for this type first
-    if (flatbuffers::BufferHasIdentifier(
-            reinterpret_cast<const uint8_t *>(buffer.c_str()),
-            EVENT_MESSAGE_ID.c_str())) {
-      eventDataFromMessage(buffer);
-    }
-    // Check if we have a sample environment log message
-    else if (flatbuffers::BufferHasIdentifier(
-                 reinterpret_cast<const uint8_t *>(buffer.c_str()),
-                 SAMPLE_MESSAGE_ID.c_str())) {
-      sampleDataFromMessage(buffer);
+      if (checkOffsets) {
+        checkRunEnd(topicName, checkOffsets, offset, partition, stopOffsets,
+                    reachedEnd);
+        if (offset > stopOffsets[topicName][static_cast<size_t>(partition)]) {
+          // If the offset is beyond the end of the current run, then skip to
+          // the next iteration and don't process the message
+          m_cbIterationEnd();
+          continue;
+        }
+      }
+
+      // Check if we have an event message
+      // Most will be event messages so we check for this type first
+      if (flatbuffers::BufferHasIdentifier(
+              reinterpret_cast<const uint8_t *>(buffer.c_str()),
+              EVENT_MESSAGE_ID.c_str())) {
+        queueEventMessage(buffer);
+      }
+      // Check if we have a sample environment log message
+      else if (flatbuffers::BufferHasIdentifier(
+                   reinterpret_cast<const uint8_t *>(buffer.c_str()),
+                   SAMPLE_MESSAGE_ID.c_str())) {
+        sampleDataFromMessage(buffer);
+      }
+      // Check if we have a runMessage
+      else
+        checkRunMessage(buffer, checkOffsets, stopOffsets, reachedEnd);
+      m_cbIterationEnd();
     }
-    // Check if we have a runMessage
-    else
-      checkRunMessage(buffer, checkOffsets, stopOffsets, reachedEnd);
-    m_cbIterationEnd();
+  } catch (...) {
+    stopDecodeThreads();
+    throw;
   }
+  stopDecodeThreads();
   g_log.debug("Event capture finished");
 }
 
-void KafkaEventStreamDecoder::eventDataFromMessage(const std::string &buffer) {
+/**
+ * Decode an event message into the buffers of a single decode thread. Only
+ * reads shared state that is fixed while decode threads are busy, so no lock
+ * is needed.
+ * @param buffer The raw ev42 message
+ * @param decoded The buffers of the calling decode thread
+ */
+void KafkaEventStreamDecoder::eventDataFromMessage(const std::string &buffer,
+                                                   DecodedEvents &decoded) {
   auto eventMsg =
       GetEventMessage(reinterpret_cast<const uint8_t *>(buffer.c_str()));
 
@@ -231,24 +274,167 @@ void KafkaEventStreamDecoder::eventDataFromMessage(const std::string &buffer) {
   const auto &detData = *(eventMsg->detector_id());
   auto nEvents = tofData.size();
 
-  DataObjects::EventWorkspace_sptr periodBuffer;
-  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t period(0);
   if (eventMsg->facility_specific_data_type() == FacilityData_ISISData) {
     auto ISISMsg =
         static_cast<const ISISData *>(eventMsg->facility_specific_data());
-    periodBuffer = m_localEvents[static_cast<size_t>(ISISMsg->period_number())];
-    auto &mutableRunInfo = periodBuffer->mutableRun();
-    mutableRunInfo.getTimeSeriesProperty<double>(PROTON_CHARGE_PROPERTY)
-        ->addValue(pulseTime, ISISMsg->proton_charge());
-  } else {
-    periodBuffer = m_localEvents[0];
+    period = static_cast<size_t>(ISISMsg->period_number());
+    if (period >= decoded.events.size()) {
+      std::ostringstream os;
+      os << "KafkaEventStreamDecoder - Message has period_number=" << period
+         << " but the run has only " << decoded.events.size() << " periods";
+      throw std::runtime_error(os.str());
+    }
+    decoded.protonCharge[period].emplace_back(pulseTime,
+                                              ISISMsg->proton_charge());
   }
+  auto &blocks = decoded.events[period];
+  const size_t nspectra = std::max<size_t>(1, m_specToIdx.size());
   for (decltype(nEvents) i = 0; i < nEvents; ++i) {
-    auto &spectrum = periodBuffer->getSpectrum(
-        m_specToIdx[static_cast<int32_t>(detData[i])]);
-    spectrum.addEventQuickly(TofEvent(static_cast<double>(tofData[i]) *
-                                          1e-3, // nanoseconds to microseconds
-                                      pulseTime));
+    // Unknown detectors go to the first spectrum
+    const auto found = m_specToIdx.find(static_cast<int32_t>(detData[i]));
+    const size_t index = found != m_specToIdx.end() ? found->second : 0;
+    blocks[std::min(index * blocks.size() / nspectra, blocks.size() - 1)]
+        .emplace_back(index,
+                      TofEvent(static_cast<double>(tofData[i]) *
+                                   1e-3, // nanoseconds to microseconds
+                               pulseTime));
+  }
+}
+
+/**
+ * Create the buffers for the events decoded by one thread
+ * @param nperiods The number of periods in the run
+ * @param nblocks The number of blocks of workspace indices
+ */
+KafkaEventStreamDecoder::DecodedEvents::DecodedEvents(size_t nperiods,
+                                                      size_t nblocks)
+    : events(nperiods, std::vector<std::vector<std::pair<size_t, TofEvent>>>(
+                           nblocks)),
+      protonCharge(nperiods) {}
+
+/**
+ * Start the threads decoding event messages. The local caches must have been
+ * initialised.
+ */
+void KafkaEventStreamDecoder::startDecodeThreads() {
+  {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    m_stopDecoding = false;
+    m_decodeError = nullptr;
+  }
+  for (size_t i = 0; i < m_decodedEvents.size(); ++i)
+    m_decodeThreads.emplace_back(&KafkaEventStreamDecoder::decodeThread, this,
+                                 i);
+}
+
+/**
+ * Let the decode threads finish the queued messages and wait for them to
+ * exit. The decoded events stay buffered until they are extracted.
+ */
+void KafkaEventStreamDecoder::stopDecodeThreads() {
+  {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    m_stopDecoding = true;
+  }
+  m_decodeCv.notify_all();
+  for (auto &thread : m_decodeThreads)
+    thread.join();
+  m_decodeThreads.clear();
+}
+
+/**
+ * Body of a decode thread: decode queued messages into the thread's own
+ * buffers until asked to stop.
+ * @param threadIndex Index of the thread's buffers in m_decodedEvents
+ */
+void KafkaEventStreamDecoder::decodeThread(size_t threadIndex) {
+  std::unique_lock<std::mutex> lock(m_decodeMutex);
+  while (true) {
+    m_decodeCv.wait(
+        lock, [this] { return !m_decodeQueue.empty() || m_stopDecoding; });
+    if (m_decodeQueue.empty())
+      return;
+    std::string buffer;
+    buffer.swap(m_decodeQueue.front());
+    m_decodeQueue.pop_front();
+    ++m_busyDecoders;
+    auto &decoded = m_decodedEvents[threadIndex];
+    lock.unlock();
+    m_decodeCv.notify_all();
+
+    std::exception_ptr error;
+    try {
+      eventDataFromMessage(buffer, decoded);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    if (error && !m_decodeError)
+      m_decodeError = error;
+    --m_busyDecoders;
+    m_decodeCv.notify_all();
+  }
+}
+
+/**
+ * Hand an event message to the decode threads. The contents of the buffer
+ * are moved to the queue rather than copied, leaving it empty. Blocks while
+ * the queue is full.
+ * @param buffer The raw ev42 message
+ * @throws the exception thrown by a decode thread, if any
+ */
+void KafkaEventStreamDecoder::queueEventMessage(std::string &buffer) {
+  std::unique_lock<std::mutex> lock(m_decodeMutex);
+  const size_t maxQueued =
+      m_decodedEvents.size() * QUEUED_MESSAGES_PER_DECODE_THREAD;
+  m_decodeCv.wait(lock, [this, maxQueued] {
+    return m_decodeError || m_decodeQueue.size() < maxQueued;
+  });
+  if (m_decodeError)
+    std::rethrow_exception(m_decodeError);
+  m_decodeQueue.emplace_back();
+  m_decodeQueue.back().swap(buffer);
+  lock.unlock();
+  m_decodeCv.notify_all();
+}
+
+/**
+ * Wait for the queued messages to be decoded and move the decoded events to
+ * the local buffers. The blocks of workspace indices are merged in parallel
+ * as they touch separate spectra. The caller must hold m_mutex.
+ */
+void KafkaEventStreamDecoder::mergeDecodedEvents() {
+  std::unique_lock<std::mutex> lock(m_decodeMutex);
+  m_decodeCv.wait(
+      lock, [this] { return m_decodeQueue.empty() && m_busyDecoders == 0; });
+  for (size_t period = 0; period < m_localEvents.size(); ++period) {
+    auto &periodBuffer = *m_localEvents[period];
+    const int nblocks = static_cast<int>(MERGE_BLOCKS);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int block = 0; block < nblocks; ++block) {
+      for (auto &decoded : m_decodedEvents) {
+        if (period >= decoded.events.size() ||
+            static_cast<size_t>(block) >= decoded.events[period].size())
+          continue;
+        auto &events = decoded.events[period][block];
+        for (const auto &event : events)
+          periodBuffer.getSpectrum(event.first).addEventQuickly(event.second);
+        events.clear();
+      }
+    }
+
+    auto protonCharge =
+        periodBuffer.mutableRun().getTimeSeriesProperty<double>(
+            PROTON_CHARGE_PROPERTY);
+    for (auto &decoded : m_decodedEvents) {
+      if (period >= decoded.protonCharge.size())
+        continue;
+      for (const auto &charge : decoded.protonCharge[period])
+        protonCharge->addValue(charge.first, charge.second);
+      decoded.protonCharge[period].clear();
+    }
   }
 }
 
@@ -309,6 +495,11 @@ void KafkaEventStreamDecoder::sampleDataFromMessage(const std::string &buffer) {
  */
 void KafkaEventStreamDecoder::initLocalCaches(
     const std::string &rawMsgBuffer, const RunStartStruct &runStartData) {
+  {
+    // Events still waiting to be merged belong to the previous run
+    std::lock_guard<std::mutex> lock(m_mutex);
+    mergeDecodedEvents();
+  }
 
   if (rawMsgBuffer.empty()) {
     throw std::runtime_error("KafkaEventStreamDecoder::initLocalCaches() - "
@@ -376,6 +567,16 @@ void KafkaEventStreamDecoder::initLocalCaches(
       m_localEvents[i] = eventBuffer->clone();
     }
   }
+  {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    const size_t nblocks = std::max<size_t>(
+        1, std::min(MERGE_BLOCKS, eventBuffer->getNumberHistograms()));
+    // One set of buffers per decode thread, keeping the count of any
+    // threads that are already running
+    const size_t nthreads = m_decodeThreads.empty() ? m_numDecodeThreads
+                                                    : m_decodedEvents.size();
+    m_decodedEvents.assign(nthreads, DecodedEvents(nperiods, nblocks));
+  }
 
   // New caches so LoadLiveData's output workspace needs to be replaced
   m_dataReset = true;
@@ -8,8 +8,8 @@
 #include "MantidAPI/IAlgorithm.h"
 #include "MantidAPI/LiveListenerFactory.h"
 #include "MantidLiveData/Exception.h"
-#include "MantidLiveData/Kafka/KafkaBroker.h"
 #include "MantidLiveData/Kafka/KafkaHistoStreamDecoder.h"
+#include "MantidLiveData/Kafka/KafkaStreamRecording.h"
 #include "MantidLiveData/Kafka/KafkaTopicSubscriber.h"
 
 namespace {
@@ -54,8 +54,8 @@ bool KafkaHistoListener::connect(const Poco::Net::SocketAddress &address) {
                        KafkaTopicSubscriber::SAMPLE_ENV_TOPIC_SUFFIX);
 
     m_decoder = Kernel::make_unique<KafkaHistoStreamDecoder>(
-        std::make_shared<KafkaBroker>(address.toString()), histoTopic,
-        runInfoTopic, spDetInfoTopic, sampleEnvTopic);
+        createKafkaBroker(address.toString()), histoTopic, runInfoTopic,
+        spDetInfoTopic, sampleEnvTopic);
   } catch (std::exception &exc) {
     g_log.error() << "KafkaHistoListener::connect - Connection Error: "
                   << exc.what() << "\n";
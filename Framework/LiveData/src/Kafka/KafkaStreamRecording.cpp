@@ -0,0 +1,497 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidLiveData/Kafka/KafkaStreamRecording.h"
+#include "MantidKernel/ConfigService.h"
+#include "MantidKernel/Logger.h"
+#include "MantidKernel/make_unique.h"
+#include "MantidLiveData/Kafka/KafkaBroker.h"
+
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace Mantid {
+namespace LiveData {
+
+namespace {
+/// Logger
+Kernel::Logger g_log("KafkaStreamRecording");
+
+/// Identifies a recording file, followed by the format version
+const std::string RECORDING_MAGIC = "MantidKafkaRecording";
+const uint32_t RECORDING_VERSION = 1;
+
+/// Longest time a replayed consumeMessage() waits for the next message, the
+/// same as the timeout of KafkaTopicSubscriber
+const std::chrono::milliseconds CONSUME_TIMEOUT(30000);
+/// Time a replayed consumeMessage() waits once the recording is exhausted
+const std::chrono::milliseconds END_OF_RECORDING_WAIT(100);
+
+/// Types of the records following the file header. Every record starts
+/// with its type, the subscription it belongs to and the time in
+/// nanoseconds since the recording started.
+enum RecordType : uint8_t {
+  SUBSCRIBE = 1,
+  MESSAGE = 2,
+  OFFSETS_FOR_TIMESTAMP = 3,
+  CURRENT_OFFSETS = 4
+};
+
+using OffsetMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
+/// Reads the values written by KafkaRecordingBroker::Writer. Sets the stream
+/// state to fail if the file ends part way through a value.
+class RecordReader {
+public:
+  explicit RecordReader(std::istream &stream) : m_stream(stream) {}
+
+  template <typename T> T value() {
+    T result{};
+    m_stream.read(reinterpret_cast<char *>(&result), sizeof(T));
+    return result;
+  }
+
+  std::string string() {
+    const auto length = value<uint32_t>();
+    std::string result(length, '\0');
+    if (length > 0)
+      m_stream.read(&result[0], length);
+    return result;
+  }
+
+  OffsetMap offsets() {
+    OffsetMap result;
+    const auto ntopics = value<uint32_t>();
+    for (uint32_t i = 0; i < ntopics && m_stream; ++i) {
+      auto topic = string();
+      const auto npartitions = value<uint32_t>();
+      std::vector<int64_t> partitionOffsets;
+      for (uint32_t j = 0; j < npartitions && m_stream; ++j)
+        partitionOffsets.push_back(value<int64_t>());
+      result.emplace(std::move(topic), std::move(partitionOffsets));
+    }
+    return result;
+  }
+
+  bool good() const { return static_cast<bool>(m_stream); }
+
+private:
+  std::istream &m_stream;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+// KafkaRecordingBroker
+// -----------------------------------------------------------------------------
+
+/// Writes the records of all of the subscriptions of a broker to one file
+class KafkaRecordingBroker::Writer {
+public:
+  explicit Writer(const std::string &filename)
+      : m_file(filename, std::ios::binary | std::ios::trunc),
+        m_start(std::chrono::steady_clock::now()) {
+    if (!m_file)
+      throw std::runtime_error("KafkaRecordingBroker - unable to open " +
+                               filename + " for writing");
+    m_file.write(RECORDING_MAGIC.data(), RECORDING_MAGIC.size());
+    writeValue(RECORDING_VERSION);
+  }
+
+  /// Record a new subscription and return its id
+  uint32_t subscription(const std::vector<std::string> &topics) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32_t id = m_nextId++;
+    writeHeader(SUBSCRIBE, id);
+    writeValue(static_cast<uint32_t>(topics.size()));
+    for (const auto &topic : topics)
+      writeString(topic);
+    return id;
+  }
+
+  void message(uint32_t id, const std::string &payload, int64_t offset,
+               int32_t partition, const std::string &topic) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    writeHeader(MESSAGE, id);
+    writeValue(offset);
+    writeValue(partition);
+    writeString(topic);
+    writeString(payload);
+  }
+
+  void offsets(RecordType type, uint32_t id, const OffsetMap &offsets) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    writeHeader(type, id);
+    writeValue(static_cast<uint32_t>(offsets.size()));
+    for (const auto &topicOffsets : offsets) {
+      writeString(topicOffsets.first);
+      writeValue(static_cast<uint32_t>(topicOffsets.second.size()));
+      for (const auto offset : topicOffsets.second)
+        writeValue(offset);
+    }
+  }
+
+  void flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.flush();
+  }
+
+private:
+  void writeHeader(RecordType type, uint32_t id) {
+    writeValue(static_cast<uint8_t>(type));
+    writeValue(id);
+    writeValue(static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start)
+            .count()));
+  }
+
+  template <typename T> void writeValue(const T &value) {
+    m_file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  void writeString(const std::string &value) {
+    writeValue(static_cast<uint32_t>(value.size()));
+    m_file.write(value.data(), value.size());
+  }
+
+  std::mutex m_mutex;
+  std::ofstream m_file;
+  const std::chrono::steady_clock::time_point m_start;
+  uint32_t m_nextId{0};
+};
+
+namespace {
+/// Passes every call on to another subscriber and records the results
+class RecordingSubscriber : public IKafkaStreamSubscriber {
+public:
+  RecordingSubscriber(std::unique_ptr<IKafkaStreamSubscriber> subscriber,
+                      std::shared_ptr<KafkaRecordingBroker::Writer> writer,
+                      uint32_t id)
+      : m_subscriber(std::move(subscriber)), m_writer(std::move(writer)),
+        m_id(id) {}
+
+  void subscribe() override { m_subscriber->subscribe(); }
+  void subscribe(int64_t offset) override { m_subscriber->subscribe(offset); }
+
+  void consumeMessage(std::string *message, int64_t &offset, int32_t &partition,
+                      std::string &topic) override {
+    m_subscriber->consumeMessage(message, offset, partition, topic);
+    // An empty message only means nothing arrived before the timeout
+    if (!message->empty())
+      m_writer->message(m_id, *message, offset, partition, topic);
+  }
+
+  OffsetMap getOffsetsForTimestamp(int64_t timestamp) override {
+    auto offsets = m_subscriber->getOffsetsForTimestamp(timestamp);
+    m_writer->offsets(OFFSETS_FOR_TIMESTAMP, m_id, offsets);
+    return offsets;
+  }
+
+  void seek(const std::string &topic, uint32_t partition,
+            int64_t offset) override {
+    m_subscriber->seek(topic, partition, offset);
+  }
+
+  OffsetMap getCurrentOffsets() override {
+    auto offsets = m_subscriber->getCurrentOffsets();
+    m_writer->offsets(CURRENT_OFFSETS, m_id, offsets);
+    return offsets;
+  }
+
+private:
+  std::unique_ptr<IKafkaStreamSubscriber> m_subscriber;
+  std::shared_ptr<KafkaRecordingBroker::Writer> m_writer;
+  const uint32_t m_id;
+};
+} // namespace
+
+/**
+ * @param broker The broker whose streams are recorded
+ * @param filename The file to record to. It is overwritten.
+ */
+KafkaRecordingBroker::KafkaRecordingBroker(std::shared_ptr<IKafkaBroker> broker,
+                                           const std::string &filename)
+    : m_broker(std::move(broker)), m_writer(std::make_shared<Writer>(filename)) {
+}
+
+KafkaRecordingBroker::~KafkaRecordingBroker() { m_writer->flush(); }
+
+std::unique_ptr<IKafkaStreamSubscriber>
+KafkaRecordingBroker::subscribe(std::vector<std::string> topics,
+                                SubscribeAtOption subscribeOption) const {
+  return record(m_broker->subscribe(topics, subscribeOption), topics);
+}
+
+std::unique_ptr<IKafkaStreamSubscriber>
+KafkaRecordingBroker::subscribe(std::vector<std::string> topics, int64_t offset,
+                                SubscribeAtOption subscribeOption) const {
+  return record(m_broker->subscribe(topics, offset, subscribeOption), topics);
+}
+
+std::unique_ptr<IKafkaStreamSubscriber> KafkaRecordingBroker::record(
+    std::unique_ptr<IKafkaStreamSubscriber> subscriber,
+    const std::vector<std::string> &topics) const {
+  const auto id = m_writer->subscription(topics);
+  return Kernel::make_unique<RecordingSubscriber>(std::move(subscriber),
+                                                  m_writer, id);
+}
+
+// -----------------------------------------------------------------------------
+// KafkaReplayBroker
+// -----------------------------------------------------------------------------
+
+/// The contents of a recording file
+struct KafkaReplayBroker::Recording {
+  struct Message {
+    std::chrono::nanoseconds time;
+    std::string payload;
+    int64_t offset;
+    int32_t partition;
+    std::string topic;
+  };
+  struct Subscription {
+    std::vector<std::string> topics;
+    std::deque<Message> messages;
+    std::deque<OffsetMap> offsetsForTimestamp;
+    std::deque<OffsetMap> currentOffsets;
+    /// Offset of the last message of each topic & partition in the recording
+    OffsetMap lastOffsets;
+  };
+
+  /// Hand out the first recorded subscription to these topics that has not
+  /// been replayed yet
+  std::unique_ptr<Subscription> claim(const std::vector<std::string> &topics) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = unclaimed.find(topics);
+    if (found == unclaimed.end() || found->second.empty()) {
+      std::string names;
+      for (const auto &topic : topics)
+        names += " " + topic;
+      throw std::runtime_error("KafkaReplayBroker - the recording has no "
+                               "further subscriptions to the topics" +
+                               names);
+    }
+    auto subscription = std::move(found->second.front());
+    found->second.pop_front();
+    return subscription;
+  }
+
+  std::map<std::vector<std::string>,
+           std::deque<std::unique_ptr<Subscription>>>
+      unclaimed;
+  std::mutex mutex;
+};
+
+namespace {
+/// Hands back the messages and offsets of one recorded subscription
+class ReplaySubscriber : public IKafkaStreamSubscriber {
+public:
+  using Recording = KafkaReplayBroker::Recording;
+
+  ReplaySubscriber(std::unique_ptr<Recording::Subscription> subscription,
+                   double speed, std::chrono::steady_clock::time_point start)
+      : m_subscription(std::move(subscription)), m_speed(speed),
+        m_start(start) {}
+
+  void subscribe() override {}
+  void subscribe(int64_t offset) override { UNUSED_ARG(offset); }
+
+  void consumeMessage(std::string *message, int64_t &offset, int32_t &partition,
+                      std::string &topic) override {
+    message->clear();
+    auto &messages = m_subscription->messages;
+    if (messages.empty()) {
+      std::this_thread::sleep_for(END_OF_RECORDING_WAIT);
+      return;
+    }
+    auto &next = messages.front();
+    if (m_speed > 0.0) {
+      const auto due =
+          m_start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        next.time / m_speed);
+      const auto now = std::chrono::steady_clock::now();
+      if (due > now) {
+        if (due - now > CONSUME_TIMEOUT) {
+          std::this_thread::sleep_for(CONSUME_TIMEOUT);
+          return;
+        }
+        std::this_thread::sleep_until(due);
+      }
+    }
+    message->swap(next.payload);
+    offset = next.offset;
+    partition = next.partition;
+    topic = next.topic;
+    auto &positions = m_position[topic];
+    if (positions.size() <= static_cast<size_t>(partition))
+      positions.resize(static_cast<size_t>(partition) + 1, -1);
+    positions[static_cast<size_t>(partition)] = offset;
+    messages.pop_front();
+  }
+
+  OffsetMap getOffsetsForTimestamp(int64_t timestamp) override {
+    UNUSED_ARG(timestamp);
+    return next(m_subscription->offsetsForTimestamp,
+                m_subscription->lastOffsets);
+  }
+
+  void seek(const std::string &topic, uint32_t partition,
+            int64_t offset) override {
+    UNUSED_ARG(topic);
+    UNUSED_ARG(partition);
+    UNUSED_ARG(offset);
+  }
+
+  OffsetMap getCurrentOffsets() override {
+    return next(m_subscription->currentOffsets, m_position);
+  }
+
+private:
+  /// The next recorded result, or a fallback once they have run out
+  static OffsetMap next(std::deque<OffsetMap> &recorded,
+                        const OffsetMap &fallback) {
+    if (recorded.empty())
+      return fallback;
+    auto result = std::move(recorded.front());
+    recorded.pop_front();
+    return result;
+  }
+
+  std::unique_ptr<Recording::Subscription> m_subscription;
+  const double m_speed;
+  const std::chrono::steady_clock::time_point m_start;
+  /// Offset of the last message handed out for each topic & partition
+  OffsetMap m_position;
+};
+} // namespace
+
+/**
+ * Load a recording. The replay clock starts now.
+ * @param filename A file written by KafkaRecordingBroker
+ * @param speed Replay speed relative to the recording, e.g. 2 for twice as
+ * fast. 0 replays every message as soon as it is requested.
+ */
+KafkaReplayBroker::KafkaReplayBroker(const std::string &filename, double speed)
+    : m_recording(std::make_shared<Recording>()), m_speed(speed) {
+  if (speed < 0.0)
+    throw std::invalid_argument(
+        "KafkaReplayBroker - the replay speed cannot be negative");
+
+  std::ifstream file(filename, std::ios::binary);
+  std::string magic(RECORDING_MAGIC.size(), '\0');
+  file.read(&magic[0], magic.size());
+  RecordReader reader(file);
+  if (!file || magic != RECORDING_MAGIC ||
+      reader.value<uint32_t>() != RECORDING_VERSION)
+    throw std::runtime_error("KafkaReplayBroker - " + filename +
+                             " is not a Kafka stream recording");
+
+  std::vector<Recording::Subscription *> subscriptions;
+  while (file.peek() != std::char_traits<char>::eof()) {
+    const auto type = reader.value<uint8_t>();
+    const auto id = reader.value<uint32_t>();
+    const std::chrono::nanoseconds time(reader.value<int64_t>());
+    if (!reader.good())
+      break;
+    if (type == SUBSCRIBE) {
+      auto subscription = Kernel::make_unique<Recording::Subscription>();
+      const auto ntopics = reader.value<uint32_t>();
+      for (uint32_t i = 0; i < ntopics && reader.good(); ++i)
+        subscription->topics.push_back(reader.string());
+      subscriptions.push_back(subscription.get());
+      m_recording->unclaimed[subscription->topics].push_back(
+          std::move(subscription));
+      continue;
+    }
+    if (id >= subscriptions.size()) {
+      g_log.warning() << "Record for unknown subscription " << id << " in "
+                      << filename << ". Ignoring the rest of the file.\n";
+      break;
+    }
+    auto &subscription = *subscriptions[id];
+    if (type == MESSAGE) {
+      Recording::Message message;
+      message.time = time;
+      message.offset = reader.value<int64_t>();
+      message.partition = reader.value<int32_t>();
+      message.topic = reader.string();
+      message.payload = reader.string();
+      if (!reader.good())
+        break;
+      auto &last = subscription.lastOffsets[message.topic];
+      if (last.size() <= static_cast<size_t>(message.partition))
+        last.resize(static_cast<size_t>(message.partition) + 1, -1);
+      last[static_cast<size_t>(message.partition)] = message.offset;
+      subscription.messages.push_back(std::move(message));
+    } else if (type == OFFSETS_FOR_TIMESTAMP || type == CURRENT_OFFSETS) {
+      auto offsets = reader.offsets();
+      if (!reader.good())
+        break;
+      (type == OFFSETS_FOR_TIMESTAMP ? subscription.offsetsForTimestamp
+                                     : subscription.currentOffsets)
+          .push_back(std::move(offsets));
+    } else {
+      g_log.warning() << "Unknown record type " << static_cast<int>(type)
+                      << " in " << filename
+                      << ". Ignoring the rest of the file.\n";
+      break;
+    }
+  }
+  if (!reader.good())
+    g_log.warning() << filename << " ends part way through a record, "
+                    << "which is ignored.\n";
+  m_start = std::chrono::steady_clock::now();
+}
+
+std::unique_ptr<IKafkaStreamSubscriber>
+KafkaReplayBroker::subscribe(std::vector<std::string> topics,
+                             SubscribeAtOption subscribeOption) const {
+  UNUSED_ARG(subscribeOption);
+  return Kernel::make_unique<ReplaySubscriber>(m_recording->claim(topics),
+                                               m_speed, m_start);
+}
+
+std::unique_ptr<IKafkaStreamSubscriber>
+KafkaReplayBroker::subscribe(std::vector<std::string> topics, int64_t offset,
+                             SubscribeAtOption subscribeOption) const {
+  UNUSED_ARG(offset);
+  return subscribe(std::move(topics), subscribeOption);
+}
+
+/**
+ * Create the broker for a Kafka listener. If kafka.replay.filename is set in
+ * the configuration, the stream is replayed from that file at the speed in
+ * kafka.replay.speed (default 1) instead of connecting to the address. If
+ * kafka.record.filename is set, the stream from the address is recorded to
+ * that file.
+ * @param address The address of the Kafka broker
+ */
+std::shared_ptr<IKafkaBroker> createKafkaBroker(const std::string &address) {
+  auto &config = Kernel::ConfigService::Instance();
+  const auto replayFile = config.getString("kafka.replay.filename");
+  if (!replayFile.empty()) {
+    const auto speed =
+        config.getValue<double>("kafka.replay.speed").get_value_or(1.0);
+    g_log.notice() << "Replaying Kafka streams from " << replayFile
+                   << " instead of connecting to " << address << "\n";
+    return std::make_shared<KafkaReplayBroker>(replayFile, speed);
+  }
+
+  std::shared_ptr<IKafkaBroker> broker = std::make_shared<KafkaBroker>(address);
+  const auto recordFile = config.getString("kafka.record.filename");
+  if (!recordFile.empty()) {
+    g_log.notice() << "Recording Kafka streams to " << recordFile << "\n";
+    return std::make_shared<KafkaRecordingBroker>(broker, recordFile);
+  }
+  return broker;
+}
+
+} // namespace LiveData
+} // namespace Mantid
@@ -141,6 +141,16 @@ void LiveDataAlgorithm::initProps() {
                                 FileProperty::OptionalLoad, "py"),
       " Python script that will be run to process the accumulated data.");
 
+  declareProperty(
+      "IncrementalPostProcessing", false,
+      "Only post-process each new chunk and add the result to the "
+      "OutputWorkspace, instead of post-processing the whole accumulated "
+      "workspace on every update.\n"
+      "Only use this if the post-processing is linear in the data and gives "
+      "the same binning every time (e.g. ConvertUnits followed by Rebin with "
+      "fixed parameters, SumSpectra). "
+      "Only applies when the AccumulationMethod is Add.");
+
   std::vector<std::string> runOptions{"Restart", "Stop", "Rename"};
   declareProperty("RunTransitionBehavior", "Restart",
                   boost::make_shared<StringListValidator>(runOptions),
@@ -19,6 +19,8 @@
 
 #include <Poco/Thread.h>
 
+#include <limits>
+
 using namespace Mantid::Kernel;
 using namespace Mantid::API;
 using namespace Mantid::DataObjects;
@@ -95,12 +97,15 @@ void LoadLiveData::init() { this->initProps(); }
  *
  * @param inputWS :: workspace being processed
  * @param PostProcess :: flag, TRUE if doing the post-processing
+ * @param isChunk :: flag, TRUE if inputWS is a chunk of data rather than the
+ *        accumulation workspace. It is processed in place under an anonymous
+ *        name.
  * @return the processed workspace. Will point to inputWS if no processing is to
  *do
  */
 Mantid::API::Workspace_sptr
 LoadLiveData::runProcessing(Mantid::API::Workspace_sptr inputWS,
-                            bool PostProcess) {
+                            bool PostProcess, bool isChunk) {
   if (!inputWS)
     throw std::runtime_error(
         "LoadLiveData::runProcessing() called for an empty input workspace.");
@@ -124,8 +129,9 @@ LoadLiveData::runProcessing(Mantid::API::Workspace_sptr inputWS,
     // Transform the chunk in-place
     std::string outputName = inputName;
 
-    // Except, no need for anonymous names with the post-processing
-    if (PostProcess) {
+    // Except, no need for anonymous names with the post-processing of the
+    // accumulated data
+    if (!isChunk) {
       inputName = this->getPropertyValue("AccumulationWorkspace");
       outputName = this->getPropertyValue("OutputWorkspace");
     }
@@ -176,7 +182,7 @@ LoadLiveData::runProcessing(Mantid::API::Workspace_sptr inputWS,
           " Algorithm's OutputWorkspace property is not a WorkspaceProperty!");
     Workspace_sptr temp = wsProp->getWorkspace();
 
-    if (!PostProcess) {
+    if (isChunk) {
       if (!temp) {
         // a group workspace cannot be returned by wsProp
         temp = AnalysisDataService::Instance().retrieve(inputName);
@@ -205,7 +211,7 @@ LoadLiveData::runProcessing(Mantid::API::Workspace_sptr inputWS,
 Mantid::API::Workspace_sptr
 LoadLiveData::processChunk(Mantid::API::Workspace_sptr chunkWS) {
   try {
-    return runProcessing(chunkWS, false);
+    return runProcessing(chunkWS, false, true);
   } catch (...) {
     g_log.error("While processing chunk:");
     throw;
@@ -219,13 +225,40 @@ LoadLiveData::processChunk(Mantid::API::Workspace_sptr chunkWS) {
  */
 void LoadLiveData::runPostProcessing() {
   try {
-    m_outputWS = runProcessing(m_accumWS, true);
+    m_outputWS = runProcessing(m_accumWS, true, false);
   } catch (...) {
     g_log.error("While post processing:");
     throw;
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Perform the PostProcessing steps on the new chunk only and add the result
+ * to the previous output. This is only valid if the post-processing is linear
+ * in the data, i.e. post-processing the sum of the accumulated data and the
+ * chunk gives the same as summing them after post-processing. The cost of
+ * each update then no longer grows with the length of the run.
+ * Sets the m_outputWS member to the updated result.
+ *
+ * @param chunkWS :: processed live data chunk workspace that has just been
+ *        added to the accumulation workspace
+ */
+void LoadLiveData::runIncrementalPostProcessing(
+    Mantid::API::Workspace_sptr chunkWS) {
+  try {
+    Workspace_sptr processedChunk = runProcessing(chunkWS, true, true);
+    // Keep the previous output alive while it is locked, in case adding
+    // replaces it
+    Workspace_sptr previousOutput = m_outputWS;
+    WriteLock _lock1(*previousOutput);
+    ReadLock _lock2(*processedChunk);
+    addChunk(m_outputWS, processedChunk);
+  } catch (...) {
+    g_log.error("While post processing the chunk:");
+    throw;
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Accumulate the data by adding (summing) to the output workspace.
  * Calls the Plus algorithm
@@ -237,12 +270,22 @@ void LoadLiveData::addChunk(Mantid::API::Workspace_sptr chunkWS) {
   // Acquire locks on the workspaces we use
   WriteLock _lock1(*m_accumWS);
   ReadLock _lock2(*chunkWS);
+  addChunk(m_accumWS, chunkWS);
+}
 
+//----------------------------------------------------------------------------------------------
+/** Add (sum) a chunk to a workspace. The caller must hold the locks.
+ *
+ * @param accumWS :: workspace to add to. Updated if it has to be replaced.
+ * @param chunkWS :: chunk workspace of the same type
+ */
+void LoadLiveData::addChunk(Mantid::API::Workspace_sptr &accumWS,
+                            Mantid::API::Workspace_sptr chunkWS) {
   // ISIS multi-period data come in workspace groups
   if (WorkspaceGroup_sptr gws =
           boost::dynamic_pointer_cast<WorkspaceGroup>(chunkWS)) {
     WorkspaceGroup_sptr accum_gws =
-        boost::dynamic_pointer_cast<WorkspaceGroup>(m_accumWS);
+        boost::dynamic_pointer_cast<WorkspaceGroup>(accumWS);
     if (!accum_gws) {
       throw std::runtime_error("Two workspace groups are expected.");
     }
@@ -259,10 +302,10 @@ void LoadLiveData::addChunk(Mantid::API::Workspace_sptr chunkWS) {
   } else if (MatrixWorkspace_sptr mws =
                  boost::dynamic_pointer_cast<MatrixWorkspace>(chunkWS)) {
     // If workspace is a Matrix workspace just add the chunk
-    addMatrixWSChunk(m_accumWS, chunkWS);
+    addMatrixWSChunk(accumWS, chunkWS);
   } else {
     // Assume MD Workspace
-    addMDWSChunk(m_accumWS, chunkWS);
+    addMDWSChunk(accumWS, chunkWS);
   }
 }
 
@@ -439,6 +482,35 @@ bool isUsingDefaultBinBoundaries(const EventWorkspace *workspace) {
   // make sure that they are sorted
   return (x.front() < x.back());
 }
+
+/** Widen the single bin of an accumulation workspace to include the events of
+ * a chunk that was just added to it. The bin already fits the previously
+ * accumulated events, so only the chunk has to be scanned.
+ * @param accumWS :: The accumulation workspace the chunk was added to
+ * @param chunkWS :: The chunk of live data
+ * @param accumHadEvents :: Whether accumWS had any events before the chunk
+ * was added. If not, its bin is still the reset default and is replaced by
+ * the range of the chunk.
+ */
+void extendDefaultBinBoundaries(EventWorkspace &accumWS,
+                                const EventWorkspace &chunkWS,
+                                bool accumHadEvents) {
+  if (chunkWS.getNumberEvents() == 0)
+    return;
+  double tofmin, tofmax;
+  chunkWS.getEventXMinMax(tofmin, tofmax);
+  if (accumHadEvents) {
+    const auto &x = accumWS.binEdges(0);
+    if (tofmin >= x.front() && tofmax <= x.back())
+      return;
+    tofmin = std::min(tofmin, x.front());
+    tofmax = std::max(tofmax, x.back());
+  }
+  // as in EventWorkspace::resetAllXToSingleBin
+  if (tofmin == tofmax)
+    tofmax += std::numeric_limits<double>::min();
+  accumWS.setAllX(HistogramData::BinEdges{tofmin, tofmax});
+}
 } // namespace
 
 //----------------------------------------------------------------------------------------------
@@ -579,11 +651,19 @@ void LoadLiveData::exec() {
     this->appendChunk(processed);
   } else {
     // Default to Add.
+    auto accumEvent = boost::dynamic_pointer_cast<EventWorkspace>(m_accumWS);
+    auto chunkEvent = boost::dynamic_pointer_cast<EventWorkspace>(processed);
+    const bool extendBins = preserveEvents && accumEvent && chunkEvent &&
+                            isUsingDefaultBinBoundaries(accumEvent.get());
+    const bool accumHadEvents =
+        extendBins && accumEvent->getNumberEvents() > 0;
     this->addChunk(processed);
 
     // When adding events, the default bin boundaries may need to be updated.
-    // The function itself checks to see if it is appropriate
-    if (preserveEvents) {
+    if (extendBins && m_accumWS == accumEvent) {
+      extendDefaultBinBoundaries(*accumEvent, *chunkEvent, accumHadEvents);
+    } else if (preserveEvents) {
+      // The function itself checks to see if it is appropriate
       this->updateDefaultBinBoundaries(m_accumWS.get());
     }
   }
@@ -592,7 +672,12 @@ void LoadLiveData::exec() {
 
   if (this->hasPostProcessing()) {
     // ----------- Run post-processing -------------
-    this->runPostProcessing();
+    const bool incremental = this->getProperty("IncrementalPostProcessing");
+    if (incremental && accum == "Add" && m_outputWS &&
+        m_outputWS != m_accumWS)
+      this->runIncrementalPostProcessing(processed);
+    else
+      this->runPostProcessing();
     // Set both output workspaces
     this->setProperty("AccumulationWorkspace", m_accumWS);
     this->setProperty("OutputWorkspace", m_outputWS);
@@ -4,8 +4,10 @@
 //     NScD Oak Ridge National Laboratory, European Spallation Source
 //     & Institut Laue - Langevin
 // SPDX - License - Identifier: GPL - 3.0 +
+#include <algorithm>
 #include <ctime>
 #include <exception>
+#include <limits>
 #include <sstream> // for ostringstream
 #include <string>
 
@@ -56,6 +58,13 @@ const std::string PAUSE_PROPERTY("pause");
 const std::string SCAN_PROPERTY("scan_index");
 const std::string PROTON_CHARGE_PROPERTY("proton_charge");
 
+// Marks pixel ids that have no workspace index in the pixel lookup table
+const std::size_t INVALID_WORKSPACE_INDEX =
+    std::numeric_limits<std::size_t>::max();
+// The pixel lookup table is only used if it would have fewer than this many
+// entries per pixel in the workspace
+const std::size_t MAX_PIXEL_TABLE_RATIO = 8;
+
 // These are names for some string properties (not time series)
 const std::string RUN_TITLE_PROPERTY("run_title");
 const std::string EXPERIMENT_ID_PROPERTY("experiment_identifier");
@@ -399,51 +408,49 @@ bool SNSLiveEventDataListener::rxPacket(const ADARA::BankedEventPkt &pkt) {
     return false;
   }
 
-  // Append the events
+  // Timestamp for the events
+  const Mantid::Types::Core::DateAndTime eventTime = timeFromPacket(pkt);
+
+  // Decode the events a whole bank at a time before taking the lock, so
+  // extractData() is only held up while the decoded events are appended
   g_log.debug() << "----- Pulse ID: " << pkt.pulseId() << " -----\n";
+  m_stagedEvents.clear();
+  for (const auto &bank : pkt.bankSections()) {
+    g_log.debug() << "BankID " << bank.bankId << " had " << bank.eventCount
+                  << " events\n";
+    totalEvents += bank.eventCount;
+    if (bank.bankId >= 0xFFFFFFFE) // Bank ID -1 & -2 are special cases and
+                                   // are not valid pixels
+      continue;
+
+    const uint32_t tofOffset = bank.isCorrected ? 0 : bank.tofOffset;
+    for (uint32_t i = 0; i < bank.eventCount; ++i) {
+      const ADARA::Event &event = bank.events[i];
+      // TofEvent needs tof to be in units of microseconds, but it comes
+      // from the ADARA stream in units of 100ns.
+      const double tof = (event.tof + tofOffset) / 10.0;
+      std::size_t workspaceIndex;
+      if (pixelToWorkspaceIndex(event.pixel, workspaceIndex)) {
+        m_stagedEvents.emplace_back(workspaceIndex, TofEvent(tof, eventTime));
+      } else {
+        g_log.warning() << "Invalid pixel ID: " << event.pixel
+                        << " (TofF: " << tof << " microseconds)\n";
+      }
+    }
+  }
+
   // Scope braces
   {
     std::lock_guard<std::mutex> scopedLock(m_mutex);
 
-    // Timestamp for the events
-    Mantid::Types::Core::DateAndTime eventTime = timeFromPacket(pkt);
-
     // Save the pulse charge in the logs (*10 because we want the units to be
     // picoCulombs, and ADARA sends them out in units of 10pC)
     m_eventBuffer->mutableRun()
         .getTimeSeriesProperty<double>(PROTON_CHARGE_PROPERTY)
         ->addValue(eventTime, pkt.pulseCharge() * 10);
 
-    // Iterate through each event
-    const ADARA::Event *event = pkt.firstEvent();
-    unsigned lastBankID = pkt.curBankId();
-    // A counter that we use for logging purposes
-    unsigned eventsPerBank = 0;
-    while (event != nullptr) {
-      eventsPerBank++;
-      totalEvents++;
-      if (lastBankID < 0xFFFFFFFE) // Bank ID -1 & -2 are special cases and are
-                                   // not valid pixels
-      {
-        // appendEvent needs tof to be in units of microseconds, but it comes
-        // from the ADARA stream in units of 100ns.
-        if (pkt.getSourceCORFlag()) {
-          appendEvent(event->pixel, event->tof / 10.0, eventTime);
-        } else {
-          appendEvent(event->pixel,
-                      (event->tof + pkt.getSourceTOFOffset()) / 10.0,
-                      eventTime);
-        }
-      }
-
-      event = pkt.nextEvent();
-      if (pkt.curBankId() != lastBankID) {
-        g_log.debug() << "BankID " << lastBankID << " had " << eventsPerBank
-                      << " events\n";
-
-        lastBankID = pkt.curBankId();
-        eventsPerBank = 0;
-      }
+    for (const auto &staged : m_stagedEvents) {
+      m_eventBuffer->getSpectrum(staged.first).addEventQuickly(staged.second);
     }
   } // mutex automatically unlocks here
 
@@ -1359,6 +1366,24 @@ void SNSLiveEventDataListener::initWorkspacePart2() {
   m_indexMap = m_eventBuffer->getDetectorIDToWorkspaceIndexMap(
       true /* bool throwIfMultipleDets */);
 
+  // Pixel ids are normally close to contiguous, so copy the map into a flat
+  // table indexed by pixel id that is much quicker to search for every event.
+  // If the ids are too sparse, we stick with the map.
+  m_pixelIndexes.clear();
+  detid_t maxPixelId = -1;
+  for (const auto &entry : m_indexMap) {
+    maxPixelId = std::max(maxPixelId, entry.first);
+  }
+  if (maxPixelId >= 0 && static_cast<std::size_t>(maxPixelId) <
+                             MAX_PIXEL_TABLE_RATIO * m_indexMap.size()) {
+    m_pixelIndexes.assign(static_cast<std::size_t>(maxPixelId) + 1,
+                          INVALID_WORKSPACE_INDEX);
+    for (const auto &entry : m_indexMap) {
+      if (entry.first >= 0)
+        m_pixelIndexes[static_cast<std::size_t>(entry.first)] = entry.second;
+    }
+  }
+
   // We always want to have at least one value for the the scan index time
   // series.  We may have already gotten a scan start packet by the time we
   // get here and therefor don't need to do anything.  If not, we need to put
@@ -1416,24 +1441,27 @@ bool SNSLiveEventDataListener::haveRequiredLogs() {
   return allFound;
 }
 
-/// Adds an event to the workspace
-void SNSLiveEventDataListener::appendEvent(
-    const uint32_t pixelId, const double tof,
-    const Mantid::Types::Core::DateAndTime pulseTime)
-// NOTE: This function does NOT lock the mutex!  Make sure you do that
-// before calling this function!
-{
+/// Looks up the workspace index for a pixel id
+/// @param pixelId The pixel id from an ADARA event
+/// @param workspaceIndex Set to the workspace index of the pixel
+/// @return Returns false if the pixel isn't in the workspace
+bool SNSLiveEventDataListener::pixelToWorkspaceIndex(
+    const uint32_t pixelId, std::size_t &workspaceIndex) const {
+  if (!m_pixelIndexes.empty()) {
+    if (pixelId >= m_pixelIndexes.size() ||
+        m_pixelIndexes[pixelId] == INVALID_WORKSPACE_INDEX)
+      return false;
+    workspaceIndex = m_pixelIndexes[pixelId];
+    return true;
+  }
+
   // It'd be nice to use operator[], but we might end up inserting a value....
   // Have to use find() instead.
   const auto it = m_indexMap.find(pixelId);
-  if (it != m_indexMap.end()) {
-    const std::size_t workspaceIndex = it->second;
-    Types::Event::TofEvent event(tof, pulseTime);
-    m_eventBuffer->getSpectrum(workspaceIndex).addEventQuickly(event);
-  } else {
-    g_log.warning() << "Invalid pixel ID: " << pixelId << " (TofF: " << tof
-                    << " microseconds)\n";
-  }
+  if (it == m_indexMap.end())
+    return false;
+  workspaceIndex = it->second;
+  return true;
 }
 
 /// Retrieve buffered data
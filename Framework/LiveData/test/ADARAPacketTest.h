@@ -76,6 +76,44 @@ public:
     }
   }
 
+  void testBankedEventPacketBankSections() {
+    boost::shared_ptr<ADARA::BankedEventPkt> pkt =
+        basicPacketTests<ADARA::BankedEventPkt>(
+            bankedEventPacket, sizeof(bankedEventPacket), 728504567, 761741666);
+    if (pkt != nullptr) {
+      const auto sections = pkt->bankSections();
+      TS_ASSERT_EQUALS(sections.size(), 2);
+      if (sections.size() == 2) {
+        TS_ASSERT_EQUALS(sections[0].bankId, 0x02);
+        TS_ASSERT_EQUALS(sections[0].eventCount, 1);
+        TS_ASSERT_EQUALS(sections[0].events[0].tof, 0x00023BD9);
+        TS_ASSERT_EQUALS(sections[0].events[0].pixel, 0x043C);
+        TS_ASSERT_EQUALS(sections[1].bankId, 0x13);
+        TS_ASSERT_EQUALS(sections[1].eventCount, 1);
+      }
+
+      // The sections must hold exactly the events the iterator visits
+      size_t sectionIndex = 0;
+      uint32_t eventIndex = 0;
+      for (const ADARA::Event *event = pkt->firstEvent(); event != nullptr;
+           event = pkt->nextEvent()) {
+        TS_ASSERT(sectionIndex < sections.size());
+        if (sectionIndex >= sections.size())
+          break;
+        const auto &section = sections[sectionIndex];
+        TS_ASSERT_EQUALS(section.bankId, pkt->curBankId());
+        TS_ASSERT_EQUALS(section.isCorrected, pkt->getSourceCORFlag());
+        TS_ASSERT_EQUALS(section.tofOffset, pkt->getSourceTOFOffset());
+        TS_ASSERT_EQUALS(&section.events[eventIndex], event);
+        if (++eventIndex == section.eventCount) {
+          ++sectionIndex;
+          eventIndex = 0;
+        }
+      }
+      TS_ASSERT_EQUALS(sectionIndex, sections.size());
+    }
+  }
+
   void testBeamMonitorPacketParser() {
     boost::shared_ptr<ADARA::BeamMonitorPkt> pkt =
         basicPacketTests<ADARA::BeamMonitorPkt>(
@@ -138,6 +138,48 @@ public:
     }
   }
 
+  void test_Events_Decoded_On_Several_Threads_Are_Merged() {
+    using namespace ::testing;
+    using namespace KafkaTesting;
+    using Mantid::API::WorkspaceGroup;
+    using Mantid::API::Workspace_sptr;
+    using Mantid::DataObjects::EventWorkspace;
+    using namespace Mantid::LiveData;
+
+    auto mockBroker = std::make_shared<MockKafkaBroker>();
+    EXPECT_CALL(*mockBroker, subscribe_(_, _))
+        .Times(Exactly(3))
+        .WillOnce(Return(new FakeISISEventSubscriber(2)))
+        .WillOnce(Return(new FakeRunInfoStreamSubscriber(2)))
+        .WillOnce(Return(new FakeISISSpDetStreamSubscriber));
+    auto decoder = createTestDecoder(mockBroker);
+    TS_ASSERT_THROWS(decoder->setNumberOfDecodeThreads(0),
+                     const std::invalid_argument &);
+    decoder->setNumberOfDecodeThreads(3);
+    startCapturing(*decoder, 20);
+
+    Workspace_sptr workspace;
+    TS_ASSERT_THROWS_NOTHING(workspace = decoder->extractData());
+    TS_ASSERT_THROWS_NOTHING(decoder->stopCapture());
+    TS_ASSERT(!decoder->isCapturing());
+
+    auto group = boost::dynamic_pointer_cast<WorkspaceGroup>(workspace);
+    TS_ASSERT(group);
+    TS_ASSERT_EQUALS(2, group->size());
+    for (size_t i = 0; i < 2; ++i) {
+      auto eventWksp =
+          boost::dynamic_pointer_cast<EventWorkspace>(group->getItem(i));
+      TS_ASSERT(eventWksp);
+      checkWorkspaceEventData(*eventWksp);
+      // Every message adds one proton charge value and 6 events, so the two
+      // must have been merged from the decode threads together
+      auto protonCharge =
+          eventWksp->run().getTimeSeriesProperty<double>("proton_charge");
+      TS_ASSERT_EQUALS(eventWksp->getNumberEvents(),
+                       6 * static_cast<size_t>(protonCharge->size()));
+    }
+  }
+
   void test_Varying_Period_Event_Stream() {
     /**
      * Test that period number is correctly updated between runs
@@ -0,0 +1,263 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_LIVEDATA_KAFKASTREAMRECORDINGTEST_H_
+#define MANTID_LIVEDATA_KAFKASTREAMRECORDINGTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "KafkaTesting.h"
+#include "MantidDataObjects/EventWorkspace.h"
+#include "MantidKernel/ConfigService.h"
+#include "MantidKernel/Memory.h"
+#include "MantidKernel/make_unique.h"
+#include "MantidLiveData/Kafka/KafkaEventStreamDecoder.h"
+#include "MantidLiveData/Kafka/KafkaStreamRecording.h"
+
+#include <Poco/File.h>
+#include <Poco/Path.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+const std::string RECORDING_NAME = "KafkaStreamRecordingTest.rec";
+
+std::string recordingPath() {
+  return Poco::Path(Poco::Path::temp(), RECORDING_NAME).toString();
+}
+
+void removeRecording() {
+  Poco::File file(recordingPath());
+  if (file.exists())
+    file.remove();
+}
+
+void useTestFacilities() {
+  using Mantid::Kernel::ConfigService;
+  auto &config = ConfigService::Instance();
+  auto baseInstDir = config.getInstrumentDirectory();
+  Poco::Path testFile =
+      Poco::Path(baseInstDir).resolve("unit_testing/UnitTestFacilities.xml");
+  config.updateFacilities(testFile.toString());
+  config.setFacility("TEST");
+  config.setString("instrumentDefinition.directory",
+                   baseInstDir + "/unit_testing");
+}
+
+void restoreFacilities() {
+  using Mantid::Kernel::ConfigService;
+  auto &config = ConfigService::Instance();
+  config.reset();
+  config.updateFacilities();
+}
+
+/// Broker handing out the fake ISIS event, run info and spectra-detector
+/// streams in the order KafkaEventStreamDecoder subscribes to them
+std::shared_ptr<KafkaTesting::MockKafkaBroker> createISISBroker() {
+  using namespace ::testing;
+  using namespace KafkaTesting;
+  auto broker = std::make_shared<MockKafkaBroker>();
+  EXPECT_CALL(*broker, subscribe_(_, _))
+      .Times(Exactly(3))
+      .WillOnce(Return(new FakeISISEventSubscriber(1)))
+      .WillOnce(Return(new FakeRunInfoStreamSubscriber(1)))
+      .WillOnce(Return(new FakeISISSpDetStreamSubscriber));
+  return broker;
+}
+
+size_t
+extractNumberOfEvents(Mantid::LiveData::KafkaEventStreamDecoder &decoder) {
+  auto workspace =
+      boost::dynamic_pointer_cast<Mantid::DataObjects::EventWorkspace>(
+          decoder.extractData());
+  return workspace ? workspace->getNumberEvents() : 0;
+}
+
+/** Run a decoder against the fake ISIS streams through a recording broker
+ * until at least the given number of messages have been consumed.
+ * @return the total number of events decoded
+ */
+size_t recordISISStream(int iterations) {
+  using namespace Mantid::LiveData;
+  auto broker = std::make_shared<KafkaRecordingBroker>(createISISBroker(),
+                                                       recordingPath());
+  std::atomic<int> count{0};
+  KafkaEventStreamDecoder decoder(broker, "", "", "", "");
+  decoder.registerIterationEndCb([&count]() { ++count; });
+  decoder.startCapture();
+  while (count < iterations)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  // Extract after stopping too so every recorded message is counted
+  size_t nevents = extractNumberOfEvents(decoder);
+  decoder.stopCapture();
+  nevents += extractNumberOfEvents(decoder);
+  return nevents;
+}
+} // namespace
+
+class KafkaStreamRecordingTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static KafkaStreamRecordingTest *createSuite() {
+    return new KafkaStreamRecordingTest();
+  }
+  static void destroySuite(KafkaStreamRecordingTest *suite) { delete suite; }
+
+  void setUp() override { useTestFacilities(); }
+
+  void tearDown() override {
+    removeRecording();
+    restoreFacilities();
+  }
+
+  void test_Replay_Returns_Recorded_Messages_And_Offsets() {
+    using namespace ::testing;
+    using namespace KafkaTesting;
+    using namespace Mantid::LiveData;
+
+    const std::vector<std::string> topics{"events"};
+    std::vector<std::string> recorded;
+    {
+      auto mockBroker = std::make_shared<MockKafkaBroker>();
+      EXPECT_CALL(*mockBroker, subscribe_(_, _))
+          .Times(Exactly(1))
+          .WillOnce(Return(new FakeISISEventSubscriber(2)));
+      KafkaRecordingBroker broker(mockBroker, recordingPath());
+      auto subscriber = broker.subscribe(topics, SubscribeAtOption::LATEST);
+      subscriber->subscribe();
+      TS_ASSERT_EQUALS(1, subscriber->getOffsetsForTimestamp(0).size());
+      for (int i = 0; i < 3; ++i) {
+        std::string message, topic;
+        int64_t offset(0);
+        int32_t partition(0);
+        subscriber->consumeMessage(&message, offset, partition, topic);
+        recorded.push_back(message);
+      }
+    }
+
+    KafkaReplayBroker replay(recordingPath(), 0.0);
+    auto subscriber = replay.subscribe(topics, SubscribeAtOption::LATEST);
+    const auto offsets = subscriber->getOffsetsForTimestamp(0);
+    TS_ASSERT_EQUALS(std::vector<int64_t>({1, 2, 3}),
+                     offsets.at("topic_name"));
+    for (const auto &expected : recorded) {
+      std::string message, topic;
+      int64_t offset(0);
+      int32_t partition(0);
+      subscriber->consumeMessage(&message, offset, partition, topic);
+      TS_ASSERT_EQUALS(expected, message);
+    }
+    // The recording has only one subscription to these topics
+    TS_ASSERT_THROWS(replay.subscribe(topics, SubscribeAtOption::LATEST),
+                     const std::runtime_error &);
+  }
+
+  void test_Decoder_Gives_Same_Events_From_Replay() {
+    using namespace Mantid::LiveData;
+    const size_t recordedEvents = recordISISStream(5);
+    TS_ASSERT(recordedEvents > 0);
+
+    KafkaEventStreamDecoder decoder(
+        std::make_shared<KafkaReplayBroker>(recordingPath(), 0.0), "", "", "",
+        "");
+    decoder.startCapture();
+    size_t replayedEvents(0);
+    const auto giveUp =
+        std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (replayedEvents < recordedEvents &&
+           std::chrono::steady_clock::now() < giveUp) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (decoder.hasData())
+        replayedEvents += extractNumberOfEvents(decoder);
+    }
+    decoder.stopCapture();
+    TS_ASSERT_EQUALS(recordedEvents, replayedEvents);
+  }
+
+  void test_Replay_Of_File_That_Is_Not_A_Recording_Throws() {
+    using Mantid::LiveData::KafkaReplayBroker;
+    TS_ASSERT_THROWS(KafkaReplayBroker("not_a_recording.rec"),
+                     const std::runtime_error &);
+  }
+
+  void test_Negative_Replay_Speed_Throws() {
+    using Mantid::LiveData::KafkaReplayBroker;
+    recordISISStream(1);
+    TS_ASSERT_THROWS(KafkaReplayBroker(recordingPath(), -1.0),
+                     const std::invalid_argument &);
+  }
+};
+
+/**
+  Replays a recorded stream through KafkaEventStreamDecoder as fast as it can
+  be decoded and reports the event rate, the longest extractData() call and
+  the growth in memory use.
+*/
+class KafkaStreamRecordingTestPerformance : public CxxTest::TestSuite {
+public:
+  static KafkaStreamRecordingTestPerformance *createSuite() {
+    return new KafkaStreamRecordingTestPerformance();
+  }
+  static void destroySuite(KafkaStreamRecordingTestPerformance *suite) {
+    delete suite;
+  }
+
+  void setUp() override {
+    useTestFacilities();
+    m_recordedEvents = recordISISStream(2000);
+  }
+
+  void tearDown() override {
+    removeRecording();
+    restoreFacilities();
+  }
+
+  void test_Replay_At_Maximum_Rate() {
+    using namespace Mantid::LiveData;
+    using Clock = std::chrono::steady_clock;
+    Mantid::Kernel::MemoryStats memory;
+    const auto memoryBefore = memory.residentMem();
+
+    KafkaEventStreamDecoder decoder(
+        std::make_shared<KafkaReplayBroker>(recordingPath(), 0.0), "", "", "",
+        "");
+    const auto start = Clock::now();
+    decoder.startCapture();
+    size_t replayedEvents(0);
+    double maxExtractSeconds(0.0);
+    while (replayedEvents < m_recordedEvents &&
+           Clock::now() - start < std::chrono::minutes(5)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      if (!decoder.hasData())
+        continue;
+      const auto extractStart = Clock::now();
+      replayedEvents += extractNumberOfEvents(decoder);
+      maxExtractSeconds = std::max(
+          maxExtractSeconds,
+          std::chrono::duration<double>(Clock::now() - extractStart).count());
+    }
+    const double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    decoder.stopCapture();
+    memory.update();
+
+    TS_ASSERT_EQUALS(m_recordedEvents, replayedEvents);
+    std::cout << "\nReplayed " << replayedEvents << " events at "
+              << static_cast<double>(replayedEvents) / seconds
+              << " events/s. Longest extractData(): " << maxExtractSeconds
+              << " s. Resident memory growth: "
+              << static_cast<int64_t>(memory.residentMem()) -
+                     static_cast<int64_t>(memoryBefore)
+              << " kB\n";
+  }
+
+private:
+  size_t m_recordedEvents{0};
+};
+
+#endif /* MANTID_LIVEDATA_KAFKASTREAMRECORDINGTEST_H_ */
@@ -59,7 +59,7 @@ public:
          std::string PostProcessingAlgorithm = "",
          std::string PostProcessingProperties = "", bool PreserveEvents = true,
          ILiveListener_sptr listener = ILiveListener_sptr(),
-         bool makeThrow = false) {
+         bool makeThrow = false, bool IncrementalPostProcessing = false) {
     FacilityHelper::ScopedFacilities loadTESTFacility(
         "unit_testing/UnitTestFacilities.xml", "TEST");
 
@@ -79,6 +79,8 @@ public:
     TS_ASSERT_THROWS_NOTHING(alg.setPropertyValue("PostProcessingProperties",
                                                   PostProcessingProperties));
     TS_ASSERT_THROWS_NOTHING(alg.setProperty("PreserveEvents", PreserveEvents));
+    TS_ASSERT_THROWS_NOTHING(alg.setProperty("IncrementalPostProcessing",
+                                             IncrementalPostProcessing));
     if (!PostProcessingAlgorithm.empty())
       TS_ASSERT_THROWS_NOTHING(
           alg.setPropertyValue("AccumulationWorkspace", "fake_accum"));
@@ -305,6 +307,34 @@ public:
     TS_ASSERT_EQUALS(AnalysisDataService::Instance().size(), 2);
   }
 
+  //--------------------------------------------------------------------------------------------
+  /** Post-process only the new chunks and add them to the output */
+  void test_Add_with_IncrementalPostProcessing() {
+    Workspace2D_sptr ws1, ws2;
+    const std::string rebin = "Params=40e3, 1e3, 60e3;PreserveEvents=0";
+    // First go post-processes the whole accumulation workspace
+    ws1 = doExec<Workspace2D>("Add", "", "", "Rebin", rebin, true,
+                              ILiveListener_sptr(), false, true);
+    TS_ASSERT_EQUALS(ws1->getNumberHistograms(), 2);
+    TS_ASSERT_EQUALS(ws1->blocksize(), 20);
+    const auto &y1 = ws1->y(0);
+    TS_ASSERT_DELTA(std::accumulate(y1.begin(), y1.end(), 0.0), 100.0, 1e-4);
+
+    // Next one only post-processes the chunk and adds it to the output
+    ws2 = doExec<Workspace2D>("Add", "", "", "Rebin", rebin, true,
+                              ILiveListener_sptr(), false, true);
+    TSM_ASSERT("Output being added to stayed the same pointer", ws1 == ws2);
+    TS_ASSERT_EQUALS(ws2->blocksize(), 20);
+    const auto &y2 = ws2->y(0);
+    TS_ASSERT_DELTA(std::accumulate(y2.begin(), y2.end(), 0.0), 200.0, 1e-4);
+
+    EventWorkspace_sptr ws_accum =
+        AnalysisDataService::Instance().retrieveWS<EventWorkspace>(
+            "fake_accum");
+    TS_ASSERT_EQUALS(ws_accum->getNumberEvents(), 400);
+    TS_ASSERT_EQUALS(AnalysisDataService::Instance().size(), 2);
+  }
+
   //--------------------------------------------------------------------------------------------
   /** Do some processing that converts to a different type of workspace */
   void test_ProcessToMDWorkspace_and_Add() {
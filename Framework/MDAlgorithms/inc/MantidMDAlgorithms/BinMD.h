@@ -75,7 +75,12 @@ private:
   /// Method to bin a single MDBox
   template <typename MDE, size_t nd>
   void binMDBox(DataObjects::MDBox<MDE, nd> *box, const size_t *const chunkMin,
-                const size_t *const chunkMax);
+                const size_t *const chunkMax, std::vector<coord_t> &inBuffer,
+                std::vector<coord_t> &outBuffer);
+
+  /// Linear index of the output bin containing a transformed point
+  bool getLinearIndex(const coord_t *outCenter, const size_t *const chunkMin,
+                      const size_t *const chunkMax, size_t &linearIndex) const;
 
   /// The output MDHistoWorkspace
   Mantid::DataObjects::MDHistoWorkspace_sptr outWS;
@@ -14,6 +14,7 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <mutex>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -46,14 +47,24 @@ struct IntegrationParameters {
     determined from the standard deviations in the directions of the
     principal axes.
 
+    Events are assigned to the peak at their nearest h,k,l. Satellite peaks
+    sharing the nearest integer h,k,l of a main peak are kept apart and each
+    event goes to the closest of them. Events can be sorted by several
+    threads at once into their own lists, which are then merged in, and the
+    peaks can be integrated in parallel.
+
     @author Dennis Mikkelson
     @date   2012-12-19
  */
 
+/// Lists of events near each peak, keyed by the index of the peak
 using EventListMap =
     std::unordered_map<int64_t,
                        std::vector<std::pair<double, Mantid::Kernel::V3D>>>;
-using PeakQMap = std::unordered_map<int64_t, Mantid::Kernel::V3D>;
+/// Index and Q-vector of the peaks nearest to each integer h,k,l
+using PeakQMap =
+    std::unordered_map<int64_t,
+                       std::vector<std::pair<int64_t, Mantid::Kernel::V3D>>>;
 
 class DLLExport Integrate3DEvents {
 public:
@@ -68,6 +79,14 @@ public:
   addEvents(std::vector<std::pair<double, Mantid::Kernel::V3D>> const &event_qs,
             bool hkl_integ);
 
+  /// Add event Q's to separate lists of events near peaks, e.g. per thread
+  void
+  addEvents(std::vector<std::pair<double, Mantid::Kernel::V3D>> const &event_qs,
+            bool hkl_integ, EventListMap &event_lists) const;
+
+  /// Move separate lists of events near peaks into the integrator
+  void addEventLists(EventListMap &event_lists);
+
   /// Find the net integrated intensity of a peak, using ellipsoidal volumes
   boost::shared_ptr<const Mantid::Geometry::PeakShape> ellipseIntegrateEvents(
       std::vector<Kernel::V3D> E1Vec, Mantid::Kernel::V3D const &peak_q,
@@ -92,9 +111,25 @@ public:
                                     const Mantid::Kernel::V3D &center);
 
 private:
+  /// Principal axes of the events near a peak
+  struct PrincipalAxes {
+    std::vector<Mantid::Kernel::V3D> directions;
+    std::vector<double> sigmas;
+  };
+
   /// Get a list of events for a given Q
   const std::vector<std::pair<double, Mantid::Kernel::V3D>> *
-  getEvents(const Mantid::Kernel::V3D &peak_q);
+  getEvents(const Mantid::Kernel::V3D &peak_q) const;
+
+  /// Get the index of the peak at a given Q and its list of events
+  const std::vector<std::pair<double, Mantid::Kernel::V3D>> *
+  findEventList(const Mantid::Kernel::V3D &peak_q, int64_t &peak_index) const;
+
+  /// Get the principal axes of the events of a peak, reusing earlier results
+  PrincipalAxes getPrincipalAxes(
+      int64_t peak_index,
+      std::vector<std::pair<double, Mantid::Kernel::V3D>> const &events,
+      double radius) const;
 
   bool correctForDetectorEdges(std::tuple<double, double, double> &radii,
                                const std::vector<Mantid::Kernel::V3D> &E1Vecs,
@@ -134,11 +169,12 @@ private:
   static int64_t getHklKey(int h, int k, int l);
 
   /// Form a map key for the specified q_vector.
-  int64_t getHklKey(Mantid::Kernel::V3D const &q_vector);
-  int64_t getHklKey2(Mantid::Kernel::V3D const &hkl);
+  int64_t getHklKey(Mantid::Kernel::V3D const &q_vector) const;
+  int64_t getHklKey2(Mantid::Kernel::V3D const &hkl) const;
 
   /// Add an event to the vector of events for the closest h,k,l
-  void addEvent(std::pair<double, Mantid::Kernel::V3D> event_Q, bool hkl_integ);
+  void addEvent(std::pair<double, Mantid::Kernel::V3D> event_Q, bool hkl_integ,
+                EventListMap &event_lists) const;
 
   /// Find the net integrated intensity of a list of Q's using ellipsoids
   boost::shared_ptr<const Mantid::DataObjects::PeakShapeEllipsoid>
@@ -163,6 +199,9 @@ private:
 
   PeakQMap m_peak_qs;         // hashtable with peak Q-vectors
   EventListMap m_event_lists; // hashtable with lists of events for each peak
+  // principal axes of the events of each peak within m_radius
+  mutable std::unordered_map<int64_t, PrincipalAxes> m_principal_axes;
+  mutable std::mutex m_principal_axes_mutex;
   Kernel::DblMatrix m_UBinv;  // matrix mapping from Q to h,k,l
   double m_radius;            // size of sphere to use for events around a peak
   const bool m_useOnePercentBackgroundCorrection =
@@ -12,7 +12,13 @@
 #include "MantidMDAlgorithms/DllConfig.h"
 #include "MantidMDAlgorithms/SlicingAlgorithm.h"
 
+#include <atomic>
+#include <memory>
+
 namespace Mantid {
+namespace API {
+class SpectrumInfo;
+}
 namespace MDAlgorithms {
 
 /** MDNormalization : Bin single crystal diffraction or direct geometry
@@ -30,6 +36,14 @@ public:
             "RecalculateTrajectoriesExtents"};
   }
 
+  /// Number of cached trajectory sets and how often the cache was used
+  struct TrajectoryCacheStatistics {
+    size_t entries;
+    size_t hits;
+  };
+  static TrajectoryCacheStatistics trajectoryCacheStatistics();
+  static void clearTrajectoryCache();
+
 private:
   void init() override;
   void exec() override;
@@ -45,7 +59,25 @@ private:
   void cacheDimensionXValues();
   void calculateNormalization(const std::vector<coord_t> &otherValues,
                               Geometry::SymmetryOperation so,
-                              uint16_t expInfoIndex, size_t soIndex);
+                              uint16_t expInfoIndex, size_t soIndex,
+                              std::vector<std::atomic<signal_t>> &signalArray);
+  /// Path of one detector's trajectory through the normalization workspace
+  struct DetectorTrajectory {
+    /// Momenta at the intersections with the bin boundaries, in order
+    std::vector<double> momenta;
+    /// Linear index of the bin between each pair of consecutive
+    /// intersections, or size_t(-1) where that segment adds nothing
+    std::vector<size_t> bins;
+  };
+  using Trajectories = std::vector<DetectorTrajectory>;
+  class TrajectoryCache;
+  static TrajectoryCache &trajectoryCache();
+  std::shared_ptr<const Trajectories>
+  getTrajectories(const std::vector<coord_t> &otherValues,
+                  const Kernel::DblMatrix &Qtransform,
+                  const std::vector<double> &lowValues,
+                  const std::vector<double> &highValues,
+                  const API::SpectrumInfo &spectrumInfo);
   void calculateIntersections(std::vector<std::array<double, 4>> &intersections,
                               const double theta, const double phi,
                               Kernel::DblMatrix transform, double lowvalue,
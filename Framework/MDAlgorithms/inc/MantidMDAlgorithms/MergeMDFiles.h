@@ -60,7 +60,26 @@ private:
 
   void finalizeOutput(const std::string &outputFile);
 
-  uint64_t loadEventsFromSubBoxes(API::IMDNode *TargetBox);
+  /// Events of a range of target boxes read from all the input files
+  struct InputEvents {
+    /// range of the target boxes [firstBox, lastBox)
+    size_t firstBox{0};
+    size_t lastBox{0};
+    /// the events read from each input file
+    std::vector<std::vector<coord_t>> data;
+    /// the row of data where the events of each box start, for each file
+    std::vector<std::vector<uint64_t>> firstRow;
+  };
+
+  size_t findBlockEnd(size_t firstBox);
+
+  InputEvents readInputEvents(size_t firstBox, size_t lastBox);
+
+  std::vector<std::vector<coord_t>> mergeEvents(const InputEvents &input,
+                                                bool parallel);
+
+  void writeEvents(API::IBoxControllerIO &saver, size_t firstBox,
+                   const std::vector<std::vector<coord_t>> &tables);
 
   // the class which flatten the box structure and deal with it
   DataObjects::MDBoxFlatTree m_BoxStruct;
@@ -85,6 +104,9 @@ protected:
   /// Vector of file handles to each input file //TODO unique?
   std::vector<API::IBoxControllerIO *> m_EventLoader;
 
+  /// number of values stored for each event in the files
+  size_t m_nEventColumns;
+
   /// Output IMDEventWorkspace
   Mantid::API::IMDEventWorkspace_sptr m_OutIWS;
 
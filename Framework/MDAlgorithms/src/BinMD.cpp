@@ -23,6 +23,10 @@
 #include "MantidKernel/Utils.h"
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace Mantid {
 namespace MDAlgorithms {
 
@@ -34,6 +38,11 @@ using namespace Mantid::API;
 using namespace Mantid::Geometry;
 using namespace Mantid::DataObjects;
 
+namespace {
+/// Number of events transformed together in one call to the transform
+constexpr size_t EVENT_BATCH_SIZE = 512;
+} // namespace
+
 //----------------------------------------------------------------------------------------------
 /** Constructor
  */
@@ -71,10 +80,10 @@ void BinMD::init() {
   setPropertyGroup("IterateEvents", grp);
 
   declareProperty(
-      make_unique<PropertyWithValue<bool>>("Parallel", false, Direction::Input),
-      "Temporary parameter: true to run in parallel. This is ignored for "
-      "file-backed workspaces, where running in parallel makes things slower "
-      "due to disk thrashing.");
+      make_unique<PropertyWithValue<bool>>("Parallel", true, Direction::Input),
+      "True to bin using all available threads. The result is the same "
+      "either way. This is ignored for file-backed workspaces, where running "
+      "in parallel makes things slower due to disk thrashing.");
   setPropertyGroup("Parallel", grp);
 
   declareProperty(make_unique<WorkspaceProperty<IMDHistoWorkspace>>(
@@ -89,6 +98,34 @@ void BinMD::init() {
                   "A name for the output MDHistoWorkspace.");
 }
 
+//----------------------------------------------------------------------------------------------
+/** Find the linear index of the output bin containing a transformed point
+ *
+ * @param outCenter :: the point in the coordinates of the output workspace
+ * @param chunkMin :: the minimum index in each dimension to consider "valid"
+ *(inclusive)
+ * @param chunkMax :: the maximum index in each dimension to consider "valid"
+ *(exclusive)
+ * @param linearIndex :: set to the linear index of the bin
+ * @return false if the point is outside the chunk
+ */
+inline bool BinMD::getLinearIndex(const coord_t *outCenter,
+                                  const size_t *const chunkMin,
+                                  const size_t *const chunkMax,
+                                  size_t &linearIndex) const {
+  linearIndex = 0;
+  for (size_t bd = 0; bd < m_outD; bd++) {
+    // What is the bin index in that dimension
+    coord_t x = outCenter[bd];
+    size_t ix = size_t(x);
+    // Within range (for this chunk)?
+    if ((x < 0) || (ix < chunkMin[bd]) || (ix >= chunkMax[bd]))
+      return false;
+    linearIndex += indexMultiplier[bd] * ix;
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------------------------
 /** Bin the contents of a MDBox
  *
@@ -97,12 +134,17 @@ void BinMD::init() {
  *(inclusive)
  * @param chunkMax :: the maximum index in each dimension to consider "valid"
  *(exclusive)
+ * @param inBuffer :: scratch space for a batch of event centres, reused
+ *between calls by the same thread
+ * @param outBuffer :: scratch space for the transformed batch
  */
 template <typename MDE, size_t nd>
 inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
-                            const size_t *const chunkMax) {
-  // An array to hold the rotated/transformed coordinates
-  auto outCenter = new coord_t[m_outD];
+                            const size_t *const chunkMax,
+                            std::vector<coord_t> &inBuffer,
+                            std::vector<coord_t> &outBuffer) {
+  inBuffer.resize(EVENT_BATCH_SIZE * nd);
+  outBuffer.resize(EVENT_BATCH_SIZE * m_outD);
 
   // Evaluate whether the entire box is in the same bin
   if (box->getNPoints() > (1 << nd) * 2) {
@@ -110,60 +152,22 @@ inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
     // to do all this processing.
     size_t numVertexes = 0;
     auto vertexes = box->getVertexesArray(numVertexes);
+    outBuffer.resize(std::max(outBuffer.size(), numVertexes * m_outD));
+    m_transform->applyBatch(vertexes.get(), outBuffer.data(), numVertexes);
 
     // All vertexes have to be within THE SAME BIN = have the same linear index.
     size_t lastLinearIndex = 0;
-    bool badOne = false;
-
-    for (size_t i = 0; i < numVertexes; i++) {
-      // Cache the center of the event (again for speed)
-      const coord_t *inCenter = vertexes.get() + i * nd;
-
-      // Now transform to the output dimensions
-      m_transform->apply(inCenter, outCenter);
-      // std::cout << "Input coord " << VMD(nd,inCenter) << " transformed to "
-      // <<  VMD(nd,outCenter) << '\n';
-
-      // To build up the linear index
+    bool sameBin = true;
+    for (size_t i = 0; i < numVertexes && sameBin; i++) {
       size_t linearIndex = 0;
-      // To mark VERTEXES outside range
-      badOne = false;
-
-      /// Loop through the dimensions on which we bin
-      for (size_t bd = 0; bd < m_outD; bd++) {
-        // What is the bin index in that dimension
-        coord_t x = outCenter[bd];
-        size_t ix = size_t(x);
-        // Within range (for this chunk)?
-        if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
-          // Build up the linear index
-          linearIndex += indexMultiplier[bd] * ix;
-        } else {
-          // Outside the range
-          badOne = true;
-          break;
-        }
-      } // (for each dim in MDHisto)
-
-      // Is the vertex at the same place as the last one?
-      if (!badOne) {
-        if ((i > 0) && (linearIndex != lastLinearIndex)) {
-          // Change of index
-          badOne = true;
-          break;
-        }
-        lastLinearIndex = linearIndex;
-      }
-
-      // Was the vertex completely outside the range?
-      if (badOne)
-        break;
-    } // (for each vertex)
+      sameBin = getLinearIndex(outBuffer.data() + i * m_outD, chunkMin,
+                               chunkMax, linearIndex) &&
+                (i == 0 || linearIndex == lastLinearIndex);
+      lastLinearIndex = linearIndex;
+    }
 
-    if (!badOne) {
+    if (sameBin) {
       // Yes, the entire box is within a single bin
-      //        std::cout << "Box at " << box->getExtentsStr() << " is within a
-      //        single bin.\n";
       // Add the CACHED signal from the entire box
       signals[lastLinearIndex] += box->getSignal();
       errors[lastLinearIndex] += box->getErrorSquared();
@@ -173,72 +177,58 @@ inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
 
       // And don't bother looking at each event. This may save lots of time
       // loading from disk.
-      delete[] outCenter;
       return;
     }
   }
 
   // If you get here, you could not determine that the entire box was in the
   // same bin.
-  // So you need to iterate through events.
+  // So you need to iterate through events, transforming them in batches.
   const std::vector<MDE> &events = box->getConstEvents();
-  for (auto it = events.begin(); it != events.end(); ++it) {
-    // Cache the center of the event (again for speed)
-    const coord_t *inCenter = it->getCenter();
-
+  for (size_t first = 0; first < events.size(); first += EVENT_BATCH_SIZE) {
+    const size_t batchSize = std::min(EVENT_BATCH_SIZE, events.size() - first);
+    // Gather the centres of the events into one contiguous block
+    for (size_t i = 0; i < batchSize; ++i) {
+      const coord_t *inCenter = events[first + i].getCenter();
+      std::copy(inCenter, inCenter + nd, inBuffer.data() + i * nd);
+    }
     // Now transform to the output dimensions
-    m_transform->apply(inCenter, outCenter);
-
-    // To build up the linear index
-    size_t linearIndex = 0;
-    // To mark events outside range
-    bool badOne = false;
-
-    /// Loop through the dimensions on which we bin
-    for (size_t bd = 0; bd < m_outD; bd++) {
-      // What is the bin index in that dimension
-      coord_t x = outCenter[bd];
-      size_t ix = size_t(x);
-      // Within range (for this chunk)?
-      if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
-        // Build up the linear index
-        linearIndex += indexMultiplier[bd] * ix;
-      } else {
-        // Outside the range
-        badOne = true;
-        break;
-      }
-    } // (for each dim in MDHisto)
+    m_transform->applyBatch(inBuffer.data(), outBuffer.data(), batchSize);
 
-    if (!badOne) {
-      // Sum the signals as doubles to preserve precision
-      signals[linearIndex] += static_cast<signal_t>(it->getSignal());
-      errors[linearIndex] += static_cast<signal_t>(it->getErrorSquared());
-      // TODO: If DataObjects get a weight, this would need to get the summed
-      // weight.
-      numEvents[linearIndex] += 1.0;
+    for (size_t i = 0; i < batchSize; ++i) {
+      size_t linearIndex = 0;
+      if (getLinearIndex(outBuffer.data() + i * m_outD, chunkMin, chunkMax,
+                         linearIndex)) {
+        const MDE &event = events[first + i];
+        // Sum the signals as doubles to preserve precision
+        signals[linearIndex] += static_cast<signal_t>(event.getSignal());
+        errors[linearIndex] += static_cast<signal_t>(event.getErrorSquared());
+        // TODO: If DataObjects get a weight, this would need to get the summed
+        // weight.
+        numEvents[linearIndex] += 1.0;
+      }
     }
   }
   // Done with the events list
   box->releaseEvents();
-
-  delete[] outCenter;
 }
 
 //----------------------------------------------------------------------------------------------
 /** Perform binning by iterating through every event and placing them in the
  *output workspace
  *
+ * The output is split into slabs along the output dimension with the most
+ * bins. Each slab is binned by one thread at a time, so threads never write
+ * to the same bins and the result does not depend on the number of threads.
+ * The slabs a box can contribute to are found once, from the positions of
+ * its vertexes in the output, so boxes are never visited for slabs they
+ * cannot reach.
+ *
  * @param ws :: MDEventWorkspace of the given type.
  */
 template <typename MDE, size_t nd>
 void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   BoxController_sptr bc = ws->getBoxController();
-  // store exisiting write buffer size for the future
-  // uint64_t writeBufSize =bc->getDiskBuffer().getWriteBufferSize();
-  // and disable write buffer (if any) for input MD Events for this algorithm
-  // purposes;
-  // bc->setCacheParameters(1,0);
 
   // Cache some data to speed up accessing them a bit
   indexMultiplier = new size_t[m_outD];
@@ -258,109 +248,138 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   }
 
   // The dimension (in the output workspace) along which we chunk for parallel
-  // processing
-  // TODO: Find the smartest dimension to chunk against
+  // processing: the one with the most bins gives the finest split
   size_t chunkDimension = 0;
-
-  // How many bins (in that dimension) per chunk.
-  // Try to split it so each core will get 2 tasks:
-  int chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins() /
-                         (PARALLEL_GET_MAX_THREADS * 2));
-  if (chunkNumBins < 1)
-    chunkNumBins = 1;
+  for (size_t bd = 1; bd < m_outD; bd++)
+    if (m_binDimensions[bd]->getNBins() >
+        m_binDimensions[chunkDimension]->getNBins())
+      chunkDimension = bd;
+  const size_t numChunkBins = m_binDimensions[chunkDimension]->getNBins();
 
   // Do we actually do it in parallel?
   bool doParallel = getProperty("Parallel");
   // Not if file-backed!
   if (bc->isFileBacked())
     doParallel = false;
-  if (!doParallel)
-    chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins());
 
-  // Total number of steps
+  // How many bins (in that dimension) per chunk. Several chunks per core let
+  // the dynamic schedule even out chunks with more events in them.
+  size_t chunkNumBins = numChunkBins;
+  if (doParallel)
+    chunkNumBins = std::max(
+        numChunkBins / (static_cast<size_t>(PARALLEL_GET_MAX_THREADS) * 4),
+        size_t(1));
+  const size_t numChunks = (numChunkBins + chunkNumBins - 1) / chunkNumBins;
+
+  // Use getBoxes() to get an array with a pointer to each box touching the
+  // output. Leaf-only; no depth limit; with the implicit function passed to it.
+  std::vector<size_t> fullMin(m_outD, 0);
+  std::vector<size_t> fullMax(m_outD);
+  for (size_t bd = 0; bd < m_outD; bd++)
+    fullMax[bd] = m_binDimensions[bd]->getNBins();
+  std::unique_ptr<MDImplicitFunction> function(
+      this->getImplicitFunctionForChunk(fullMin.data(), fullMax.data()));
+  std::vector<API::IMDNode *> boxes;
+  ws->getBox()->getBoxes(boxes, 1000, true, function.get());
+
+  // Sort boxes by file position IF file backed. This reduces seeking time,
+  // hopefully.
+  if (bc->isFileBacked())
+    API::IMDNode::sortObjByID(boxes);
+
+  // The range of chunks each box reaches. The transform is affine, so the
+  // extent of a box in the output is bounded by its transformed vertexes.
+  std::vector<std::pair<size_t, size_t>> chunkRanges(boxes.size(),
+                                                     {0, numChunks});
+  if (numChunks > 1) {
+    PRAGMA_OMP(parallel for schedule(static) if (doParallel))
+    for (int64_t i = 0; i < static_cast<int64_t>(boxes.size()); ++i) {
+      size_t numVertexes = 0;
+      auto vertexes = boxes[i]->getVertexesArray(numVertexes);
+      std::vector<coord_t> outVertexes(numVertexes * m_outD);
+      m_transform->applyBatch(vertexes.get(), outVertexes.data(), numVertexes);
+      double xMin = std::numeric_limits<double>::max();
+      double xMax = std::numeric_limits<double>::lowest();
+      for (size_t v = 0; v < numVertexes; ++v) {
+        const double x = outVertexes[v * m_outD + chunkDimension];
+        xMin = std::min(xMin, x);
+        xMax = std::max(xMax, x);
+      }
+      // Allow for events on a face of the box rounding differently
+      const double pad = 1e-2 + 1e-5 * std::max(std::abs(xMin), std::abs(xMax));
+      xMin -= pad;
+      xMax += pad;
+      if (xMax < 0 || xMin >= static_cast<double>(numChunkBins)) {
+        chunkRanges[i] = {0, 0};
+        continue;
+      }
+      const size_t binMin = xMin < 0 ? 0 : size_t(xMin);
+      const size_t binMax = xMax >= static_cast<double>(numChunkBins)
+                                ? numChunkBins - 1
+                                : size_t(xMax);
+      chunkRanges[i] = {binMin / chunkNumBins, binMax / chunkNumBins + 1};
+    }
+  }
+
+  // The boxes to bin for each chunk
+  std::vector<std::vector<MDBox<MDE, nd> *>> chunkBoxes(numChunks);
   size_t progNumSteps = 0;
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    auto box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+    if (!box || box->getIsMasked())
+      continue;
+    for (size_t chunk = chunkRanges[i].first; chunk < chunkRanges[i].second;
+         ++chunk)
+      chunkBoxes[chunk].push_back(box);
+    progNumSteps += chunkRanges[i].second - chunkRanges[i].first;
+  }
+  g_log.debug() << "Binning " << boxes.size() << " boxes in " << numChunks
+                << " chunks of dimension " << chunkDimension << ".\n";
   if (prog) {
     prog->setNotifyStep(0.1);
-    prog->resetNumSteps(100, 0.00, 1.0);
+    prog->resetNumSteps(std::max(progNumSteps, size_t(1)), 0.00, 1.0);
   }
 
   // Run the chunks in parallel. There is no overlap in the output workspace so
   // it is thread safe to write to it..
-  // cppcheck-suppress syntaxError
-    PRAGMA_OMP( parallel for schedule(dynamic,1) if (doParallel) )
-    for (int chunk = 0;
-         chunk < int(m_binDimensions[chunkDimension]->getNBins());
-         chunk += chunkNumBins) {
-      PARALLEL_START_INTERUPT_REGION
-      // Region of interest for this chunk.
-      std::vector<size_t> chunkMin(m_outD);
-      std::vector<size_t> chunkMax(m_outD);
-      for (size_t bd = 0; bd < m_outD; bd++) {
-        // Same limits in the other dimensions
-        chunkMin[bd] = 0;
-        chunkMax[bd] = m_binDimensions[bd]->getNBins();
-      }
-      // Parcel out a chunk in that single dimension dimension
-      chunkMin[chunkDimension] = size_t(chunk);
-      if (size_t(chunk + chunkNumBins) >
-          m_binDimensions[chunkDimension]->getNBins())
-        chunkMax[chunkDimension] = m_binDimensions[chunkDimension]->getNBins();
-      else
-        chunkMax[chunkDimension] = size_t(chunk + chunkNumBins);
-
-      // Build an implicit function (it needs to be in the space of the
-      // MDEventWorkspace)
-      MDImplicitFunction *function =
-          this->getImplicitFunctionForChunk(chunkMin.data(), chunkMax.data());
-
-      // Use getBoxes() to get an array with a pointer to each box
-      std::vector<API::IMDNode *> boxes;
-      // Leaf-only; no depth limit; with the implicit function passed to it.
-      ws->getBox()->getBoxes(boxes, 1000, true, function);
-
-      // Sort boxes by file position IF file backed. This reduces seeking time,
-      // hopefully.
-      if (bc->isFileBacked())
-        API::IMDNode::sortObjByID(boxes);
-
-      // For progress reporting, the # of boxes
-      if (prog) {
-        PARALLEL_CRITICAL(BinMD_progress) {
-          g_log.debug() << "Chunk " << chunk << ": found " << boxes.size()
-                        << " boxes within the implicit function.\n";
-          progNumSteps += boxes.size();
-          prog->setNumSteps(progNumSteps);
-        }
-      }
-
-      // Go through every box for this chunk.
-      for (auto &boxe : boxes) {
-        MDBox<MDE, nd> *box = dynamic_cast<MDBox<MDE, nd> *>(boxe);
-        // Perform the binning in this separate method.
-        if (box && !box->getIsMasked())
-          this->binMDBox(box, chunkMin.data(), chunkMax.data());
-
-        // Progress reporting
-        if (prog)
-          prog->report();
-        // For early cancelling of the loop
-        if (this->m_cancel)
-          break;
-      } // for each box in the vector
-      PARALLEL_END_INTERUPT_REGION
-    } // for each chunk in parallel
-    PARALLEL_CHECK_INTERUPT_REGION
-
-    // Now the implicit function
-    if (implicitFunction) {
+  PRAGMA_OMP(parallel for schedule(dynamic, 1) if (doParallel))
+  for (int chunk = 0; chunk < static_cast<int>(numChunks); ++chunk) {
+    PARALLEL_START_INTERUPT_REGION
+    // Region of interest for this chunk.
+    std::vector<size_t> chunkMin(fullMin);
+    std::vector<size_t> chunkMax(fullMax);
+    // Parcel out a chunk in that single dimension dimension
+    chunkMin[chunkDimension] = size_t(chunk) * chunkNumBins;
+    chunkMax[chunkDimension] =
+        std::min(chunkMin[chunkDimension] + chunkNumBins, numChunkBins);
+
+    // Scratch space for transforming events, reused for every box
+    std::vector<coord_t> inBuffer;
+    std::vector<coord_t> outBuffer;
+    // Go through every box for this chunk.
+    for (auto box : chunkBoxes[chunk]) {
+      // Perform the binning in this separate method.
+      this->binMDBox(box, chunkMin.data(), chunkMax.data(), inBuffer,
+                     outBuffer);
+
+      // Progress reporting
       if (prog)
-        prog->report("Applying implicit function.");
-      signal_t nan = std::numeric_limits<signal_t>::quiet_NaN();
-      outWS->applyImplicitFunction(implicitFunction, nan, nan);
-    }
-
-    // return the size of the input workspace write buffer to its initial value
-    // bc->setCacheParameters(sizeof(MDE),writeBufSize);
+        prog->report();
+      // For early cancelling of the loop
+      if (this->m_cancel)
+        break;
+    } // for each box in the vector
+    PARALLEL_END_INTERUPT_REGION
+  } // for each chunk in parallel
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  // Now the implicit function
+  if (implicitFunction) {
+    if (prog)
+      prog->report("Applying implicit function.");
+    signal_t nan = std::numeric_limits<signal_t>::quiet_NaN();
+    outWS->applyImplicitFunction(implicitFunction, nan, nan);
+  }
 }
 
 //----------------------------------------------------------------------------------------------
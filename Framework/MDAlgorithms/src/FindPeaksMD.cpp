@@ -15,9 +15,15 @@
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/EnabledWhenProperty.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/VMD.h"
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <unordered_map>
 #include <vector>
 
 using namespace Mantid::Kernel;
@@ -85,6 +91,7 @@ void addDetectors(DataObjects::Peak &peak, MDBoxBase<MDE, nd> &box,
   for (auto it = events.begin(); it != itend; ++it) {
     peak.addContributingDetID(it->getDetectorID());
   }
+  mdBox->releaseEvents();
 }
 
 /// Add detectors based on lean events. Always throws as they do not know their
@@ -106,6 +113,188 @@ void addDetectors(DataObjects::Peak &peak, MDBoxBase<MDE, nd> &box) {
   // Compile time deduction of the correct function call
   addDetectors(peak, box, IsFullEvent<MDE, nd>());
 }
+
+/// A box that may hold a peak: <signal density, index of the box>
+using Candidate = std::pair<double, size_t>;
+
+/** Find the boxes with the highest densities above a threshold. Each thread
+ * keeps the densest of the boxes it looks at in a bounded heap, so the boxes
+ * are never sorted all together.
+ *
+ * @param numBoxes :: number of boxes
+ * @param density :: function giving the density of the box at an index
+ * @param threshold :: boxes must have a higher density than this
+ * @param maxCandidates :: number of boxes to keep
+ * @param numAboveThreshold :: set to the number of boxes above the threshold
+ * @return the densest boxes, in order of decreasing density
+ */
+template <typename DensityFunction>
+std::vector<Candidate>
+findDensestBoxes(const size_t numBoxes, const DensityFunction &density,
+                 const double threshold, const size_t maxCandidates,
+                 size_t &numAboveThreshold) {
+  std::vector<Candidate> candidates;
+  numAboveThreshold = 0;
+  if (maxCandidates == 0)
+    return candidates;
+
+  PARALLEL {
+    // The top of the heap is the least dense of the boxes kept
+    std::priority_queue<Candidate, std::vector<Candidate>,
+                        std::greater<Candidate>>
+        densest;
+    size_t numAbove(0);
+    PRAGMA_OMP(for nowait)
+    for (int64_t i = 0; i < static_cast<int64_t>(numBoxes); ++i) {
+      const Candidate candidate(density(static_cast<size_t>(i)),
+                                static_cast<size_t>(i));
+      // Skip any boxes with too small a signal value.
+      if (!(candidate.first > threshold))
+        continue;
+      ++numAbove;
+      if (densest.size() < maxCandidates) {
+        densest.push(candidate);
+      } else if (densest.top() < candidate) {
+        densest.pop();
+        densest.push(candidate);
+      }
+    }
+    PARALLEL_CRITICAL(FindPeaksMD_findDensestBoxes) {
+      numAboveThreshold += numAbove;
+      for (; !densest.empty(); densest.pop())
+        candidates.push_back(densest.top());
+    }
+  }
+
+  // Equal densities are ordered by decreasing index, as the multimap used
+  // to do when iterated backwards.
+  std::sort(candidates.begin(), candidates.end(), std::greater<Candidate>());
+  if (candidates.size() > maxCandidates)
+    candidates.resize(maxCandidates);
+  return candidates;
+}
+
+/** The centres of the peaks found so far, hashed on a grid of cells as wide
+ * as the rejection distance. The peaks close to a point are then all in the
+ * 27 cells around it in the first three dimensions.
+ */
+class PeakCentreGrid {
+public:
+  PeakCentreGrid(const size_t nd, const coord_t distanceSquared)
+      : m_nd(nd), m_distanceSquared(distanceSquared),
+        m_cellSize(std::sqrt(distanceSquared)) {}
+
+  /// @return true if the point is closer than the distance to a peak
+  bool isNearPeak(const coord_t *centre) const {
+    if (!(m_distanceSquared > 0))
+      return false;
+    const Cell cell = cellOf(centre);
+    Cell neighbour;
+    for (int64_t i = -1; i <= 1; ++i)
+      for (int64_t j = -1; j <= 1; ++j)
+        for (int64_t k = -1; k <= 1; ++k) {
+          neighbour = {{cell[0] + i, cell[1] + j, cell[2] + k}};
+          const auto found = m_cells.find(neighbour);
+          if (found == m_cells.end())
+            continue;
+          const std::vector<coord_t> &peaks = found->second;
+          for (size_t p = 0; p < peaks.size(); p += m_nd) {
+            coord_t distSquared = 0.0;
+            for (size_t d = 0; d < m_nd; d++) {
+              coord_t dist = peaks[p + d] - centre[d];
+              distSquared += (dist * dist);
+            }
+            if (distSquared < m_distanceSquared)
+              return true;
+          }
+        }
+    return false;
+  }
+
+  /// Add the centre of a new peak
+  void addPeak(const coord_t *centre) {
+    if (!(m_distanceSquared > 0))
+      return;
+    std::vector<coord_t> &peaks = m_cells[cellOf(centre)];
+    peaks.insert(peaks.end(), centre, centre + m_nd);
+  }
+
+private:
+  using Cell = std::array<int64_t, 3>;
+  struct CellHash {
+    size_t operator()(const Cell &cell) const {
+      return std::hash<int64_t>()(cell[0]) ^
+             (std::hash<int64_t>()(cell[1]) << 1) ^
+             (std::hash<int64_t>()(cell[2]) << 2);
+    }
+  };
+
+  Cell cellOf(const coord_t *centre) const {
+    // Stay well within the range of the cell indices for tiny distances
+    const double maxIndex = 1e15;
+    Cell cell;
+    for (size_t d = 0; d < 3; d++) {
+      const double index = std::floor(centre[d] / m_cellSize);
+      cell[d] = static_cast<int64_t>(
+          std::max(-maxIndex, std::min(maxIndex, index)));
+    }
+    return cell;
+  }
+
+  const size_t m_nd;
+  const coord_t m_distanceSquared;
+  const double m_cellSize;
+  std::unordered_map<Cell, std::vector<coord_t>, CellHash> m_cells;
+};
+
+/** Pick the peak boxes in order of decreasing density, rejecting boxes too
+ * close to a peak already picked. Only the densest boxes are considered at
+ * first; more are looked at only if too many of them were rejected.
+ *
+ * @param numBoxes :: number of boxes
+ * @param nd :: number of dimensions
+ * @param density :: function giving the density of the box at an index
+ * @param centre :: function writing the centre of the box at an index
+ * @param threshold :: peak boxes must have a higher density than this
+ * @param maxPeaks :: maximum number of peaks to pick
+ * @param distanceSquared :: peaks must be at least this far from each other
+ * @param limitReached :: set to true if more peaks than maxPeaks were found
+ * @return the peak boxes, in order of decreasing density
+ */
+template <typename DensityFunction, typename CentreFunction>
+std::vector<Candidate>
+pickPeakBoxes(const size_t numBoxes, const size_t nd,
+              const DensityFunction &density, const CentreFunction &centre,
+              const double threshold, const int64_t maxPeaks,
+              const coord_t distanceSquared, bool &limitReached) {
+  const size_t wantedPeaks = static_cast<size_t>(
+      std::min(std::max(maxPeaks, int64_t(0)), int64_t(numBoxes)));
+  size_t maxCandidates = std::max(size_t(4096), 16 * wantedPeaks);
+  std::vector<coord_t> boxCenter(nd);
+  while (true) {
+    size_t numAboveThreshold;
+    const auto candidates = findDensestBoxes(numBoxes, density, threshold,
+                                             maxCandidates, numAboveThreshold);
+    std::vector<Candidate> peaks;
+    PeakCentreGrid peakCentres(nd, distanceSquared);
+    limitReached = false;
+    for (const auto &candidate : candidates) {
+      centre(candidate.second, boxCenter.data());
+      // Reject this box if it is too close to another previously found box.
+      if (peakCentres.isNearPeak(boxCenter.data()))
+        continue;
+      if (static_cast<int64_t>(peaks.size()) >= maxPeaks) {
+        limitReached = true;
+        break;
+      }
+      peakCentres.addPeak(boxCenter.data());
+      peaks.push_back(candidate);
+    }
+    if (limitReached || candidates.size() == numAboveThreshold)
+      return peaks;
+    maxCandidates *= 4;
+  }
+}
 } // namespace
 
 // Register the algorithm into the AlgorithmFactory
@@ -394,7 +583,6 @@ void FindPeaksMD::findPeaks(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     }
     g_log.information() << "Threshold signal density: " << threshold << '\n';
 
-    using boxPtr = API::IMDNode *;
     // We will fill this vector with pointers to all the boxes (up to a given
     // depth)
     typename std::vector<API::IMDNode *> boxes;
@@ -403,108 +591,60 @@ void FindPeaksMD::findPeaks(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     progress(0.10, "Getting Boxes");
     ws->getBox()->getBoxes(boxes, 1000, true);
 
-    // This pair is the <density, ptr to the box>
-    using dens_box = std::pair<double, API::IMDNode *>;
-
-    // Map that will sort the boxes by increasing density. The key = density;
-    // value = box *.
-    typename std::multimap<double, API::IMDNode *> sortedBoxes;
-
-    // --------------- Sort and Filter by Density -----------------------------
-    progress(0.20, "Sorting Boxes by Density");
-    auto it1 = boxes.begin();
-    auto it1_end = boxes.end();
-    for (; it1 != it1_end; it1++) {
-      auto box = *it1;
+    // --------------- Find Peak Boxes -----------------------------
+    // Only the box averages are used, so the events of file-backed
+    // workspaces are not loaded.
+    progress(0.20, "Finding Peaks");
+    const auto density = [this, &boxes](size_t i) {
       double value = m_useNumberOfEventsNormalization
-                         ? box->getSignalByNEvents()
-                         : box->getSignalNormalized();
-      value *= m_densityScaleFactor;
-      // Skip any boxes with too small a signal value.
-      if (value > threshold)
-        sortedBoxes.insert(dens_box(value, box));
-    }
+                         ? boxes[i]->getSignalByNEvents()
+                         : boxes[i]->getSignalNormalized();
+      return value * m_densityScaleFactor;
+    };
+    const auto centre = [&boxes](size_t i, coord_t *boxCenter) {
+      const coord_t *centroid = boxes[i]->getCentroid();
+      std::copy(centroid, centroid + nd, boxCenter);
+    };
+    bool limitReached;
+    const auto peakCandidates =
+        pickPeakBoxes(boxes.size(), nd, density, centre, threshold, m_maxPeaks,
+                      peakRadiusSquared, limitReached);
+    if (limitReached)
+      g_log.notice() << "Number of peaks found exceeded the limit of "
+                     << m_maxPeaks << ". Stopping peak finding.\n";
 
-    // --------------- Find Peak Boxes -----------------------------
     // List of chosen possible peak boxes.
     std::vector<API::IMDNode *> peakBoxes;
+    for (const auto &candidate : peakCandidates) {
+      API::IMDNode *box = boxes[candidate.second];
+      peakBoxes.push_back(box);
+      const coord_t *boxCenter = box->getCentroid();
+      g_log.debug() << "Found box at ";
+      for (size_t d = 0; d < nd; d++)
+        g_log.debug() << (d > 0 ? "," : "") << boxCenter[d];
+      g_log.debug() << "; Density = " << candidate.first << '\n';
+    }
 
-    prog = make_unique<Progress>(this, 0.30, 0.95, m_maxPeaks);
+    prog = make_unique<Progress>(this, 0.95, 1.0, peakBoxes.size());
 
     // used for selecting method for calculating BinCount
     bool isMDEvent(ws->id().find("MDEventWorkspace") != std::string::npos);
 
-    int64_t numBoxesFound = 0;
-    // Now we go (backwards) through the map
-    // e.g. from highest density down to lowest density.
-    typename std::multimap<double, boxPtr>::reverse_iterator it2;
-    auto it2_end = sortedBoxes.rend();
-    for (it2 = sortedBoxes.rbegin(); it2 != it2_end; ++it2) {
-      signal_t density = it2->first;
-      boxPtr box = it2->second;
-#ifndef MDBOX_TRACK_CENTROID
-      coord_t boxCenter[nd];
-      box->calculateCentroid(boxCenter);
-#else
-      const coord_t *boxCenter = box->getCentroid();
-#endif
-
-      // Compare to all boxes already picked.
-      bool badBox = false;
-      for (auto &peakBoxe : peakBoxes) {
-
-#ifndef MDBOX_TRACK_CENTROID
-        coord_t otherCenter[nd];
-        (*it3)->calculateCentroid(otherCenter);
-#else
-        const coord_t *otherCenter = peakBoxe->getCentroid();
-#endif
-
-        // Distance between this box and a box we already put in.
-        coord_t distSquared = 0.0;
-        for (size_t d = 0; d < nd; d++) {
-          coord_t dist = otherCenter[d] - boxCenter[d];
-          distSquared += (dist * dist);
-        }
-
-        // Reject this box if it is too close to another previously found box.
-        if (distSquared < peakRadiusSquared) {
-          badBox = true;
-          break;
-        }
-      }
-
-      // The box was not rejected for another reason.
-      if (!badBox) {
-        if (numBoxesFound++ >= m_maxPeaks) {
-          g_log.notice() << "Number of peaks found exceeded the limit of "
-                         << m_maxPeaks << ". Stopping peak finding.\n";
-          break;
-        }
-
-        peakBoxes.push_back(box);
-        g_log.debug() << "Found box at ";
-        for (size_t d = 0; d < nd; d++)
-          g_log.debug() << (d > 0 ? "," : "") << boxCenter[d];
-        g_log.debug() << "; Density = " << density << '\n';
-        // Report progres for each box found.
-        prog->report("Finding Peaks");
-      }
-    }
-
-    prog->resetNumSteps(numBoxesFound, 0.95, 1.0);
-
     // --- Convert the "boxes" to peaks ----
     for (auto box : peakBoxes) {
       //  If no events from this experimental contribute to the box then skip
       if (nexp > 1) {
         MDBox<MDE, nd> *mdbox = dynamic_cast<MDBox<MDE, nd> *>(box);
-        typename std::vector<MDE> &events = mdbox->getEvents();
-        if (std::none_of(events.cbegin(), events.cend(),
-                         [&iexp, &nexp](MDE event) {
-                           return event.getRunIndex() == iexp ||
-                                  event.getRunIndex() >= nexp;
-                         }))
+        const std::vector<MDE> &events = mdbox->getConstEvents();
+        const bool fromThisRun =
+            std::any_of(events.cbegin(), events.cend(),
+                        [&iexp, &nexp](const MDE &event) {
+                          return event.getRunIndex() == iexp ||
+                                 event.getRunIndex() >= nexp;
+                        });
+        // Let a file-backed box go back to the disk buffer
+        mdbox->releaseEvents();
+        if (!fromThisRun)
           continue;
       }
         // The center of the box = Q in the lab frame
@@ -586,13 +726,6 @@ void FindPeaksMD::findPeaksHisto(
     // Copy the instrument, sample, run to the peaks workspace.
     peakWS->copyExperimentInfoFrom(ei.get());
 
-    // This pair is the <density, box index>
-    using dens_box = std::pair<double, size_t>;
-
-    // Map that will sort the boxes by increasing density. The key = density;
-    // value = box index.
-    std::multimap<double, size_t> sortedBoxes;
-
     size_t numBoxes = ws->getNPoints();
 
     // --------- Count the overall signal density -----------------------------
@@ -613,66 +746,34 @@ void FindPeaksMD::findPeaksHisto(
     g_log.information() << "Threshold signal density: " << thresholdDensity
                         << '\n';
 
-    // -------------- Sort and Filter by Density -----------------------------
-    progress(0.20, "Sorting Boxes by Density");
-    for (size_t i = 0; i < numBoxes; i++) {
-      double density = ws->getSignalNormalizedAt(i) * m_densityScaleFactor;
-      // Skip any boxes with too small a signal density.
-      if (density > thresholdDensity)
-        sortedBoxes.insert(dens_box(density, i));
-    }
-
     // --------------- Find Peak Boxes -----------------------------
+    progress(0.20, "Finding Peaks");
+    const auto density = [this, &ws](size_t i) {
+      return ws->getSignalNormalizedAt(i) * m_densityScaleFactor;
+    };
+    const auto centre = [&ws, nd](size_t i, coord_t *boxCenter) {
+      const VMD center = ws->getCenter(i);
+      for (size_t d = 0; d < nd; d++)
+        boxCenter[d] = static_cast<coord_t>(center[d]);
+    };
+    bool limitReached;
+    const auto peakCandidates =
+        pickPeakBoxes(numBoxes, nd, density, centre, thresholdDensity,
+                      m_maxPeaks, peakRadiusSquared, limitReached);
+    if (limitReached)
+      g_log.notice() << "Number of peaks found exceeded the limit of "
+                     << m_maxPeaks << ". Stopping peak finding.\n";
+
     // List of chosen possible peak boxes.
     std::vector<size_t> peakBoxes;
+    for (const auto &candidate : peakCandidates) {
+      peakBoxes.push_back(candidate.second);
+      g_log.debug() << "Found box at index " << candidate.second;
+      g_log.debug() << "; Density = " << candidate.first << '\n';
+    }
 
-    prog = make_unique<Progress>(this, 0.30, 0.95, m_maxPeaks);
-
-    int64_t numBoxesFound = 0;
-    // Now we go (backwards) through the map
-    // e.g. from highest density down to lowest density.
-    std::multimap<double, size_t>::reverse_iterator it2;
-    auto it2_end = sortedBoxes.rend();
-    for (it2 = sortedBoxes.rbegin(); it2 != it2_end; ++it2) {
-      signal_t density = it2->first;
-      size_t index = it2->second;
-      // Get the center of the box
-      VMD boxCenter = ws->getCenter(index);
-
-      // Compare to all boxes already picked.
-      bool badBox = false;
-      for (auto &peakBoxe : peakBoxes) {
-        VMD otherCenter = ws->getCenter(peakBoxe);
-
-        // Distance between this box and a box we already put in.
-        coord_t distSquared = 0.0;
-        for (size_t d = 0; d < nd; d++) {
-          coord_t dist = otherCenter[d] - boxCenter[d];
-          distSquared += (dist * dist);
-        }
-
-        // Reject this box if it is too close to another previously found box.
-        if (distSquared < peakRadiusSquared) {
-          badBox = true;
-          break;
-        }
-      }
-
-      // The box was not rejected for another reason.
-      if (!badBox) {
-        if (numBoxesFound++ >= m_maxPeaks) {
-          g_log.notice() << "Number of peaks found exceeded the limit of "
-                         << m_maxPeaks << ". Stopping peak finding.\n";
-          break;
-        }
+    prog = make_unique<Progress>(this, 0.30, 1.0, peakBoxes.size());
 
-        peakBoxes.push_back(index);
-        g_log.debug() << "Found box at index " << index;
-        g_log.debug() << "; Density = " << density << '\n';
-        // Report progres for each box found.
-        prog->report("Finding Peaks");
-      }
-    }
     // --- Convert the "boxes" to peaks ----
     for (auto index : peakBoxes) {
       // The center of the box = Q in the lab frame
@@ -26,6 +26,12 @@ using namespace Mantid::DataObjects;
 namespace Mantid {
 namespace MDAlgorithms {
 
+namespace {
+/// Peaks with the same nearest integer h,k,l closer than this in h,k,l are
+/// the same peak. Peaks further apart are satellites of each other.
+constexpr double SAME_PEAK_HKL_TOLERANCE = 0.05;
+} // namespace
+
 using namespace std;
 using Mantid::Kernel::DblMatrix;
 using Mantid::Kernel::V3D;
@@ -50,9 +56,21 @@ Integrate3DEvents::Integrate3DEvents(
     : m_UBinv(UBinv), m_radius(radius),
       m_useOnePercentBackgroundCorrection(useOnePercentBackgroundCorrection) {
   for (size_t it = 0; it != peak_q_list.size(); ++it) {
-    int64_t hkl_key = getHklKey(peak_q_list[it].second);
-    if (hkl_key != 0) // only save if hkl != (0,0,0)
-      m_peak_qs[hkl_key] = peak_q_list[it].second;
+    const V3D &peak_q = peak_q_list[it].second;
+    int64_t hkl_key = getHklKey(peak_q);
+    if (hkl_key == 0) // only save if hkl != (0,0,0)
+      continue;
+    // A peak at the same h,k,l as an earlier one replaces it
+    auto &cell = m_peak_qs[hkl_key];
+    auto same = std::find_if(
+        cell.begin(), cell.end(), [&](const std::pair<int64_t, V3D> &peak) {
+          return (m_UBinv * (peak.second - peak_q)).norm() <
+                 SAME_PEAK_HKL_TOLERANCE;
+        });
+    if (same != cell.end())
+      same->second = peak_q;
+    else
+      cell.emplace_back(static_cast<int64_t>(it), peak_q);
   }
 }
 
@@ -75,9 +93,45 @@ Integrate3DEvents::Integrate3DEvents(
  */
 void Integrate3DEvents::addEvents(
     std::vector<std::pair<double, V3D>> const &event_qs, bool hkl_integ) {
+  addEvents(event_qs, hkl_integ, m_event_lists);
+  m_principal_axes.clear();
+}
+
+/**
+ * Add the specified event Q's to the given lists of events near peaks,
+ * instead of the lists kept by the integrator. This does not modify the
+ * integrator, so threads can each sort events into their own lists at the
+ * same time, to be added to the integrator with addEventLists afterwards.
+ *
+ * @param event_qs     List of event Q vectors to add to lists of Q's
+ *                     associated with peaks.
+ * @param hkl_integ
+ * @param event_lists  The lists of events near each peak to add to
+ */
+void Integrate3DEvents::addEvents(
+    std::vector<std::pair<double, V3D>> const &event_qs, bool hkl_integ,
+    EventListMap &event_lists) const {
   for (const auto &event_q : event_qs) {
-    addEvent(event_q, hkl_integ);
+    addEvent(event_q, hkl_integ, event_lists);
+  }
+}
+
+/**
+ * Move lists of events near peaks, filled by addEvents, into the lists of
+ * the integrator.
+ *
+ * @param event_lists  The lists of events near each peak. They are emptied.
+ */
+void Integrate3DEvents::addEventLists(EventListMap &event_lists) {
+  for (auto &item : event_lists) {
+    auto &events = m_event_lists[item.first];
+    if (events.empty())
+      events.swap(item.second);
+    else
+      events.insert(events.end(), item.second.cbegin(), item.second.cend());
   }
+  event_lists.clear();
+  m_principal_axes.clear();
 }
 
 std::pair<boost::shared_ptr<const Geometry::PeakShape>,
@@ -88,8 +142,9 @@ Integrate3DEvents::integrateStrongPeak(const IntegrationParameters &params,
 
   inti = 0.0; // default values, in case something
   sigi = 0.0; // is wrong with the peak.
-  auto result = getEvents(peak_q);
-  if (!result)
+  int64_t peak_index;
+  auto result = findEventList(peak_q, peak_index);
+  if (!result || result->size() < 3)
     return std::make_pair(boost::make_shared<NoShape>(),
                           make_tuple(0., 0., 0.));
 
@@ -98,16 +153,9 @@ Integrate3DEvents::integrateStrongPeak(const IntegrationParameters &params,
     return std::make_pair(boost::make_shared<NoShape>(),
                           make_tuple(0., 0., 0.));
 
-  DblMatrix cov_matrix(3, 3);
-  makeCovarianceMatrix(events, cov_matrix, params.regionRadius);
-
-  std::vector<V3D> eigen_vectors;
-  getEigenVectors(cov_matrix, eigen_vectors);
-
-  std::vector<double> sigmas(3);
-  for (int i = 0; i < 3; i++) {
-    sigmas[i] = stdDev(events, eigen_vectors[i], params.regionRadius);
-  }
+  const auto axes = getPrincipalAxes(peak_index, events, params.regionRadius);
+  const auto &eigen_vectors = axes.directions;
+  const auto &sigmas = axes.sigmas;
 
   bool invalid_peak =
       std::any_of(sigmas.cbegin(), sigmas.cend(), [](const double sigma) {
@@ -239,24 +287,18 @@ Integrate3DEvents::integrateWeakPeak(
 double Integrate3DEvents::estimateSignalToNoiseRatio(
     const IntegrationParameters &params, const V3D &center) {
 
-  auto result = getEvents(center);
-  if (!result)
+  int64_t peak_index;
+  auto result = findEventList(center, peak_index);
+  if (!result || result->size() < 3)
     return .0;
 
   const auto &events = *result;
   if (events.empty())
     return .0;
 
-  DblMatrix cov_matrix(3, 3);
-  makeCovarianceMatrix(events, cov_matrix, params.regionRadius);
-
-  std::vector<V3D> eigen_vectors;
-  getEigenVectors(cov_matrix, eigen_vectors);
-
-  std::vector<double> sigmas(3);
-  for (int i = 0; i < 3; i++) {
-    sigmas[i] = stdDev(events, eigen_vectors[i], params.regionRadius);
-  }
+  const auto axes = getPrincipalAxes(peak_index, events, params.regionRadius);
+  const auto &eigen_vectors = axes.directions;
+  const auto &sigmas = axes.sigmas;
 
   const auto max_sigma = *std::max_element(sigmas.begin(), sigmas.end());
   if (max_sigma == 0)
@@ -289,23 +331,88 @@ double Integrate3DEvents::estimateSignalToNoiseRatio(
 }
 
 const std::vector<std::pair<double, V3D>> *
-Integrate3DEvents::getEvents(const V3D &peak_q) {
-  const auto hkl_key = getHklKey(peak_q);
+Integrate3DEvents::getEvents(const V3D &peak_q) const {
+  int64_t peak_index;
+  const auto events = findEventList(peak_q, peak_index);
 
-  if (hkl_key == 0)
+  if (!events || events->size() < 3) // if there are not enough events
     return nullptr;
 
-  const auto pos = m_event_lists.find(hkl_key);
+  return events;
+}
 
-  if (m_event_lists.end() == pos)
+/**
+ * Find the peak closest to the given Q among the peaks with the same nearest
+ * integer h,k,l, and its list of events.
+ *
+ * @param peak_q      The Q-vector of the peak
+ * @param peak_index  Set to the index of the peak found
+ * @return the list of events of the peak, or nullptr if there is none
+ */
+const std::vector<std::pair<double, V3D>> *
+Integrate3DEvents::findEventList(const V3D &peak_q,
+                                 int64_t &peak_index) const {
+  const auto hkl_key = getHklKey(peak_q);
+  if (hkl_key == 0)
     return nullptr;
 
-  if (pos->second.size() < 3) // if there are not enough events
+  const auto cell = m_peak_qs.find(hkl_key);
+  if (m_peak_qs.end() == cell)
+    return nullptr;
+
+  const auto closest = std::min_element(
+      cell->second.cbegin(), cell->second.cend(),
+      [&peak_q](const std::pair<int64_t, V3D> &a,
+                const std::pair<int64_t, V3D> &b) {
+        return (a.second - peak_q).norm2() < (b.second - peak_q).norm2();
+      });
+  peak_index = closest->first;
+
+  const auto pos = m_event_lists.find(peak_index);
+  if (m_event_lists.end() == pos)
     return nullptr;
 
   return &(pos->second);
 }
 
+/**
+ * Get the principal axes of a list of events centered at (0,0,0) and the
+ * standard deviations of the events along them. The axes of the events
+ * within the region radius are kept, so that integrating a peak again does
+ * not recalculate them. This may be called from several threads at once.
+ *
+ * @param peak_index  The index of the peak the events belong to
+ * @param events      The events of the peak, centered at (0,0,0)
+ * @param radius      Only events within this radius of (0,0,0) are used
+ * @return the principal axes and the standard deviations along them
+ */
+Integrate3DEvents::PrincipalAxes Integrate3DEvents::getPrincipalAxes(
+    int64_t peak_index, std::vector<std::pair<double, V3D>> const &events,
+    double radius) const {
+  const bool keep = radius == m_radius;
+  if (keep) {
+    std::lock_guard<std::mutex> lock(m_principal_axes_mutex);
+    const auto found = m_principal_axes.find(peak_index);
+    if (found != m_principal_axes.end())
+      return found->second;
+  }
+
+  PrincipalAxes axes;
+  DblMatrix cov_matrix(3, 3);
+  makeCovarianceMatrix(events, cov_matrix, radius);
+  getEigenVectors(cov_matrix, axes.directions);
+  axes.sigmas.resize(3);
+  for (int i = 0; i < 3; i++) {
+    axes.sigmas[i] = stdDev(events, axes.directions[i], radius);
+  }
+
+  if (keep) {
+    std::lock_guard<std::mutex> lock(m_principal_axes_mutex);
+    m_principal_axes.emplace(peak_index, axes);
+  }
+  return axes;
+}
+
 bool Integrate3DEvents::correctForDetectorEdges(
     std::tuple<double, double, double> &radii, const std::vector<V3D> &E1Vecs,
     const V3D &peak_q, const std::vector<double> &axesRadii,
@@ -384,33 +491,21 @@ Integrate3DEvents::ellipseIntegrateEvents(
   inti = 0.0; // default values, in case something
   sigi = 0.0; // is wrong with the peak.
 
-  int64_t hkl_key = getHklKey(peak_q);
-  if (hkl_key == 0) {
+  int64_t peak_index;
+  auto pos = findEventList(peak_q, peak_index);
+  if (!pos)
     return boost::make_shared<NoShape>();
-  }
 
-  auto pos = m_event_lists.find(hkl_key);
-  if (m_event_lists.end() == pos)
-    return boost::make_shared<NoShape>();
-  ;
-
-  std::vector<std::pair<double, V3D>> &some_events = pos->second;
+  const std::vector<std::pair<double, V3D>> &some_events = *pos;
 
   if (some_events.size() < 3) // if there are not enough events to
   {                           // find covariance matrix, return
     return boost::make_shared<NoShape>();
   }
 
-  DblMatrix cov_matrix(3, 3);
-  makeCovarianceMatrix(some_events, cov_matrix, m_radius);
-
-  std::vector<V3D> eigen_vectors;
-  getEigenVectors(cov_matrix, eigen_vectors);
-
-  std::vector<double> sigmas(3);
-  for (int i = 0; i < 3; i++) {
-    sigmas[i] = stdDev(some_events, eigen_vectors[i], m_radius);
-  }
+  const auto axes = getPrincipalAxes(peak_index, some_events, m_radius);
+  const auto &eigen_vectors = axes.directions;
+  const auto &sigmas = axes.sigmas;
 
   bool invalid_peak =
       std::any_of(sigmas.cbegin(), sigmas.cend(), [](const double sigma) {
@@ -538,15 +633,19 @@ double Integrate3DEvents::numInEllipsoidBkg(
 void Integrate3DEvents::makeCovarianceMatrix(
     std::vector<std::pair<double, V3D>> const &events, DblMatrix &matrix,
     double radius) {
+  // One pass over the events sums the products for all the elements
+  double sums[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+  for (const auto &value : events) {
+    const auto &event = value.second;
+    if (event.norm() <= radius) {
+      for (int row = 0; row < 3; row++)
+        for (int col = row; col < 3; col++)
+          sums[row][col] += event[row] * event[col];
+    }
+  }
   for (int row = 0; row < 3; row++) {
     for (int col = 0; col < 3; col++) {
-      double sum = 0;
-      for (const auto &value : events) {
-        const auto &event = value.second;
-        if (event.norm() <= radius) {
-          sum += event[row] * event[col];
-        }
-      }
+      const double sum = row <= col ? sums[row][col] : sums[col][row];
       if (events.size() > 1)
         matrix[row][col] = sum / static_cast<double>(events.size() - 1);
       else
@@ -652,7 +751,7 @@ int64_t Integrate3DEvents::getHklKey(int h, int k, int l) {
  *
  *  @param hkl  The q_vector to be mapped to h,k,l
  */
-int64_t Integrate3DEvents::getHklKey2(V3D const &hkl) {
+int64_t Integrate3DEvents::getHklKey2(V3D const &hkl) const {
   int h = boost::math::iround<double>(hkl[0]);
   int k = boost::math::iround<double>(hkl[1]);
   int l = boost::math::iround<double>(hkl[2]);
@@ -665,7 +764,7 @@ int64_t Integrate3DEvents::getHklKey2(V3D const &hkl) {
  *
  *  @param q_vector  The q_vector to be mapped to h,k,l
  */
-int64_t Integrate3DEvents::getHklKey(V3D const &q_vector) {
+int64_t Integrate3DEvents::getHklKey(V3D const &q_vector) const {
   V3D hkl = m_UBinv * q_vector;
   int h = boost::math::iround<double>(hkl[0]);
   int k = boost::math::iround<double>(hkl[1]);
@@ -688,7 +787,8 @@ int64_t Integrate3DEvents::getHklKey(V3D const &q_vector) {
  * @param hkl_integ
  */
 void Integrate3DEvents::addEvent(std::pair<double, V3D> event_Q,
-                                 bool hkl_integ) {
+                                 bool hkl_integ,
+                                 EventListMap &event_lists) const {
   int64_t hkl_key;
   if (hkl_integ)
     hkl_key = getHklKey2(event_Q.second);
@@ -699,17 +799,30 @@ void Integrate3DEvents::addEvent(std::pair<double, V3D> event_Q,
     return;
 
   auto peak_it = m_peak_qs.find(hkl_key);
-  if (peak_it != m_peak_qs.end()) {
-    if (!peak_it->second.nullVector()) {
-      if (hkl_integ)
-        event_Q.second = event_Q.second - m_UBinv * peak_it->second;
-      else
-        event_Q.second = event_Q.second - peak_it->second;
-      if (event_Q.second.norm() < m_radius) {
-        m_event_lists[hkl_key].push_back(event_Q);
-      }
+  if (peak_it == m_peak_qs.end())
+    return;
+
+  // Usually there is one peak at this h,k,l, otherwise it has satellites
+  // and the closest peak is used
+  const std::pair<int64_t, V3D> *closest = nullptr;
+  V3D offset;
+  for (const auto &peak : peak_it->second) {
+    if (peak.second.nullVector())
+      continue;
+    V3D peak_offset;
+    if (hkl_integ)
+      peak_offset = event_Q.second - m_UBinv * peak.second;
+    else
+      peak_offset = event_Q.second - peak.second;
+    if (!closest || peak_offset.norm2() < offset.norm2()) {
+      closest = &peak;
+      offset = peak_offset;
     }
   }
+  if (closest && offset.norm() < m_radius) {
+    event_Q.second = offset;
+    event_lists[closest->first].push_back(event_Q);
+  }
 }
 
 /**
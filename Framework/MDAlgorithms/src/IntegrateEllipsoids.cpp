@@ -66,6 +66,8 @@ void IntegrateEllipsoids::qListFromEventWS(Integrate3DEvents &integrator,
   // loop through the eventlists
 
   int numSpectra = static_cast<int>(wksp->getNumberHistograms());
+  // Each thread sorts its events into its own lists of events near peaks
+  std::vector<EventListMap> threadLists(PARALLEL_GET_MAX_THREADS);
   PARALLEL_FOR_IF(Kernel::threadSafe(*wksp))
   for (int i = 0; i < numSpectra; ++i) {
     PARALLEL_START_INTERUPT_REGION
@@ -113,12 +115,15 @@ void IntegrateEllipsoids::qListFromEventWS(Integrate3DEvents &integrator,
         qVec = UBinv * qVec;
       qList.emplace_back(raw_event.m_weight, qVec);
     } // end of loop over events in list
-    PARALLEL_CRITICAL(addEvents) { integrator.addEvents(qList, hkl_integ); }
+    integrator.addEvents(qList, hkl_integ,
+                          threadLists[PARALLEL_THREAD_NUMBER]);
 
     prog.report();
     PARALLEL_END_INTERUPT_REGION
   } // end of loop over spectra
   PARALLEL_CHECK_INTERUPT_REGION
+  for (auto &eventLists : threadLists)
+    integrator.addEventLists(eventLists);
 }
 
 /**
@@ -139,6 +144,8 @@ void IntegrateEllipsoids::qListFromHistoWS(Integrate3DEvents &integrator,
   // loop through the eventlists
 
   int numSpectra = static_cast<int>(wksp->getNumberHistograms());
+  // Each thread sorts its events into its own lists of events near peaks
+  std::vector<EventListMap> threadLists(PARALLEL_GET_MAX_THREADS);
   PARALLEL_FOR_IF(Kernel::threadSafe(*wksp))
   for (int i = 0; i < numSpectra; ++i) {
     PARALLEL_START_INTERUPT_REGION
@@ -189,11 +196,14 @@ void IntegrateEllipsoids::qListFromHistoWS(Integrate3DEvents &integrator,
         qList.emplace_back(yVal, qVec);
       }
     }
-    PARALLEL_CRITICAL(addHisto) { integrator.addEvents(qList, hkl_integ); }
+    integrator.addEvents(qList, hkl_integ,
+                          threadLists[PARALLEL_THREAD_NUMBER]);
     prog.report();
     PARALLEL_END_INTERUPT_REGION
   } // end of loop over spectra
   PARALLEL_CHECK_INTERUPT_REGION
+  for (auto &eventLists : threadLists)
+    integrator.addEventLists(eventLists);
 }
 
 /** NOTE: This has been adapted from the SaveIsawQvector algorithm.
@@ -434,14 +444,18 @@ void IntegrateEllipsoids::exec() {
     qListFromHistoWS(integrator, prog, histoWS, UBinv, hkl_integ);
   }
 
-  double inti;
-  double sigi;
-  std::vector<double> principalaxis1, principalaxis2, principalaxis3;
-  V3D peak_q;
-  for (size_t i = 0; i < n_peaks; i++) {
+  // The peaks are integrated in parallel, keeping the axes of each peak so
+  // they are gathered in the order of the peaks afterwards
+  std::vector<std::vector<double>> peakAxesRadii(n_peaks);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t j = 0; j < static_cast<int64_t>(n_peaks); j++) {
+    PARALLEL_START_INTERUPT_REGION
+    const auto i = static_cast<size_t>(j);
     V3D hkl(peaks[i].getH(), peaks[i].getK(), peaks[i].getL());
     if (Geometry::IndexingUtils::ValidIndex(hkl, 1.0)) {
-      peak_q = peaks[i].getQLabFrame();
+      const V3D peak_q = peaks[i].getQLabFrame();
+      double inti;
+      double sigi;
       std::vector<double> axes_radii;
       // modulus of Q
       double lenQpeak = 0.0;
@@ -480,15 +494,23 @@ void IntegrateEllipsoids::exec() {
       peaks[i].setPeakShape(shape);
       if (axes_radii.size() == 3) {
         if (inti / sigi > cutoffIsigI || cutoffIsigI == EMPTY_DBL()) {
-          principalaxis1.push_back(axes_radii[0]);
-          principalaxis2.push_back(axes_radii[1]);
-          principalaxis3.push_back(axes_radii[2]);
+          peakAxesRadii[i] = std::move(axes_radii);
         }
       }
     } else {
       peaks[i].setIntensity(0.0);
       peaks[i].setSigmaIntensity(0.0);
     }
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+  std::vector<double> principalaxis1, principalaxis2, principalaxis3;
+  for (const auto &axes_radii : peakAxesRadii) {
+    if (axes_radii.size() == 3) {
+      principalaxis1.push_back(axes_radii[0]);
+      principalaxis2.push_back(axes_radii[1]);
+      principalaxis3.push_back(axes_radii[2]);
+    }
   }
   if (principalaxis1.size() > 1) {
     Statistics stats1 = getStatistics(principalaxis1);
@@ -536,26 +558,35 @@ void IntegrateEllipsoids::exec() {
       back_outer_radius = peak_radius * 1.25992105; // A factor of 2 ^ (1/3)
                                                     // will make the background
       // shell volume equal to the peak region volume.
-      V3D peak_q;
-      for (size_t i = 0; i < n_peaks; i++) {
+      for (auto &axes_radii : peakAxesRadii)
+        axes_radii.clear();
+      PARALLEL_FOR_NO_WSP_CHECK()
+      for (int64_t j = 0; j < static_cast<int64_t>(n_peaks); j++) {
+        PARALLEL_START_INTERUPT_REGION
+        const auto i = static_cast<size_t>(j);
         V3D hkl(peaks[i].getH(), peaks[i].getK(), peaks[i].getL());
         if (Geometry::IndexingUtils::ValidIndex(hkl, 1.0)) {
-          peak_q = peaks[i].getQLabFrame();
-          std::vector<double> axes_radii;
+          const V3D peak_q = peaks[i].getQLabFrame();
+          double inti;
+          double sigi;
           integrator.ellipseIntegrateEvents(
               E1Vec, peak_q, specify_size, peak_radius, back_inner_radius,
-              back_outer_radius, axes_radii, inti, sigi);
+              back_outer_radius, peakAxesRadii[i], inti, sigi);
           peaks[i].setIntensity(inti);
           peaks[i].setSigmaIntensity(sigi);
-          if (axes_radii.size() == 3) {
-            principalaxis1.push_back(axes_radii[0]);
-            principalaxis2.push_back(axes_radii[1]);
-            principalaxis3.push_back(axes_radii[2]);
-          }
         } else {
           peaks[i].setIntensity(0.0);
           peaks[i].setSigmaIntensity(0.0);
         }
+        PARALLEL_END_INTERUPT_REGION
+      }
+      PARALLEL_CHECK_INTERUPT_REGION
+      for (const auto &axes_radii : peakAxesRadii) {
+        if (axes_radii.size() == 3) {
+          principalaxis1.push_back(axes_radii[0]);
+          principalaxis2.push_back(axes_radii[1]);
+          principalaxis3.push_back(axes_radii[2]);
+        }
       }
       if (principalaxis1.size() > 1) {
         size_t histogramNumber = 3;
@@ -219,51 +219,69 @@ void IntegrateEllipsoidsTwoStep::exec() {
 
   std::vector<std::pair<int, V3D>> weakPeaks, strongPeaks;
 
+  // The parameters are made up front as reading the properties is not
+  // thread safe, then the peaks are integrated in parallel
+  const auto nPeaks = static_cast<int>(qList.size());
+  std::vector<IntegrationParameters> peakParams;
+  peakParams.reserve(qList.size());
+  for (const auto &item : qList)
+    peakParams.push_back(makeIntegrationParameters(item.second));
+
   // Compute signal to noise ratio for all peaks
-  int index = 0;
-  for (const auto &item : qList) {
-    const auto center = item.second;
-    IntegrationParameters params = makeIntegrationParameters(center);
-    auto sig2noise = integrator.estimateSignalToNoiseRatio(params, center);
+  std::vector<double> sig2noise(qList.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int index = 0; index < nPeaks; ++index) {
+    PARALLEL_START_INTERUPT_REGION
+    sig2noise[index] = integrator.estimateSignalToNoiseRatio(
+        peakParams[index], qList[index].second);
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
 
+  for (int index = 0; index < nPeaks; ++index) {
+    const auto center = qList[index].second;
     auto &peak = peak_ws->getPeak(index);
     peak.setIntensity(0);
     peak.setSigmaIntensity(0);
 
     const auto result = std::make_pair(index, center);
-    if (sig2noise < weakPeakThreshold) {
+    if (sig2noise[index] < weakPeakThreshold) {
       g_log.notice() << "Peak " << peak.getHKL() << " with Q = " << center
-                     << " is a weak peak with signal to noise " << sig2noise
-                     << "\n";
+                     << " is a weak peak with signal to noise "
+                     << sig2noise[index] << "\n";
       weakPeaks.push_back(result);
     } else {
       g_log.notice() << "Peak " << peak.getHKL() << " with Q = " << center
-                     << " is a strong peak with signal to noise " << sig2noise
-                     << "\n";
+                     << " is a strong peak with signal to noise "
+                     << sig2noise[index] << "\n";
       strongPeaks.push_back(result);
     }
-    ++index;
   }
 
   std::vector<std::pair<boost::shared_ptr<const Geometry::PeakShape>,
                         std::tuple<double, double, double>>>
-      shapeLibrary;
+      shapeLibrary(strongPeaks.size());
 
   // Integrate strong peaks
-  for (const auto &item : strongPeaks) {
-    const auto index = item.first;
-    const auto q = item.second;
+  const auto nStrong = static_cast<int>(strongPeaks.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nStrong; ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    const auto index = strongPeaks[i].first;
+    const auto q = strongPeaks[i].second;
     double inti, sigi;
 
-    IntegrationParameters params = makeIntegrationParameters(q);
-    const auto result = integrator.integrateStrongPeak(params, q, inti, sigi);
-    shapeLibrary.push_back(result);
+    const auto result =
+        integrator.integrateStrongPeak(peakParams[index], q, inti, sigi);
+    shapeLibrary[i] = result;
 
     auto &peak = peak_ws->getPeak(index);
     peak.setIntensity(inti);
     peak.setSigmaIntensity(sigi);
     peak.setPeakShape(std::get<0>(result));
+    PARALLEL_END_INTERUPT_REGION
   }
+  PARALLEL_CHECK_INTERUPT_REGION
 
   std::vector<Eigen::Vector3d> points;
   std::transform(strongPeaks.begin(), strongPeaks.end(),
@@ -279,36 +297,52 @@ void IntegrateEllipsoidsTwoStep::exec() {
 
   NearestNeighbours<3> kdTree(points);
 
-  // Integrate weak peaks
-  for (const auto &item : weakPeaks) {
-    double inti, sigi;
-    const auto index = item.first;
-    const auto q = item.second;
+  // Find the strong peak to integrate each weak peak like
+  std::vector<int> weakPeakLibraryIndex(weakPeaks.size());
+  for (size_t i = 0; i < weakPeaks.size(); ++i) {
+    const auto index = weakPeaks[i].first;
+    const auto q = weakPeaks[i].second;
 
     const auto result = kdTree.findNearest(Eigen::Vector3d(q[0], q[1], q[2]));
     const auto strongIndex = static_cast<int>(std::get<1>(result[0]));
+    weakPeakLibraryIndex[i] = strongIndex;
 
     auto &peak = peak_ws->getPeak(index);
     auto &strongPeak = peak_ws->getPeak(strongIndex);
 
     g_log.notice() << "Integrating weak peak " << peak.getHKL()
                    << " using strong peak " << strongPeak.getHKL() << "\n";
+    g_log.notice() << "Weak peak will be adjusted by "
+                   << std::get<0>(shapeLibrary[strongIndex].second) << "\n";
+  }
+
+  // Integrate weak peaks
+  const auto nWeak = static_cast<int>(weakPeaks.size());
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int i = 0; i < nWeak; ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    double inti, sigi;
+    const auto index = weakPeaks[i].first;
+    const auto q = weakPeaks[i].second;
+    const auto strongIndex = weakPeakLibraryIndex[i];
 
-    const auto libShape = shapeLibrary[static_cast<int>(strongIndex)];
+    const auto &libShape = shapeLibrary[strongIndex];
     const auto shape =
         boost::dynamic_pointer_cast<const PeakShapeEllipsoid>(libShape.first);
-    const auto frac = std::get<0>(libShape.second);
-
-    g_log.notice() << "Weak peak will be adjusted by " << frac << "\n";
-    IntegrationParameters params =
-        makeIntegrationParameters(strongPeak.getQLabFrame());
+    // strongIndex indexes the strong peak list but, as before the loop was
+    // parallelised, the parameters are those of the peak at that index in
+    // the workspace
+    const auto &params = peakParams[strongIndex];
     const auto weakShape = integrator.integrateWeakPeak(
         params, shape, libShape.second, q, inti, sigi);
 
+    auto &peak = peak_ws->getPeak(index);
     peak.setIntensity(inti);
     peak.setSigmaIntensity(sigi);
     peak.setPeakShape(weakShape);
+    PARALLEL_END_INTERUPT_REGION
   }
+  PARALLEL_CHECK_INTERUPT_REGION
 
   // This flag is used by the PeaksWorkspace to evaluate whether it has been
   // integrated.
@@ -376,6 +410,8 @@ void IntegrateEllipsoidsTwoStep::qListFromEventWS(Integrate3DEvents &integrator,
   m_targWSDescr.m_PreprDetTable = table;
 
   int numSpectra = static_cast<int>(wksp->getNumberHistograms());
+  // Each thread sorts its events into its own lists of events near peaks
+  std::vector<EventListMap> threadLists(PARALLEL_GET_MAX_THREADS);
   PARALLEL_FOR_IF(Kernel::threadSafe(*wksp))
   for (int i = 0; i < numSpectra; ++i) {
     PARALLEL_START_INTERUPT_REGION
@@ -423,12 +459,15 @@ void IntegrateEllipsoidsTwoStep::qListFromEventWS(Integrate3DEvents &integrator,
         qVec = UBinv * qVec;
       qList.emplace_back(raw_event.m_weight, qVec);
     } // end of loop over events in list
-    PARALLEL_CRITICAL(addEvents) { integrator.addEvents(qList, hkl_integ); }
+    integrator.addEvents(qList, hkl_integ,
+                          threadLists[PARALLEL_THREAD_NUMBER]);
 
     prog.report();
     PARALLEL_END_INTERUPT_REGION
   } // end of loop over spectra
   PARALLEL_CHECK_INTERUPT_REGION
+  for (auto &eventLists : threadLists)
+    integrator.addEventLists(eventLists);
 }
 
 /**
@@ -474,6 +513,8 @@ void IntegrateEllipsoidsTwoStep::qListFromHistoWS(Integrate3DEvents &integrator,
     m_targWSDescr.m_PreprDetTable = table;
 
   int numSpectra = static_cast<int>(wksp->getNumberHistograms());
+  // Each thread sorts its events into its own lists of events near peaks
+  std::vector<EventListMap> threadLists(PARALLEL_GET_MAX_THREADS);
   PARALLEL_FOR_IF(Kernel::threadSafe(*wksp))
   for (int i = 0; i < numSpectra; ++i) {
     PARALLEL_START_INTERUPT_REGION
@@ -518,11 +559,14 @@ void IntegrateEllipsoidsTwoStep::qListFromHistoWS(Integrate3DEvents &integrator,
         qList.emplace_back(yVal, qVec);
       }
     }
-    PARALLEL_CRITICAL(addHisto) { integrator.addEvents(qList, hkl_integ); }
+    integrator.addEvents(qList, hkl_integ,
+                          threadLists[PARALLEL_THREAD_NUMBER]);
     prog.report();
     PARALLEL_END_INTERUPT_REGION
   } // end of loop over spectra
   PARALLEL_CHECK_INTERUPT_REGION
+  for (auto &eventLists : threadLists)
+    integrator.addEventLists(eventLists);
 }
 
 /*
@@ -44,6 +44,11 @@ using namespace Mantid::API;
 using namespace Mantid::Geometry;
 using namespace Mantid::DataObjects;
 
+namespace {
+/// Number of events read from the file at once when loading into memory
+constexpr uint64_t EVENTS_PER_BLOCK = 1 << 20;
+} // namespace
+
 namespace Mantid {
 namespace MDAlgorithms {
 
@@ -589,20 +594,43 @@ void LoadMD::doLoad(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     const std::vector<uint64_t> &BoxEventIndex = FlatBoxTree.getEventIndex();
     prog->setNumSteps(numBoxes);
 
-    for (size_t i = 0; i < numBoxes; i++) {
-      prog->report();
-      MDBox<MDE, nd> *box = dynamic_cast<MDBox<MDE, nd> *>(boxTree[i]);
-      if (!box)
+    // Load in memory NOT using the file as the back-end. Boxes lying one
+    // after the other in the file are read together in one block, and their
+    // events are then converted in parallel.
+    size_t first = 0;
+    while (first < numBoxes) {
+      if (!dynamic_cast<MDBox<MDE, nd> *>(boxTree[first]) ||
+          BoxEventIndex[2 * first + 1] == 0) {
+        prog->report();
+        ++first;
         continue;
+      }
+      const uint64_t blockStart = BoxEventIndex[2 * first];
+      uint64_t blockEnd = blockStart + BoxEventIndex[2 * first + 1];
+      size_t last = first + 1;
+      while (last < numBoxes && blockEnd - blockStart < EVENTS_PER_BLOCK &&
+             dynamic_cast<MDBox<MDE, nd> *>(boxTree[last]) &&
+             BoxEventIndex[2 * last + 1] > 0 &&
+             BoxEventIndex[2 * last] == blockEnd) {
+        blockEnd += BoxEventIndex[2 * last + 1];
+        ++last;
+      }
 
-      if (BoxEventIndex[2 * i + 1] >
-          0) // Load in memory NOT using the file as the back-end,
-      {
-        boxTree[i]->reserveMemoryForLoad(BoxEventIndex[2 * i + 1]);
-        boxTree[i]->loadAndAddFrom(
-            loader.get(), BoxEventIndex[2 * i],
-            static_cast<size_t>(BoxEventIndex[2 * i + 1]));
+      std::vector<coord_t> block;
+      loader->loadBlock(block, blockStart,
+                        static_cast<size_t>(blockEnd - blockStart));
+      const size_t nColumns = block.size() / (blockEnd - blockStart);
+      PARALLEL_FOR_NO_WSP_CHECK()
+      for (int64_t i = static_cast<int64_t>(first);
+           i < static_cast<int64_t>(last); ++i) {
+        const auto begin =
+            block.cbegin() + (BoxEventIndex[2 * i] - blockStart) * nColumns;
+        const auto end = begin + BoxEventIndex[2 * i + 1] * nColumns;
+        boxTree[i]->setEventsData(std::vector<coord_t>(begin, end));
       }
+      for (size_t i = first; i < last; ++i)
+        prog->report();
+      first = last;
     }
     loader->closeFile();
   } else // box structure and metadata only
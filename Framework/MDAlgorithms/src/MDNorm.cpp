@@ -28,8 +28,14 @@
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/Strings.h"
 #include "MantidKernel/VisibleWhenProperty.h"
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 namespace Mantid {
 namespace MDAlgorithms {
 
@@ -433,6 +439,8 @@ void MDNorm::exec() {
   this->setProperty("OutputDataWorkspace", outputDataWS);
 
   m_numExptInfos = outputDataWS->getNumExperimentInfo();
+  // The normalization from all experiment infos and symmetry operations
+  std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
   // loop over all experiment infos
   for (uint16_t expInfoIndex = 0; expInfoIndex < m_numExptInfos;
        expInfoIndex++) {
@@ -447,7 +455,8 @@ void MDNorm::exec() {
     if (!skipNormalization) {
       size_t symmOpsIndex = 0;
       for (const auto &so : symmetryOps) {
-        calculateNormalization(otherValues, so, expInfoIndex, symmOpsIndex);
+        calculateNormalization(otherValues, so, expInfoIndex, symmOpsIndex,
+                               signalArray);
         symmOpsIndex++;
       }
 
@@ -455,8 +464,15 @@ void MDNorm::exec() {
       g_log.warning("Binning limits are outside the limits of the MDWorkspace. "
                     "Not applying normalization.");
     }
-    // if more than one experiment info, keep accumulating
-    m_accumulate = true;
+  }
+  if (m_accumulate) {
+    std::transform(
+        signalArray.cbegin(), signalArray.cend(), m_normWS->getSignalArray(),
+        m_normWS->getSignalArray(),
+        [](const std::atomic<signal_t> &a, const signal_t &b) { return a + b; });
+  } else {
+    std::copy(signalArray.cbegin(), signalArray.cend(),
+              m_normWS->getSignalArray());
   }
   IAlgorithm_sptr divideMD = createChildAlgorithm("DivideMD", 0.99, 1.);
   divideMD->setProperty("LHSWorkspace", outputDataWS);
@@ -889,17 +905,270 @@ void MDNorm::cacheDimensionXValues() {
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Trajectories calculated by earlier runs of the algorithm. Normalizing the
+ * same runs again, e.g. with different data or with a subset of the runs,
+ * then skips recalculating them. The least recently used trajectories are
+ * dropped to keep the cache within the size set by MDNorm.TrajectoryCacheSize
+ * (in MB).
+ *
+ * The per-detector inputs (angles, masking and momentum limits) are only
+ * stored as a hash, the other inputs are compared exactly.
+ */
+class MDNorm::TrajectoryCache {
+public:
+  /// Everything the trajectories of one run and symmetry operation depend on
+  struct Key {
+    /// Number of detectors
+    size_t numberOfDetectors;
+    /// Hash of the angles, masking and momentum limits of all detectors
+    size_t detectorHash;
+    /// The transforms, binning and other small inputs
+    std::vector<double> parameters;
+
+    bool operator==(const Key &other) const {
+      return numberOfDetectors == other.numberOfDetectors &&
+             detectorHash == other.detectorHash &&
+             parameters == other.parameters;
+    }
+  };
+
+  std::shared_ptr<const Trajectories> find(const Key &key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto entry = m_index.find(key);
+    if (entry == m_index.end())
+      return nullptr;
+    m_entries.splice(m_entries.begin(), m_entries, entry->second);
+    ++m_hits;
+    return m_entries.front().trajectories;
+  }
+
+  void insert(const Key &key,
+              std::shared_ptr<const Trajectories> trajectories) {
+    const size_t capacity = capacityInBytes();
+    size_t bytes = key.parameters.size() * sizeof(double);
+    for (const auto &trajectory : *trajectories)
+      bytes += sizeof(DetectorTrajectory) +
+               trajectory.momenta.size() * sizeof(double) +
+               trajectory.bins.size() * sizeof(size_t);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto existing = m_index.find(key);
+    if (existing != m_index.end())
+      erase(existing->second);
+    while (!m_entries.empty() && m_bytes + bytes > capacity)
+      erase(std::prev(m_entries.end()));
+    if (bytes > capacity)
+      return;
+    m_entries.push_front({key, std::move(trajectories), bytes});
+    m_index.emplace(key, m_entries.begin());
+    m_bytes += bytes;
+  }
+
+  TrajectoryCacheStatistics statistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_entries.size(), m_hits};
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+    m_bytes = 0;
+    m_hits = 0;
+  }
+
+private:
+  static size_t capacityInBytes() {
+    auto megabytes = ConfigService::Instance().getValue<double>(
+        "MDNorm.TrajectoryCacheSize");
+    return static_cast<size_t>(std::max(megabytes.value_or(1024.), 0.) *
+                               1024. * 1024.);
+  }
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      size_t seed = key.detectorHash;
+      boost::hash_combine(seed, key.numberOfDetectors);
+      boost::hash_range(seed, key.parameters.begin(), key.parameters.end());
+      return seed;
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<const Trajectories> trajectories;
+    size_t bytes;
+  };
+
+  void erase(std::list<Entry>::iterator entry) {
+    m_bytes -= entry->bytes;
+    m_index.erase(entry->key);
+    m_entries.erase(entry);
+  }
+
+  /// Most recently used first
+  std::list<Entry> m_entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+  size_t m_bytes{0};
+  size_t m_hits{0};
+  std::mutex m_mutex;
+};
+
+/// The cache shared by all instances of the algorithm
+MDNorm::TrajectoryCache &MDNorm::trajectoryCache() {
+  static TrajectoryCache cache;
+  return cache;
+}
+
+/// @return the number of entries in the trajectory cache and the number of
+/// times it was used since it was last cleared
+MDNorm::TrajectoryCacheStatistics MDNorm::trajectoryCacheStatistics() {
+  return trajectoryCache().statistics();
+}
+
+/// Drop all trajectories calculated by earlier runs
+void MDNorm::clearTrajectoryCache() { trajectoryCache().clear(); }
+
+/**
+ * Get the trajectories of all detectors through the normalization workspace
+ * for one experiment info and symmetry operation, calculating them in
+ * parallel unless an earlier run already did.
+ * @param otherValues - values for dimensions other than Q or DeltaE
+ * @param Qtransform - matrix to convert from Q_lab to HKL
+ * @param lowValues - lowest momentum or energy transfer for each detector
+ * @param highValues - highest momentum or energy transfer for each detector
+ * @param spectrumInfo - spectrum info of the experiment info
+ * @return the trajectory of each spectrum, empty for those not measured
+ */
+std::shared_ptr<const MDNorm::Trajectories>
+MDNorm::getTrajectories(const std::vector<coord_t> &otherValues,
+                        const DblMatrix &Qtransform,
+                        const std::vector<double> &lowValues,
+                        const std::vector<double> &highValues,
+                        const SpectrumInfo &spectrumInfo) {
+  const int64_t ndets = static_cast<int64_t>(spectrumInfo.size());
+  // Angles of each detector, -1 for those that are not used
+  std::vector<double> thetas(ndets, -1.), phis(ndets, 0.);
+  PRAGMA_OMP(parallel for)
+  for (int64_t i = 0; i < ndets; i++) {
+    if (!spectrumInfo.hasDetectors(i) || spectrumInfo.isMonitor(i) ||
+        spectrumInfo.isMasked(i))
+      continue;
+    const auto &detector = spectrumInfo.detector(i);
+    thetas[i] = detector.getTwoTheta(m_samplePos, m_beamDir);
+    phis[i] = detector.getPhi();
+  }
+
+  // Everything the trajectories depend on
+  TrajectoryCache::Key key;
+  key.numberOfDetectors = static_cast<size_t>(ndets);
+  key.detectorHash = boost::hash_range(thetas.begin(), thetas.end());
+  boost::hash_range(key.detectorHash, phis.begin(), phis.end());
+  boost::hash_range(key.detectorHash, lowValues.begin(), lowValues.end());
+  boost::hash_range(key.detectorHash, highValues.begin(), highValues.end());
+  auto &parameters = key.parameters;
+  parameters = Qtransform.getVector();
+  parameters.push_back(convention == "Crystallography" ? 1. : 0.);
+  parameters.push_back(m_diffraction ? 1. : 0.);
+  parameters.push_back(m_dEIntegrated ? 1. : 0.);
+  parameters.push_back(m_Ei);
+  for (const auto *x : {&m_hX, &m_kX, &m_lX, &m_eX}) {
+    parameters.push_back(static_cast<double>(x->size()));
+    parameters.insert(parameters.end(), x->begin(), x->end());
+  }
+  for (size_t d = 0; d < m_normWS->getNumDims(); ++d) {
+    const auto dimension = m_normWS->getDimension(d);
+    parameters.push_back(dimension->getMinimum());
+    parameters.push_back(dimension->getMaximum());
+    parameters.push_back(static_cast<double>(dimension->getNBins()));
+  }
+  const auto transformation = m_transformation.getVector();
+  parameters.insert(parameters.end(), transformation.begin(),
+                    transformation.end());
+  parameters.insert(parameters.end(), otherValues.begin(), otherValues.end());
+
+  auto &cache = trajectoryCache();
+  if (auto cached = cache.find(key)) {
+    g_log.debug("Using cached trajectories for the normalization.");
+    return cached;
+  }
+
+  const size_t vmdDims = (m_diffraction) ? 3 : 4;
+  auto trajectories = std::make_shared<Trajectories>(ndets);
+  std::vector<std::array<double, 4>> intersections;
+  std::vector<coord_t> pos, posNew;
+  PRAGMA_OMP(parallel for schedule(dynamic, 64) private(intersections, pos, posNew))
+  for (int64_t i = 0; i < ndets; i++) {
+    PARALLEL_START_INTERUPT_REGION
+    if (thetas[i] < 0.)
+      continue;
+    this->calculateIntersections(intersections, thetas[i], phis[i], Qtransform,
+                                 lowValues[i], highValues[i]);
+    if (intersections.empty())
+      continue;
+
+    auto &trajectory = (*trajectories)[i];
+    trajectory.momenta.resize(intersections.size());
+    std::transform(intersections.cbegin(), intersections.cend(),
+                   trajectory.momenta.begin(),
+                   [](const std::array<double, 4> &intersection) {
+                     return intersection[3];
+                   });
+    trajectory.bins.assign(intersections.size() - 1, size_t(-1));
+
+    // Compute final position in HKL
+    // pre-allocate for efficiency and copy non-hkl dim values into place
+    pos.resize(vmdDims + otherValues.size());
+    std::copy(otherValues.begin(), otherValues.end(), pos.begin() + vmdDims);
+    for (size_t k = 1; k < intersections.size(); ++k) {
+      const auto &curIntSec = intersections[k];
+      const auto &prevIntSec = intersections[k - 1];
+      // the full vector isn't used so compute only what is necessary
+      double delta, eps;
+      if (m_diffraction) {
+        delta = curIntSec[3] - prevIntSec[3];
+        eps = 1e-7;
+      } else {
+        delta = (curIntSec[3] * curIntSec[3] - prevIntSec[3] * prevIntSec[3]) /
+                energyToK;
+        eps = 1e-10;
+      }
+      if (delta < eps)
+        continue; // Assume zero contribution if difference is small
+      // Average between two intersections for final position
+      std::transform(curIntSec.data(), curIntSec.data() + vmdDims,
+                     prevIntSec.data(), pos.begin(),
+                     [](const double rhs, const double lhs) {
+                       return static_cast<coord_t>(0.5 * (rhs + lhs));
+                     });
+      if (!m_diffraction) {
+        // transform kf to energy transfer
+        pos[3] = static_cast<coord_t>(m_Ei - pos[3] * pos[3] / energyToK);
+      }
+      m_transformation.multiplyPoint(pos, posNew);
+      trajectory.bins[k - 1] = m_normWS->getLinearIndexAtCoord(posNew.data());
+    }
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  cache.insert(key, trajectories);
+  return trajectories;
+}
+
 /**
- * Computed the normalization for the input workspace. Results are stored in
- * m_normWS
+ * Computed the normalization for the input workspace and add it to the
+ * accumulated signal
  * @param otherValues - values for dimensions other than Q or DeltaE
  * @param so - symmetry operation
  * @param expInfoIndex - current experiment info index
  * @param soIndex - the index of symmetry operation (for progress purposes)
+ * @param signalArray - the normalization accumulated so far
  */
-void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
-                                    Geometry::SymmetryOperation so,
-                                    uint16_t expInfoIndex, size_t soIndex) {
+void MDNorm::calculateNormalization(
+    const std::vector<coord_t> &otherValues, Geometry::SymmetryOperation so,
+    uint16_t expInfoIndex, size_t soIndex,
+    std::vector<std::atomic<signal_t>> &signalArray) {
   const auto &currentExptInfo = *(m_inputWS->getExperimentInfo(expInfoIndex));
   std::vector<double> lowValues, highValues;
   auto *lowValuesLog = dynamic_cast<VectorDoubleProperty *>(
@@ -939,11 +1208,9 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
     fluxDetToIdx = integrFlux->getDetectorIDToWorkspaceIndexMap();
   }
 
-  const size_t vmdDims = (m_diffraction) ? 3 : 4;
-  std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
-  std::vector<std::array<double, 4>> intersections;
-  std::vector<double> xValues, yValues;
-  std::vector<coord_t> pos, posNew;
+  const auto trajectories = getTrajectories(otherValues, Qtransform, lowValues,
+                                            highValues, spectrumInfo);
+  std::vector<double> yValues;
 
   double progStep = 0.7 / static_cast<double>(m_numExptInfos * m_numSymmOps);
   double progIndex = static_cast<double>(soIndex + expInfoIndex * m_numSymmOps);
@@ -956,26 +1223,16 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
     safe = Kernel::threadSafe(*integrFlux);
   }
   // cppcheck-suppress syntaxError
-PRAGMA_OMP(parallel for private(intersections, xValues, yValues, pos, posNew) if (safe))
+PRAGMA_OMP(parallel for schedule(dynamic, 64) private(yValues) if (safe))
 for (int64_t i = 0; i < ndets; i++) {
   PARALLEL_START_INTERUPT_REGION
 
-  if (!spectrumInfo.hasDetectors(i) || spectrumInfo.isMonitor(i) ||
-      spectrumInfo.isMasked(i)) {
+  const auto &trajectory = (*trajectories)[i];
+  if (trajectory.momenta.empty())
     continue;
-  }
 
-  const auto &detector = spectrumInfo.detector(i);
-  double theta = detector.getTwoTheta(m_samplePos, m_beamDir);
-  double phi = detector.getPhi();
   // If the dtefctor is a group, this should be the ID of the first detector
-  const auto detID = detector.getID();
-
-  // Intersections
-  this->calculateIntersections(intersections, theta, phi, Qtransform,
-                               lowValues[i], highValues[i]);
-  if (intersections.empty())
-    continue;
+  const auto detID = spectrumInfo.detector(i).getID();
   // Get solid angle for this contribution
   double solid = protonCharge;
   if (haveSA) {
@@ -983,69 +1240,32 @@ for (int64_t i = 0; i < ndets; i++) {
         solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0] * protonCharge;
   }
 
+  const auto &momenta = trajectory.momenta;
   if (m_diffraction) {
     // -- calculate integrals for the intersection --
-    // momentum values at intersections
-    auto intersectionsBegin = intersections.begin();
-    // copy momenta to xValues
-    xValues.resize(intersections.size());
-    yValues.resize(intersections.size());
-    auto x = xValues.begin();
-    for (auto it = intersectionsBegin; it != intersections.end(); ++it, ++x) {
-      *x = (*it)[3];
-    }
+    yValues.resize(momenta.size());
     // get the flux spetrum number
     size_t wsIdx = fluxDetToIdx.find(detID)->second;
-    // calculate integrals at momenta from xValues by interpolating between
-    // points in spectrum sp
-    // of workspace integrFlux. The result is stored in yValues
-    calcIntegralsForIntersections(xValues, *integrFlux, wsIdx, yValues);
+    // calculate integrals at momenta by interpolating between points in
+    // spectrum sp of workspace integrFlux. The result is stored in yValues
+    calcIntegralsForIntersections(momenta, *integrFlux, wsIdx, yValues);
   }
 
-  // Compute final position in HKL
-  // pre-allocate for efficiency and copy non-hkl dim values into place
-  pos.resize(vmdDims + otherValues.size());
-  std::copy(otherValues.begin(), otherValues.end(), pos.begin() + vmdDims);
-
-  auto intersectionsBegin = intersections.begin();
-  for (auto it = intersectionsBegin + 1; it != intersections.end(); ++it) {
-    const auto &curIntSec = *it;
-    const auto &prevIntSec = *(it - 1);
-    // the full vector isn't used so compute only what is necessary
-    double delta, eps;
-    if (m_diffraction) {
-      delta = curIntSec[3] - prevIntSec[3];
-      eps = 1e-7;
-    } else {
-      delta = (curIntSec[3] * curIntSec[3] - prevIntSec[3] * prevIntSec[3]) /
-              energyToK;
-      eps = 1e-10;
-    }
-    if (delta < eps)
-      continue; // Assume zero contribution if difference is small
-    // Average between two intersections for final position
-    std::transform(curIntSec.data(), curIntSec.data() + vmdDims,
-                   prevIntSec.data(), pos.begin(),
-                   [](const double rhs, const double lhs) {
-                     return static_cast<coord_t>(0.5 * (rhs + lhs));
-                   });
+  for (size_t k = 1; k < momenta.size(); ++k) {
+    const size_t linIndex = trajectory.bins[k - 1];
+    if (linIndex == size_t(-1))
+      continue;
     signal_t signal;
     if (m_diffraction) {
-      // index of the current intersection
-      size_t k = static_cast<size_t>(std::distance(intersectionsBegin, it));
       // signal = integral between two consecutive intersections
       signal = (yValues[k] - yValues[k - 1]) * solid;
     } else {
-      // transform kf to energy transfer
-      pos[3] = static_cast<coord_t>(m_Ei - pos[3] * pos[3] / energyToK);
       // signal = energy distance between two consecutive intersections *solid
       // angle *PC
-      signal = solid * delta;
+      signal = solid * (momenta[k] * momenta[k] -
+                        momenta[k - 1] * momenta[k - 1]) /
+               energyToK;
     }
-    m_transformation.multiplyPoint(pos, posNew);
-    size_t linIndex = m_normWS->getLinearIndexAtCoord(posNew.data());
-    if (linIndex == size_t(-1))
-      continue;
     Mantid::Kernel::AtomicOp(signalArray[linIndex], signal,
                              std::plus<signal_t>());
   }
@@ -1055,16 +1275,6 @@ for (int64_t i = 0; i < ndets; i++) {
   PARALLEL_END_INTERUPT_REGION
 }
 PARALLEL_CHECK_INTERUPT_REGION
-if (m_accumulate) {
-  std::transform(
-      signalArray.cbegin(), signalArray.cend(), m_normWS->getSignalArray(),
-      m_normWS->getSignalArray(),
-      [](const std::atomic<signal_t> &a, const signal_t &b) { return a + b; });
-} else {
-  std::copy(signalArray.cbegin(), signalArray.cend(),
-            m_normWS->getSignalArray());
-}
-m_accumulate = true;
 }
 
 /**
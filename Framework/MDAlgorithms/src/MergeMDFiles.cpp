@@ -11,6 +11,7 @@
 #include "MantidDataObjects/MDBoxBase.h"
 #include "MantidDataObjects/MDEventFactory.h"
 #include "MantidKernel/CPUTimer.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/Strings.h"
 #include "MantidKernel/System.h"
 #include "MantidKernel/VectorHelper.h"
@@ -18,10 +19,20 @@
 #include <Poco/File.h>
 #include <boost/scoped_ptr.hpp>
 
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <numeric>
+
 using namespace Mantid::Kernel;
 using namespace Mantid::API;
 using namespace Mantid::DataObjects;
 
+namespace {
+/// Number of merged events read, merged and written together
+constexpr uint64_t EVENTS_PER_BLOCK = 1 << 22;
+} // namespace
+
 namespace Mantid {
 namespace MDAlgorithms {
 
@@ -33,8 +44,8 @@ DECLARE_ALGORITHM(MergeMDFiles)
  */
 MergeMDFiles::MergeMDFiles()
     : m_nDims(0), m_MDEventType(), m_fileBasedTargetWS(false), m_Filenames(),
-      m_EventLoader(), m_OutIWS(), m_totalEvents(0), m_totalLoaded(0),
-      m_fileMutex(), m_statsMutex() {}
+      m_EventLoader(), m_nEventColumns(0), m_OutIWS(), m_totalEvents(0),
+      m_totalLoaded(0), m_fileMutex(), m_statsMutex() {}
 
 //----------------------------------------------------------------------------------------------
 /** Destructor
@@ -59,9 +70,10 @@ void MergeMDFiles::init() {
       "Optional: if specified, the workspace created will be file-backed. \n"
       "If not, it will be created in memory.");
 
-  declareProperty("Parallel", false,
-                  "Run the loading tasks in parallel.\n"
-                  "This can be faster but might use more memory.");
+  declareProperty("Parallel", true,
+                  "Merge the events of the boxes in parallel and read the "
+                  "next block of events from the input files while merging.\n"
+                  "This is faster but uses more memory.");
 
   declareProperty(make_unique<WorkspaceProperty<IMDEventWorkspace>>(
                       "OutputWorkspace", "", Direction::Output),
@@ -124,6 +136,9 @@ void MergeMDFiles::loadBoxData() {
       m_EventLoader[i]->setDataType(sizeof(coord_t), m_MDEventType);
       m_EventLoader[i]->openFile(m_Filenames[i], "r");
     }
+    m_nEventColumns = static_cast<size_t>(
+        static_cast<BoxControllerNeXusIO *>(m_EventLoader.front())
+            ->getNDataColums());
   } catch (...) {
     // Close all open files in case of error
     clearEventLoaders();
@@ -153,39 +168,184 @@ void MergeMDFiles::loadBoxData() {
                  << " files.\n";
 }
 
-/** Task that loads all of the events from corresponded boxes of all files
- * that is being merged into a particular box in the output workspace.
+//----------------------------------------------------------------------------------------------
+/** Find the range of target boxes merged together, starting at the given box.
+ * The range holds about EVENTS_PER_BLOCK merged events, and at least one box.
+ *
+ * @param firstBox :: index of the first box of the range
+ * @return the index of the box after the range
  */
+size_t MergeMDFiles::findBlockEnd(size_t firstBox) {
+  const std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
+  const std::vector<uint64_t> &targetEventIndexes = m_BoxStruct.getEventIndex();
+  uint64_t nEvents(0);
+  size_t lastBox = firstBox;
+  while (lastBox < boxes.size() && nEvents < EVENTS_PER_BLOCK) {
+    const size_t ID = boxes[lastBox]->getID();
+    if (boxes[lastBox]->isBox())
+      nEvents += targetEventIndexes[2 * ID + 1];
+    ++lastBox;
+  }
+  return lastBox;
+}
 
-uint64_t MergeMDFiles::loadEventsFromSubBoxes(API::IMDNode *TargetBox) {
-  /// get rid of the events and averages which are in the memory erroneously
-  /// (from cloning)
-  TargetBox->clear();
-
-  uint64_t nBoxEvents(0);
-  std::vector<size_t> numFileEvents(m_EventLoader.size());
+//----------------------------------------------------------------------------------------------
+/** Read the events of a range of target boxes from all the input files.
+ * The boxes of a file generated by SaveMD follow each other on the file, so
+ * their events are read from each file with one large sequential read. Files
+ * where the boxes are scattered are read box by box instead.
+ *
+ * @param firstBox :: index of the first box of the range
+ * @param lastBox :: index of the box after the range
+ * @return the events of the boxes in all the files
+ */
+MergeMDFiles::InputEvents MergeMDFiles::readInputEvents(size_t firstBox,
+                                                        size_t lastBox) {
+  const std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
+  InputEvents input;
+  input.firstBox = firstBox;
+  input.lastBox = lastBox;
+  input.data.resize(m_EventLoader.size());
+  input.firstRow.resize(m_EventLoader.size());
+
+  for (size_t iw = 0; iw < m_EventLoader.size(); iw++) {
+    const std::vector<uint64_t> &eventIndex =
+        m_fileComponentsStructure[iw].getEventIndex();
+    std::vector<uint64_t> &firstRow = input.firstRow[iw];
+    firstRow.assign(lastBox - firstBox, 0);
+
+    // Find the part of the file holding the events of the boxes
+    uint64_t spanStart = std::numeric_limits<uint64_t>::max();
+    uint64_t spanEnd(0), nEvents(0);
+    for (size_t ib = firstBox; ib < lastBox; ib++) {
+      const size_t ID = boxes[ib]->getID();
+      if (!boxes[ib]->isBox() || eventIndex[2 * ID + 1] == 0)
+        continue;
+      spanStart = std::min(spanStart, eventIndex[2 * ID]);
+      spanEnd = std::max(spanEnd, eventIndex[2 * ID] + eventIndex[2 * ID + 1]);
+      nEvents += eventIndex[2 * ID + 1];
+    }
+    if (nEvents == 0)
+      continue;
 
-  for (size_t iw = 0; iw < this->m_EventLoader.size(); iw++) {
-    size_t ID = TargetBox->getID();
-    numFileEvents[iw] = static_cast<size_t>(
-        m_fileComponentsStructure[iw].getEventIndex()[2 * ID + 1]);
-    nBoxEvents += numFileEvents[iw];
+    if (spanEnd - spanStart <= 2 * nEvents) {
+      m_EventLoader[iw]->loadBlock(input.data[iw], spanStart,
+                                   static_cast<size_t>(spanEnd - spanStart));
+      for (size_t ib = firstBox; ib < lastBox; ib++) {
+        const size_t ID = boxes[ib]->getID();
+        if (boxes[ib]->isBox() && eventIndex[2 * ID + 1] > 0)
+          firstRow[ib - firstBox] = eventIndex[2 * ID] - spanStart;
+      }
+    } else {
+      std::vector<coord_t> &data = input.data[iw];
+      data.reserve(static_cast<size_t>(nEvents) * m_nEventColumns);
+      std::vector<coord_t> boxData;
+      for (size_t ib = firstBox; ib < lastBox; ib++) {
+        const size_t ID = boxes[ib]->getID();
+        firstRow[ib - firstBox] = data.size() / m_nEventColumns;
+        if (!boxes[ib]->isBox() || eventIndex[2 * ID + 1] == 0)
+          continue;
+        m_EventLoader[iw]->loadBlock(
+            boxData, eventIndex[2 * ID],
+            static_cast<size_t>(eventIndex[2 * ID + 1]));
+        data.insert(data.end(), boxData.cbegin(), boxData.cend());
+      }
+    }
   }
+  return input;
+}
 
-  // At this point memory required is known, so it is reserved all in one go
-  TargetBox->reserveMemoryForLoad(nBoxEvents);
+//----------------------------------------------------------------------------------------------
+/** Merge the events read from all the files into the target boxes. If the
+ * target workspace is in memory the events are given to the boxes, otherwise
+ * the merged events are returned to be written to the file and only the
+ * signal and error of the boxes are set.
+ *
+ * @param input :: the events read from the files
+ * @param parallel :: merge the boxes in parallel
+ * @return the merged events of each box in file layout, if they have to be
+ * written to the target file
+ */
+std::vector<std::vector<coord_t>>
+MergeMDFiles::mergeEvents(const InputEvents &input, bool parallel) {
+  std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
+  std::vector<std::vector<coord_t>> tables(input.lastBox - input.firstBox);
 
-  for (size_t iw = 0; iw < this->m_EventLoader.size(); iw++) {
-    size_t ID = TargetBox->getID();
-    uint64_t fileLocation =
-        m_fileComponentsStructure[iw].getEventIndex()[2 * ID + 0];
-    if (numFileEvents[iw] == 0)
+  PARALLEL_FOR_IF(parallel)
+  for (int64_t i = 0; i < static_cast<int64_t>(tables.size()); ++i) {
+    API::IMDNode *box = boxes[input.firstBox + i];
+    if (!box->isBox())
       continue;
-    TargetBox->loadAndAddFrom(m_EventLoader[iw], fileLocation,
-                              numFileEvents[iw]);
+    const size_t ID = box->getID();
+
+    // At this point memory required is known, so it is reserved all in one go
+    std::vector<coord_t> &table = tables[i];
+    table.reserve(static_cast<size_t>(
+                      m_BoxStruct.getEventIndex()[2 * ID + 1]) *
+                  m_nEventColumns);
+    for (size_t iw = 0; iw < input.data.size(); iw++) {
+      const auto nEvents = static_cast<size_t>(
+          m_fileComponentsStructure[iw].getEventIndex()[2 * ID + 1]);
+      if (nEvents == 0)
+        continue;
+      const auto begin = input.data[iw].cbegin() +
+                         input.firstRow[iw][i] * m_nEventColumns;
+      table.insert(table.end(), begin, begin + nEvents * m_nEventColumns);
+    }
+
+    if (m_fileBasedTargetWS) {
+      // The signal and error are the first two columns of the events
+      signal_t signal(0), errorSquared(0);
+      for (size_t j = 0; j < table.size(); j += m_nEventColumns) {
+        signal += table[j];
+        errorSquared += table[j + 1];
+      }
+      box->setSignal(signal);
+      box->setErrorSquared(errorSquared);
+    } else {
+      box->setEventsData(table);
+      std::vector<coord_t>().swap(table);
+    }
   }
 
-  return nBoxEvents;
+  return tables;
+}
+
+//----------------------------------------------------------------------------------------------
+/** Write the merged events of a range of boxes to the target file. The boxes
+ * are placed one after the other on the file so the events are written in
+ * one go and the boxes are marked as saved.
+ *
+ * @param saver :: the target file
+ * @param firstBox :: index of the first box of the range
+ * @param tables :: the merged events of each box in the range
+ */
+void MergeMDFiles::writeEvents(
+    API::IBoxControllerIO &saver, size_t firstBox,
+    const std::vector<std::vector<coord_t>> &tables) {
+  std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
+  const std::vector<uint64_t> &targetEventIndexes = m_BoxStruct.getEventIndex();
+
+  std::vector<coord_t> block;
+  block.reserve(std::accumulate(
+      tables.cbegin(), tables.cend(), size_t(0),
+      [](size_t size, const std::vector<coord_t> &table) {
+        return size + table.size();
+      }));
+  uint64_t blockStart(0);
+  for (size_t i = 0; i < tables.size(); i++) {
+    if (tables[i].empty())
+      continue;
+    const size_t ID = boxes[firstBox + i]->getID();
+    const uint64_t position = targetEventIndexes[2 * ID];
+    if (block.empty())
+      blockStart = position;
+    block.insert(block.end(), tables[i].cbegin(), tables[i].cend());
+    boxes[firstBox + i]->setFileBacked(
+        position, static_cast<size_t>(targetEventIndexes[2 * ID + 1]), true);
+  }
+  if (!block.empty())
+    saver.saveBlock(block, blockStart);
 }
 
 //----------------------------------------------------------------------------------------------
@@ -202,9 +362,6 @@ void MergeMDFiles::doExecByCloning(Mantid::API::IMDEventWorkspace_sptr ws,
   m_OutIWS = ws;
   m_MDEventType = ws->getEventTypeName();
 
-  // Run the tasks in parallel? TODO: enable
-  // bool Parallel = this->getProperty("Parallel");
-
   // Fix the box controller settings in the output workspace so that it splits
   // normally
   BoxController_sptr bc = ws->getBoxController();
@@ -240,65 +397,40 @@ void MergeMDFiles::doExecByCloning(Mantid::API::IMDEventWorkspace_sptr ws,
   m_progress = Kernel::make_unique<Progress>(this, 0.1, 0.9, size_t(numBoxes));
   m_progress->setNotifyStep(0.1);
 
-  // For tracking progress
-  // uint64_t m_totalEventsInTasks = 0;
-
-  // Prepare thread pool
+  const bool parallel = this->getProperty("Parallel");
   CPUTimer overallTime;
 
-  auto ts = new ThreadSchedulerFIFO();
-  ThreadPool tp(ts);
+  // The boxes are merged in blocks following the order of the boxes on the
+  // files. The next block is read while the current one is merged, and
+  // the merged events are written to the target file sequentially.
+  size_t firstBox = 0;
+  InputEvents input = readInputEvents(firstBox, findBlockEnd(firstBox));
+  while (firstBox < numBoxes) {
+    const size_t lastBox = input.lastBox;
+    std::future<InputEvents> nextInput;
+    if (parallel && lastBox < numBoxes)
+      nextInput = std::async(std::launch::async, [this, lastBox]() {
+        return readInputEvents(lastBox, findBlockEnd(lastBox));
+      });
+
+    auto tables = mergeEvents(input, parallel);
+
+    if (nextInput.valid())
+      input = nextInput.get();
+    else if (lastBox < numBoxes)
+      input = readInputEvents(lastBox, findBlockEnd(lastBox));
+
+    // Only one thread may access the files at a time
+    if (m_fileBasedTargetWS)
+      writeEvents(*saver, firstBox, tables);
 
-  Kernel::DiskBuffer *DiskBuf(nullptr);
-  if (m_fileBasedTargetWS) {
-    DiskBuf = bc->getFileIO();
+    m_progress->reportIncrement(lastBox - firstBox,
+                                "Loading and merging box data");
+    interruption_point();
+    firstBox = lastBox;
   }
-
-  this->m_totalLoaded = 0;
-  std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
-
-  for (size_t ib = 0; ib < numBoxes; ib++) {
-    auto box = boxes[ib];
-    if (!box->isBox())
-      continue;
-    // load all contributed events into current box;
-    this->loadEventsFromSubBoxes(boxes[ib]);
-
-    if (DiskBuf) {
-      if (box->getDataInMemorySize() >
-          0) { // data position has been already pre-calculated
-        box->getISaveable()->save();
-        box->clearDataFromMemory();
-        // Kernel::ISaveable *Saver = box->getISaveable();
-        // DiskBuf->toWrite(Saver);
-      }
-    }
-    // else
-    //{   size_t ID = box->getID();
-    //    uint64_t filePosition = targetEventIndexes[2*ID];
-    //    box->saveAt(saver.get(), filePosition);
-    //}
-    //
-    // if (!Parallel)
-    //{
-    //  // Run the task serially only
-    //  task->run();
-    //  delete task;
-    //}
-    // else
-    //{
-    //  // Enqueue to run in parallel (at the joinAll() call below).
-    //  ts->push(task);
-    //}
-
-    m_progress->reportIncrement(ib, "Loading and merging box data");
-  }
-  if (DiskBuf) {
-    DiskBuf->flushCache();
+  if (m_fileBasedTargetWS)
     bc->getFileIO()->flushData();
-  }
-  //// Run any final tasks
-  // tp.joinAll();
   g_log.information() << overallTime << " to do all the adding.\n";
 
   // Close any open file handle
@@ -23,6 +23,8 @@
 #include "MantidKernel/System.h"
 #include <Poco/File.h>
 
+#include <numeric>
+
 using file_holder_type = std::unique_ptr<::NeXus::File>;
 
 using namespace Mantid::Kernel;
@@ -41,6 +43,61 @@ void prepareUpdate(MDBoxFlatTree &BoxFlatStruct, BoxController *bc,
   // box structure
   BoxFlatStruct.initFlatStructure(ws, filename);
 }
+
+/// Number of events gathered before they are written to the file together
+constexpr uint64_t EVENTS_PER_BLOCK = 1 << 20;
+
+/** Save the events of the boxes. Boxes lying one after the other in the file
+ * are written together in blocks of about EVENTS_PER_BLOCK events, after
+ * their events have been converted to the file layout in parallel.
+ * @param saver :: the open file to write to
+ * @param boxes :: all boxes of the workspace
+ * @param eventIndex :: file position and number of events of each box
+ * @param prog :: progress reporting, one step per box
+ */
+void saveBoxesInBlocks(IBoxControllerIO &saver,
+                       const std::vector<IMDNode *> &boxes,
+                       const std::vector<uint64_t> &eventIndex,
+                       Progress &prog) {
+  size_t first = 0;
+  while (first < boxes.size()) {
+    // Skip the boxes that need not be saved
+    if (eventIndex[2 * first + 1] == 0 || boxes[first]->getIsMasked()) {
+      prog.report("Saving Box");
+      ++first;
+      continue;
+    }
+    // Extend the block over the boxes that follow on in the file
+    const uint64_t blockStart = eventIndex[2 * first];
+    uint64_t blockEnd = blockStart + eventIndex[2 * first + 1];
+    size_t last = first + 1;
+    while (last < boxes.size() && blockEnd - blockStart < EVENTS_PER_BLOCK &&
+           eventIndex[2 * last + 1] > 0 && !boxes[last]->getIsMasked() &&
+           eventIndex[2 * last] == blockEnd) {
+      blockEnd += eventIndex[2 * last + 1];
+      ++last;
+    }
+
+    std::vector<std::vector<Mantid::coord_t>> tables(last - first);
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = 0; i < static_cast<int64_t>(tables.size()); ++i) {
+      size_t nColumns;
+      boxes[first + i]->getEventsData(tables[i], nColumns);
+    }
+    std::vector<Mantid::coord_t> block;
+    block.reserve(std::accumulate(
+        tables.cbegin(), tables.cend(), size_t(0),
+        [](size_t size, const std::vector<Mantid::coord_t> &table) {
+          return size + table.size();
+        }));
+    for (const auto &table : tables)
+      block.insert(block.end(), table.cbegin(), table.cend());
+    saver.saveBlock(block, blockStart);
+    for (size_t i = first; i < last; ++i)
+      prog.report("Saving Box");
+    first = last;
+  }
+}
 } // namespace
 
 namespace Mantid {
@@ -82,6 +139,14 @@ void SaveMD::init() {
   setPropertySettings(
       "MakeFileBacked",
       make_unique<EnabledWhenProperty>("UpdateFileBackEnd", IS_EQUAL_TO, "0"));
+
+  declareProperty("CompressEvents", false,
+                  "Compress the events in the file. The file is smaller and "
+                  "can still be loaded or used as a file back end, but "
+                  "takes longer to write. Ignored when updating a file.");
+  setPropertySettings(
+      "CompressEvents",
+      make_unique<EnabledWhenProperty>("UpdateFileBackEnd", IS_EQUAL_TO, "0"));
 }
 
 //----------------------------------------------------------------------------------------------
@@ -168,6 +233,9 @@ void SaveMD::doSaveEvents(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     auto Saver = boost::shared_ptr<API::IBoxControllerIO>(
         new DataObjects::BoxControllerNeXusIO(bc.get()));
     Saver->setDataType(sizeof(coord_t), MDE::getTypeName());
+    const bool compress = getProperty("CompressEvents");
+    boost::static_pointer_cast<DataObjects::BoxControllerNeXusIO>(Saver)
+        ->setCompression(compress);
     if (makeFileBackend) {
       // store saver with box controller
       bc->setFileBacked(Saver, filename);
@@ -207,12 +275,7 @@ void SaveMD::doSaveEvents(typename MDEventWorkspace<MDE, nd>::sptr ws) {
       std::vector<API::IMDNode *> &boxes = BoxFlatStruct.getBoxes();
       std::vector<uint64_t> &eventIndex = BoxFlatStruct.getEventIndex();
       prog->resetNumSteps(boxes.size(), 0.06, 0.90);
-      for (size_t i = 0; i < boxes.size(); i++) {
-        if (eventIndex[2 * i + 1] == 0 || boxes[i]->getIsMasked())
-          continue;
-        boxes[i]->saveAt(Saver.get(), eventIndex[2 * i]);
-        prog->report("Saving Box");
-      }
+      saveBoxesInBlocks(*Saver, boxes, eventIndex, *prog);
       Saver->closeFile();
     }
   }
@@ -70,6 +70,14 @@ void SaveMD2::init() {
   setPropertySettings(
       "MakeFileBacked",
       make_unique<EnabledWhenProperty>("UpdateFileBackEnd", IS_EQUAL_TO, "0"));
+
+  declareProperty("CompressEvents", false,
+                  "Compress the events in the file. The file is smaller and "
+                  "can still be loaded or used as a file back end, but "
+                  "takes longer to write. Ignored when updating a file.");
+  setPropertySettings(
+      "CompressEvents",
+      make_unique<EnabledWhenProperty>("UpdateFileBackEnd", IS_EQUAL_TO, "0"));
 }
 
 //----------------------------------------------------------------------------------------------
@@ -216,6 +224,8 @@ void SaveMD2::exec() {
                                 getProperty("UpdateFileBackEnd"));
     saveMDv1->setProperty<bool>("MakeFileBacked",
                                 getProperty("MakeFileBacked"));
+    saveMDv1->setProperty<bool>("CompressEvents",
+                                getProperty("CompressEvents"));
     saveMDv1->execute();
   } else if (histoWS) {
     this->doSaveHisto(histoWS);
@@ -989,6 +989,56 @@ public:
         alg.execute(), std::runtime_error &);
   }
 
+  MDHistoWorkspace_sptr bin_rotated(IMDEventWorkspace_sptr in_ws,
+                                    bool parallel) {
+    BinMD alg;
+    alg.initialize();
+    alg.setChild(true);
+    alg.setRethrows(true);
+    alg.setProperty("InputWorkspace", in_ws);
+    alg.setProperty("AxisAligned", false);
+    alg.setPropertyValue("BasisVector0", "OutX,m,0.8,0.6,0");
+    alg.setPropertyValue("BasisVector1", "OutY,m,-0.6,0.8,0");
+    alg.setPropertyValue("BasisVector2", "OutZ,m,0,0,1");
+    alg.setPropertyValue("Translation", "1,-1,0");
+    alg.setProperty("OutputBins", std::vector<int>{17, 43, 9});
+    alg.setPropertyValue("OutputExtents", "0,9, -3,7, 1,8");
+    alg.setProperty("Parallel", parallel);
+    alg.setPropertyValue("OutputWorkspace", "dummy");
+    alg.execute();
+    IMDHistoWorkspace_sptr out = alg.getProperty("OutputWorkspace");
+    return boost::dynamic_pointer_cast<MDHistoWorkspace>(out);
+  }
+
+  void test_parallel_gives_same_result_as_serial() {
+    MDEventWorkspace3Lean::sptr in_ws =
+        MDEventsTestHelper::makeMDEW<3>(10, 0.0, 10.0, 0);
+    in_ws->getBoxController()->setSplitThreshold(50);
+    FakeMDEventData fake;
+    fake.initialize();
+    fake.setProperty("InputWorkspace",
+                     boost::dynamic_pointer_cast<IMDEventWorkspace>(in_ws));
+    fake.setPropertyValue("UniformParams", "20000");
+    fake.setPropertyValue("PeakParams", "5000, 4.0, 5.0, 6.0, 0.5");
+    fake.setProperty("RandomSeed", 1234);
+    fake.execute();
+    TS_ASSERT_EQUALS(in_ws->getNPoints(), 25000);
+
+    auto serial = bin_rotated(in_ws, false);
+    auto parallel = bin_rotated(in_ws, true);
+    TS_ASSERT(serial);
+    TS_ASSERT(parallel);
+    if (!serial || !parallel)
+      return;
+    TS_ASSERT_EQUALS(serial->getNPoints(), parallel->getNPoints());
+    TS_ASSERT(serial->getNEvents() > 10000);
+    for (size_t i = 0; i < serial->getNPoints(); ++i) {
+      TS_ASSERT_EQUALS(serial->getSignalAt(i), parallel->getSignalAt(i));
+      TS_ASSERT_EQUALS(serial->getErrorAt(i), parallel->getErrorAt(i));
+      TS_ASSERT_EQUALS(serial->getNumEventsAt(i), parallel->getNumEventsAt(i));
+    }
+  }
+
   void test_normalization() {
 
     FrameworkManager::Instance().exec(
@@ -202,6 +202,39 @@ public:
     AnalysisDataService::Instance().remove("peaksFound");
   }
 
+  /** Every box of a uniform background is above the threshold and all but
+   * the densest box, in the single peak, are too close to it, so the search
+   * has to go through many more boxes than it first considers */
+  void test_exec_rejects_all_candidates_near_densest_box() {
+    createMDEW();
+    FrameworkManager::Instance().exec("FakeMDEventData", 4, "InputWorkspace",
+                                      "MDEWS", "UniformParams", "-100000");
+    addPeak(1000, 4, 5, 6, 0.2);
+
+    FindPeaksMD alg;
+    alg.initialize();
+    alg.setPropertyValue("InputWorkspace", "MDEWS");
+    alg.setPropertyValue("OutputWorkspace", "peaksFound");
+    alg.setPropertyValue("DensityThresholdFactor", "0.5");
+    alg.setPropertyValue("PeakDistanceThreshold", "40");
+    alg.setProperty("MaxPeaks", int64_t(10));
+    TS_ASSERT_THROWS_NOTHING(alg.execute());
+    TS_ASSERT(alg.isExecuted());
+
+    auto peaksWS = AnalysisDataService::Instance().retrieveWS<PeaksWorkspace>(
+        "peaksFound");
+    TS_ASSERT_EQUALS(peaksWS->getNumberPeaks(), 1);
+    if (peaksWS->getNumberPeaks() == 1) {
+      const auto q = peaksWS->getPeak(0).getQLabFrame();
+      TS_ASSERT_DELTA(q[0], 4.0, 0.2);
+      TS_ASSERT_DELTA(q[1], 5.0, 0.2);
+      TS_ASSERT_DELTA(q[2], 6.0, 0.2);
+    }
+
+    AnalysisDataService::Instance().remove("peaksFound");
+    AnalysisDataService::Instance().remove("MDEWS");
+  }
+
   /** Run on MDHistoWorkspace */
   void test_exec_histo() {
     do_test(true, 100, 3, false, true /*histo conversion*/);
@@ -317,6 +317,89 @@ public:
     doTestSignalToNoiseRatio(false, 99.3417, 5.0972, 0.5821);
   }
 
+  void test_addEventLists_gives_same_result_as_addEvents() {
+    V3D peak_1(20, 0, 0);
+    V3D peak_2(0, 20, 0);
+    std::vector<std::pair<double, V3D>> peak_q_list{{1., peak_1},
+                                                    {1., peak_2}};
+    DblMatrix UBinv(3, 3, false); // Q to h,k,l
+    UBinv.setRow(0, V3D(.1, 0, 0));
+    UBinv.setRow(1, V3D(0, .2, 0));
+    UBinv.setRow(2, V3D(0, 0, .25));
+
+    std::vector<std::pair<double, V3D>> event_Qs;
+    generatePeak(event_Qs, peak_1, 0.1, 1000, 1);
+    generatePeak(event_Qs, peak_2, 0.1, 200, 2);
+
+    Integrate3DEvents serial(peak_q_list, UBinv, 1.);
+    serial.addEvents(event_Qs, false);
+
+    // Sort the events into two sets of lists, as two threads would
+    Integrate3DEvents merged(peak_q_list, UBinv, 1.);
+    const auto middle = event_Qs.begin() + event_Qs.size() / 3;
+    const std::vector<std::pair<double, V3D>> first(event_Qs.begin(), middle);
+    const std::vector<std::pair<double, V3D>> second(middle, event_Qs.end());
+    EventListMap firstLists, secondLists;
+    merged.addEvents(second, false, secondLists);
+    merged.addEvents(first, false, firstLists);
+    merged.addEventLists(firstLists);
+    merged.addEventLists(secondLists);
+    TS_ASSERT(firstLists.empty());
+
+    std::vector<Kernel::V3D> E1Vec;
+    for (const auto &peak : peak_q_list) {
+      std::vector<double> serialRadii, mergedRadii;
+      double serialInti, serialSigi, mergedInti, mergedSigi;
+      serial.ellipseIntegrateEvents(E1Vec, peak.second, false, 0.3, 0.3, 0.4,
+                                    serialRadii, serialInti, serialSigi);
+      merged.ellipseIntegrateEvents(E1Vec, peak.second, false, 0.3, 0.3, 0.4,
+                                    mergedRadii, mergedInti, mergedSigi);
+      TS_ASSERT(serialInti > 0.);
+      TS_ASSERT_DELTA(serialInti, mergedInti, 1e-9);
+      TS_ASSERT_DELTA(serialSigi, mergedSigi, 1e-9);
+      TS_ASSERT_EQUALS(serialRadii.size(), 3);
+      TS_ASSERT_EQUALS(mergedRadii.size(), 3);
+      for (size_t i = 0; i < serialRadii.size() && i < mergedRadii.size(); ++i)
+        TS_ASSERT_DELTA(serialRadii[i], mergedRadii[i], 1e-9);
+    }
+  }
+
+  void test_satellite_peaks_with_same_hkl_are_integrated_separately() {
+    // Both peaks round to h,k,l = (1,0,0)
+    V3D peak_1(10, 0, 0);
+    V3D satellite(11, 0, 0);
+    std::vector<std::pair<double, V3D>> peak_q_list{{1., peak_1},
+                                                    {1., satellite}};
+    DblMatrix UBinv(3, 3, false); // Q to h,k,l
+    UBinv.setRow(0, V3D(.1, 0, 0));
+    UBinv.setRow(1, V3D(0, .2, 0));
+    UBinv.setRow(2, V3D(0, 0, .25));
+
+    // 303 events around the peak and 153 around the satellite
+    std::vector<std::pair<double, V3D>> event_Qs;
+    for (int i = -50; i <= 50; i++) {
+      const double offset = static_cast<double>(i) / 200.0;
+      for (const auto &direction : {V3D(1, 0, 0), V3D(0, 1, 0), V3D(0, 0, 1)}) {
+        event_Qs.emplace_back(1., peak_1 + direction * offset);
+        if (i % 2 == 0)
+          event_Qs.emplace_back(1., satellite + direction * offset);
+      }
+    }
+
+    Integrate3DEvents integrator(peak_q_list, UBinv, 0.5);
+    integrator.addEvents(event_Qs, false);
+
+    std::vector<Kernel::V3D> E1Vec;
+    std::vector<double> axes_radii;
+    double inti, sigi;
+    integrator.ellipseIntegrateEvents(E1Vec, peak_1, true, 0.45, 0.45, 0.5,
+                                      axes_radii, inti, sigi);
+    TS_ASSERT_DELTA(inti, 303, 0.1);
+    integrator.ellipseIntegrateEvents(E1Vec, satellite, true, 0.45, 0.45, 0.5,
+                                      axes_radii, inti, sigi);
+    TS_ASSERT_DELTA(inti, 153, 0.1);
+  }
+
 private:
   void doTestSignalToNoiseRatio(const bool useOnePercentBackgroundCorrection,
                                 const double expectedRatio1,
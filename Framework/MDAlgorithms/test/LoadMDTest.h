@@ -173,10 +173,39 @@ public:
     }
   }
 
+  /// Whether HDF5 deflates the events in a file saved by SaveMD
+  static bool eventDataIsCompressed(const std::string &filename) {
+    auto fid = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    auto did =
+        H5Dopen(fid, "/MDEventWorkspace/event_data/event_data", H5P_DEFAULT);
+    bool compressed = false;
+    if (did > 0) {
+      auto plist = H5Dget_create_plist(did);
+      const int nFilters = H5Pget_nfilters(plist);
+      for (int i = 0; i < nFilters; ++i) {
+        unsigned flags = 0;
+        size_t nValues = 0;
+        unsigned filterConfig = 0;
+        if (H5Pget_filter2(plist, static_cast<unsigned>(i), &flags, &nValues,
+                           nullptr, 0, nullptr,
+                           &filterConfig) == H5Z_FILTER_DEFLATE)
+          compressed = true;
+      }
+      H5Pclose(plist);
+      H5Dclose(did);
+    } else {
+      TS_FAIL("Cannot open the event data. Test file has unexpected "
+              "structure.");
+    }
+    H5Fclose(fid);
+    return compressed;
+  }
+
   //=================================================================================================================
   template <size_t nd>
   void do_test_exec(bool FileBackEnd, bool deleteWorkspace = true,
-                    double memory = 0, bool BoxStructureOnly = false) {
+                    double memory = 0, bool BoxStructureOnly = false,
+                    bool compressEvents = false) {
     using MDE = MDLeanEvent<nd>;
 
     //------ Start by creating the file
@@ -209,6 +238,8 @@ public:
         saver.setProperty("InputWorkspace", "LoadMDTest_ws"));
     TS_ASSERT_THROWS_NOTHING(saver.setPropertyValue(
         "Filename", "LoadMDTest" + Strings::toString(nd) + ".nxs"));
+    TS_ASSERT_THROWS_NOTHING(
+        saver.setProperty("CompressEvents", compressEvents));
 
     // Retrieve the full path; delete any pre-existing file
     std::string filename = saver.getPropertyValue("Filename");
@@ -217,6 +248,7 @@ public:
 
     TS_ASSERT_THROWS_NOTHING(saver.execute(););
     TS_ASSERT(saver.isExecuted());
+    TS_ASSERT_EQUALS(eventDataIsCompressed(filename), compressEvents);
 
     //------ Now the loading -------------------------------------
     // Name of the output workspace.
@@ -407,6 +439,16 @@ public:
   /// Run the loading but keep the events on file and load on demand
   void test_exec_3D_with_FileBackEnd() { do_test_exec<3>(true); }
 
+  /// Save with compressed events and load directly to memory
+  void test_exec_3D_compressed() {
+    do_test_exec<3>(false, true, 0, false, true);
+  }
+
+  /// Save with compressed events and load them on demand
+  void test_exec_3D_compressed_with_FileBackEnd() {
+    do_test_exec<3>(true, true, 0, false, true);
+  }
+
   /// Run the loading but keep the events on file and load on demand
   void test_exec_3D_with_FileBackEnd_andSmallBuffer() {
     do_test_exec<3>(true, true, 1.0);
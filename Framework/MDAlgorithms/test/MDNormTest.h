@@ -0,0 +1,166 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_MDALGORITHMS_MDNORMTEST_H_
+#define MANTID_MDALGORITHMS_MDNORMTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidAPI/IMDEventWorkspace.h"
+#include "MantidAPI/IMDHistoWorkspace.h"
+#include "MantidAPI/Run.h"
+#include "MantidKernel/ConfigService.h"
+#include "MantidMDAlgorithms/ConvertToMD.h"
+#include "MantidMDAlgorithms/MDNorm.h"
+#include "MantidTestHelpers/WorkspaceCreationHelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using Mantid::MDAlgorithms::MDNorm;
+using namespace Mantid::API;
+
+class MDNormTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static MDNormTest *createSuite() { return new MDNormTest(); }
+  static void destroySuite(MDNormTest *suite) { delete suite; }
+
+  void setUp() override {
+    m_cacheSize = Mantid::Kernel::ConfigService::Instance().getString(
+        "MDNorm.TrajectoryCacheSize");
+    MDNorm::clearTrajectoryCache();
+  }
+
+  void tearDown() override {
+    Mantid::Kernel::ConfigService::Instance().setString(
+        "MDNorm.TrajectoryCacheSize", m_cacheSize);
+    MDNorm::clearTrajectoryCache();
+  }
+
+  void test_Init() {
+    MDNorm alg;
+    TS_ASSERT_THROWS_NOTHING(alg.initialize())
+    TS_ASSERT(alg.isInitialized())
+  }
+
+  void test_trajectory_cache_does_not_change_normalization() {
+    const auto input = createInputWorkspace();
+    setCacheSize("0");
+    const auto uncached = normalize(input);
+    setCacheSize("1024");
+    const auto first = normalize(input);
+    const auto second = normalize(input);
+
+    TS_ASSERT(totalSignal(*uncached) > 0.);
+    assertSameSignal(*uncached, *first);
+    assertSameSignal(*uncached, *second);
+  }
+
+  void test_second_run_uses_cached_trajectories() {
+    const auto input = createInputWorkspace();
+    setCacheSize("1024");
+    normalize(input);
+    auto statistics = MDNorm::trajectoryCacheStatistics();
+    // One experiment info and one symmetry operation
+    TS_ASSERT_EQUALS(statistics.entries, 1);
+    TS_ASSERT_EQUALS(statistics.hits, 0);
+
+    normalize(input);
+    statistics = MDNorm::trajectoryCacheStatistics();
+    TS_ASSERT_EQUALS(statistics.entries, 1);
+    TS_ASSERT_EQUALS(statistics.hits, 1);
+  }
+
+  void test_cache_size_zero_disables_cache() {
+    const auto input = createInputWorkspace();
+    setCacheSize("0");
+    normalize(input);
+    normalize(input);
+    const auto statistics = MDNorm::trajectoryCacheStatistics();
+    TS_ASSERT_EQUALS(statistics.entries, 0);
+    TS_ASSERT_EQUALS(statistics.hits, 0);
+  }
+
+private:
+  void setCacheSize(const std::string &megabytes) {
+    Mantid::Kernel::ConfigService::Instance().setString(
+        "MDNorm.TrajectoryCacheSize", megabytes);
+  }
+
+  /// Direct geometry inelastic data of 9 detectors converted to Q_sample
+  IMDEventWorkspace_sptr createInputWorkspace() {
+    const size_t numberOfDetectors = 9;
+    std::vector<double> L2(numberOfDetectors, 5.), polar(numberOfDetectors),
+        azimuthal(numberOfDetectors);
+    for (size_t i = 0; i < numberOfDetectors; ++i) {
+      polar[i] = 0.2 + 0.1 * static_cast<double>(i);
+      azimuthal[i] = -0.4 + 0.1 * static_cast<double>(i);
+    }
+    auto ws = WorkspaceCreationHelper::createProcessedInelasticWS(
+        L2, polar, azimuthal, 10, -1., 8., 10.);
+    // What CropWorkspaceForMDNorm would add
+    ws->mutableRun().addProperty(
+        "MDNorm_low", std::vector<double>(numberOfDetectors, -1.), true);
+    ws->mutableRun().addProperty(
+        "MDNorm_high", std::vector<double>(numberOfDetectors, 8.), true);
+
+    Mantid::MDAlgorithms::ConvertToMD convert;
+    convert.setChild(true);
+    convert.initialize();
+    convert.setProperty("InputWorkspace", ws);
+    convert.setPropertyValue("QDimensions", "Q3D");
+    convert.setPropertyValue("dEAnalysisMode", "Direct");
+    convert.setPropertyValue("Q3DFrames", "Q_sample");
+    convert.setPropertyValue("MinValues", "-10,-10,-10,-1");
+    convert.setPropertyValue("MaxValues", "10,10,10,8");
+    convert.setPropertyValue("PreprocDetectorsWS", "-");
+    convert.setPropertyValue("OutputWorkspace", "unused");
+    TS_ASSERT_THROWS_NOTHING(convert.execute());
+    IMDEventWorkspace_sptr md = convert.getProperty("OutputWorkspace");
+    return md;
+  }
+
+  IMDHistoWorkspace_sptr normalize(const IMDEventWorkspace_sptr &input) {
+    MDNorm alg;
+    alg.setChild(true);
+    alg.initialize();
+    alg.setProperty("InputWorkspace", input);
+    alg.setPropertyValue("Dimension0Binning", "-2,0.5,2");
+    alg.setPropertyValue("Dimension1Binning", "-2,0.5,2");
+    alg.setPropertyValue("Dimension2Binning", "-2,2");
+    alg.setPropertyValue("Dimension3Name", "DeltaE");
+    alg.setPropertyValue("Dimension3Binning", "-1,1,8");
+    alg.setPropertyValue("OutputWorkspace", "unused");
+    alg.setPropertyValue("OutputDataWorkspace", "unusedData");
+    alg.setPropertyValue("OutputNormalizationWorkspace", "unusedNorm");
+    TS_ASSERT_THROWS_NOTHING(alg.execute());
+    Workspace_sptr norm = alg.getProperty("OutputNormalizationWorkspace");
+    return boost::dynamic_pointer_cast<IMDHistoWorkspace>(norm);
+  }
+
+  static double totalSignal(const IMDHistoWorkspace &ws) {
+    const auto *signal = ws.getSignalArray();
+    return std::accumulate(signal, signal + ws.getNPoints(), 0.);
+  }
+
+  /// The detectors are summed in parallel, so allow for rounding
+  static void assertSameSignal(const IMDHistoWorkspace &expected,
+                               const IMDHistoWorkspace &actual) {
+    TS_ASSERT_EQUALS(actual.getNPoints(), expected.getNPoints());
+    for (size_t i = 0; i < expected.getNPoints(); ++i) {
+      const auto value = expected.getSignalArray()[i];
+      TS_ASSERT_DELTA(actual.getSignalArray()[i], value,
+                      1e-12 * std::max(1., std::fabs(value)));
+    }
+  }
+
+  std::string m_cacheSize;
+};
+
+#endif /* MANTID_MDALGORITHMS_MDNORMTEST_H_ */
@@ -33,7 +33,13 @@ public:
 
   void test_exec_fileBacked() { do_test_exec("MergeMDFilesTest_OutputWS.nxs"); }
 
-  void do_test_exec(std::string OutputFilename) {
+  void test_exec_serial() { do_test_exec("", false); }
+
+  void test_exec_fileBacked_serial() {
+    do_test_exec("MergeMDFilesTest_OutputWS.nxs", false);
+  }
+
+  void do_test_exec(std::string OutputFilename, bool parallel = true) {
     if (OutputFilename != "") {
       if (Poco::File(OutputFilename).exists())
         Poco::File(OutputFilename).remove();
@@ -47,6 +53,7 @@ public:
     std::vector<MDEventWorkspace3Lean::sptr> inWorkspaces;
     // how many events put into each file.
     long nFileEvents(1000);
+    double totalSignal(0);
     for (size_t i = 0; i < 3; i++) {
       std::ostringstream mess;
       mess << "MergeMDFilesTestInput" << i;
@@ -54,6 +61,7 @@ public:
           MDAlgorithmsTestHelper::makeFileBackedMDEWwithMDFrame(
               mess.str(), true, frame, -nFileEvents, appliedCoord);
       inWorkspaces.push_back(ws);
+      totalSignal += ws->getBox()->getSignal();
       filenames.push_back(
           std::vector<std::string>(1, ws->getBoxController()->getFilename()));
     }
@@ -69,6 +77,7 @@ public:
         alg.setPropertyValue("OutputFilename", OutputFilename));
     TS_ASSERT_THROWS_NOTHING(
         alg.setPropertyValue("OutputWorkspace", outWSName));
+    TS_ASSERT_THROWS_NOTHING(alg.setProperty("Parallel", parallel));
 
     // clean up possible rubbish from previous runs
     std::string fullName = alg.getPropertyValue("OutputFilename");
@@ -92,6 +101,8 @@ public:
 
     TS_ASSERT_EQUALS(appliedCoord, ws->getSpecialCoordinateSystem());
     TS_ASSERT_EQUALS(ws->getNPoints(), 3 * nFileEvents);
+    TS_ASSERT_DELTA(ws->getBox()->getSignal(), totalSignal,
+                    1e-5 * totalSignal);
     MDBoxBase3Lean *box = ws->getBox();
     TS_ASSERT_EQUALS(box->getNumChildren(), 1000);
 
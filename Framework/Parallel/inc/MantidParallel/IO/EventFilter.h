@@ -0,0 +1,43 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_PARALLEL_EVENTFILTER_H_
+#define MANTID_PARALLEL_EVENTFILTER_H_
+
+#include "MantidTypes/Event/TofEvent.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace Mantid {
+namespace Parallel {
+namespace IO {
+
+/** EventFilter : Limits on time-of-flight and pulse time applied to events
+  while they are loaded, so that rejected events never reach the event lists.
+  Both ranges are inclusive, matching the default loader of LoadEventNexus.
+  Pulse times are absolute, in nanoseconds as used by DateAndTime. A default
+  constructed filter accepts every event.
+*/
+struct EventFilter {
+  double tofMin{std::numeric_limits<double>::lowest()};
+  double tofMax{std::numeric_limits<double>::max()};
+  int64_t pulseTimeMin{std::numeric_limits<int64_t>::min()};
+  int64_t pulseTimeMax{std::numeric_limits<int64_t>::max()};
+
+  bool accepts(const Types::Event::TofEvent &event) const {
+    const double tof = event.tof();
+    const int64_t pulseTime = event.pulseTime().totalNanoseconds();
+    return tof >= tofMin && tof <= tofMax && pulseTime >= pulseTimeMin &&
+           pulseTime <= pulseTimeMax;
+  }
+};
+
+} // namespace IO
+} // namespace Parallel
+} // namespace Mantid
+
+#endif /* MANTID_PARALLEL_EVENTFILTER_H_ */
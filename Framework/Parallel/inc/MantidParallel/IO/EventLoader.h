@@ -22,6 +22,7 @@ class TofEvent;
 namespace Parallel {
 class Communicator;
 namespace IO {
+struct EventFilter;
 
 /** Loader for event data from Nexus files with parallelism based on multiple
   processes (MPI) for performance.
@@ -45,7 +46,7 @@ load(const std::string &filename, const std::string &groupName,
      const std::vector<std::string> &bankNames,
      const std::vector<int32_t> &bankOffsets,
      std::vector<std::vector<Types::Event::TofEvent> *> eventLists,
-     bool precalcEvents);
+     bool precalcEvents, const EventFilter &filter);
 
 } // namespace EventLoader
 
@@ -16,6 +16,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "MantidParallel/IO/EventFilter.h"
 #include "MantidParallel/IO/EventLoaderHelpers.h"
 #include "MantidParallel/IO/EventsListsShmemStorage.h"
 
@@ -42,6 +43,10 @@ namespace IO {
  *
  * There 3 main time consuming parts: reading from file, pushing to shared
  * memory, collecting from shared memory, the cost of sorting is small.
+ *
+ * Events rejected by the EventFilter are dropped in the child processes, so
+ * they take up neither shared memory nor time when collecting. If the number
+ * of processes is 0 it is chosen from the number of events in the file.
 
   @author Igor Gudich
   @date 2018
@@ -50,7 +55,8 @@ class MANTID_PARALLEL_DLL MultiProcessEventLoader {
 public:
   MultiProcessEventLoader(uint32_t numPixels, uint32_t numProcesses,
                           uint32_t numThreads, const std::string &binary,
-                          bool precalc = true);
+                          bool precalc = true,
+                          const EventFilter &filter = EventFilter());
   void
   load(const std::string &filename, const std::string &groupname,
        const std::vector<std::string> &bankNames,
@@ -62,10 +68,16 @@ public:
                            const std::string &groupname,
                            const std::vector<std::string> &bankNames,
                            const std::vector<int32_t> &bankOffsets,
-                           std::size_t from, std::size_t to, bool precalc);
+                           std::size_t from, std::size_t to, bool precalc,
+                           const EventFilter &filter = EventFilter());
+
+  uint32_t numberOfProcesses(std::size_t eventCount) const;
 
   enum struct LoadType { preCalcEvents, producerConsumer };
 
+  /// Fewest events worth starting another child process for
+  static constexpr std::size_t minEventsPerProcess{1000000};
+
 private:
   static std::vector<std::string> generateSegmentsName(uint32_t procNum);
   static std::string generateStoragename();
@@ -79,20 +91,23 @@ private:
                               const H5::Group &group,
                               const std::vector<std::string> &bankNames,
                               const std::vector<int32_t> &bankOffsets,
-                              std::size_t from, std::size_t to);
+                              std::size_t from, std::size_t to,
+                              const EventFilter &filter);
 
     static void loadFromGroupWrapper(const H5::DataType &type,
                                      EventsListsShmemStorage &storage,
                                      const H5::Group &group,
                                      const std::vector<std::string> &bankNames,
                                      const std::vector<int32_t> &bankOffsets,
-                                     std::size_t from, std::size_t to);
+                                     std::size_t from, std::size_t to,
+                                     const EventFilter &filter);
   };
 
   void assembleFromShared(
+      const std::vector<std::string> &segmentNames,
       std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const;
 
-  size_t estimateShmemAmount(size_t eventCount) const;
+  size_t estimateShmemAmount(size_t eventCount, uint32_t numProcesses) const;
 
 private:
   bool m_precalculateEvents;
@@ -100,8 +115,8 @@ private:
   uint32_t m_numProcesses;
   uint32_t m_numThreads;
   std::string m_binaryToLaunch;
-  std::vector<std::string> m_segmentNames;
   std::string m_storageName;
+  EventFilter m_filter;
 };
 
 /// Wrapper to avoid manual processing of all cases of 2 template arguments
@@ -109,25 +124,26 @@ template <typename MultiProcessEventLoader::LoadType LT>
 void MultiProcessEventLoader::GroupLoader<LT>::loadFromGroupWrapper(
     const H5::DataType &type, EventsListsShmemStorage &storage,
     const H5::Group &instrument, const std::vector<std::string> &bankNames,
-    const std::vector<int32_t> &bankOffsets, std::size_t from, std::size_t to) {
+    const std::vector<int32_t> &bankOffsets, std::size_t from, std::size_t to,
+    const EventFilter &filter) {
   if (type == H5::PredType::NATIVE_INT32)
     return loadFromGroup<int32_t>(storage, instrument, bankNames, bankOffsets,
-                                  from, to);
+                                  from, to, filter);
   if (type == H5::PredType::NATIVE_INT64)
     return loadFromGroup<int64_t>(storage, instrument, bankNames, bankOffsets,
-                                  from, to);
+                                  from, to, filter);
   if (type == H5::PredType::NATIVE_UINT32)
     return loadFromGroup<uint32_t>(storage, instrument, bankNames, bankOffsets,
-                                   from, to);
+                                   from, to, filter);
   if (type == H5::PredType::NATIVE_UINT64)
     return loadFromGroup<uint64_t>(storage, instrument, bankNames, bankOffsets,
-                                   from, to);
+                                   from, to, filter);
   if (type == H5::PredType::NATIVE_FLOAT)
     return loadFromGroup<float>(storage, instrument, bankNames, bankOffsets,
-                                from, to);
+                                from, to, filter);
   if (type == H5::PredType::NATIVE_DOUBLE)
     return loadFromGroup<double>(storage, instrument, bankNames, bankOffsets,
-                                 from, to);
+                                 from, to, filter);
   throw std::runtime_error(
       "Unsupported H5::DataType for event_time_offset in NXevent_data");
 }
@@ -146,9 +162,11 @@ void MultiProcessEventLoader::GroupLoader<
     loadFromGroup(EventsListsShmemStorage &storage, const H5::Group &instrument,
                   const std::vector<std::string> &bankNames,
                   const std::vector<int32_t> &bankOffsets,
-                  const std::size_t from, const std::size_t to) {
+                  const std::size_t from, const std::size_t to,
+                  const EventFilter &filter) {
   std::vector<int32_t> eventId;
   std::vector<T> eventTimeOffset;
+  std::vector<TofEvent> events;
 
   std::size_t eventCounter{0};
   auto bankSizes = EventLoader::readBankSizes(instrument, bankNames);
@@ -177,6 +195,21 @@ void MultiProcessEventLoader::GroupLoader<
       detail::eventIdToGlobalSpectrumIndex(eventId.data(), cnt,
                                            bankOffsets[bankIdx]);
 
+      // Drop the filtered events before counting them, keeping the IDs of
+      // the accepted ones in step with the events
+      part->setEventOffset(start);
+      events.clear();
+      events.reserve(cnt);
+      for (std::size_t i = 0; i < cnt; ++i) {
+        TofEvent event{boost::numeric_cast<ToFType>(eventTimeOffset[i]),
+                       part->next()};
+        if (filter.accepts(event)) {
+          eventId[events.size()] = eventId[i];
+          events.push_back(event);
+        }
+      }
+      eventId.resize(events.size());
+
       std::unordered_map<int32_t, std::size_t> eventsPerPixel;
       for (auto &pixId : eventId) {
         auto iter = eventsPerPixel.find(pixId);
@@ -188,13 +221,9 @@ void MultiProcessEventLoader::GroupLoader<
       for (const auto &pair : eventsPerPixel)
         storage.reserve(0, pair.first, pair.second);
 
-      part->setEventOffset(start);
       for (std::size_t i = 0; i < eventId.size(); ++i) {
         try {
-          storage.appendEvent(
-              0, eventId[i],
-              TofEvent{boost::numeric_cast<ToFType>(eventTimeOffset[i]),
-                       part->next()});
+          storage.appendEvent(0, eventId[i], events[i]);
         } catch (...) {
           std::throw_with_nested(
               std::runtime_error("Something wrong in multiprocess "
@@ -218,7 +247,8 @@ void MultiProcessEventLoader::GroupLoader<
     loadFromGroup(EventsListsShmemStorage &storage, const H5::Group &instrument,
                   const std::vector<std::string> &bankNames,
                   const std::vector<int32_t> &bankOffsets,
-                  const std::size_t from, const std::size_t to) {
+                  const std::size_t from, const std::size_t to,
+                  const EventFilter &filter) {
   constexpr std::size_t chunksPerBank{10};
   const std::size_t chLen{
       std::max<std::size_t>((to - from) / chunksPerBank, 1)};
@@ -326,10 +356,11 @@ void MultiProcessEventLoader::GroupLoader<
           auto &task = tasks[tn];
           task.partitioner->setEventOffset(task.from);
           for (unsigned i = 0; i < task.eventId.size(); ++i) {
-            pixels.at(task.eventId[i])
-                .emplace_back(
-                    boost::numeric_cast<ToFType>(task.eventTimeOffset[i]),
-                    task.partitioner->next());
+            const TofEvent event{
+                boost::numeric_cast<ToFType>(task.eventTimeOffset[i]),
+                task.partitioner->next()};
+            if (filter.accepts(event))
+              pixels.at(task.eventId[i]).push_back(event);
           }
           task.eventId.resize(0);
           task.eventId.shrink_to_fit();
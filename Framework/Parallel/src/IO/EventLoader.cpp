@@ -8,6 +8,7 @@
 #include "MantidKernel/ConfigService.h"
 #include "MantidKernel/MantidVersion.h"
 #include "MantidKernel/MultiThreaded.h"
+#include "MantidParallel/IO/EventFilter.h"
 #include "MantidParallel/IO/EventLoaderHelpers.h"
 #include "MantidParallel/IO/MultiProcessEventLoader.h"
 #include "MantidParallel/IO/NXEventDataLoader.h"
@@ -56,22 +57,23 @@ void load(const Communicator &comm, const std::string &filename,
        bankNames, bankOffsets, std::move(eventLists));
 }
 
-/// Load events from given banks into event lists.
+/** Load events from given banks into event lists, using child processes
+ * that read from the file independently. Their number is chosen from the
+ * number of events, the threads collecting their results from the number of
+ * cores. Events rejected by the filter are not loaded. */
 void load(const std::string &filename, const std::string &groupname,
           const std::vector<std::string> &bankNames,
           const std::vector<int32_t> &bankOffsets,
           std::vector<std::vector<Types::Event::TofEvent> *> eventLists,
-          bool precalcEvents) {
-  auto concurencyNumber = PARALLEL_GET_MAX_THREADS;
-  auto numThreads = std::max<int>(concurencyNumber / 2, 1);
-  auto numProceses = std::max<int>(concurencyNumber / 2, 1);
+          bool precalcEvents, const EventFilter &filter) {
+  const auto numThreads = std::max<int>(PARALLEL_GET_MAX_THREADS, 1);
   std::string executableName =
       Kernel::ConfigService::Instance().getPropertiesDir() +
       "/MantidNexusParallelLoader";
 
-  MultiProcessEventLoader loader(static_cast<unsigned>(eventLists.size()),
-                                 numProceses, numThreads, executableName,
-                                 precalcEvents);
+  MultiProcessEventLoader loader(static_cast<unsigned>(eventLists.size()), 0,
+                                 numThreads, executableName, precalcEvents,
+                                 filter);
   loader.load(filename, groupname, bankNames, bankOffsets, eventLists);
 }
 
@@ -10,7 +10,9 @@
 #include <chrono>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <numeric>
+#include <sstream>
 #include <thread>
 
 #include "MantidParallel/IO/MultiProcessEventLoader.h"
@@ -23,17 +25,40 @@ namespace Mantid {
 namespace Parallel {
 namespace IO {
 
+namespace {
+/// Format a double for the command line of a child process without losing
+/// precision
+std::string toArgument(double value) {
+  std::ostringstream out;
+  out << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+  return out.str();
+}
+} // namespace
+
 /// Constructor
 MultiProcessEventLoader::MultiProcessEventLoader(uint32_t numPixels,
                                                  uint32_t numProcesses,
                                                  uint32_t numThreads,
                                                  const std::string &binary,
-                                                 bool precalc)
+                                                 bool precalc,
+                                                 const EventFilter &filter)
     : m_precalculateEvents(precalc), m_numPixels(numPixels),
-      m_numProcesses(numProcesses), m_numThreads(numThreads),
-      m_binaryToLaunch(binary),
-      m_segmentNames(generateSegmentsName(numProcesses)),
-      m_storageName(generateStoragename()) {}
+      m_numProcesses(numProcesses), m_numThreads(std::max(numThreads, 1u)),
+      m_binaryToLaunch(binary), m_storageName(generateStoragename()),
+      m_filter(filter) {}
+
+/** The number of child processes used to load the given number of events: the
+ * number given on construction, or if that was 0 one process per
+ * minEventsPerProcess events, but no more than the number of threads. Small
+ * files are not worth the cost of starting processes. */
+uint32_t
+MultiProcessEventLoader::numberOfProcesses(std::size_t eventCount) const {
+  if (m_numProcesses > 0)
+    return m_numProcesses;
+  const auto wanted = std::max<std::size_t>(eventCount / minEventsPerProcess, 1);
+  return static_cast<uint32_t>(
+      std::min<std::size_t>(wanted, static_cast<std::size_t>(m_numThreads)));
+}
 
 /// Generates "unique" shared memory segment name
 std::vector<std::string>
@@ -77,9 +102,11 @@ void MultiProcessEventLoader::load(
     auto bkSz = EventLoader::readBankSizes(instrument, bankNames);
     auto numEvents = std::accumulate(bkSz.begin(), bkSz.end(), std::size_t{0});
 
-    std::size_t storageSize = estimateShmemAmount(numEvents);
+    const auto numProcesses = numberOfProcesses(numEvents);
+    const auto segmentNames = generateSegmentsName(numProcesses);
+    std::size_t storageSize = estimateShmemAmount(numEvents, numProcesses);
 
-    std::size_t evPerPr = numEvents / m_numProcesses;
+    std::size_t evPerPr = numEvents / numProcesses;
 
     /*  boost::process implementation can be used
      * with proper boost version instead of Poco*/
@@ -87,13 +114,13 @@ void MultiProcessEventLoader::load(
         std::vector<bp::child> vChilds;
 
         // prepare command for launching of parallel processes
-        for (unsigned i = 0; i < m_numProcesses; ++i) {
+        for (unsigned i = 0; i < numProcesses; ++i) {
           std::size_t upperBound =
-              i < m_numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
+              i < numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
 
           std::string command;
           command += m_binaryToLaunch + " ";
-          command += m_segmentNames[i] + " ";           // segment name
+          command += segmentNames[i] + " ";             // segment name
           command += m_storageName + " ";               // storage name
           command += std::to_string(i) + " ";           // proc id
           command += std::to_string(evPerPr * i) + " "; // first event to load
@@ -128,15 +155,15 @@ void MultiProcessEventLoader::load(
         for (const auto &name : segments)
           ip::shared_memory_object::remove(name.c_str());
       }
-    } shared_memory_destroyer(m_segmentNames);
+    } shared_memory_destroyer(segmentNames);
 
     std::vector<Poco::ProcessHandle> vChilds;
-    for (unsigned i = 0; i < m_numProcesses; ++i) {
+    for (unsigned i = 0; i < numProcesses; ++i) {
       std::size_t upperBound =
-          i < m_numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
+          i < numProcesses - 1 ? evPerPr * (i + 1) : numEvents;
       std::vector<std::string> processArgs;
 
-      processArgs.push_back(m_segmentNames[i]);           // segment name
+      processArgs.push_back(segmentNames[i]);             // segment name
       processArgs.push_back(m_storageName);               // storage name
       processArgs.push_back(std::to_string(i));           // proc id
       processArgs.push_back(std::to_string(evPerPr * i)); // first event to load
@@ -148,6 +175,10 @@ void MultiProcessEventLoader::load(
       processArgs.push_back(
           m_precalculateEvents ? "1 "
                                : "0 "); // variant of algorithm used for loading
+      processArgs.push_back(toArgument(m_filter.tofMin)); // event filter
+      processArgs.push_back(toArgument(m_filter.tofMax));
+      processArgs.push_back(std::to_string(m_filter.pulseTimeMin));
+      processArgs.push_back(std::to_string(m_filter.pulseTimeMax));
       for (unsigned j = 0; j < bankNames.size(); ++j) {
         processArgs.push_back(bankNames[j]);                   // bank name
         processArgs.push_back(std::to_string(bankOffsets[j])); // bank size
@@ -183,52 +214,51 @@ void MultiProcessEventLoader::load(
             "Error while waiting processes in  multiprocess loading.");
 
     // Assemble multiprocess data from shared memory
-    assembleFromShared(eventLists);
+    assembleFromShared(segmentNames, eventLists);
   } catch (...) {
     std::throw_with_nested(std::runtime_error("Something wrong in "
                                               "MultiprocessLoader."));
   }
 }
 
-/**Collects data from the chunks in shared memory to the final structure*/
+/**Collects data from the chunks in shared memory to the final structure.
+ * All segments are mapped at once so that every event list can be reserved
+ * to its final size before the events of all processes are appended.*/
 void MultiProcessEventLoader::assembleFromShared(
+    const std::vector<std::string> &segmentNames,
     std::vector<std::vector<Mantid::Types::Event::TofEvent> *> &result) const {
-  std::vector<std::thread> workers;
-
-  std::vector<std::atomic<uint32_t>> cnts(m_segmentNames.size());
-  std::vector<std::atomic<uint32_t>> processCounter(m_segmentNames.size());
-  for (auto &cnt : cnts)
-    cnt = 0;
-  for (auto &cnt : processCounter)
-    cnt = 0;
+  std::vector<ip::managed_shared_memory> segments;
+  std::vector<const Chunks *> chunks;
+  segments.reserve(segmentNames.size());
+  for (const auto &name : segmentNames) {
+    segments.emplace_back(ip::open_read_only, name.c_str());
+    chunks.push_back(
+        segments.back().find<Chunks>(m_storageName.c_str()).first);
+    if (!chunks.back())
+      throw std::runtime_error("No events found in shared memory segment " +
+                               name);
+  }
 
+  std::atomic<uint32_t> cnt{0};
   const unsigned portion{std::max<unsigned>(m_numPixels / m_numThreads / 3, 1)};
 
+  std::vector<std::thread> workers;
   for (unsigned i = 0; i < m_numThreads; ++i) {
     workers.emplace_back([&]() {
-      for (std::size_t segId = 0; segId < m_segmentNames.size(); ++segId) {
-        ip::managed_shared_memory segment{ip::open_read_only,
-                                          m_segmentNames[segId].c_str()};
-        auto chunks =
-            segment.find<Mantid::Parallel::IO::Chunks>(m_storageName.c_str())
-                .first;
-        auto &cnt = cnts[segId];
-        for (uint32_t startPixel = cnt.fetch_add(portion);
-             startPixel < m_numPixels; startPixel = cnt.fetch_add(portion)) {
-          auto toPixel = std::min(startPixel + portion, m_numPixels);
-          for (uint32_t pixel = startPixel; pixel < toPixel; ++pixel) {
-            auto &res = result[pixel];
-            for (auto &ch : *chunks) {
-              res->insert(res->end(), ch[pixel].begin(), ch[pixel].end());
-            }
-          }
+      for (uint32_t startPixel = cnt.fetch_add(portion);
+           startPixel < m_numPixels; startPixel = cnt.fetch_add(portion)) {
+        auto toPixel = std::min(startPixel + portion, m_numPixels);
+        for (uint32_t pixel = startPixel; pixel < toPixel; ++pixel) {
+          auto &res = *result[pixel];
+          std::size_t size{res.size()};
+          for (const auto segmentChunks : chunks)
+            for (const auto &ch : *segmentChunks)
+              size += ch[pixel].size();
+          res.reserve(size);
+          for (const auto segmentChunks : chunks)
+            for (const auto &ch : *segmentChunks)
+              res.insert(res.end(), ch[pixel].begin(), ch[pixel].end());
         }
-        ++processCounter[segId];
-        if (processCounter[segId] == m_numThreads)
-          ip::shared_memory_object::remove(m_segmentNames[segId].c_str());
-
-        while (processCounter[segId] != m_numThreads)
-          ;
       }
     });
   }
@@ -243,7 +273,7 @@ void MultiProcessEventLoader::fillFromFile(
     EventsListsShmemStorage &storage, const std::string &filename,
     const std::string &groupname, const std::vector<std::string> &bankNames,
     const std::vector<int32_t> &bankOffsets, const std::size_t from,
-    const std::size_t to, bool precalc) {
+    const std::size_t to, bool precalc, const EventFilter &filter) {
   H5::H5File file(filename.c_str(), H5F_ACC_RDONLY);
   auto instrument = file.openGroup(groupname);
 
@@ -252,19 +282,20 @@ void MultiProcessEventLoader::fillFromFile(
 
   if (precalc)
     return GroupLoader<LoadType::preCalcEvents>::loadFromGroupWrapper(
-        type, storage, instrument, bankNames, bankOffsets, from, to);
+        type, storage, instrument, bankNames, bankOffsets, from, to, filter);
   else
     return GroupLoader<LoadType::producerConsumer>::loadFromGroupWrapper(
-        type, storage, instrument, bankNames, bankOffsets, from, to);
+        type, storage, instrument, bankNames, bankOffsets, from, to, filter);
 }
 
 // Estimates the memory amount for shared memory segments
 // vector representing each pixel allocated only once, so we have allocationFee
 // bytes extra overhead
-size_t MultiProcessEventLoader::estimateShmemAmount(size_t eventCount) const {
+size_t MultiProcessEventLoader::estimateShmemAmount(
+    size_t eventCount, uint32_t numProcesses) const {
   // 8 bytes pointer to allocator + 8 bytes pointer to metadata
   auto allocationFee = 8 + 8 + generateStoragename().length();
-  std::size_t len{(eventCount / m_numProcesses + eventCount % m_numProcesses) *
+  std::size_t len{(eventCount / numProcesses + eventCount % numProcesses) *
                       sizeof(TofEvent) +
                   m_numPixels * (sizeof(EventLists) + allocationFee) +
                   sizeof(Chunks) + allocationFee};
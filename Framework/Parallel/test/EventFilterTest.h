@@ -0,0 +1,53 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2019 ISIS Rutherford Appleton Laboratory UKRI,
+//     NScD Oak Ridge National Laboratory, European Spallation Source
+//     & Institut Laue - Langevin
+// SPDX - License - Identifier: GPL - 3.0 +
+#ifndef MANTID_PARALLEL_EVENTFILTERTEST_H_
+#define MANTID_PARALLEL_EVENTFILTERTEST_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidParallel/IO/EventFilter.h"
+
+using Mantid::Parallel::IO::EventFilter;
+using Mantid::Types::Core::DateAndTime;
+using Mantid::Types::Event::TofEvent;
+
+class EventFilterTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventFilterTest *createSuite() { return new EventFilterTest(); }
+  static void destroySuite(EventFilterTest *suite) { delete suite; }
+
+  void test_default_accepts_everything() {
+    const EventFilter filter;
+    TS_ASSERT(filter.accepts(TofEvent(0.0, DateAndTime(0))));
+    TS_ASSERT(filter.accepts(TofEvent(-1e30, DateAndTime::minimum())));
+    TS_ASSERT(filter.accepts(TofEvent(1e30, DateAndTime::maximum())));
+  }
+
+  void test_tof_limits_are_inclusive() {
+    EventFilter filter;
+    filter.tofMin = 100.0;
+    filter.tofMax = 200.0;
+    TS_ASSERT(!filter.accepts(TofEvent(99.9, DateAndTime(0))));
+    TS_ASSERT(filter.accepts(TofEvent(100.0, DateAndTime(0))));
+    TS_ASSERT(filter.accepts(TofEvent(200.0, DateAndTime(0))));
+    TS_ASSERT(!filter.accepts(TofEvent(200.1, DateAndTime(0))));
+  }
+
+  void test_pulse_time_limits_are_inclusive() {
+    EventFilter filter;
+    filter.pulseTimeMin = 1000;
+    filter.pulseTimeMax = 2000;
+    TS_ASSERT(!filter.accepts(TofEvent(1.0, DateAndTime(999))));
+    TS_ASSERT(filter.accepts(TofEvent(1.0, DateAndTime(1000))));
+    TS_ASSERT(filter.accepts(TofEvent(1.0, DateAndTime(2000))));
+    TS_ASSERT(!filter.accepts(TofEvent(1.0, DateAndTime(2001))));
+  }
+};
+
+#endif /* MANTID_PARALLEL_EVENTFILTERTEST_H_ */
@@ -225,7 +225,8 @@ WorkspaceGroup_sptr MuonProcess::groupWorkspaces(WorkspaceGroup_sptr wsGroup,
     auto ws = boost::dynamic_pointer_cast<MatrixWorkspace>(wsGroup->getItem(i));
     if (ws) {
       MatrixWorkspace_sptr result;
-      IAlgorithm_sptr group = createChildAlgorithm("MuonGroupDetectors");
+      // The same stateless child is run for every period
+      IAlgorithm_sptr group = reuseChildAlgorithm("MuonGroupDetectors");
       group->setProperty("InputWorkspace", ws);
       group->setProperty("DetectorGroupingTable", grouping);
       group->execute();
@@ -249,7 +250,7 @@ WorkspaceGroup_sptr MuonProcess::applyDTC(WorkspaceGroup_sptr wsGroup,
     auto ws = boost::dynamic_pointer_cast<MatrixWorkspace>(wsGroup->getItem(i));
     if (ws) {
       MatrixWorkspace_sptr result;
-      IAlgorithm_sptr dtc = createChildAlgorithm("ApplyDeadTimeCorr");
+      IAlgorithm_sptr dtc = reuseChildAlgorithm("ApplyDeadTimeCorr");
       dtc->setProperty("InputWorkspace", ws);
       dtc->setProperty("DeadTimeTable", dt);
       dtc->execute();
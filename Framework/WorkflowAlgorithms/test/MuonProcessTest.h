@@ -257,6 +257,39 @@ public:
     }
   }
 
+  /// The children run for every period are reused, so check that each
+  /// period is still corrected and grouped on its own
+  void test_multiPeriod_deadTimeCorrection() {
+    std::vector<int> group1, group2;
+    for (int i = 33; i <= 64; ++i)
+      group1.push_back(i);
+    for (int i = 1; i <= 32; ++i)
+      group2.push_back(i);
+    TableWorkspace_sptr grouping = createGroupingTable(group1, group2);
+
+    auto deadTimes = boost::make_shared<TableWorkspace>();
+    deadTimes->addColumn("int", "spectrum");
+    deadTimes->addColumn("double", "dead-time");
+    for (int i = 0; i < 64; ++i) {
+      TableRow newRow = deadTimes->appendRow();
+      newRow << (i + 1) << 0.01 * (i + 1);
+    }
+
+    auto data = loadMUSR();
+    const auto summed = runGroupCounts(*data, grouping, deadTimes, "1,2");
+    const auto first = runGroupCounts(*data, grouping, deadTimes, "1");
+    const auto second = runGroupCounts(*data, grouping, deadTimes, "2");
+    TS_ASSERT(summed && first && second);
+    if (!summed || !first || !second)
+      return;
+
+    TS_ASSERT_EQUALS(summed->blocksize(), 2000);
+    for (const size_t i : {0, 1000, 1701}) {
+      const double expected = first->y(0)[i] + second->y(0)[i];
+      TS_ASSERT_DELTA(summed->y(0)[i], expected, 1e-9 * expected);
+    }
+  }
+
   void test_binCorrectionParams() {
     ScopedWorkspace output;
 
@@ -586,6 +619,30 @@ public:
   }
 
 private:
+  /// Run MuonProcess for the counts of the second group with dead time
+  /// correction
+  MatrixWorkspace_sptr runGroupCounts(const LoadedData &data,
+                                      const TableWorkspace_sptr &grouping,
+                                      const TableWorkspace_sptr &deadTimes,
+                                      const std::string &periods) {
+    MuonProcess alg;
+    alg.setChild(true);
+    alg.initialize();
+    alg.setProperty("InputWorkspace", data.workspace);
+    alg.setPropertyValue("SummedPeriodSet", periods);
+    alg.setProperty("LoadedTimeZero", data.timeZero);
+    alg.setProperty("Mode", "Combined");
+    alg.setProperty("DetectorGroupingTable", grouping);
+    alg.setProperty("ApplyDeadTimeCorrection", true);
+    alg.setProperty("DeadTimeTable", deadTimes);
+    alg.setProperty("OutputType", "GroupCounts");
+    alg.setProperty("GroupIndex", 1);
+    alg.setPropertyValue("OutputWorkspace", "__notused");
+    TS_ASSERT_THROWS_NOTHING(alg.execute());
+    Workspace_sptr output = alg.getProperty("OutputWorkspace");
+    return boost::dynamic_pointer_cast<MatrixWorkspace>(output);
+  }
+
   TableWorkspace_sptr createGroupingTable(const std::vector<int> &group1,
                                           const std::vector<int> &group2) {
     auto t = boost::make_shared<TableWorkspace>();